@@ -0,0 +1,159 @@
+/**
+ * @file async_compressor.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Asynchronous SCHC compression and decompression in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details An Async Compressor lets an event loop, e.g. built on epoll or
+ * libuv, hand packets to worker threads instead of compressing them inline.
+ * Each worker owns its memory pool, see memory.h, and its Flow Cache, and
+ * pulls requests from a lock-free ring buffer, see ring_buffer.h.
+ *
+ * A request either has a callback, called by the worker that processed it,
+ * or goes to a completion queue polled with poll_async_completion(...). The
+ * descriptor returned by get_async_compressor_fd(...) becomes readable when
+ * completions are queued, so that the event loop watches it along with its
+ * sockets. Each time it is readable, the event loop polls completions until
+ * there is none left, which clears the signal.
+ *
+ * At most max_in_flight requests are submitted and not yet completed, a
+ * request being completed once its callback returned or once it was polled.
+ * submit_async_request(...) fails beyond, and the descriptor becomes readable
+ * again when half of the requests in flight completed, the signal for the
+ * event loop to resume its submissions.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _ASYNC_COMPRESSOR_H_
+#define _ASYNC_COMPRESSOR_H_
+
+#include "compiled_context.h"
+#include "flow_cache.h"
+#include "utils/ring_buffer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define ASYNC_MAX_WORKERS        256
+#define ASYNC_FLOW_CACHE_ENTRIES 1024
+
+typedef struct async_request_s async_request_t;
+
+/**
+ * @brief Callback of a request, called by a worker thread once the request is
+ * processed.
+ *
+ * @param request Pointer to the request.
+ * @param user_data The user data of the request.
+ */
+typedef void (*async_callback_t)(async_request_t *request, void *user_data);
+
+/**
+ * @brief Struct that defines a request of compression or decompression.
+ */
+struct async_request_s {
+  const compiled_context_t *compiled_context;     // Context of the packet
+  direction_indicator_t     direction;            // DI_UP or DI_DW
+  int                       decompression;        // 1 to decompress
+  const uint8_t            *packet;               // Packet or SCHC Packet
+  size_t                    packet_byte_len;      // Byte length of the packet
+  uint8_t                  *output;               // Buffer of the result
+  size_t                    output_max_byte_len;  // Byte length of the buffer
+  size_t                    output_byte_len;      // Byte length of the result,
+                                                  // 0 if it failed
+  async_callback_t          callback;             // NULL to poll instead
+  void                     *user_data;            // Passed to the callback
+};
+
+typedef struct async_compressor_s async_compressor_t;
+
+/**
+ * @brief Struct that defines a worker of an Async Compressor.
+ */
+typedef struct {
+  pthread_t           thread;
+  flow_cache_t        flow_cache;        // Of the compressions of the worker
+  async_compressor_t *async_compressor;  // Async Compressor of the worker
+} async_worker_t;
+
+/**
+ * @brief Struct that defines an Async Compressor.
+ */
+struct async_compressor_s {
+  async_worker_t *workers;        // Worker threads
+  size_t          card_workers;   // Number of workers
+  size_t          max_in_flight;  // Requests submitted and not completed
+  ring_buffer_t   submissions;    // Requests not yet processed
+  ring_buffer_t   completions;    // Requests processed, to poll
+  int             signal_fds[2];  // Pipe, the read end is readable on signals
+  _Atomic int     stop;           // Set to end the workers
+  _Atomic int     is_signaled;    // 1 while the pipe holds a signal
+  _Atomic int     is_refused;     // 1 since a submission was refused
+  _Alignas(64) _Atomic size_t card_in_flight;  // Requests not completed
+};
+
+/**
+ * @brief Starts an Async Compressor.
+ *
+ * @param card_workers Number of worker threads, from 1 to ASYNC_MAX_WORKERS.
+ * @param max_in_flight Maximum number of requests submitted and not yet
+ * completed, at least 1.
+ * @return A pointer to the Async Compressor, NULL if the threads, descriptors
+ * or memory are exhausted.
+ */
+async_compressor_t *create_async_compressor(const size_t card_workers,
+                                            const size_t max_in_flight);
+
+/**
+ * @brief Stops the workers of an Async Compressor and frees it.
+ *
+ * @details The requests submitted and not yet processed are dropped, without
+ * callback.
+ *
+ * @param async_compressor Pointer to the Async Compressor to destroy.
+ */
+void destroy_async_compressor(async_compressor_t *async_compressor);
+
+/**
+ * @brief Returns the descriptor an event loop watches for readability, set
+ * when completions are queued and when submissions may resume.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ * @return The descriptor, non-blocking.
+ */
+int get_async_compressor_fd(const async_compressor_t *async_compressor);
+
+/**
+ * @brief Submits a request to the workers of an Async Compressor, without
+ * blocking.
+ *
+ * @details The request, its packet and its output buffer must stay valid
+ * until it completes.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ * @param request Pointer to the request.
+ * @return 1 if the request was submitted, otherwise 0 if max_in_flight
+ * requests are in flight, the descriptor then signals when to resume.
+ */
+int submit_async_request(async_compressor_t *async_compressor,
+                         async_request_t    *request);
+
+/**
+ * @brief Polls the completion queue of an Async Compressor, without blocking.
+ *
+ * @details Once the queue is found empty, the signal of the descriptor is
+ * cleared.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ * @return A pointer to the next processed request without callback, or NULL
+ * if there is none.
+ */
+async_request_t *poll_async_completion(async_compressor_t *async_compressor);
+
+#endif  // _ASYNC_COMPRESSOR_H_
\ No newline at end of file
@@ -0,0 +1,96 @@
+/**
+ * @file compiled_context.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Compiled SCHC Context in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A Compiled Context is built from a validated SCHC Context, either a
+ * private copy of a byte array or a Context file mapped by the loader of
+ * context_loader.h, whose pages stay shared by the processes using the same
+ * file. It owns everything that is built once from the Context and then
+ * used on every packet, such as its Compiled Rules, Rule Matchers, Mapping
+ * Tables and Rule Programs, so it can be published, shared and released as a
+ * whole.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _COMPILED_CONTEXT_H_
+#define _COMPILED_CONTEXT_H_
+
+#include "compiled_rules.h"
+#include "context.h"
+#include "mapping_table.h"
+#include "rule_matcher.h"
+#include "rule_program.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Struct that defines a Compiled Context.
+ */
+typedef struct {
+  const uint8_t      *context;            // Private copy or mapped Context
+  validated_context_t validated_context;  // Validated view of the Context
+  int                 is_mapped;          // 1 if the Context is a mapped file
+  compiled_rules_t    compiled_rules;     // Rules decoded from the Context
+  rule_matcher_t      rule_matchers[2];   // Rule Matchers, DI_UP and DI_DW
+  mapping_tables_t    mapping_tables;     // Tables of the Mapping Sent Fields
+  rule_programs_t     rule_programs;      // Programs of the Rules
+  uint32_t            rules_hash;         // Hash of the Context without its ID
+  unsigned int        card_references;    // Number of Context IDs sharing it
+                                          // in a Context Registry
+} compiled_context_t;
+
+/**
+ * @brief Validates a SCHC Context and compiles it.
+ *
+ * @details The Context is copied, therefore the caller can release or reuse
+ * its byte array as soon as this function returns.
+ *
+ * @param context Pointer to the SCHC Context to compile.
+ * @param context_byte_len Byte length of the context.
+ * @return A pointer to a dynamically allocated compiled_context_t, or NULL if
+ * the Context is not valid or memory is exhausted.
+ */
+compiled_context_t *compile_context(const uint8_t *context,
+                                    const size_t   context_byte_len);
+
+/**
+ * @brief Loads a Context file and compiles it, without copying the Context.
+ *
+ * @details The Compiled Context reads the Context from the mapping of the
+ * file, see load_context_file(...), and unmaps it once freed. The file must
+ * not be modified while the Compiled Context exists.
+ *
+ * @param path Path of the Context file.
+ * @return A pointer to a dynamically allocated compiled_context_t, or NULL if
+ * the file cannot be mapped, the Context is not valid or memory is exhausted.
+ */
+compiled_context_t *compile_context_file(const char *path);
+
+/**
+ * @brief Checks if two Compiled Contexts hold the same Rules.
+ *
+ * @details The Context ID, at offset 0, is not compared: Contexts that only
+ * differ by their ID compress and decompress packets the same way.
+ *
+ * @param first_context Pointer to the first Compiled Context.
+ * @param second_context Pointer to the second Compiled Context.
+ * @return 1 if both Compiled Contexts hold the same Rules, otherwise 0.
+ */
+int compiled_context_same_rules(const compiled_context_t *first_context,
+                                const compiled_context_t *second_context);
+
+/**
+ * @brief Frees a Compiled Context created by compile_context(...).
+ *
+ * @param compiled_context Pointer to the Compiled Context to free.
+ */
+void free_compiled_context(compiled_context_t *compiled_context);
+
+#endif  // _COMPILED_CONTEXT_H_
\ No newline at end of file
@@ -0,0 +1,104 @@
+/**
+ * @file compiled_rules.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Compiled SCHC Rules in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Compiled Rules hold the Rule Descriptors and Rule Field Descriptors
+ * of a validated Context, decoded once. The Rule Field Descriptors of a Rule
+ * are laid out as a struct of arrays: SIDs, lengths, positions, MSB lengths,
+ * Target Value offsets, packed DI/MO/CDA and Target Value cardinalities, each
+ * array holding one entry per Rule Field Descriptor. The arrays of a Rule are
+ * contiguous and start on a cache line, so that a Rule of up to 10 Rule Field
+ * Descriptors takes 2 cache lines, and that one member can be compared across
+ * Rule Field Descriptors without reading the others.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _COMPILED_RULES_H_
+#define _COMPILED_RULES_H_
+
+#include "context.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CACHE_LINE_BYTE_LEN 64
+
+/**
+ * @brief Struct that defines a Compiled Rule, which takes a cache line on
+ * 64-bit targets.
+ */
+typedef struct compiled_rule_s {
+  uint16_t offset;  // Offset of the Rule Descriptor in the SCHC Context
+  uint8_t  id;      // ID
+  uint8_t  card_rule_field_descriptor;  // Number of Rule Field Descriptor
+  nature_t nature;                      // Compression Nature
+  const uint16_t *sids;                  // Schema Item iDentifiers
+  const uint16_t *lens;                  // Field Lengths
+  const uint16_t *positions;             // Field Positions
+  const uint16_t *msb_lens;              // MSB lengths, 0 unless MO_MSB
+  const uint16_t *target_value_offsets;  // First Target Value offsets, see
+                                         // rule_field_descriptor_t
+  const uint8_t  *di_mo_cdas;            // Packed DI, MO and CDA
+  const uint8_t  *card_target_values;    // Number of Target Values
+} compiled_rule_t;
+
+/**
+ * @brief Struct that defines the Compiled Rules of a SCHC Context.
+ */
+typedef struct {
+  compiled_rule_t *rules;       // Rules, in Context order
+  size_t           card_rules;  // Number of Rules
+  uint8_t         *fields;      // Arrays of the Rule Field Descriptors
+  size_t           fields_byte_len;  // Byte length of fields
+} compiled_rules_t;
+
+/**
+ * @brief Compiles the Rules of a Validated SCHC Context.
+ *
+ * @details The Compiled Rules only refer to the Context through Target Value
+ * offsets, the Context must outlive them.
+ *
+ * @param compiled_rules Pointer to the Compiled Rules to initialize.
+ * @param validated_context Pointer to the Validated SCHC Context.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_compiled_rules(compiled_rules_t          *compiled_rules,
+                        const validated_context_t *validated_context);
+
+/**
+ * @brief Frees the arrays of Compiled Rules.
+ *
+ * @param compiled_rules Pointer to the Compiled Rules to destroy.
+ */
+void destroy_compiled_rules(compiled_rules_t *compiled_rules);
+
+/**
+ * @brief Gets a Rule Descriptor from Compiled Rules.
+ *
+ * @param rule_descriptor Pointer to the Rule Descriptor to fill.
+ * @param index Index of the Rule Descriptor, lower than the number of Rules.
+ * @param compiled_rules Pointer to the Compiled Rules.
+ */
+void get_compiled_rule_descriptor(rule_descriptor_t      *rule_descriptor,
+                                  const unsigned int      index,
+                                  const compiled_rules_t *compiled_rules);
+
+/**
+ * @brief Gets a Rule Field Descriptor from a Compiled Rule.
+ *
+ * @param rule_field_descriptor Pointer to the Rule Field Descriptor to fill.
+ * @param index Index of the Rule Field Descriptor, lower than the number of
+ * Rule Field Descriptors of the Rule.
+ * @param compiled_rule Pointer to the Compiled Rule.
+ */
+void get_compiled_rule_field_descriptor(
+    rule_field_descriptor_t *rule_field_descriptor, const unsigned int index,
+    const compiled_rule_t *compiled_rule);
+
+#endif  // _COMPILED_RULES_H_
\ No newline at end of file
@@ -15,6 +15,9 @@
 #ifndef _COMPRESSION_H_
 #define _COMPRESSION_H_
 
+#include "compiled_context.h"
+#include "context.h"
+#include "flow_cache.h"
 #include "schc8724.h"
 
 #include <stddef.h>
@@ -37,4 +40,75 @@ size_t compress(uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
                 const uint8_t* packet, const size_t packet_byte_len,
                 const uint8_t* context, const size_t context_byte_len);
 
+/**
+ * @brief Compress a Packet using a Validated SCHC Context.
+ *
+ * @details Same as compress(...), except that Rule Descriptors, Rule Field
+ * Descriptors and Target Values are read without any bounds check, as
+ * context_validate(...) already proved them to be in range.
+ *
+ * @param schc_packet Pointer to the SCHC Packet to fill.
+ * @param schc_packet_max_byte_len Maximum byte length of the schc_packet.
+ * @param packet_direction Packet Direction Indicator.
+ * @param packet Pointer to the packet that needs to be compressed.
+ * @param packet_byte_len Byte length of the packet to compress.
+ * @param validated_context Pointer to the Validated SCHC Context used to
+ * perform compression.
+ * @return The final byte length of the compressed SCHC packet.
+ */
+size_t compress_validated(uint8_t*                    schc_packet,
+                          const size_t                schc_packet_max_byte_len,
+                          const direction_indicator_t packet_direction,
+                          const uint8_t* packet, const size_t packet_byte_len,
+                          const validated_context_t* validated_context);
+
+/**
+ * @brief Compress a Packet using a Compiled SCHC Context.
+ *
+ * @details Same as compress_validated(...), except that Rule Descriptors and
+ * Rule Field Descriptors are read from the Compiled Rules instead of being
+ * decoded from the Context, and that the Rules with a Rule Program run it, see
+ * rule_program.h.
+ *
+ * @param schc_packet Pointer to the SCHC Packet to fill.
+ * @param schc_packet_max_byte_len Maximum byte length of the schc_packet.
+ * @param packet_direction Packet Direction Indicator.
+ * @param packet Pointer to the packet that needs to be compressed.
+ * @param packet_byte_len Byte length of the packet to compress.
+ * @param compiled_context Pointer to the Compiled SCHC Context used to perform
+ * compression.
+ * @return The final byte length of the compressed SCHC packet.
+ */
+size_t compress_compiled(uint8_t*                    schc_packet,
+                         const size_t                schc_packet_max_byte_len,
+                         const direction_indicator_t packet_direction,
+                         const uint8_t* packet, const size_t packet_byte_len,
+                         const compiled_context_t* compiled_context);
+
+/**
+ * @brief Compress a Packet using a Compiled SCHC Context, trying first the Rule
+ * that last compressed its flow.
+ *
+ * @details Same as compress_compiled(...). The Rule of the flow in the Flow
+ * Cache is tried alone when no earlier candidate Rule may compress the same
+ * packet, see is_rule_shadowed(...), and every candidate Rule is tried
+ * otherwise, in which case the Rule found is cached. Packets other than IPv6
+ * ones go through compress_compiled(...).
+ *
+ * @param schc_packet Pointer to the SCHC Packet to fill.
+ * @param schc_packet_max_byte_len Maximum byte length of the schc_packet.
+ * @param packet_direction Packet Direction Indicator.
+ * @param packet Pointer to the packet that needs to be compressed.
+ * @param packet_byte_len Byte length of the packet to compress.
+ * @param compiled_context Pointer to the Compiled SCHC Context used to perform
+ * compression.
+ * @param flow_cache Pointer to the Flow Cache of the worker, see flow_cache.h.
+ * @return The final byte length of the compressed SCHC packet.
+ */
+size_t compress_compiled_cached(
+    uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
+    const direction_indicator_t packet_direction, const uint8_t* packet,
+    const size_t packet_byte_len, const compiled_context_t* compiled_context,
+    flow_cache_t* flow_cache);
+
 #endif  // _COMPRESSION_H_
\ No newline at end of file
@@ -40,6 +40,11 @@
  *                 ...,
  * ...,
  *
+ * // Fragmentation Rule Descriptor, see fragmentation_descriptor.h
+ * RULE_DESC_ID, NATURE_FRAGMENTATION, 0, MODE, DIR, DTAG_LEN, W_LEN, FCN_LEN,
+ *                 WINDOW_SIZE, MAX_ACK_REQUESTS, TILE_LEN_1, TILE_LEN_2,
+ * ...,
+ *
  * // Rule Field Descriptor
  * RULE_FIELD_DESC_SID_1, RULE_FIELD_DESC_SID_2, LEN_1, LEN_2, POS_1, POS_2,
  * DIR_MO_CDA, (MSB_LEN_1, MSB_LEN_2), NUM_TARGET_VALUE, TARGET_VALUE1_OFFSET_1,
@@ -69,6 +74,19 @@ typedef struct {
                                        // Descriptor
 } compute_entry_t;
 
+/**
+ * @brief Struct that defines a SCHC Context proven consistent by
+ * context_validate(...).
+ *
+ * @details Functions taking a Validated Context read Rule Descriptors, Rule
+ * Field Descriptors and Target Values without checking their offsets again.
+ * Only the checks that depend on the processed packet remain.
+ */
+typedef struct {
+  const uint8_t *context;           // Pointer to the validated SCHC Context
+  size_t         context_byte_len;  // Byte length of the context
+} validated_context_t;
+
 /**
  * @brief Gets the number of CDA fields that are equal to CDA_COMPUTE among all
  * Rule Field Descriptors in a specific Rule Descriptor.
@@ -87,4 +105,26 @@ int get_cardinal_compute_entries(const rule_descriptor_t *rule_descriptor,
                                  const uint8_t           *context,
                                  const size_t             context_byte_len);
 
+/**
+ * @brief Checks that a SCHC Context is consistent.
+ *
+ * @details Every offset stored in the Context (Rule Descriptors, Rule Field
+ * Descriptors and Target Values) must point inside the byte array, each
+ * cardinality must fit the Matching Operator and the Compression Decompression
+ * Action it is used with, and every Target Value must be long enough for the
+ * Field it describes. Rule IDs must be unique and fit on the Rule ID length.
+ *
+ * The Context is checked once, the returned Validated Context can then be used
+ * with compress_validated(...) and decompress_validated(...) for as long as
+ * the context byte array is left untouched.
+ *
+ * @param validated_context Pointer to the Validated Context to fill, left
+ * empty if the Context is not valid.
+ * @param context Pointer to the SCHC Context to check.
+ * @param context_byte_len Byte length of the context.
+ * @return The validation status code, 1 for a valid Context, otherwise 0.
+ */
+int context_validate(validated_context_t *validated_context,
+                     const uint8_t *context, const size_t context_byte_len);
+
 #endif  // _CONTEXT_H_
\ No newline at end of file
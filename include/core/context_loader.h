@@ -0,0 +1,53 @@
+/**
+ * @file context_loader.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Context file loader in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A Context file is the raw CSCHC Context byte array, as described in
+ * context.h, stored as is. The file is mapped read-only in memory, therefore
+ * its pages are shared by every process that loads the same file and no copy
+ * nor parsing is performed at startup.
+ *
+ * The Context is validated once, when it is loaded, and read without checks
+ * afterwards. The mapping does not protect it from the file: writes to the file
+ * show through the mapped pages, and reading past a truncation raises SIGBUS.
+ * Keeping the file unmodified and untruncated while it is mapped is therefore
+ * a requirement on the caller, which the loader does not check. A Context is
+ * updated by writing a new file and renaming it over the old one, which leaves
+ * the mapped file untouched, then by loading it.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _CONTEXT_LOADER_H_
+#define _CONTEXT_LOADER_H_
+
+#include "context.h"
+
+/**
+ * @brief Maps a Context file in memory and validates it.
+ *
+ * @details The Context is validated once using context_validate(...). On
+ * success, validated_context points to the read-only mapping of the file
+ * until unload_context_file(...) is called, during which the caller must not
+ * modify nor truncate the file.
+ *
+ * @param validated_context Pointer to the Validated Context to fill.
+ * @param path Path of the Context file.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int load_context_file(validated_context_t *validated_context,
+                      const char          *path);
+
+/**
+ * @brief Unmaps a Context previously loaded with load_context_file(...).
+ *
+ * @param validated_context Pointer to the Validated Context to release.
+ */
+void unload_context_file(validated_context_t *validated_context);
+
+#endif  // _CONTEXT_LOADER_H_
\ No newline at end of file
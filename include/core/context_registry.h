@@ -0,0 +1,252 @@
+/**
+ * @file context_registry.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Context Registry in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details The Context Registry publishes Compiled Contexts by Context ID
+ * (offset 0 of the Context byte array) and lets them be replaced while packets
+ * are being processed.
+ *
+ * Devices are bound to a Context ID, hence a new version of a Context applies
+ * at once to every device bound to it. Context IDs publishing the same Rules
+ * share a single Compiled Context, so memory grows with the number of distinct
+ * Contexts and only by a table entry per device.
+ *
+ * Readers never take a lock. A worker enters a read-side critical section with
+ * context_reader_lock(...), gets the Compiled Contexts it needs with
+ * get_published_context(...), processes a whole batch of packets with them,
+ * and leaves with context_reader_unlock(...).
+ *
+ * Writers are serialized by a mutex. Publishing a new Compiled Context swaps
+ * a single pointer, the previous one is retired along with the current epoch.
+ * A retired Compiled Context is freed once every reader that could still
+ * reference it has left its critical section (epoch-based reclamation).
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _CONTEXT_REGISTRY_H_
+#define _CONTEXT_REGISTRY_H_
+
+#include "compiled_context.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define CONTEXT_REGISTRY_SLOTS       256  // One slot per Context ID
+#define CONTEXT_REGISTRY_MAX_READERS 64   // Maximum number of readers
+#define CONTEXT_READER_OFFLINE       UINT64_MAX  // Epoch of an idle reader
+#define DEVICE_TABLE_MIN_CAPACITY    1024        // Initial number of entries
+#define DEVICE_ID_EMPTY              UINT64_MAX  // Key of a free entry
+#define DEVICE_UNBOUND               0xffff  // Context ID of an unbound device
+
+/**
+ * @brief Struct that defines a Context Reader, i.e. a thread that uses
+ * published Compiled Contexts.
+ *
+ * @details Each reader sits on its own cache line, as its epoch is written on
+ * every batch.
+ */
+typedef struct {
+  _Alignas(64) _Atomic uint64_t epoch;  // Epoch observed on lock, or
+                                        // CONTEXT_READER_OFFLINE
+  int in_use;                           // Reader slot registered
+} context_reader_t;
+
+/**
+ * @brief Struct that defines an entry of the Device Table.
+ *
+ * @details Entries are never moved nor removed while the table is published:
+ * an unbound device keeps its entry with DEVICE_UNBOUND as Context ID.
+ */
+typedef struct {
+  _Atomic uint64_t device_id;   // Device ID, or DEVICE_ID_EMPTY
+  _Atomic uint16_t context_id;  // Context ID, or DEVICE_UNBOUND
+} device_entry_t;
+
+/**
+ * @brief Struct that defines the Device Table, an open addressing hash table
+ * with linear probing from device IDs to Context IDs.
+ *
+ * @details The table is replaced by a larger copy, published like a Compiled
+ * Context, when more than half of its entries are used.
+ */
+typedef struct {
+  size_t         capacity;   // Number of entries, a power of 2
+  size_t         card_used;  // Number of entries with a device ID
+  device_entry_t entries[];  // Entries
+} device_table_t;
+
+/**
+ * @brief Struct that defines a retired object, a Compiled Context or a Device
+ * Table, waiting to be freed.
+ */
+typedef struct retired_object_s {
+  void                    *object;        // Object to free
+  uint64_t                 retire_epoch;  // Epoch of the retirement
+  struct retired_object_s *next;          // Next retired object
+  void (*free_object)(void *);            // Function freeing object
+} retired_object_t;
+
+/**
+ * @brief Struct that defines a Context Registry.
+ */
+typedef struct {
+  _Atomic(compiled_context_t *) slots[CONTEXT_REGISTRY_SLOTS];  // By ID
+  _Atomic(device_table_t *) device_table;  // Device ID to Context ID
+  _Atomic uint64_t          global_epoch;  // Incremented on every retirement
+  pthread_mutex_t           writer_mutex;  // Serializes writers
+  retired_object_t         *retired;       // Retired objects not freed yet
+  size_t                    card_retired;  // Number of retired objects
+  context_reader_t          readers[CONTEXT_REGISTRY_MAX_READERS];  // Readers
+} context_registry_t;
+
+/**
+ * @brief Creates a Context Registry with no published Context.
+ *
+ * @return A pointer to a dynamically allocated context_registry_t, or NULL if
+ * memory is exhausted.
+ */
+context_registry_t *create_context_registry(void);
+
+/**
+ * @brief Frees a Context Registry along with all its Compiled Contexts.
+ *
+ * @details No reader must be using the registry anymore.
+ *
+ * @param registry Pointer to the Context Registry to free.
+ */
+void destroy_context_registry(context_registry_t *registry);
+
+/**
+ * @brief Registers the calling thread as a Context Reader.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @return A pointer to the Context Reader, or NULL if all reader slots are
+ * taken.
+ */
+context_reader_t *register_context_reader(context_registry_t *registry);
+
+/**
+ * @brief Releases a Context Reader obtained with register_context_reader(...).
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param reader Pointer to the Context Reader to release, which must not be in
+ * a read-side critical section.
+ */
+void unregister_context_reader(context_registry_t *registry,
+                               context_reader_t   *reader);
+
+/**
+ * @brief Enters a read-side critical section.
+ *
+ * @details Every Compiled Context obtained until context_reader_unlock(...) is
+ * guaranteed to stay alive, even if it is replaced in the meantime.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param reader Pointer to the Context Reader of the calling thread.
+ */
+void context_reader_lock(context_registry_t *registry,
+                         context_reader_t   *reader);
+
+/**
+ * @brief Leaves a read-side critical section.
+ *
+ * @param reader Pointer to the Context Reader of the calling thread.
+ */
+void context_reader_unlock(context_reader_t *reader);
+
+/**
+ * @brief Gets the Compiled Context published for a Context ID.
+ *
+ * @details Must be called inside a read-side critical section. The returned
+ * pointer must not be used after context_reader_unlock(...).
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param context_id The Context ID.
+ * @return A pointer to the Compiled Context, or NULL if none is published.
+ */
+const compiled_context_t *get_published_context(
+    context_registry_t *registry, const uint8_t context_id);
+
+/**
+ * @brief Gets the Compiled Context of the Context ID a device is bound to.
+ *
+ * @details Must be called inside a read-side critical section. The returned
+ * pointer must not be used after context_reader_unlock(...).
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param device_id The device ID.
+ * @return A pointer to the Compiled Context, or NULL if the device is not
+ * bound or its Context ID has nothing published.
+ */
+const compiled_context_t *get_device_context(context_registry_t *registry,
+                                             const uint64_t      device_id);
+
+/**
+ * @brief Publishes a Compiled Context under its Context ID.
+ *
+ * @details The registry takes ownership of compiled_context. If another
+ * Context ID already publishes the same Rules, compiled_context is freed and
+ * the existing Compiled Context is shared instead. The Compiled Context
+ * previously published under the same Context ID, if any, is retired and
+ * freed once no reader nor Context ID can reference it anymore.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param compiled_context Pointer to the Compiled Context to publish.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int publish_context(context_registry_t *registry,
+                    compiled_context_t *compiled_context);
+
+/**
+ * @brief Withdraws the Compiled Context published for a Context ID.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param context_id The Context ID.
+ * @return The status code, 1 if a Compiled Context was withdrawn, otherwise 0.
+ */
+int withdraw_context(context_registry_t *registry, const uint8_t context_id);
+
+/**
+ * @brief Binds a device to a Context ID.
+ *
+ * @details The Context ID does not need to be published yet. Binding an
+ * already bound device moves it to the new Context ID.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param device_id The device ID, any value but DEVICE_ID_EMPTY.
+ * @param context_id The Context ID.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int bind_device(context_registry_t *registry, const uint64_t device_id,
+                const uint8_t context_id);
+
+/**
+ * @brief Unbinds a device from its Context ID.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param device_id The device ID.
+ * @return The status code, 1 if the device was bound, otherwise 0.
+ */
+int unbind_device(context_registry_t *registry, const uint64_t device_id);
+
+/**
+ * @brief Frees the retired objects that no reader can reference anymore.
+ *
+ * @details publish_context(...) and withdraw_context(...) already call it,
+ * this function is meant for writers that want to release memory without
+ * publishing anything.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @return The number of retired objects still waiting for readers.
+ */
+size_t reclaim_contexts(context_registry_t *registry);
+
+#endif  // _CONTEXT_REGISTRY_H_
\ No newline at end of file
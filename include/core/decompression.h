@@ -15,6 +15,8 @@
 #ifndef _DECOMPRESSION_H_
 #define _DECOMPRESSION_H_
 
+#include "compiled_context.h"
+#include "context.h"
 #include "schc8724.h"
 
 #include <stddef.h>
@@ -37,4 +39,50 @@ size_t decompress(uint8_t *packet, const size_t packet_max_byte_len,
                   const uint8_t *schc_packet, const size_t schc_packet_byte_len,
                   const uint8_t *context, const size_t context_byte_len);
 
+/**
+ * @brief Decompress a SCHC Packet using a Validated SCHC Context.
+ *
+ * @details Same as decompress(...), except that Rule Descriptors, Rule Field
+ * Descriptors and Target Values are read without any bounds check, as
+ * context_validate(...) already proved them to be in range. Values read from
+ * the SCHC Packet, such as mapping indexes, are still checked.
+ *
+ * @param packet Pointer to the Packet to fill.
+ * @param packet_max_byte_len Maximum byte length of the packet.
+ * @param packet_direction Packet Direction Indicator.
+ * @param schc_packet Pointer to the SCHC Packet that needs to be decompressed.
+ * @param schc_packet_byte_len Byte length of the schc_packet to decompress.
+ * @param validated_context Pointer to the Validated SCHC Context used to
+ * perform decompression.
+ * @return The final byte length of the decompressed SCHC packet.
+ */
+size_t decompress_validated(uint8_t *packet, const size_t packet_max_byte_len,
+                            const direction_indicator_t packet_direction,
+                            const uint8_t              *schc_packet,
+                            const size_t                schc_packet_byte_len,
+                            const validated_context_t  *validated_context);
+
+/**
+ * @brief Decompress a SCHC Packet using a Compiled SCHC Context.
+ *
+ * @details Same as decompress_validated(...), except that Rule Descriptors and
+ * Rule Field Descriptors are read from the Compiled Rules instead of being
+ * decoded from the Context, and that the Rules with a Rule Program run it, see
+ * rule_program.h.
+ *
+ * @param packet Pointer to the Packet to fill.
+ * @param packet_max_byte_len Maximum byte length of the packet.
+ * @param packet_direction Packet Direction Indicator.
+ * @param schc_packet Pointer to the SCHC Packet that needs to be decompressed.
+ * @param schc_packet_byte_len Byte length of the schc_packet to decompress.
+ * @param compiled_context Pointer to the Compiled SCHC Context used to perform
+ * decompression.
+ * @return The final byte length of the decompressed SCHC packet.
+ */
+size_t decompress_compiled(uint8_t *packet, const size_t packet_max_byte_len,
+                           const direction_indicator_t packet_direction,
+                           const uint8_t              *schc_packet,
+                           const size_t                schc_packet_byte_len,
+                           const compiled_context_t   *compiled_context);
+
 #endif  // _DECOMPRESSION_H_
\ No newline at end of file
@@ -0,0 +1,108 @@
+/**
+ * @file flow_cache.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC per-flow Rule cache in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Most packets belong to long-lived flows, the same IPv6 addresses,
+ * Next Header and UDP ports, that a Context compresses with the same Rule. The
+ * Flow Cache remembers the Rule that last compressed each flow, in a
+ * direct-mapped table indexed by a hash of these header bytes, so that
+ * compress_compiled_cached(...) tries it before the other Rules.
+ *
+ * The cached Rule is only a hint: it is tried first only if no earlier
+ * candidate Rule may compress the same packets, see is_rule_shadowed(...), and
+ * every Rule is tried on a miss, so the SCHC Packet is always the one of
+ * compress_compiled(...). A Flow Cache is not thread-safe, each worker keeps
+ * its own.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _FLOW_CACHE_H_
+#define _FLOW_CACHE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FLOW_CACHE_RULE_NONE UINT16_MAX  // Entry without a Rule
+
+/**
+ * @brief Struct that defines an entry of the Flow Cache.
+ */
+typedef struct {
+  uint32_t flow_hash;   // Hash of the flow header bytes
+  uint16_t rule_index;  // Index of the Rule, or FLOW_CACHE_RULE_NONE
+} flow_cache_entry_t;
+
+/**
+ * @brief Struct that defines a Flow Cache.
+ */
+typedef struct {
+  flow_cache_entry_t *entries;      // Entries, indexed by flow hash
+  size_t              capacity;     // Number of entries, a power of 2
+  size_t              card_hits;    // Packets compressed with the cached Rule
+  size_t              card_misses;  // Packets that went through every Rule
+} flow_cache_t;
+
+/**
+ * @brief Allocates the entries of a Flow Cache.
+ *
+ * @param flow_cache Pointer to the Flow Cache to initialize.
+ * @param capacity Number of entries, rounded up to a power of 2.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_flow_cache(flow_cache_t *flow_cache, const size_t capacity);
+
+/**
+ * @brief Frees the entries of a Flow Cache.
+ *
+ * @param flow_cache Pointer to the Flow Cache to destroy.
+ */
+void destroy_flow_cache(flow_cache_t *flow_cache);
+
+/**
+ * @brief Forgets every flow of a Flow Cache, for instance once the Context
+ * changed.
+ *
+ * @param flow_cache Pointer to the Flow Cache to clear.
+ */
+void clear_flow_cache(flow_cache_t *flow_cache);
+
+/**
+ * @brief Hashes the header bytes that identify the flow of a packet: the IPv6
+ * Next Header and addresses, and the UDP ports.
+ *
+ * @param flow_hash Pointer to the hash to set.
+ * @param packet Pointer to the packet.
+ * @param packet_byte_len Byte length of the packet.
+ * @return 1 if the packet is an IPv6 packet, otherwise 0.
+ */
+int get_flow_hash(uint32_t *flow_hash, const uint8_t *packet,
+                  const size_t packet_byte_len);
+
+/**
+ * @brief Gets the Rule that last compressed a flow.
+ *
+ * @param flow_cache Pointer to the Flow Cache.
+ * @param flow_hash Hash of the flow, see get_flow_hash(...).
+ * @return The index of the Rule, or FLOW_CACHE_RULE_NONE.
+ */
+uint16_t get_flow_rule(const flow_cache_t *flow_cache,
+                       const uint32_t      flow_hash);
+
+/**
+ * @brief Sets the Rule that last compressed a flow, replacing the flow that
+ * shared its entry.
+ *
+ * @param flow_cache Pointer to the Flow Cache.
+ * @param flow_hash Hash of the flow, see get_flow_hash(...).
+ * @param rule_index Index of the Rule, or FLOW_CACHE_RULE_NONE.
+ */
+void set_flow_rule(flow_cache_t *flow_cache, const uint32_t flow_hash,
+                   const uint16_t rule_index);
+
+#endif  // _FLOW_CACHE_H_
\ No newline at end of file
@@ -0,0 +1,381 @@
+/**
+ * @file fragmentation.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Fragmentation implementation in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details See Section 8 in SCHC RFC 8724. A SCHC Packet that does not fit the
+ * L2 MTU is sent as SCHC Fragments:
+ *
+ * RULE_ID | DTAG | W | FCN | (RCS) | TILES | PADDING
+ *
+ * The sender never copies the SCHC Packet, tiles are written in each fragment
+ * straight from the caller's buffer. The receiver reassembles the SCHC Packet
+ * in a buffer taken from a Reassembly Pool, which bounds the memory every
+ * device can hold.
+ *
+ * In No-ACK mode, the last tile goes with the RCS in the All-1 fragment and
+ * the receiver computes the RCS as the tiles arrive.
+ *
+ * In ACK-on-Error mode, tiles are numbered by window (W) and by position in
+ * their window (FCN, from WINDOW_SIZE - 1 down to 0), and all of them travel
+ * in Regular fragments. The All-1 fragment only carries the RCS. The receiver
+ * answers the All-1 fragment and ACK REQs with a SCHC ACK, either C=1 or the
+ * compressed bitmap of the lowest window missing tiles, and the sender
+ * retransmits those tiles.
+ *
+ * Timers run on a Timer Wheel driven by the caller's clock: the sender's
+ * Retransmission Timer and the receiver's Inactivity Timer are embedded in
+ * their state, so sender and receiver must not move while in use.
+ *
+ * @note Tiles are whole bytes and the L2 Word is a byte, hence the RCS is the
+ * CRC32 of the SCHC Packet byte array.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _FRAGMENTATION_H_
+#define _FRAGMENTATION_H_
+
+#include "fragmentation_descriptor.h"
+#include "utils/timer_wheel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define REASSEMBLY_BUFFER_FREE UINT64_MAX  // Owner of a free reassembly buffer
+#define WINDOW_BITMAP_BYTE_LEN 32          // Bitmap of 255 tiles, a window
+
+/**
+ * @brief Enumeration that defines the outcome of a received SCHC Fragment.
+ */
+typedef enum {
+  REASSEMBLY_ERROR = 0,    // Fragment rejected, the reassembly is aborted
+  REASSEMBLY_IN_PROGRESS,  // Fragment accepted, more are expected
+  REASSEMBLY_COMPLETE      // SCHC Packet reassembled, RCS checked
+} reassembly_status_t;
+
+/**
+ * @brief Enumeration that defines the next step of an ACK-on-Error sender.
+ */
+typedef enum {
+  SENDER_SEND_TILES = 0,  // First transmission of the tiles
+  SENDER_SEND_ALL_1,      // All-1 fragment to send
+  SENDER_WAIT_ACK,        // Waiting for a SCHC ACK
+  SENDER_RESEND_TILES,    // Retransmission of the missing tiles of a window
+  SENDER_SEND_ACK_REQ,    // SCHC ACK REQ to send
+  SENDER_SEND_ABORT,      // Sender-Abort to send
+  SENDER_DONE             // Transfer over
+} sender_step_t;
+
+/**
+ * @brief Struct that defines the header of a SCHC Fragment.
+ */
+typedef struct {
+  uint8_t rule_id;  // Rule ID
+  uint8_t dtag;     // Datagram Tag
+  uint8_t w;        // Window
+  uint8_t fcn;      // Fragment Compressed Number
+  size_t  bit_len;  // Bit length of the header
+} fragment_header_t;
+
+/**
+ * @brief Struct that defines an entry of the Device Table of a Reassembly
+ * Pool.
+ */
+typedef struct {
+  uint64_t device_id;     // Device ID, or REASSEMBLY_BUFFER_FREE if empty
+  size_t   card_buffers;  // Number of buffers the device holds
+} reassembly_device_t;
+
+/**
+ * @brief Struct that defines a Reassembly Pool, a fixed set of reassembly
+ * buffers allocated once from the memory pool.
+ *
+ * @details A device holds at most max_buffers_per_device buffers, so a single
+ * device cannot starve the others. Each buffer comes with a bitmap of the
+ * tiles received, one bit per byte of the buffer so that any tile length fits.
+ *
+ * Free buffers are kept on a stack and the number of buffers of each device in
+ * an open addressing Device Table, so that taking and giving back a buffer are
+ * O(1) whatever the number of buffers.
+ */
+typedef struct {
+  uint8_t             *memory;        // Reassembly buffers
+  uint8_t             *bitmaps;       // Received tiles of each buffer
+  uint64_t            *owners;        // Device ID holding each buffer, or
+                                      // REASSEMBLY_BUFFER_FREE
+  size_t              *free_buffers;  // Indexes of the free buffers, a stack
+  reassembly_device_t *devices;       // Device Table, devices holding buffers
+  size_t buffer_byte_len;         // Byte length of a reassembly buffer
+  size_t card_buffers;            // Number of reassembly buffers
+  size_t card_free_buffers;       // Number of free buffers
+  size_t devices_capacity;        // Number of Device Table entries, a power
+                                  // of 2
+  size_t max_buffers_per_device;  // Buffers a single device can hold
+} reassembly_pool_t;
+
+/**
+ * @brief Struct that defines the state of a SCHC Fragment sender.
+ */
+typedef struct {
+  fragmentation_descriptor_t descriptor;   // Fragmentation Rule
+  const uint8_t             *schc_packet;  // SCHC Packet, tiles are read there
+  size_t                     schc_packet_byte_len;  // Byte length of the packet
+  size_t                     byte_position;  // First byte not sent yet
+  size_t                     card_tiles;     // Number of tiles
+  uint32_t                   rcs;            // Reassembly Check Sequence
+  uint8_t                    dtag;           // Datagram Tag
+  int                        is_complete;    // No-ACK: All-1 fragment sent,
+                                             // ACK-on-Error: C=1 received
+  int                        is_aborted;     // Transfer given up
+  sender_step_t              step;           // ACK-on-Error next step
+  uint8_t                    last_window;    // Window of the last tile
+  uint8_t                    retransmission_window;  // Window being resent
+  uint8_t retransmission_bitmap[WINDOW_BITMAP_BYTE_LEN];  // Tiles to resend
+  uint8_t card_ack_requests;              // ACK REQs without any progress
+  timer_wheel_t *timer_wheel;             // Timer Wheel of the timer
+  uint64_t       retransmission_ticks;    // Retransmission Timer duration
+  wheel_timer_t  retransmission_timer;    // Retransmission Timer
+} fragmentation_sender_t;
+
+/**
+ * @brief Struct that defines the state of a SCHC Fragment receiver.
+ */
+typedef struct {
+  fragmentation_descriptor_t descriptor;       // Fragmentation Rule
+  reassembly_pool_t         *reassembly_pool;  // Pool of reassembly buffers
+  uint64_t                   device_id;        // Device sending the fragments
+  uint8_t                   *buffer;    // Reassembly buffer, NULL when idle
+  uint8_t                   *bitmap;    // Received tiles of the buffer
+  size_t                     byte_len;  // Byte length reassembled
+  uint32_t                   crc;       // No-ACK CRC32 register
+  uint32_t                   rcs;       // ACK-on-Error RCS of the All-1
+  size_t                     card_tiles;  // Tiles up to the last one received
+  size_t                     card_received_tiles;  // Distinct tiles received
+  size_t                     last_tile_byte_len;   // Byte length of the last
+                                                   // tile received
+  uint8_t                    dtag;          // Datagram Tag being reassembled
+  uint8_t                    last_window;   // Highest window known
+  int                        is_all_1_received;  // All-1 fragment received
+  int                        is_complete;        // SCHC Packet reassembled
+  int                        is_ack_pending;     // SCHC ACK to send
+  int                        is_abort_pending;   // Receiver-Abort to send
+  timer_wheel_t             *timer_wheel;        // Timer Wheel of the timer
+  uint64_t                   inactivity_ticks;   // Inactivity Timer duration
+  wheel_timer_t              inactivity_timer;   // Inactivity Timer
+} fragmentation_receiver_t;
+
+/**
+ * @brief Allocates the reassembly buffers of a Reassembly Pool from the memory
+ * pool.
+ *
+ * @details Like any allocation from the memory pool, Reassembly Pools must be
+ * destroyed in the reverse order of their creation.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool to initialize.
+ * @param card_buffers Number of reassembly buffers.
+ * @param buffer_byte_len Byte length of a reassembly buffer, i.e. of the
+ * largest SCHC Packet to reassemble.
+ * @param max_buffers_per_device Number of buffers a single device can hold.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int init_reassembly_pool(reassembly_pool_t *reassembly_pool,
+                         const size_t card_buffers,
+                         const size_t buffer_byte_len,
+                         const size_t max_buffers_per_device);
+
+/**
+ * @brief Gives the reassembly buffers of a Reassembly Pool back to the memory
+ * pool.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool to destroy.
+ */
+void destroy_reassembly_pool(reassembly_pool_t *reassembly_pool);
+
+/**
+ * @brief Takes a reassembly buffer for a device.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool.
+ * @param device_id The device ID, any value but REASSEMBLY_BUFFER_FREE.
+ * @return A pointer to the reassembly buffer, or NULL if the pool is exhausted
+ * or the device already holds max_buffers_per_device buffers.
+ */
+uint8_t *acquire_reassembly_buffer(reassembly_pool_t *reassembly_pool,
+                                   const uint64_t     device_id);
+
+/**
+ * @brief Gives a reassembly buffer back to its Reassembly Pool.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool.
+ * @param buffer Pointer to the buffer obtained with
+ * acquire_reassembly_buffer(...).
+ */
+void release_reassembly_buffer(reassembly_pool_t *reassembly_pool,
+                               uint8_t           *buffer);
+
+/**
+ * @brief Gets the header of a SCHC Fragment.
+ *
+ * @param header Pointer to the Fragment Header to fill.
+ * @param descriptor Pointer to the Fragmentation Rule of the fragment.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @return The status code, 1 for success, 0 if the fragment is too short.
+ */
+int parse_fragment_header(fragment_header_t                *header,
+                          const fragmentation_descriptor_t *descriptor,
+                          const uint8_t                    *fragment,
+                          const size_t                      fragment_byte_len);
+
+/**
+ * @brief Gets the Fragmentation Rule of a SCHC Fragment from its Rule ID.
+ *
+ * @param descriptor Pointer to the Fragmentation Descriptor to fill.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @param context Pointer to the SCHC Context.
+ * @param context_byte_len Byte length of the context.
+ * @return The status code, 1 for success, 0 if the Rule ID does not identify a
+ * Fragmentation Rule.
+ */
+int get_fragment_descriptor(fragmentation_descriptor_t *descriptor,
+                            const uint8_t              *fragment,
+                            const size_t                fragment_byte_len,
+                            const uint8_t              *context,
+                            const size_t                context_byte_len);
+
+/**
+ * @brief Prepares the fragmentation of a SCHC Packet.
+ *
+ * @details The SCHC Packet is not copied and must stay available until the
+ * transfer is over. In ACK-on-Error mode, the SCHC Packet spans at most 2^M
+ * windows.
+ *
+ * @param sender Pointer to the Fragmentation Sender to initialize.
+ * @param descriptor Pointer to the Fragmentation Rule.
+ * @param dtag Datagram Tag of the SCHC Packet, on dtag_len bits.
+ * @param schc_packet Pointer to the SCHC Packet to fragment.
+ * @param schc_packet_byte_len Byte length of the SCHC Packet.
+ * @param timer_wheel Pointer to the Timer Wheel of the Retransmission Timer,
+ * only used in ACK-on-Error mode.
+ * @param retransmission_ticks Retransmission Timer duration in ticks.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int init_fragmentation_sender(fragmentation_sender_t           *sender,
+                              const fragmentation_descriptor_t *descriptor,
+                              const uint8_t                     dtag,
+                              const uint8_t                    *schc_packet,
+                              const size_t   schc_packet_byte_len,
+                              timer_wheel_t *timer_wheel,
+                              const uint64_t retransmission_ticks);
+
+/**
+ * @brief Builds the next SCHC Fragment, SCHC ACK REQ or Sender-Abort.
+ *
+ * @details Each fragment carries as many tiles as fragment_max_byte_len
+ * allows. In No-ACK mode, the last tile goes in the All-1 fragment along with
+ * the RCS. In ACK-on-Error mode, a fragment never spans two windows, and
+ * nothing is built while waiting for a SCHC ACK.
+ *
+ * @param sender Pointer to the Fragmentation Sender.
+ * @param fragment Pointer to the SCHC Fragment to fill.
+ * @param fragment_max_byte_len Maximum byte length of a fragment, i.e. the L2
+ * MTU.
+ * @return The byte length of the fragment, 0 if there is nothing to send yet,
+ * once the transfer is over, or if fragment_max_byte_len cannot carry a tile.
+ */
+size_t get_next_fragment(fragmentation_sender_t *sender, uint8_t *fragment,
+                         const size_t fragment_max_byte_len);
+
+/**
+ * @brief Handles a SCHC ACK, or a Receiver-Abort, in ACK-on-Error mode.
+ *
+ * @details A C=1 SCHC ACK completes the transfer. Otherwise the missing tiles
+ * of the acknowledged window are sent again by get_next_fragment(...).
+ *
+ * @param sender Pointer to the Fragmentation Sender.
+ * @param ack Pointer to the SCHC ACK.
+ * @param ack_byte_len Byte length of the SCHC ACK.
+ * @return The status code, 1 if the SCHC ACK was expected, otherwise 0.
+ */
+int receive_ack(fragmentation_sender_t *sender, const uint8_t *ack,
+                const size_t ack_byte_len);
+
+/**
+ * @brief Stops the Retransmission Timer of a sender, e.g. before dropping it.
+ *
+ * @param sender Pointer to the Fragmentation Sender.
+ */
+void reset_fragmentation_sender(fragmentation_sender_t *sender);
+
+/**
+ * @brief Prepares the reassembly of the SCHC Packets sent by a device.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver to initialize.
+ * @param descriptor Pointer to the Fragmentation Rule.
+ * @param reassembly_pool Pointer to the Reassembly Pool to take buffers from.
+ * @param device_id The device ID.
+ * @param timer_wheel Pointer to the Timer Wheel of the Inactivity Timer, or
+ * NULL for no Inactivity Timer.
+ * @param inactivity_ticks Inactivity Timer duration in ticks.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int init_fragmentation_receiver(fragmentation_receiver_t         *receiver,
+                                const fragmentation_descriptor_t *descriptor,
+                                reassembly_pool_t *reassembly_pool,
+                                const uint64_t     device_id,
+                                timer_wheel_t     *timer_wheel,
+                                const uint64_t     inactivity_ticks);
+
+/**
+ * @brief Adds a SCHC Fragment to the reassembly.
+ *
+ * @details In No-ACK mode, fragments are expected in order. In both modes, a
+ * fragment with a new DTag starts a new SCHC Packet, the one being reassembled
+ * is dropped. Once complete, the SCHC Packet lies in receiver->buffer on
+ * receiver->byte_len bytes until reset_fragmentation_receiver(...).
+ *
+ * In ACK-on-Error mode, a SCHC ACK may be pending afterwards, see
+ * get_next_ack(...). The All-1 fragment and ACK REQs of a SCHC Packet already
+ * complete are answered with C=1 again. A fragment whose window starts beyond
+ * the tiles of a reassembly buffer drops the reassembly.
+ *
+ * When the Inactivity Timer expires, the reassembly is dropped and, in
+ * ACK-on-Error mode, a Receiver-Abort is pending.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @return The reassembly status.
+ */
+reassembly_status_t receive_fragment(fragmentation_receiver_t *receiver,
+                                     const uint8_t            *fragment,
+                                     const size_t fragment_byte_len);
+
+/**
+ * @brief Builds the pending SCHC ACK or Receiver-Abort, in ACK-on-Error mode.
+ *
+ * @details Bitmaps are compressed as in Section 8.3.2.2 of RFC 8724: trailing
+ * 1 bits are left out when the SCHC ACK then ends on a byte boundary.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ * @param ack Pointer to the SCHC ACK to fill.
+ * @param ack_max_byte_len Maximum byte length of the SCHC ACK.
+ * @return The byte length of the SCHC ACK, 0 if none is pending.
+ */
+size_t get_next_ack(fragmentation_receiver_t *receiver, uint8_t *ack,
+                    const size_t ack_max_byte_len);
+
+/**
+ * @brief Drops the SCHC Packet being reassembled, if any, gives its buffer
+ * back to the Reassembly Pool and stops the Inactivity Timer.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ */
+void reset_fragmentation_receiver(fragmentation_receiver_t *receiver);
+
+#endif  // _FRAGMENTATION_H_
\ No newline at end of file
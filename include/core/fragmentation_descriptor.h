@@ -0,0 +1,80 @@
+/**
+ * @file fragmentation_descriptor.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Fragmentation Rule parameters in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details See Section 8.2 in SCHC RFC 8724. A Fragmentation Rule has no Rule
+ * Field Descriptor, its parameters follow the Rule Descriptor header in the
+ * Context byte array:
+ *
+ * @struct
+ * RULE_DESC_ID, NATURE_FRAGMENTATION, 0, MODE, DIR, DTAG_LEN, W_LEN, FCN_LEN,
+ * WINDOW_SIZE, MAX_ACK_REQUESTS, TILE_LEN_1, TILE_LEN_2
+ *
+ * Lengths are in bits, except the tile length which is in bytes.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _FRAGMENTATION_DESCRIPTOR_H_
+#define _FRAGMENTATION_DESCRIPTOR_H_
+
+#include "rule_descriptor.h"
+#include "schc8724.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define FRAGMENTATION_DESCRIPTOR_BYTE_LEN 9   // Bytes after the Rule header
+#define RCS_BIT_LEN                       32  // CRC32 Reassembly Check Sequence
+
+/**
+ * @brief Struct that defines the parameters of a Fragmentation Rule.
+ */
+typedef struct {
+  uint8_t               rule_id;           // Rule ID
+  size_t                rule_id_len;       // Rule ID bit length
+  fragmentation_mode_t  mode;              // Fragmentation Mode
+  direction_indicator_t di;                // Direction of the fragments
+  uint8_t               dtag_len;          // DTag bit length (T)
+  uint8_t               w_len;             // W bit length (M)
+  uint8_t               fcn_len;           // FCN bit length (N)
+  uint8_t               window_size;       // Tiles per window
+  uint8_t               max_ack_requests;  // MAX_ACK_REQUESTS
+  uint16_t              tile_byte_len;     // Tile byte length
+} fragmentation_descriptor_t;
+
+/**
+ * @brief Gets the parameters of a Fragmentation Rule.
+ *
+ * @param fragmentation_descriptor Pointer to the Fragmentation Descriptor to
+ * fill.
+ * @param rule_descriptor Pointer to the Rule Descriptor of the Fragmentation
+ * Rule.
+ * @param context Pointer to the SCHC Context.
+ * @param context_byte_len Byte length of context.
+ * @return The status code, 1 for success, 0 if the Rule is not a valid
+ * Fragmentation Rule.
+ */
+int get_fragmentation_descriptor(
+    fragmentation_descriptor_t *fragmentation_descriptor,
+    const rule_descriptor_t *rule_descriptor, const uint8_t *context,
+    const size_t context_byte_len);
+
+/**
+ * @brief Checks that the parameters of a Fragmentation Rule are consistent.
+ *
+ * @param rule_descriptor_offset Offset of the Rule Descriptor in the context.
+ * @param context Pointer to the SCHC Context.
+ * @param context_byte_len Byte length of context.
+ * @return The validation status code, 1 for success, otherwise 0.
+ */
+int validate_fragmentation_descriptor(const uint16_t rule_descriptor_offset,
+                                      const uint8_t *context,
+                                      const size_t   context_byte_len);
+
+#endif  // _FRAGMENTATION_DESCRIPTOR_H_
\ No newline at end of file
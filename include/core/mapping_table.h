@@ -0,0 +1,115 @@
+/**
+ * @file mapping_table.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Mapping Tables for MO_MATCH_MAPPING and CDA_MAPPING_SENT in
+ * CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Compressing a Field with CDA_MAPPING_SENT finds the index of its
+ * value among the Target Values of the Rule Field Descriptor. A Mapping Table
+ * holds these Target Values sorted by value, so that the index is found by a
+ * binary search instead of comparing the Field with every Target Value.
+ *
+ * A Mapping Table is built for each list of Target Values of a Compiled
+ * Context. The list follows its Rule Field Descriptor, so Rules sharing the
+ * Rule Field Descriptor share the table, found from the list offset. Target
+ * Values that cannot match the Field, see __MO_equal_from_offset(...), are left
+ * out, and equal Target Values give the lowest index, as with
+ * CDA_mapping_sent(...).
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _MAPPING_TABLE_H_
+#define _MAPPING_TABLE_H_
+
+#include "compiled_rules.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Struct that defines an entry of a Mapping Table.
+ */
+typedef struct {
+  uint16_t target_value_offset;  // Offset of the Target Value in the Context
+  uint8_t  index;                // Index of the Target Value in its list
+} mapping_entry_t;
+
+/**
+ * @brief Struct that defines the Mapping Table of a list of Target Values.
+ */
+typedef struct {
+  uint16_t         first_target_value_offset;  // Offset of the list
+  uint16_t         len;                        // Field Length
+  uint8_t          card_target_value;          // Number of Target Values
+  uint8_t          mask;          // Mask of the first byte of the Field
+  uint8_t          card_entries;  // Number of entries
+  mapping_entry_t *entries;       // Entries, sorted by Target Value
+} mapping_table_t;
+
+/**
+ * @brief Struct that defines the Mapping Tables of Compiled Rules.
+ */
+typedef struct {
+  mapping_table_t *tables;       // Tables, sorted by list offset
+  size_t           card_tables;  // Number of tables
+  mapping_entry_t *entries;      // Entries of all tables
+} mapping_tables_t;
+
+/**
+ * @brief Builds the Mapping Tables of the CDA_MAPPING_SENT Rule Field
+ * Descriptors of Compiled Rules.
+ *
+ * @details Only the Fixed-Length Fields with more than one Target Value get a
+ * Mapping Table.
+ *
+ * @param mapping_tables Pointer to the Mapping Tables to initialize.
+ * @param compiled_rules Pointer to the Compiled Rules.
+ * @param context Pointer to the validated SCHC Context of the Compiled Rules.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_mapping_tables(mapping_tables_t       *mapping_tables,
+                        const compiled_rules_t *compiled_rules,
+                        const uint8_t          *context);
+
+/**
+ * @brief Frees the tables and entries of Mapping Tables.
+ *
+ * @param mapping_tables Pointer to the Mapping Tables to destroy.
+ */
+void destroy_mapping_tables(mapping_tables_t *mapping_tables);
+
+/**
+ * @brief Gets the Mapping Table of a Rule Field Descriptor.
+ *
+ * @param mapping_tables Pointer to the Mapping Tables.
+ * @param rule_field_descriptor Pointer to the Rule Field Descriptor.
+ * @return A pointer to the Mapping Table, or NULL if the Rule Field Descriptor
+ * has none.
+ */
+const mapping_table_t *get_mapping_table(
+    const mapping_tables_t        *mapping_tables,
+    const rule_field_descriptor_t *rule_field_descriptor);
+
+/**
+ * @brief Finds the index of a Field value in a Mapping Table.
+ *
+ * @details Same result as CDA_mapping_sent(...) on the Rule Field Descriptor
+ * of the Mapping Table.
+ *
+ * @param mapping_index Pointer to the index to set.
+ * @param field Pointer to the Field, right-aligned on the byte length of the
+ * Field Length.
+ * @param mapping_table Pointer to the Mapping Table.
+ * @param context Pointer to the SCHC Context of the Mapping Table.
+ * @return 1 if the Field value is in the Mapping Table, otherwise 0.
+ */
+int lookup_mapping_table(uint8_t *mapping_index, const uint8_t *field,
+                         const mapping_table_t *mapping_table,
+                         const uint8_t         *context);
+
+#endif  // _MAPPING_TABLE_H_
\ No newline at end of file
@@ -46,6 +46,10 @@ int MO_ignore(void);
  * @brief Checks if the Most Significant Bits of the Field Value correspond to
  * the Target Value defined in the current Rule Field Descriptor.
  *
+ * @details Fields up to 64 bits, or 128 bits where the compiler supports it,
+ * are loaded into an integer, shifted and masked in registers. Longer Fields
+ * are shifted byte by byte.
+ *
  * @param field Pointer to the Field Value.
  * @param rule_field_descriptor Pointer to the corresponding Rule Field
  * Descriptor.
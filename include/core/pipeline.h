@@ -0,0 +1,136 @@
+/**
+ * @file pipeline.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Multi-threaded SCHC compression and decompression pipeline in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A Pipeline runs a number of worker threads that compress or
+ * decompress batches of packets with a Compiled Context. Each worker owns its
+ * memory pool, see memory.h, and pulls batches from a lock-free ring buffer,
+ * see ring_buffer.h, so workers share nothing but the read-only Compiled
+ * Contexts.
+ *
+ * Batches get a sequence number when submitted and are received in that
+ * order, whichever worker finished them first: a worker stores a processed
+ * batch in the slot of its sequence number in a reorder window, and
+ * receive_pipeline_batch(...) only returns the batch following the last one
+ * received. The window is as large as the ring buffer, submitting a batch
+ * fails while that many batches are in flight.
+ *
+ * A single thread submits batches and a single thread receives them, possibly
+ * the same one.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _PIPELINE_H_
+#define _PIPELINE_H_
+
+#include "compiled_context.h"
+#include "flow_cache.h"
+#include "utils/ring_buffer.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PIPELINE_MAX_WORKERS 256
+
+/**
+ * @brief Struct that defines a packet of a batch, and the result of its
+ * compression or decompression.
+ */
+typedef struct {
+  const uint8_t *packet;               // Packet or SCHC Packet to process
+  size_t         packet_byte_len;      // Byte length of the packet
+  uint8_t       *output;               // Buffer of the result
+  size_t         output_max_byte_len;  // Byte length of the output buffer
+  size_t         output_byte_len;      // Byte length of the result, 0 if the
+                                       // packet could not be processed
+} pipeline_packet_t;
+
+/**
+ * @brief Struct that defines a batch of packets processed by a worker.
+ */
+typedef struct {
+  uint64_t                  sequence;          // Set when submitted
+  const compiled_context_t *compiled_context;  // Context of the packets
+  direction_indicator_t     direction;         // DI_UP or DI_DW
+  int                       decompression;     // 1 to decompress the packets
+  pipeline_packet_t        *packets;           // Packets of the batch
+  size_t                    card_packets;      // Number of packets
+} pipeline_batch_t;
+
+/**
+ * @brief Struct that defines a Pipeline.
+ */
+typedef struct {
+  pthread_t     workers[PIPELINE_MAX_WORKERS];  // Worker threads
+  size_t        card_workers;                   // Number of workers
+  ring_buffer_t pending_batches;  // Batches submitted, not yet processed
+  _Atomic(pipeline_batch_t *) *processed_batches;  // Reorder window, by
+                                                   // sequence number
+  _Atomic int stop;  // Set to end the workers
+  _Alignas(64) _Atomic uint64_t card_submitted;  // Next sequence number
+  _Alignas(64) _Atomic uint64_t card_received;   // Sequence number awaited
+} pipeline_t;
+
+/**
+ * @brief Starts a Pipeline.
+ *
+ * @param card_workers Number of worker threads, from 1 to
+ * PIPELINE_MAX_WORKERS.
+ * @param max_batches_in_flight Maximum number of batches submitted and not yet
+ * received, rounded up to a power of 2.
+ * @return A pointer to the Pipeline, NULL if the threads or memory are
+ * exhausted.
+ */
+pipeline_t *create_pipeline(const size_t card_workers,
+                            const size_t max_batches_in_flight);
+
+/**
+ * @brief Stops the workers of a Pipeline and frees it.
+ *
+ * @details The batches submitted and not yet processed are dropped.
+ *
+ * @param pipeline Pointer to the Pipeline to destroy.
+ */
+void destroy_pipeline(pipeline_t *pipeline);
+
+/**
+ * @brief Submits a batch to the workers of a Pipeline.
+ *
+ * @details The batch, its packets and their buffers must stay valid until the
+ * batch is received.
+ *
+ * @param pipeline Pointer to the Pipeline.
+ * @param batch Pointer to the batch, whose sequence number is set.
+ * @return 1 if the batch was submitted, otherwise 0 if too many batches are
+ * in flight.
+ */
+int submit_pipeline_batch(pipeline_t *pipeline, pipeline_batch_t *batch);
+
+/**
+ * @brief Receives the next processed batch of a Pipeline, in submission
+ * order.
+ *
+ * @param pipeline Pointer to the Pipeline.
+ * @return A pointer to the batch, or NULL if it is not processed yet.
+ */
+pipeline_batch_t *receive_pipeline_batch(pipeline_t *pipeline);
+
+/**
+ * @brief Compresses or decompresses the packets of a batch in the calling
+ * thread, as a worker does.
+ *
+ * @param batch Pointer to the batch.
+ * @param flow_cache Pointer to the Flow Cache of the calling thread, see
+ * compress_compiled_cached(...), or NULL to compress without.
+ */
+void process_pipeline_batch(pipeline_batch_t *batch, flow_cache_t *flow_cache);
+
+#endif  // _PIPELINE_H_
\ No newline at end of file
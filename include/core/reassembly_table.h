@@ -0,0 +1,172 @@
+/**
+ * @file reassembly_table.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Reassembly Table implementation in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details The Reassembly Table keeps a reassembly session per SCHC Packet
+ * being received, keyed by (device ID, Rule ID, DTag), for gateways serving
+ * many devices at once.
+ *
+ * All its memory is taken once from the memory pool, within a byte budget:
+ * the sessions, an open addressing index with linear probing, and a
+ * Reassembly Pool holding a buffer per session. Receiving fragments never
+ * allocates, whatever the uplink load.
+ *
+ * Sessions are kept in least recently used order. Opening a session while the
+ * table is full evicts the least recently used one, and a session without any
+ * fragment for inactivity_ticks expires on the Timer Wheel.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _REASSEMBLY_TABLE_H_
+#define _REASSEMBLY_TABLE_H_
+
+#include "fragmentation.h"
+#include "utils/timer_wheel.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define REASSEMBLY_SESSION_NONE UINT32_MAX  // No session
+#define REASSEMBLY_INDEX_EMPTY  0           // Index entry without a session
+
+/**
+ * @brief Struct that defines a reassembly session, the reception of a SCHC
+ * Packet from a device.
+ */
+typedef struct reassembly_session_s {
+  uint64_t device_id;  // Device sending the SCHC Packet
+  uint8_t  rule_id;    // Rule ID of the Fragmentation Rule
+  uint8_t  dtag;       // Datagram Tag of the SCHC Packet
+  uint32_t previous;   // Less recently used session
+  uint32_t next;       // More recently used session, or next free session
+  struct reassembly_table_s *table;             // Table holding the session
+  wheel_timer_t              inactivity_timer;  // Inactivity Timer
+  fragmentation_receiver_t   receiver;          // Receiver of the SCHC Packet
+} reassembly_session_t;
+
+/**
+ * @brief Struct that defines a Reassembly Table.
+ */
+typedef struct reassembly_table_s {
+  reassembly_session_t *sessions;  // Sessions, from the pool
+  uint32_t *index;           // Session index + 1, or REASSEMBLY_INDEX_EMPTY
+  size_t    index_capacity;  // Number of index entries, a power of 2
+  size_t    max_sessions;    // Number of sessions
+  size_t    card_sessions;   // Number of open sessions
+  uint32_t  least_recent;    // Least recently used session, evicted first
+  uint32_t  most_recent;     // Most recently used session
+  uint32_t  first_free;      // First free session
+  size_t    card_evictions;  // Sessions evicted so far
+  reassembly_pool_t reassembly_pool;   // A reassembly buffer per session
+  timer_wheel_t    *timer_wheel;       // Timer Wheel of the Inactivity Timers
+  uint64_t          inactivity_ticks;  // Inactivity Timer duration
+} reassembly_table_t;
+
+/**
+ * @brief Allocates a Reassembly Table from the memory pool.
+ *
+ * @details The number of sessions is the largest that fits in max_byte_len
+ * bytes, see get_reassembly_session_byte_len(...). Like any allocation from
+ * the memory pool, Reassembly Tables must be destroyed in the reverse order of
+ * their creation.
+ *
+ * @param table Pointer to the Reassembly Table to initialize.
+ * @param max_byte_len Memory budget of the table in bytes.
+ * @param buffer_byte_len Byte length of a reassembly buffer, i.e. of the
+ * largest SCHC Packet to reassemble.
+ * @param timer_wheel Pointer to the Timer Wheel of the Inactivity Timers.
+ * @param inactivity_ticks Inactivity Timer duration in ticks.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int init_reassembly_table(reassembly_table_t *table, const size_t max_byte_len,
+                          const size_t   buffer_byte_len,
+                          timer_wheel_t *timer_wheel,
+                          const uint64_t inactivity_ticks);
+
+/**
+ * @brief Closes every session of a Reassembly Table and gives its memory back
+ * to the memory pool.
+ *
+ * @param table Pointer to the Reassembly Table to destroy.
+ */
+void destroy_reassembly_table(reassembly_table_t *table);
+
+/**
+ * @brief Gets the memory a session takes in a Reassembly Table.
+ *
+ * @param buffer_byte_len Byte length of a reassembly buffer.
+ * @return The byte length of a session, index and reassembly buffer included.
+ */
+size_t get_reassembly_session_byte_len(const size_t buffer_byte_len);
+
+/**
+ * @brief Looks up the session of a SCHC Packet.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param device_id The device ID.
+ * @param rule_id Rule ID of the Fragmentation Rule.
+ * @param dtag Datagram Tag of the SCHC Packet.
+ * @return A pointer to the session, or NULL if none is open.
+ */
+reassembly_session_t *find_reassembly_session(const reassembly_table_t *table,
+                                              const uint64_t device_id,
+                                              const uint8_t  rule_id,
+                                              const uint8_t  dtag);
+
+/**
+ * @brief Gets the session of a SCHC Fragment, opening it if needed.
+ *
+ * @details The session becomes the most recently used one. If the table is
+ * full, the least recently used session is closed to open a new one.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param descriptor Pointer to the Fragmentation Rule of the fragment.
+ * @param device_id The device ID, any value but REASSEMBLY_BUFFER_FREE.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @return A pointer to the session, or NULL if the fragment header is invalid.
+ */
+reassembly_session_t *get_reassembly_session(
+    reassembly_table_t *table, const fragmentation_descriptor_t *descriptor,
+    const uint64_t device_id, const uint8_t *fragment,
+    const size_t fragment_byte_len);
+
+/**
+ * @brief Adds a SCHC Fragment to the reassembly of its session.
+ *
+ * @details Every fragment restarts the Inactivity Timer of its session. A
+ * session is closed on REASSEMBLY_ERROR. On REASSEMBLY_COMPLETE, the SCHC
+ * Packet lies in (*session)->receiver.buffer: once it is processed, the caller
+ * either closes the session, or resets its receiver so that, in ACK-on-Error
+ * mode, the SCHC Packet is acknowledged again until the session expires.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param descriptor Pointer to the Fragmentation Rule of the fragment.
+ * @param device_id The device ID, any value but REASSEMBLY_BUFFER_FREE.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @param session Pointer to the session of the fragment to set, NULL if it was
+ * closed.
+ * @return The reassembly status.
+ */
+reassembly_status_t receive_session_fragment(
+    reassembly_table_t *table, const fragmentation_descriptor_t *descriptor,
+    const uint64_t device_id, const uint8_t *fragment,
+    const size_t fragment_byte_len, reassembly_session_t **session);
+
+/**
+ * @brief Closes a session and gives its reassembly buffer back.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param session Pointer to the session to close.
+ */
+void close_reassembly_session(reassembly_table_t   *table,
+                              reassembly_session_t *session);
+
+#endif  // _REASSEMBLY_TABLE_H_
\ No newline at end of file
@@ -30,6 +30,8 @@ typedef struct {
   uint8_t  id;      // ID
   nature_t nature;  // Compression Nature
   uint8_t  card_rule_field_descriptor;  // Number of Rule Field Descriptor
+  const struct compiled_rule_s *compiled_rule;  // Compiled Rule, or NULL when
+                                                // read from the Context
 } rule_descriptor_t;
 
 /**
@@ -45,4 +47,18 @@ int get_rule_descriptor(rule_descriptor_t *rule_descriptor,
                         const unsigned int index, const uint8_t *context,
                         const size_t context_byte_len);
 
+/**
+ * @brief Gets a Rule Descriptor thanks to an index, without any bounds check.
+ *
+ * @details Only meant for Contexts that went through context_validate(...),
+ * and for an index lower than the number of Rule Descriptors.
+ *
+ * @param rule_descriptor Pointer to the Rule Descriptor to fill.
+ * @param index Index of the Rule Descriptor to get in context.
+ * @param context Pointer to the validated SCHC Context.
+ */
+void get_rule_descriptor_unchecked(rule_descriptor_t *rule_descriptor,
+                                   const unsigned int index,
+                                   const uint8_t     *context);
+
 #endif  // _RULE_DESCRIPTOR_H_
\ No newline at end of file
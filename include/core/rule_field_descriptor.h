@@ -63,6 +63,10 @@ void unpack_di_mo_cda(direction_indicator_t *di, matching_operator_t *mo,
  * @brief Gets a Rule Field Descriptor using an index and the offset of the
  * associated Rule Descriptor.
  *
+ * @details The bytes of the Rule Field Descriptor and its single Target Value
+ * are checked in constant time. The Target Values of a mapping are not, a
+ * Context from an untrusted source goes through context_validate(...) first.
+ *
  * @param rule_field_descriptor Pointer to the Rule Field Descriptor to fill.
  * @param index Index of the Rule Field Descriptor to get in the Rule
  * Descriptor.
@@ -77,4 +81,40 @@ int get_rule_field_descriptor(rule_field_descriptor_t *rule_field_descriptor,
                               const uint8_t           *context,
                               const size_t             context_byte_len);
 
+/**
+ * @brief Gets a Rule Field Descriptor using an index and the offset of the
+ * associated Rule Descriptor, without any bounds check.
+ *
+ * @details Only meant for Contexts that went through context_validate(...),
+ * and for an index lower than the number of Rule Field Descriptors.
+ *
+ * @param rule_field_descriptor Pointer to the Rule Field Descriptor to fill.
+ * @param index Index of the Rule Field Descriptor to get in the Rule
+ * Descriptor.
+ * @param rule_descriptor_offset Offset of the corresponding Rule Descriptor.
+ * @param context Pointer to the validated SCHC Context.
+ */
+void get_rule_field_descriptor_unchecked(
+    rule_field_descriptor_t *rule_field_descriptor, const unsigned int index,
+    const uint16_t rule_descriptor_offset, const uint8_t *context);
+
+/**
+ * @brief Checks that a Rule Field Descriptor and its Target Values are
+ * consistent.
+ *
+ * @details Every byte of the Rule Field Descriptor must be in the Context, its
+ * cardinality must fit its Matching Operator and Compression Decompression
+ * Action, and every Target Value must be long enough to be compared with or
+ * copied into the Field it describes.
+ *
+ * @param rule_field_descriptor_offset Offset of the Rule Field Descriptor in
+ * the context.
+ * @param context Pointer to the SCHC Context.
+ * @param context_byte_len Byte length of the context.
+ * @return The validation status code, 1 for success, otherwise 0.
+ */
+int validate_rule_field_descriptor(const uint16_t rule_field_descriptor_offset,
+                                   const uint8_t *context,
+                                   const size_t   context_byte_len);
+
 #endif  // _RULE_FIELD_DESCRIPTOR_H_
\ No newline at end of file
@@ -0,0 +1,138 @@
+/**
+ * @file rule_matcher.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC multi-Rule matcher for MO_EQUAL fields in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Rules often differ by a few Fields compressed with MO_EQUAL and
+ * CDA_NOT_SENT, such as addresses, ports or the CoAP Code. The Rule Matcher
+ * groups these Fields by position in the packet into columns, each column
+ * holding the Target Value of every Rule. A packet Field is then compared with
+ * all the Target Values of its column at once, with AVX2 or SSE4.1 compares
+ * when the CPU supports them, and the result is a bitmask of candidate Rules.
+ *
+ * Only the Fields found at a fixed bit position are in a column: those before
+ * the first Variable-Length Field or whole CoAP Option of their Rule. Fields
+ * longer than 64 bits are split into 64-bit columns, up to 128 bits. A Rule
+ * left out of the bitmask cannot compress the packet, the candidate Rules
+ * still go through the Rule-by-Rule compression.
+ *
+ * The columns also tell which earlier Rules may shadow a Rule: two Rules with
+ * different Target Values in a column never compress the same packet, so only
+ * the earlier Rules sharing no such column with a Rule may compress a packet
+ * before it. A Rule with no such earlier candidate can be tried first, see
+ * compress_compiled_cached(...).
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _RULE_MATCHER_H_
+#define _RULE_MATCHER_H_
+
+#include "compiled_rules.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define RULE_MATCHER_MAX_RULES  256  // A Rule Descriptor count fits on 8 bits
+#define RULE_MATCHER_MASK_WORDS (RULE_MATCHER_MAX_RULES / 64)
+
+/**
+ * @brief Enumeration that defines the instruction sets of the Rule Matcher.
+ */
+typedef enum {
+  RULE_MATCHER_SCALAR = 0,
+  RULE_MATCHER_SSE4,
+  RULE_MATCHER_AVX2
+} rule_matcher_isa_t;
+
+/**
+ * @brief Struct that defines a column of the Rule Matcher, the Target Values
+ * of the Rules for the bits at a given position of the packet.
+ */
+typedef struct {
+  size_t    bit_position;   // Bit position of the column in the packet
+  size_t    bit_len;        // Bit length of the column, from 1 to 64
+  uint64_t *target_values;  // Target Value of each Rule, 0 if unused
+  uint64_t  rules[RULE_MATCHER_MASK_WORDS];  // Rules comparing the column
+} rule_matcher_column_t;
+
+/**
+ * @brief Struct that defines a Rule Matcher for a Packet Direction.
+ */
+typedef struct {
+  rule_matcher_column_t *columns;        // Columns, by order of appearance
+  size_t                 card_columns;   // Number of columns
+  size_t                 card_rules;     // Number of Rules
+  size_t                 stride;         // Target Values per column, padded
+  uint64_t              *target_values;  // Target Values of all columns
+  uint64_t *shadowing_rules;  // Earlier Rules that may compress the packets of
+                              // each Rule, RULE_MATCHER_MASK_WORDS per Rule
+  rule_matcher_isa_t isa;     // Instruction set of the compares
+} rule_matcher_t;
+
+/**
+ * @brief Builds the Rule Matcher of Compiled Rules for a Packet Direction.
+ *
+ * @details The instruction set is the best one supported by the CPU, see
+ * get_rule_matcher_isa(...).
+ *
+ * @param rule_matcher Pointer to the Rule Matcher to initialize.
+ * @param compiled_rules Pointer to the Compiled Rules.
+ * @param context Pointer to the validated SCHC Context of the Compiled Rules.
+ * @param packet_direction Packet Direction Indicator, DI_UP or DI_DW.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_rule_matcher(rule_matcher_t              *rule_matcher,
+                      const compiled_rules_t      *compiled_rules,
+                      const uint8_t               *context,
+                      const direction_indicator_t  packet_direction);
+
+/**
+ * @brief Frees the columns of a Rule Matcher.
+ *
+ * @param rule_matcher Pointer to the Rule Matcher to destroy.
+ */
+void destroy_rule_matcher(rule_matcher_t *rule_matcher);
+
+/**
+ * @brief Gets the best instruction set of the Rule Matcher the CPU supports.
+ *
+ * @return The instruction set, RULE_MATCHER_SCALAR outside of x86.
+ */
+rule_matcher_isa_t get_rule_matcher_isa(void);
+
+/**
+ * @brief Finds the Rules that may compress a packet.
+ *
+ * @param candidate_rules Bitmask to fill, bit i % 64 of word i / 64 being set
+ * if the Rule i is a candidate.
+ * @param rule_matcher Pointer to the Rule Matcher.
+ * @param packet Pointer to the packet.
+ * @param packet_byte_len Byte length of the packet.
+ */
+void match_rules(uint64_t              candidate_rules[RULE_MATCHER_MASK_WORDS],
+                 const rule_matcher_t *rule_matcher, const uint8_t *packet,
+                 const size_t packet_byte_len);
+
+/**
+ * @brief Checks whether an earlier candidate Rule may compress the packets a
+ * Rule compresses.
+ *
+ * @details Fragmentation Rules never compress a packet, the no-compression
+ * Rule compresses them all.
+ *
+ * @param rule_matcher Pointer to the Rule Matcher.
+ * @param candidate_rules Bitmask of the candidate Rules, see match_rules(...).
+ * @param index Index of the Rule.
+ * @return 1 if one of the candidate Rules before the Rule may compress the
+ * same packet, otherwise 0.
+ */
+int is_rule_shadowed(const rule_matcher_t *rule_matcher,
+                     const uint64_t candidate_rules[RULE_MATCHER_MASK_WORDS],
+                     const size_t   index);
+
+#endif  // _RULE_MATCHER_H_
\ No newline at end of file
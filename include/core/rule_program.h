@@ -0,0 +1,185 @@
+/**
+ * @file rule_program.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC Rule Programs, Rules compiled into bit operations in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A Rule Program is the list of bit operations that compresses, or
+ * decompresses, a packet with a Rule in a Packet Direction: compare N bits of
+ * the packet with a constant under a mask, send N bits, skip N bits, send the
+ * index of a Target Value, and so on. The Rule Field Descriptors are decoded
+ * once when the Programs are built, so running a Program reads neither the
+ * Context Rule Field Descriptors nor dispatches on their SID, MO or CDA: it
+ * runs its instructions one after the other, threaded with computed gotos on
+ * GCC and Clang, with a switch otherwise.
+ *
+ * Programs are only built for the Compression Rules whose Fields all have a
+ * Fixed Length and are not whole CoAP Options, in which case the bit positions
+ * in the packet and the SCHC Packet are known in advance. Decompression
+ * Programs also leave out the Rules with CDA_LSB or CDA_COMPUTE. The other
+ * Rules, and the no-compression Rule, have no Program and go through the
+ * Rule-by-Rule (de)compression. A Program gives the same result as the latter.
+ *
+ * As the Fields of a decompression Program are at fixed positions, the bits of
+ * the CDA_NOT_SENT Fields are the same in every packet. They are laid out once
+ * in a header template, copied at the start of the packet, and the Program
+ * then only fills the holes left for the Field Residues and Mapping Sent
+ * Fields.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _RULE_PROGRAM_H_
+#define _RULE_PROGRAM_H_
+
+#include "compiled_rules.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Enumeration that defines the operations of a Rule Program.
+ */
+typedef enum {
+  OPCODE_END = 0,       // End of the Program, the payload follows
+  OPCODE_FAIL,          // The Rule cannot compress any packet
+  OPCODE_MATCH,         // Compare up to 64 packet bits with a constant
+  OPCODE_SEND,          // Copy packet bits to the SCHC Packet
+  OPCODE_SKIP,          // Skip packet bits, or header template bits
+  OPCODE_MAP,           // Send the index of the Target Value of the bits
+  OPCODE_RECEIVE,       // Copy SCHC Packet bits to the packet
+  OPCODE_UNMAP,         // Add the Target Value of the index sent
+  CARD_OPCODES
+} rule_opcode_t;
+
+/**
+ * @brief Struct that defines an instruction of a Rule Program.
+ *
+ * @details The operand of OPCODE_MATCH is the index of the mask and value in
+ * the constants, the one of OPCODE_MAP the index of the mask followed by the
+ * sorted (Target Value, index) pairs. The operand of OPCODE_UNMAP is the first
+ * Target Value offset in the Context.
+ */
+typedef struct {
+  uint8_t  opcode;  // Operation, see rule_opcode_t
+  uint8_t  card;    // Number of pairs for OPCODE_MAP, of Target Values for
+                    // OPCODE_UNMAP
+  uint16_t len;     // Bit length of the operation
+  uint32_t operand;
+} rule_instruction_t;
+
+/**
+ * @brief Struct that defines the Program of a Rule in a Packet Direction.
+ */
+typedef struct {
+  const rule_instruction_t *instructions;  // Instructions, NULL without
+                                           // Program
+  const uint8_t *header_template;  // Bits of the Fields known in advance,
+                                   // decompression only
+  size_t packet_bit_len;  // Bit length of the Fields in the packet
+  size_t residue_len;     // Bit length of the Field Residues
+} rule_program_t;
+
+/**
+ * @brief Struct that defines the Rule Programs of Compiled Rules.
+ */
+typedef struct {
+  rule_program_t     *programs;  // Compression then decompression Programs,
+                                 // DI_UP then DI_DW, in Rule order
+  size_t              card_rules;    // Number of Rules
+  rule_instruction_t *instructions;  // Instructions of all Programs
+  uint64_t           *constants;     // Constants of all Programs
+  uint8_t            *header_templates;  // Header templates of all Programs
+} rule_programs_t;
+
+/**
+ * @brief Builds the compression and decompression Programs of Compiled Rules
+ * for DI_UP and DI_DW.
+ *
+ * @param rule_programs Pointer to the Rule Programs to initialize.
+ * @param compiled_rules Pointer to the Compiled Rules.
+ * @param context Pointer to the validated SCHC Context of the Compiled Rules.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_rule_programs(rule_programs_t        *rule_programs,
+                       const compiled_rules_t *compiled_rules,
+                       const uint8_t          *context);
+
+/**
+ * @brief Frees the Programs, instructions, constants and header templates of
+ * Rule Programs.
+ *
+ * @param rule_programs Pointer to the Rule Programs to destroy.
+ */
+void destroy_rule_programs(rule_programs_t *rule_programs);
+
+/**
+ * @brief Gets the compression or decompression Program of a Rule.
+ *
+ * @param rule_programs Pointer to the Rule Programs.
+ * @param index Index of the Rule.
+ * @param direction Packet Direction Indicator, DI_UP or DI_DW.
+ * @param decompression 1 for the decompression Program, 0 for the compression
+ * one.
+ * @return A pointer to the Program, or NULL if the Rule has none.
+ */
+const rule_program_t *get_rule_program(const rule_programs_t      *rule_programs,
+                                       const unsigned int          index,
+                                       const direction_indicator_t direction,
+                                       const int decompression);
+
+/**
+ * @brief Compresses a packet with a compression Program, after the Rule ID.
+ *
+ * @details Same as the Rule-by-Rule compression of the Rule of the Program.
+ * The bits from bit_position on are overwritten, whatever a previous Rule
+ * left there.
+ *
+ * @param schc_packet Pointer to the SCHC Packet to fill.
+ * @param schc_packet_max_byte_len Maximum byte length of the schc_packet.
+ * @param bit_position Pointer to the bit position in the SCHC Packet, after
+ * the Rule ID, moved to its end.
+ * @param packet Pointer to the Packet to compress.
+ * @param packet_byte_len Byte length of the packet.
+ * @param rule_program Pointer to the compression Program.
+ * @param rule_programs Pointer to the Rule Programs of the Program.
+ * @return The compression status code, 1 for success, otherwise 0.
+ */
+int run_compression_program(uint8_t     *schc_packet,
+                            const size_t schc_packet_max_byte_len,
+                            size_t *bit_position, const uint8_t *packet,
+                            const size_t           packet_byte_len,
+                            const rule_program_t  *rule_program,
+                            const rule_programs_t *rule_programs);
+
+/**
+ * @brief Decompresses a SCHC Packet with a decompression Program, after the
+ * Rule ID.
+ *
+ * @details Same as the Rule-by-Rule decompression of the Rule of the Program,
+ * the packet being zeroed beforehand.
+ *
+ * @param packet Pointer to the Packet to fill, zeroed.
+ * @param packet_max_byte_len Maximum byte length of the packet.
+ * @param packet_bit_position Pointer to the bit position in the packet, moved
+ * to its end.
+ * @param schc_packet_bit_position Bit position in the SCHC Packet, after the
+ * Rule ID.
+ * @param schc_packet Pointer to the SCHC Packet to decompress.
+ * @param schc_packet_byte_len Byte length of the schc_packet.
+ * @param rule_program Pointer to the decompression Program.
+ * @param context Pointer to the SCHC Context of the Program.
+ * @return The decompression status code, 1 for success, otherwise 0.
+ */
+int run_decompression_program(uint8_t *packet, const size_t packet_max_byte_len,
+                              size_t        *packet_bit_position,
+                              const size_t   schc_packet_bit_position,
+                              const uint8_t *schc_packet,
+                              const size_t   schc_packet_byte_len,
+                              const rule_program_t *rule_program,
+                              const uint8_t        *context);
+
+#endif  // _RULE_PROGRAM_H_
\ No newline at end of file
@@ -21,7 +21,7 @@
 typedef enum {
   NATURE_COMPRESSION = 0,
   NATURE_NO_COMPRESSION,
-  NATURE_FRAGMENTATION  // Not implemented
+  NATURE_FRAGMENTATION
 } nature_t;
 
 /**
@@ -57,4 +57,15 @@ typedef enum {
   CDA_COMPUTE
 } compression_decompression_action_t;
 
+/**
+ * @brief Enumeration that defines SCHC RFC 8724 Fragmentation Modes.
+ *
+ * @details See Section 8.4 in SCHC RFC 8724.
+ */
+typedef enum {
+  FRAGMENTATION_NO_ACK = 0,
+  FRAGMENTATION_ACK_ALWAYS,  // Not implemented
+  FRAGMENTATION_ACK_ON_ERROR
+} fragmentation_mode_t;
+
 #endif  // _RFC_SCHC_8724_H_
\ No newline at end of file
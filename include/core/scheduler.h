@@ -0,0 +1,124 @@
+/**
+ * @file scheduler.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Work-stealing SCHC compression and decompression scheduler in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A Scheduler runs worker threads that compress or decompress
+ * batches of packets, see pipeline.h, tagged with their Compiled Context and
+ * Direction Indicator. Unlike the Pipeline, it keeps no order between batches
+ * but balances uneven ones, e.g. uplink decompression interleaved with
+ * downlink compression of packets of 20 bytes to 1.5 KB.
+ *
+ * A batch is submitted to the inbox, a lock-free ring buffer, of the worker
+ * its Compiled Context and Direction Indicator hash to, so that batches of
+ * the same Rules go to the same caches. Each worker moves its inbox to its
+ * Work Deque, see work_deque.h, and processes it last in first out. An idle
+ * worker steals the oldest batch of another worker, from its Work Deque or
+ * from its inbox, picked at random.
+ *
+ * Each worker owns its memory pool, see memory.h, and a Flow Cache, see
+ * flow_cache.h, with which it compresses the packets.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _SCHEDULER_H_
+#define _SCHEDULER_H_
+
+#include "flow_cache.h"
+#include "pipeline.h"
+#include "utils/ring_buffer.h"
+#include "utils/work_deque.h"
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SCHEDULER_FLOW_CACHE_ENTRIES 1024  // Flow Cache entries per worker
+
+/**
+ * @brief Function called by a worker once a batch is processed.
+ */
+typedef void (*scheduler_callback_t)(pipeline_batch_t *batch,
+                                     void             *user_data);
+
+struct scheduler_s;
+
+/**
+ * @brief Struct that defines a worker of a Scheduler.
+ */
+typedef struct {
+  work_deque_t        work_deque;        // Batches of the worker
+  ring_buffer_t       inbox;             // Batches submitted to the worker
+  flow_cache_t        flow_cache;        // Flow Cache of the compression
+  pthread_t           thread;            // Worker thread
+  uint32_t            random_state;      // Choice of the victims
+  struct scheduler_s *scheduler;         // Scheduler of the worker
+  _Atomic uint64_t    card_processed;    // Batches processed
+  _Atomic uint64_t    card_stolen;       // Batches stolen from others
+} scheduler_worker_t;
+
+/**
+ * @brief Struct that defines a Scheduler.
+ */
+typedef struct scheduler_s {
+  scheduler_worker_t  *workers;       // Workers
+  size_t               card_workers;  // Number of workers
+  scheduler_callback_t callback;      // Called once a batch is processed
+  void                *user_data;     // Argument of the callback
+  _Atomic int          stop;          // Set to end the workers
+  _Alignas(64) _Atomic uint64_t card_submitted;  // Batches submitted
+  _Alignas(64) _Atomic uint64_t card_completed;  // Batches processed
+} scheduler_t;
+
+/**
+ * @brief Starts a Scheduler.
+ *
+ * @param card_workers Number of worker threads, from 1 to
+ * PIPELINE_MAX_WORKERS.
+ * @param inbox_capacity Batches each worker may be submitted before it takes
+ * them, rounded up to a power of 2.
+ * @param callback Function called by a worker once a batch is processed, or
+ * NULL.
+ * @param user_data Argument of the callback.
+ * @return A pointer to the Scheduler, NULL if the threads or memory are
+ * exhausted.
+ */
+scheduler_t *create_scheduler(const size_t         card_workers,
+                              const size_t         inbox_capacity,
+                              scheduler_callback_t callback, void *user_data);
+
+/**
+ * @brief Stops the workers of a Scheduler and frees it.
+ *
+ * @details The batches submitted and not yet processed are dropped.
+ *
+ * @param scheduler Pointer to the Scheduler to destroy.
+ */
+void destroy_scheduler(scheduler_t *scheduler);
+
+/**
+ * @brief Submits a batch to the workers of a Scheduler, from any thread.
+ *
+ * @details The batch, its packets and their buffers must stay valid until it
+ * is processed.
+ *
+ * @param scheduler Pointer to the Scheduler.
+ * @param batch Pointer to the batch.
+ * @return 1 if the batch was submitted, otherwise 0 if every inbox is full.
+ */
+int submit_scheduler_batch(scheduler_t *scheduler, pipeline_batch_t *batch);
+
+/**
+ * @brief Waits until every batch submitted to a Scheduler is processed.
+ *
+ * @param scheduler Pointer to the Scheduler.
+ */
+void wait_scheduler(scheduler_t *scheduler);
+
+#endif  // _SCHEDULER_H_
\ No newline at end of file
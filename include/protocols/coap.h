@@ -53,6 +53,86 @@
 #define SID_COAP_OPTION_VALUE 5140
 #define SID_COAP_PAYLOAD_MARKER 5141
 
+// Defined for this library (Not in current SCHC Yang Model). Each SID stands
+// for a whole CoAP Option of a given Option Number: its Option Delta and
+// Option Length are deduced from the Option Numbers and the Option Value.
+#define SID_COAP_OPTION_IF_MATCH 5142
+#define SID_COAP_OPTION_URI_HOST 5143
+#define SID_COAP_OPTION_ETAG 5144
+#define SID_COAP_OPTION_IF_NONE_MATCH 5145
+#define SID_COAP_OPTION_OBSERVE 5146
+#define SID_COAP_OPTION_URI_PORT 5147
+#define SID_COAP_OPTION_LOCATION_PATH 5148
+#define SID_COAP_OPTION_URI_PATH 5149
+#define SID_COAP_OPTION_CONTENT_FORMAT 5150
+#define SID_COAP_OPTION_MAX_AGE 5151
+#define SID_COAP_OPTION_URI_QUERY 5152
+#define SID_COAP_OPTION_ACCEPT 5153
+#define SID_COAP_OPTION_LOCATION_QUERY 5154
+#define SID_COAP_OPTION_BLOCK2 5155
+#define SID_COAP_OPTION_BLOCK1 5156
+#define SID_COAP_OPTION_SIZE2 5157
+#define SID_COAP_OPTION_PROXY_URI 5158
+#define SID_COAP_OPTION_PROXY_SCHEME 5159
+#define SID_COAP_OPTION_SIZE1 5160
+#define SID_COAP_OPTION_NO_RESPONSE 5161
+
+/**
+ * @brief CoAP Option Numbers.
+ *
+ * @details See Section 12.2 of CoAP RFC 7252, RFC 7641, RFC 7959 and RFC 7967.
+ */
+#define COAP_OPTION_NUMBER_IF_MATCH 1
+#define COAP_OPTION_NUMBER_URI_HOST 3
+#define COAP_OPTION_NUMBER_ETAG 4
+#define COAP_OPTION_NUMBER_IF_NONE_MATCH 5
+#define COAP_OPTION_NUMBER_OBSERVE 6
+#define COAP_OPTION_NUMBER_URI_PORT 7
+#define COAP_OPTION_NUMBER_LOCATION_PATH 8
+#define COAP_OPTION_NUMBER_URI_PATH 11
+#define COAP_OPTION_NUMBER_CONTENT_FORMAT 12
+#define COAP_OPTION_NUMBER_MAX_AGE 14
+#define COAP_OPTION_NUMBER_URI_QUERY 15
+#define COAP_OPTION_NUMBER_ACCEPT 17
+#define COAP_OPTION_NUMBER_LOCATION_QUERY 20
+#define COAP_OPTION_NUMBER_BLOCK2 23
+#define COAP_OPTION_NUMBER_BLOCK1 27
+#define COAP_OPTION_NUMBER_SIZE2 28
+#define COAP_OPTION_NUMBER_PROXY_URI 35
+#define COAP_OPTION_NUMBER_PROXY_SCHEME 39
+#define COAP_OPTION_NUMBER_SIZE1 60
+#define COAP_OPTION_NUMBER_NO_RESPONSE 258
+
+#define COAP_PAYLOAD_MARKER_BYTE 0xff  // Ends the Options, see RFC 7252
+
+/**
+ * @brief Maximum number of CoAP Options parsed in a message.
+ */
+#ifndef COAP_MAX_OPTIONS
+#define COAP_MAX_OPTIONS 32
+#endif
+
+/**
+ * @brief Struct that defines a CoAP Option found in a packet.
+ */
+typedef struct {
+  uint16_t number;         // Option Number
+  uint16_t position;       // Occurrence of the Option Number, from 1
+  uint16_t length;         // Option Value byte length
+  size_t   header_offset;  // Byte offset of the Option in the packet
+  size_t   value_offset;   // Byte offset of the Option Value in the packet
+} coap_option_t;
+
+/**
+ * @brief Struct that defines the list of CoAP Options of a packet.
+ */
+typedef struct {
+  coap_option_t options[COAP_MAX_OPTIONS];  // Options, in packet order
+  size_t        card_options;               // Number of Options
+  size_t        end_offset;  // Byte offset of the Payload Marker, or the
+                             // byte length of the packet without payload
+} coap_options_t;
+
 /**
  * @brief Sets the CoAP Variable-Length.
  *
@@ -79,4 +159,54 @@ void set_coap_option_variable_length(uint16_t*      variable_length,
  */
 size_t get_coap_option_bit_length(const uint16_t option, const uint16_t sid);
 
+/**
+ * @brief Parses the list of CoAP Options of a packet.
+ *
+ * @details See Section 3.1 of CoAP RFC 7252. The Options are walked once, up
+ * to the Payload Marker or the end of the packet. Their Option Delta and
+ * Option Length nibbles are resolved, with their 13 and 14 extensions, into
+ * Option Numbers and Option Value offsets. Repeated Options, such as Uri-Path
+ * segments, are numbered by their occurrence, which is the Field Position of
+ * RFC 8724.
+ *
+ * @param coap_options Pointer to the list of CoAP Options to fill.
+ * @param packet Pointer to the packet.
+ * @param packet_byte_len Byte length of the packet.
+ * @param byte_position Byte position of the first Option in the packet.
+ * @param first_number Option Number the first Option Delta is relative to, 0
+ * unless some Options were already read.
+ * @return The status code, 1 for success, otherwise 0 if an Option is
+ * truncated, uses the reserved nibble 15, or if there are more than
+ * COAP_MAX_OPTIONS Options.
+ */
+int parse_coap_options(coap_options_t* coap_options, const uint8_t* packet,
+                       const size_t packet_byte_len, const size_t byte_position,
+                       const uint16_t first_number);
+
+/**
+ * @brief Adds the Option Delta and Option Length of a CoAP Option into a
+ * buffer, with their extensions.
+ *
+ * @details See Section 3.1 of CoAP RFC 7252.
+ *
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position Pointer to the current bit position in the buffer.
+ * @param option_delta The Option Delta.
+ * @param option_length The Option Value byte length.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int add_coap_option_header(uint8_t* buffer, const size_t buffer_byte_len,
+                           size_t* bit_position, const uint16_t option_delta,
+                           const uint16_t option_length);
+
+/**
+ * @brief Gets the Option Number a SID stands for.
+ *
+ * @param sid The SID.
+ * @return The Option Number, or 0 if the SID does not stand for a whole CoAP
+ * Option.
+ */
+uint16_t get_coap_option_number(const uint16_t sid);
+
 #endif  // _COAP_H_
\ No newline at end of file
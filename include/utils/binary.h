@@ -83,6 +83,63 @@ int add_bits_to_buffer(uint8_t* buffer, size_t buffer_byte_len,
                        size_t* bit_position, const uint8_t* content,
                        size_t content_len);
 
+/**
+ * @brief Writes a uint8_t into a buffer, overwriting the bits from the bit
+ * position on.
+ *
+ * @details Unlike add_byte_to_buffer(...), the buffer needs no clearing: the
+ * bits of the byte at the bit position that follow it are cleared and the
+ * next byte, if reached, is overwritten, so that a writer rolls back by
+ * resetting its bit position. The bits before the bit position are kept and,
+ * as with add_byte_to_buffer(...), the bits of content beyond content_len are
+ * ORed into them, so that both give the same buffer when the bits from the
+ * bit position on are zero.
+ *
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position Pointer to the current bit position in the buffer.
+ * @param content Data to write.
+ * @param content_len Data bit length, from 0 to 8.
+ * @return The status code, 1 for success otherwise 0.
+ */
+int write_byte_to_buffer(uint8_t* buffer, size_t buffer_byte_len,
+                         size_t* bit_position, uint8_t content,
+                         size_t content_len);
+
+/**
+ * @brief Writes bits into a buffer, overwriting the bits from the bit position
+ * on.
+ *
+ * @details See int write_byte_to_buffer and int add_bits_to_buffer.
+ *
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position Pointer to the current bit position in the buffer.
+ * @param content Pointer to the data to write.
+ * @param content_len Data bit length.
+ * @return The status code, 1 for success otherwise 0.
+ */
+int write_bits_to_buffer(uint8_t* buffer, size_t buffer_byte_len,
+                         size_t* bit_position, const uint8_t* content,
+                         size_t content_len);
+
+/**
+ * @brief Writes the length of a Variable-Length Field Residue into a buffer.
+ *
+ * @details RFC 8724, Section 7.4.2. The length is sent on 4 bits if below 15,
+ * as 0xf followed by 8 bits if below 255, otherwise as 0xff followed by 16
+ * bits. The prefix is built in a register without branching on its form, then
+ * written 4 bits first and a byte at a time.
+ *
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position Pointer to the current bit position in the buffer.
+ * @param variable_len The length to write, at most 0xffff.
+ * @return The status code, 1 for success otherwise 0.
+ */
+int write_variable_length(uint8_t* buffer, size_t buffer_byte_len,
+                          size_t* bit_position, size_t variable_len);
+
 /* ********************************************************************** */
 /*                               Extraction                               */
 /* ********************************************************************** */
@@ -104,6 +161,40 @@ int extract_bits(uint8_t* content, size_t content_max_byte_len,
                  size_t content_len, size_t* bit_position,
                  const uint8_t* buffer, size_t buffer_byte_len);
 
+/**
+ * @brief Loads the 64 bits of a buffer that follow a bit position.
+ *
+ * @details The bits are read with a single 8-byte load whenever the buffer
+ * holds 8 bytes from the byte of bit_position, the bits beyond the end of the
+ * buffer read as 0 otherwise. As the load is byte aligned, only the first
+ * 64 - (bit_position % 8) bits are loaded, the remaining ones are 0.
+ *
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position The bit position in the buffer.
+ * @return The bits, the first one being the most significant bit.
+ */
+uint64_t load_bits(const uint8_t* buffer, size_t buffer_byte_len,
+                   size_t bit_position);
+
+/**
+ * @brief Reads the length of a Variable-Length Field Residue.
+ *
+ * @details RFC 8724, Section 7.4.2. The length is sent on 4 bits if below 15,
+ * as 0xf followed by 8 bits if below 255, otherwise as 0xff followed by 16
+ * bits. The prefix is decoded from a single load_bits(...) without branching
+ * on its form.
+ *
+ * @param variable_len Pointer to the decoded length.
+ * @param bit_position Pointer to the bit position in the buffer, moved past
+ * the prefix.
+ * @param buffer Pointer to the buffer.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @return The status code, 1 for success otherwise 0.
+ */
+int read_variable_length(size_t* variable_len, size_t* bit_position,
+                         const uint8_t* buffer, size_t buffer_byte_len);
+
 /* ********************************************************************** */
 /*                                Other(s)                                */
 /* ********************************************************************** */
@@ -135,4 +226,50 @@ void split_uint16_t(uint8_t* left_byte, uint8_t* right_byte,
  */
 uint16_t merge_uint8_t(const uint8_t left_byte, const uint8_t right_byte);
 
+/**
+ * @brief Loads a big-endian value of up to 8 bytes.
+ *
+ * @param buffer Pointer to the value.
+ * @param buffer_byte_len Byte length of the value, from 0 to 8.
+ * @return The value, 0 if buffer_byte_len is 0.
+ */
+uint64_t load_uint64_t(const uint8_t* buffer, size_t buffer_byte_len);
+
+/**
+ * @brief Stores the buffer_byte_len least significant bytes of a value,
+ * big-endian.
+ *
+ * @param buffer Pointer to the buffer to fill.
+ * @param buffer_byte_len Byte length of the buffer, from 0 to 8.
+ * @param value The value to store.
+ */
+void store_uint64_t(uint8_t* buffer, size_t buffer_byte_len, uint64_t value);
+
+#ifdef __SIZEOF_INT128__
+/**
+ * @brief Unsigned 128-bit integer, for Fields such as IPv6 addresses.
+ */
+__extension__ typedef unsigned __int128 uint128_t;
+
+/**
+ * @brief Loads a big-endian value of up to 16 bytes.
+ *
+ * @param buffer Pointer to the value.
+ * @param buffer_byte_len Byte length of the value, from 0 to 16.
+ * @return The value, 0 if buffer_byte_len is 0.
+ */
+uint128_t load_uint128_t(const uint8_t* buffer, size_t buffer_byte_len);
+
+/**
+ * @brief Stores the buffer_byte_len least significant bytes of a value,
+ * big-endian.
+ *
+ * @param buffer Pointer to the buffer to fill.
+ * @param buffer_byte_len Byte length of the buffer, from 0 to 16.
+ * @param value The value to store.
+ */
+void store_uint128_t(uint8_t* buffer, size_t buffer_byte_len,
+                     uint128_t value);
+#endif
+
 #endif  // _BINARY_H_
\ No newline at end of file
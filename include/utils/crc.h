@@ -0,0 +1,57 @@
+/**
+ * @file crc.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief CRC32 implementation in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details CRC32 as defined by IEEE 802.3, the default Reassembly Check
+ * Sequence of SCHC RFC 8724. It is computed a byte at a time with a lookup
+ * table rather than a bit at a time.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _CRC_H_
+#define _CRC_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define CRC32_INIT 0xffffffffu  // Initial CRC32 register
+
+/**
+ * @brief Updates a CRC32 register with a buffer.
+ *
+ * @details Meant for data received in several parts: start from CRC32_INIT,
+ * update the register with each part and get the CRC32 with
+ * crc32_final(...).
+ *
+ * @param crc The CRC32 register.
+ * @param buffer Pointer to the bytes to add.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @return The updated CRC32 register.
+ */
+uint32_t crc32_update(uint32_t crc, const uint8_t *buffer,
+                      const size_t buffer_byte_len);
+
+/**
+ * @brief Gets the CRC32 of a CRC32 register.
+ *
+ * @param crc The CRC32 register.
+ * @return The CRC32.
+ */
+uint32_t crc32_final(const uint32_t crc);
+
+/**
+ * @brief Computes the CRC32 of a buffer.
+ *
+ * @param buffer Pointer to the bytes to check.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @return The CRC32.
+ */
+uint32_t crc32(const uint8_t *buffer, const size_t buffer_byte_len);
+
+#endif  // _CRC_H_
\ No newline at end of file
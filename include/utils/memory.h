@@ -16,7 +16,17 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#define POOL_SIZE (1024 * 1024)  // 1MB
+#ifndef POOL_SIZE
+#define POOL_SIZE (1024 * 1024)  // 1MB, -DPOOL_SIZE=... to change it
+#endif
+
+// Each thread has its own pool, -DPOOL_SHARED for a single one on targets
+// without thread-local storage
+#ifdef POOL_SHARED
+#define POOL_THREAD_LOCAL
+#else
+#define POOL_THREAD_LOCAL _Thread_local
+#endif
 
 /**
  * @brief Struct that defines a memory pool.
@@ -25,6 +35,10 @@
  * Indeed, no realignment is performed. Therefore, allocation/deallocation from
  * the pool must be done in the correct order to prevent data fragmentation. As
  * the pool is mainly used internally, we should avoid this issue.
+ *
+ * The pool is per thread: every thread that compresses or decompresses
+ * packets calls init_memory_pool(...) first, and destroy_memory_pool(...)
+ * before it ends, so that threads never share allocations.
  */
 typedef struct {
   uint8_t *memory;  // Dynamically allocated space
@@ -40,17 +54,17 @@ typedef struct {
 memory_pool_t *create_memory_pool(void);
 
 /**
- * @brief Pointer to track the memory_pool_t.
+ * @brief Pointer to track the memory_pool_t of the calling thread.
  */
-extern memory_pool_t *pool;
+extern POOL_THREAD_LOCAL memory_pool_t *pool;
 
 /**
- * @brief Frees the pool.
+ * @brief Frees the pool of the calling thread.
  */
 void destroy_memory_pool(void);
 
 /**
- * @brief Initializes the pool.
+ * @brief Initializes the pool of the calling thread.
  */
 void init_memory_pool(void);
 
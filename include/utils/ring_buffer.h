@@ -0,0 +1,79 @@
+/**
+ * @file ring_buffer.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Lock-free bounded ring buffer for CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A ring buffer of pointers that any number of threads push to and
+ * pop from without locks, each slot carrying a sequence number that tells
+ * whether it is ready to be written or read, as in D. Vyukov's bounded MPMC
+ * queue. With a single producer and a single consumer, pushes and pops never
+ * retry. Neither blocks: a full or empty ring buffer makes them return 0, the
+ * caller then retries or backs off.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _RING_BUFFER_H_
+#define _RING_BUFFER_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Struct that defines a slot of a Ring Buffer.
+ */
+typedef struct {
+  _Atomic size_t sequence;  // Position the slot is ready for
+  void          *item;      // Item, once pushed
+} ring_buffer_slot_t;
+
+/**
+ * @brief Struct that defines a Ring Buffer.
+ */
+typedef struct {
+  ring_buffer_slot_t *slots;     // Slots
+  size_t              capacity;  // Number of slots, a power of 2
+  _Alignas(64) _Atomic size_t push_position;  // Next position to push to
+  _Alignas(64) _Atomic size_t pop_position;   // Next position to pop from
+} ring_buffer_t;
+
+/**
+ * @brief Allocates the slots of a Ring Buffer.
+ *
+ * @param ring_buffer Pointer to the Ring Buffer to initialize.
+ * @param capacity Number of slots, rounded up to a power of 2.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_ring_buffer(ring_buffer_t *ring_buffer, const size_t capacity);
+
+/**
+ * @brief Frees the slots of a Ring Buffer.
+ *
+ * @param ring_buffer Pointer to the Ring Buffer to destroy.
+ */
+void destroy_ring_buffer(ring_buffer_t *ring_buffer);
+
+/**
+ * @brief Pushes an item to a Ring Buffer.
+ *
+ * @param ring_buffer Pointer to the Ring Buffer.
+ * @param item The item.
+ * @return 1 if the item was pushed, otherwise 0 if the Ring Buffer is full.
+ */
+int ring_buffer_push(ring_buffer_t *ring_buffer, void *item);
+
+/**
+ * @brief Pops the oldest item of a Ring Buffer.
+ *
+ * @param ring_buffer Pointer to the Ring Buffer.
+ * @param item Pointer to the item to set.
+ * @return 1 if an item was popped, otherwise 0 if the Ring Buffer is empty.
+ */
+int ring_buffer_pop(ring_buffer_t *ring_buffer, void **item);
+
+#endif  // _RING_BUFFER_H_
\ No newline at end of file
@@ -0,0 +1,129 @@
+/**
+ * @file timer_wheel.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Timer wheel implementation in CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A hierarchical timer wheel of TIMER_WHEEL_LEVELS levels of
+ * card_slots slots. A slot of level L spans card_slots^L ticks: a timer waits
+ * in the lowest level whose slot holds its expiry tick, and moves down a level
+ * each time its slot is reached. Starting and stopping a timer is O(1), and
+ * advancing the wheel by a tick visits a slot of level 0, plus a slot of an
+ * upper level once every card_slots ticks, however many timers are running.
+ *
+ * Timers further than card_slots^TIMER_WHEEL_LEVELS ticks wait in the highest
+ * level and go back to it until they are close enough.
+ *
+ * The wheel has no clock of its own: the caller advances it to its current
+ * tick with advance_timer_wheel(...), which makes it usable offline.
+ *
+ * Timers are embedded in the objects they belong to, hence starting a timer
+ * never allocates.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _TIMER_WHEEL_H_
+#define _TIMER_WHEEL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define TIMER_WHEEL_LEVELS        4   // Number of levels
+#define TIMER_WHEEL_MAX_SLOT_BITS 15  // Slots of a level, at most 2^15
+
+/**
+ * @brief Struct that defines a timer of a Timer Wheel.
+ */
+typedef struct wheel_timer_s {
+  struct wheel_timer_s *previous;     // Previous timer in the slot
+  struct wheel_timer_s *next;         // Next timer in the slot, NULL if stopped
+  uint64_t              expiry_tick;  // Tick at which the timer expires
+  void                 *owner;        // Object the timer belongs to
+  void (*expire)(struct wheel_timer_s *);  // Called on expiry
+} wheel_timer_t;
+
+/**
+ * @brief Struct that defines a Timer Wheel.
+ */
+typedef struct {
+  wheel_timer_t *slots;         // Sentinel of each slot, level after level,
+                                // from the pool
+  size_t         card_slots;    // Number of slots of a level, a power of 2
+  size_t         slot_bits;     // log2(card_slots)
+  size_t         card_timers;   // Number of running timers
+  uint64_t       current_tick;  // Last tick the wheel was advanced to
+} timer_wheel_t;
+
+/**
+ * @brief Allocates the slots of a Timer Wheel from the memory pool.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel to initialize.
+ * @param card_slots Number of slots of a level, a power of 2 between 2 and
+ * 2^TIMER_WHEEL_MAX_SLOT_BITS.
+ * @param current_tick Current tick of the caller's clock.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+int init_timer_wheel(timer_wheel_t *timer_wheel, const size_t card_slots,
+                     const uint64_t current_tick);
+
+/**
+ * @brief Gives the slots of a Timer Wheel back to the memory pool.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel to destroy.
+ */
+void destroy_timer_wheel(timer_wheel_t *timer_wheel);
+
+/**
+ * @brief Initializes a stopped timer.
+ *
+ * @param timer Pointer to the timer to initialize.
+ * @param expire Function called when the timer expires.
+ * @param owner Object the timer belongs to.
+ */
+void init_wheel_timer(wheel_timer_t *timer, void (*expire)(wheel_timer_t *),
+                      void *owner);
+
+/**
+ * @brief Starts a timer, or restarts it if it is running.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param timer Pointer to the timer, which must not move while running.
+ * @param delay_ticks Number of ticks before expiry, at least 1.
+ */
+void start_wheel_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer,
+                       const uint64_t delay_ticks);
+
+/**
+ * @brief Stops a timer, if it is running.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param timer Pointer to the timer.
+ */
+void stop_wheel_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer);
+
+/**
+ * @brief Checks if a timer is running.
+ *
+ * @param timer Pointer to the timer.
+ * @return 1 if the timer is running, otherwise 0.
+ */
+int is_wheel_timer_running(const wheel_timer_t *timer);
+
+/**
+ * @brief Advances a Timer Wheel to the caller's current tick and expires the
+ * timers due meanwhile.
+ *
+ * @details Expiry functions may start or stop any timer of the wheel.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param current_tick Current tick of the caller's clock.
+ * @return The number of expired timers.
+ */
+size_t advance_timer_wheel(timer_wheel_t *timer_wheel,
+                           const uint64_t current_tick);
+
+#endif  // _TIMER_WHEEL_H_
\ No newline at end of file
@@ -0,0 +1,90 @@
+/**
+ * @file work_deque.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Lock-free work-stealing deque for CSCHC.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details A bounded deque of pointers owned by one thread, after Chase and
+ * Lev, in the C11 formulation of Lê et al. The owner pushes and pops at the
+ * bottom, last in first out, so that it works on what it touched last, while
+ * any other thread steals at the top, the oldest item first. Only a pop and a
+ * steal racing for the last item synchronize, with a compare-and-swap on the
+ * top.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _WORK_DEQUE_H_
+#define _WORK_DEQUE_H_
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Struct that defines a Work Deque.
+ */
+typedef struct {
+  _Atomic(void *) *items;     // Items, indexed by position
+  size_t           capacity;  // Number of items, a power of 2
+  _Alignas(64) _Atomic ptrdiff_t top;     // Position of the next steal
+  _Alignas(64) _Atomic ptrdiff_t bottom;  // Position of the next push
+} work_deque_t;
+
+/**
+ * @brief Allocates the items of a Work Deque.
+ *
+ * @param work_deque Pointer to the Work Deque to initialize.
+ * @param capacity Number of items, rounded up to a power of 2.
+ * @return The status code, 1 for success, otherwise 0 if memory is exhausted.
+ */
+int init_work_deque(work_deque_t *work_deque, const size_t capacity);
+
+/**
+ * @brief Frees the items of a Work Deque.
+ *
+ * @param work_deque Pointer to the Work Deque to destroy.
+ */
+void destroy_work_deque(work_deque_t *work_deque);
+
+/**
+ * @brief Returns the number of items of a Work Deque, exact for its owner
+ * only.
+ *
+ * @param work_deque Pointer to the Work Deque.
+ * @return The number of items.
+ */
+size_t get_work_deque_size(work_deque_t *work_deque);
+
+/**
+ * @brief Pushes an item at the bottom of a Work Deque, by its owner.
+ *
+ * @param work_deque Pointer to the Work Deque.
+ * @param item The item.
+ * @return 1 if the item was pushed, otherwise 0 if the Work Deque is full.
+ */
+int work_deque_push(work_deque_t *work_deque, void *item);
+
+/**
+ * @brief Pops the item at the bottom of a Work Deque, by its owner.
+ *
+ * @param work_deque Pointer to the Work Deque.
+ * @param item Pointer to the item to set.
+ * @return 1 if an item was popped, otherwise 0 if the Work Deque is empty.
+ */
+int work_deque_pop(work_deque_t *work_deque, void **item);
+
+/**
+ * @brief Steals the item at the top of a Work Deque, by any thread.
+ *
+ * @param work_deque Pointer to the Work Deque.
+ * @param item Pointer to the item to set.
+ * @return 1 if an item was stolen, otherwise 0 if the Work Deque is empty or
+ * another thread took the item first.
+ */
+int work_deque_steal(work_deque_t *work_deque, void **item);
+
+#endif  // _WORK_DEQUE_H_
\ No newline at end of file
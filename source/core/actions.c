@@ -35,6 +35,23 @@ int CDA_least_significant_bits(
   field_byte_len = BYTE_LENGTH(rule_field_descriptor->len);
   residue_byte_len = BYTE_LENGTH(lsb_len);
 
+  // The LSB of Fields up to 64 bits, or 128 bits, are extracted with a mask
+  if (field_byte_len <= sizeof(uint64_t)) {
+    store_uint64_t(field_residue, residue_byte_len,
+                   load_uint64_t(field, field_byte_len) &
+                       (((uint64_t) 1 << lsb_len) - 1));
+    return 1;
+  }
+
+#ifdef __SIZEOF_INT128__
+  if (field_byte_len <= sizeof(uint128_t)) {
+    store_uint128_t(field_residue, residue_byte_len,
+                    load_uint128_t(field, field_byte_len) &
+                        (((uint128_t) 1 << lsb_len) - 1));
+    return 1;
+  }
+#endif
+
   // Copy the LSB content into field_residue
   memcpy(field_residue, field + (field_byte_len - residue_byte_len),
          residue_byte_len);
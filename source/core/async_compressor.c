@@ -0,0 +1,294 @@
+#include "async_compressor.h"
+#include "compression.h"
+#include "decompression.h"
+#include "utils/memory.h"
+
+#include <fcntl.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define ASYNC_IDLE_SPINS    1024   // Empty pops before a worker sleeps
+#define ASYNC_IDLE_SLEEP_NS 50000  // Sleep of an idle worker
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Frees the workers, queues and pipe of an Async Compressor and the
+ * Async Compressor, once their threads ended.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ */
+static void __free_async_compressor(async_compressor_t *async_compressor);
+
+/**
+ * @brief Makes the descriptor of an Async Compressor readable, unless it
+ * already is.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ */
+static void __signal_async_compressor(async_compressor_t *async_compressor);
+
+/**
+ * @brief Counts a request as completed, and signals that submissions may
+ * resume once half of the requests in flight completed since one was refused.
+ *
+ * @param async_compressor Pointer to the Async Compressor.
+ */
+static void __complete_async_request(async_compressor_t *async_compressor);
+
+/**
+ * @brief Worker thread, processes the submitted requests until the Async
+ * Compressor stops.
+ *
+ * @param arg Pointer to the worker.
+ * @return NULL.
+ */
+static void *__async_worker(void *arg);
+
+/* ********************************************************************** */
+
+async_compressor_t *create_async_compressor(const size_t card_workers,
+                                            const size_t max_in_flight) {
+  async_compressor_t *async_compressor;
+  size_t              card_started;
+
+  if (card_workers == 0 || card_workers > ASYNC_MAX_WORKERS ||
+      max_in_flight == 0) {
+    return NULL;
+  }
+
+  // The counter is on its own cache line
+  async_compressor = (async_compressor_t *) aligned_alloc(
+      64, sizeof(async_compressor_t));
+  if (async_compressor == NULL) {
+    return NULL;
+  }
+  memset(async_compressor, 0x00, sizeof(async_compressor_t));
+  async_compressor->signal_fds[0] = -1;
+  async_compressor->signal_fds[1] = -1;
+  async_compressor->card_workers  = card_workers;
+  async_compressor->max_in_flight = max_in_flight;
+  atomic_init(&async_compressor->stop, 0);
+  atomic_init(&async_compressor->is_signaled, 0);
+  atomic_init(&async_compressor->is_refused, 0);
+  atomic_init(&async_compressor->card_in_flight, 0);
+
+  // Both queues hold at most the requests in flight, they are never full
+  async_compressor->workers = (async_worker_t *) calloc(
+      card_workers, sizeof(async_worker_t));
+  if (async_compressor->workers == NULL ||
+      !init_ring_buffer(&async_compressor->submissions, max_in_flight) ||
+      !init_ring_buffer(&async_compressor->completions, max_in_flight) ||
+      pipe(async_compressor->signal_fds) != 0 ||
+      fcntl(async_compressor->signal_fds[0], F_SETFL, O_NONBLOCK) != 0 ||
+      fcntl(async_compressor->signal_fds[1], F_SETFL, O_NONBLOCK) != 0) {
+    __free_async_compressor(async_compressor);
+    return NULL;
+  }
+  for (size_t index = 0; index < card_workers; index++) {
+    async_compressor->workers[index].async_compressor = async_compressor;
+    if (!init_flow_cache(&async_compressor->workers[index].flow_cache,
+                         ASYNC_FLOW_CACHE_ENTRIES)) {
+      __free_async_compressor(async_compressor);
+      return NULL;
+    }
+  }
+
+  for (card_started = 0; card_started < card_workers; card_started++) {
+    if (pthread_create(&async_compressor->workers[card_started].thread, NULL,
+                       __async_worker,
+                       &async_compressor->workers[card_started]) != 0) {
+      atomic_store(&async_compressor->stop, 1);
+      for (size_t index = 0; index < card_started; index++) {
+        pthread_join(async_compressor->workers[index].thread, NULL);
+      }
+      __free_async_compressor(async_compressor);
+      return NULL;
+    }
+  }
+
+  return async_compressor;
+}
+
+/* ********************************************************************** */
+
+void destroy_async_compressor(async_compressor_t *async_compressor) {
+  if (async_compressor == NULL) {
+    return;
+  }
+
+  atomic_store(&async_compressor->stop, 1);
+  for (size_t index = 0; index < async_compressor->card_workers; index++) {
+    pthread_join(async_compressor->workers[index].thread, NULL);
+  }
+
+  __free_async_compressor(async_compressor);
+}
+
+/* ********************************************************************** */
+
+int get_async_compressor_fd(const async_compressor_t *async_compressor) {
+  return async_compressor->signal_fds[0];
+}
+
+/* ********************************************************************** */
+
+int submit_async_request(async_compressor_t *async_compressor,
+                         async_request_t    *request) {
+  if (atomic_fetch_add(&async_compressor->card_in_flight, 1) >=
+      async_compressor->max_in_flight) {
+    atomic_fetch_sub(&async_compressor->card_in_flight, 1);
+    atomic_store(&async_compressor->is_refused, 1);
+
+    // The requests may have completed before the refusal was seen
+    if (atomic_load(&async_compressor->card_in_flight) <=
+            async_compressor->max_in_flight / 2 &&
+        atomic_exchange(&async_compressor->is_refused, 0)) {
+      __signal_async_compressor(async_compressor);
+    }
+    return 0;
+  }
+
+  request->output_byte_len = 0;
+  if (!ring_buffer_push(&async_compressor->submissions, request)) {
+    atomic_fetch_sub(&async_compressor->card_in_flight, 1);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+async_request_t *poll_async_completion(async_compressor_t *async_compressor) {
+  void   *item;
+  uint8_t signals[64];
+
+  if (!ring_buffer_pop(&async_compressor->completions, &item)) {
+    // A worker that finds the signal cleared writes a new one, otherwise its
+    // request is popped below
+    if (!atomic_exchange(&async_compressor->is_signaled, 0)) {
+      return NULL;
+    }
+    while (read(async_compressor->signal_fds[0], signals, sizeof(signals)) >
+           0) {
+    }
+    if (!ring_buffer_pop(&async_compressor->completions, &item)) {
+      return NULL;
+    }
+  }
+
+  __complete_async_request(async_compressor);
+
+  return (async_request_t *) item;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static void __free_async_compressor(async_compressor_t *async_compressor) {
+  if (async_compressor->workers != NULL) {
+    for (size_t index = 0; index < async_compressor->card_workers; index++) {
+      destroy_flow_cache(&async_compressor->workers[index].flow_cache);
+    }
+  }
+  if (async_compressor->signal_fds[0] >= 0) {
+    close(async_compressor->signal_fds[0]);
+    close(async_compressor->signal_fds[1]);
+  }
+
+  destroy_ring_buffer(&async_compressor->completions);
+  destroy_ring_buffer(&async_compressor->submissions);
+  free(async_compressor->workers);
+  free(async_compressor);
+}
+
+/* ********************************************************************** */
+
+static void __signal_async_compressor(async_compressor_t *async_compressor) {
+  const uint8_t signal = 0x01;
+
+  // The pipe cannot be full, it holds a single byte at a time
+  if (!atomic_exchange(&async_compressor->is_signaled, 1)) {
+    if (write(async_compressor->signal_fds[1], &signal, sizeof(signal)) < 0) {
+      atomic_store(&async_compressor->is_signaled, 0);
+    }
+  }
+}
+
+/* ********************************************************************** */
+
+static void __complete_async_request(async_compressor_t *async_compressor) {
+  size_t card_in_flight;
+
+  card_in_flight = atomic_fetch_sub(&async_compressor->card_in_flight, 1) - 1;
+  if (card_in_flight <= async_compressor->max_in_flight / 2 &&
+      atomic_load_explicit(&async_compressor->is_refused,
+                           memory_order_relaxed) &&
+      atomic_exchange(&async_compressor->is_refused, 0)) {
+    __signal_async_compressor(async_compressor);
+  }
+}
+
+/* ********************************************************************** */
+
+static void *__async_worker(void *arg) {
+  async_worker_t     *worker;
+  async_compressor_t *async_compressor;
+  async_request_t    *request;
+  void               *item;
+  struct timespec     idle_sleep;
+  size_t              card_idle;
+
+  worker           = (async_worker_t *) arg;
+  async_compressor = worker->async_compressor;
+  init_memory_pool();
+
+  idle_sleep.tv_sec  = 0;
+  idle_sleep.tv_nsec = ASYNC_IDLE_SLEEP_NS;
+  card_idle          = 0;
+  while (!atomic_load_explicit(&async_compressor->stop,
+                               memory_order_relaxed)) {
+    // An idle worker ends up sleeping, so that a quiet event loop costs no CPU
+    if (!ring_buffer_pop(&async_compressor->submissions, &item)) {
+      if (++card_idle < ASYNC_IDLE_SPINS) {
+        sched_yield();
+      } else {
+        nanosleep(&idle_sleep, NULL);
+      }
+      continue;
+    }
+    card_idle = 0;
+
+    request = (async_request_t *) item;
+    if (request->decompression) {
+      request->output_byte_len = decompress_compiled(
+          request->output, request->output_max_byte_len, request->direction,
+          request->packet, request->packet_byte_len,
+          request->compiled_context);
+    } else {
+      request->output_byte_len = compress_compiled_cached(
+          request->output, request->output_max_byte_len, request->direction,
+          request->packet, request->packet_byte_len,
+          request->compiled_context, &worker->flow_cache);
+    }
+
+    if (request->callback != NULL) {
+      request->callback(request, request->user_data);
+      __complete_async_request(async_compressor);
+    } else {
+      ring_buffer_push(&async_compressor->completions, request);
+      __signal_async_compressor(async_compressor);
+    }
+  }
+
+  destroy_memory_pool();
+
+  return NULL;
+}
\ No newline at end of file
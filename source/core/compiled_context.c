@@ -0,0 +1,168 @@
+#include "compiled_context.h"
+#include "context_loader.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Computes the FNV-1a hash of a byte array.
+ *
+ * @param buffer Pointer to the bytes to hash.
+ * @param byte_len Byte length of the buffer.
+ * @return The 32-bit hash.
+ */
+static uint32_t __fnv1a_hash(const uint8_t *buffer, const size_t byte_len);
+
+/**
+ * @brief Compiles the validated Context of a Compiled Context.
+ *
+ * @param compiled_context Pointer to the Compiled Context, whose Context is
+ * validated.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __compile_validated_context(compiled_context_t *compiled_context);
+
+/* ********************************************************************** */
+
+compiled_context_t *compile_context(const uint8_t *context,
+                                    const size_t   context_byte_len) {
+  compiled_context_t *compiled_context;
+  uint8_t            *context_copy;
+
+  if (context == NULL || context_byte_len == 0) {
+    return NULL;
+  }
+
+  compiled_context =
+      (compiled_context_t *) calloc(1, sizeof(compiled_context_t));
+  if (compiled_context == NULL) {
+    return NULL;
+  }
+
+  context_copy = (uint8_t *) malloc(context_byte_len);
+  if (context_copy == NULL) {
+    free(compiled_context);
+    return NULL;
+  }
+  memcpy(context_copy, context, context_byte_len);
+  compiled_context->context = context_copy;
+
+  if (!context_validate(&compiled_context->validated_context,
+                        compiled_context->context, context_byte_len) ||
+      !__compile_validated_context(compiled_context)) {
+    free_compiled_context(compiled_context);
+    return NULL;
+  }
+
+  return compiled_context;
+}
+
+/* ********************************************************************** */
+
+compiled_context_t *compile_context_file(const char *path) {
+  compiled_context_t *compiled_context;
+
+  compiled_context =
+      (compiled_context_t *) calloc(1, sizeof(compiled_context_t));
+  if (compiled_context == NULL) {
+    return NULL;
+  }
+
+  if (!load_context_file(&compiled_context->validated_context, path)) {
+    free(compiled_context);
+    return NULL;
+  }
+  compiled_context->context   = compiled_context->validated_context.context;
+  compiled_context->is_mapped = 1;
+
+  if (!__compile_validated_context(compiled_context)) {
+    free_compiled_context(compiled_context);
+    return NULL;
+  }
+
+  return compiled_context;
+}
+
+/* ********************************************************************** */
+
+int compiled_context_same_rules(const compiled_context_t *first_context,
+                                const compiled_context_t *second_context) {
+  size_t context_byte_len;
+
+  context_byte_len = first_context->validated_context.context_byte_len;
+
+  return first_context->rules_hash == second_context->rules_hash &&
+         context_byte_len ==
+             second_context->validated_context.context_byte_len &&
+         memcmp(first_context->context + 1, second_context->context + 1,
+                context_byte_len - 1) == 0;
+}
+
+/* ********************************************************************** */
+
+void free_compiled_context(compiled_context_t *compiled_context) {
+  if (compiled_context == NULL) {
+    return;
+  }
+
+  destroy_rule_programs(&compiled_context->rule_programs);
+  destroy_mapping_tables(&compiled_context->mapping_tables);
+  destroy_rule_matcher(&compiled_context->rule_matchers[DI_UP]);
+  destroy_rule_matcher(&compiled_context->rule_matchers[DI_DW]);
+  destroy_compiled_rules(&compiled_context->compiled_rules);
+  if (compiled_context->is_mapped) {
+    unload_context_file(&compiled_context->validated_context);
+  } else {
+    free((void *) compiled_context->context);
+  }
+  free(compiled_context);
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __compile_validated_context(compiled_context_t *compiled_context) {
+  size_t context_byte_len;
+
+  if (!init_compiled_rules(&compiled_context->compiled_rules,
+                           &compiled_context->validated_context) ||
+      !init_rule_matcher(&compiled_context->rule_matchers[DI_UP],
+                         &compiled_context->compiled_rules,
+                         compiled_context->context, DI_UP) ||
+      !init_rule_matcher(&compiled_context->rule_matchers[DI_DW],
+                         &compiled_context->compiled_rules,
+                         compiled_context->context, DI_DW) ||
+      !init_mapping_tables(&compiled_context->mapping_tables,
+                           &compiled_context->compiled_rules,
+                           compiled_context->context) ||
+      !init_rule_programs(&compiled_context->rule_programs,
+                          &compiled_context->compiled_rules,
+                          compiled_context->context)) {
+    return 0;
+  }
+
+  // The Context ID is left out, see compiled_context_same_rules(...)
+  context_byte_len = compiled_context->validated_context.context_byte_len;
+  compiled_context->rules_hash =
+      __fnv1a_hash(compiled_context->context + 1, context_byte_len - 1);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static uint32_t __fnv1a_hash(const uint8_t *buffer, const size_t byte_len) {
+  uint32_t hash;
+
+  hash = 2166136261u;
+  for (size_t index = 0; index < byte_len; index++) {
+    hash = (hash ^ buffer[index]) * 16777619u;
+  }
+
+  return hash;
+}
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "compiled_rules.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Gets the byte length of the arrays of a Compiled Rule, rounded up to
+ * a whole number of cache lines.
+ *
+ * @param card_rule_field_descriptor Number of Rule Field Descriptors.
+ * @return The byte length of the arrays.
+ */
+static size_t __get_compiled_rule_byte_len(
+    const uint8_t card_rule_field_descriptor);
+
+/**
+ * @brief Packs Direction Indicator, Matching Operator and Compression
+ * Decompression Action as in the Context, see unpack_di_mo_cda(...).
+ *
+ * @param rule_field_descriptor Pointer to the Rule Field Descriptor.
+ * @return The packed value.
+ */
+static uint8_t __pack_di_mo_cda(
+    const rule_field_descriptor_t *rule_field_descriptor);
+
+/* ********************************************************************** */
+
+int init_compiled_rules(compiled_rules_t          *compiled_rules,
+                        const validated_context_t *validated_context) {
+  size_t                  rules_byte_len;
+  size_t                  fields_byte_position;
+  uint16_t               *uint16_arrays;
+  uint8_t                *uint8_arrays;
+  uint8_t                 card_rule_field_descriptor;
+  compiled_rule_t        *compiled_rule;
+  rule_descriptor_t       rule_descriptor;
+  rule_field_descriptor_t rule_field_descriptor;
+
+  memset(compiled_rules, 0x00, sizeof(compiled_rules_t));
+  compiled_rules->card_rules =
+      validated_context->context[CARD_RULE_DESCRIPTOR_OFFSET];
+
+  // aligned_alloc(...) expects a multiple of the alignment
+  rules_byte_len = compiled_rules->card_rules * sizeof(compiled_rule_t);
+  rules_byte_len = (rules_byte_len + CACHE_LINE_BYTE_LEN - 1) /
+                   CACHE_LINE_BYTE_LEN * CACHE_LINE_BYTE_LEN;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    get_rule_descriptor_unchecked(&rule_descriptor, index,
+                                  validated_context->context);
+    compiled_rules->fields_byte_len += __get_compiled_rule_byte_len(
+        rule_descriptor.card_rule_field_descriptor);
+  }
+
+  // One more cache line, Contexts without any Rule Field Descriptor included
+  compiled_rules->rules = (compiled_rule_t *) aligned_alloc(
+      CACHE_LINE_BYTE_LEN, rules_byte_len + CACHE_LINE_BYTE_LEN);
+  compiled_rules->fields = (uint8_t *) aligned_alloc(
+      CACHE_LINE_BYTE_LEN,
+      compiled_rules->fields_byte_len + CACHE_LINE_BYTE_LEN);
+  if (compiled_rules->rules == NULL || compiled_rules->fields == NULL) {
+    destroy_compiled_rules(compiled_rules);
+    return 0;
+  }
+  memset(compiled_rules->fields, 0x00, compiled_rules->fields_byte_len);
+
+  fields_byte_position = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    get_rule_descriptor_unchecked(&rule_descriptor, index,
+                                  validated_context->context);
+    card_rule_field_descriptor = rule_descriptor.card_rule_field_descriptor;
+
+    // uint16_t arrays first, the uint8_t ones need no alignment
+    uint16_arrays =
+        (uint16_t *) (compiled_rules->fields + fields_byte_position);
+    uint8_arrays = (uint8_t *) (uint16_arrays + 5 * card_rule_field_descriptor);
+
+    compiled_rule         = &compiled_rules->rules[index];
+    compiled_rule->offset = rule_descriptor.offset;
+    compiled_rule->id     = rule_descriptor.id;
+    compiled_rule->nature = rule_descriptor.nature;
+    compiled_rule->card_rule_field_descriptor = card_rule_field_descriptor;
+
+    compiled_rule->sids      = uint16_arrays;
+    compiled_rule->lens      = uint16_arrays + card_rule_field_descriptor;
+    compiled_rule->positions = uint16_arrays + 2 * card_rule_field_descriptor;
+    compiled_rule->msb_lens  = uint16_arrays + 3 * card_rule_field_descriptor;
+    compiled_rule->target_value_offsets =
+        uint16_arrays + 4 * card_rule_field_descriptor;
+    compiled_rule->di_mo_cdas = uint8_arrays;
+    compiled_rule->card_target_values =
+        uint8_arrays + card_rule_field_descriptor;
+
+    for (unsigned int index_rule_field_descriptor = 0;
+         index_rule_field_descriptor < card_rule_field_descriptor;
+         index_rule_field_descriptor++) {
+      get_rule_field_descriptor_unchecked(
+          &rule_field_descriptor, index_rule_field_descriptor,
+          rule_descriptor.offset, validated_context->context);
+
+      uint16_arrays[index_rule_field_descriptor] = rule_field_descriptor.sid;
+      uint16_arrays[card_rule_field_descriptor + index_rule_field_descriptor] =
+          rule_field_descriptor.len;
+      uint16_arrays[2 * card_rule_field_descriptor +
+                    index_rule_field_descriptor] = rule_field_descriptor.pos;
+      uint16_arrays[3 * card_rule_field_descriptor +
+                    index_rule_field_descriptor] =
+          rule_field_descriptor.msb_len;
+      uint16_arrays[4 * card_rule_field_descriptor +
+                    index_rule_field_descriptor] =
+          rule_field_descriptor.first_target_value_offset;
+      uint8_arrays[index_rule_field_descriptor] =
+          __pack_di_mo_cda(&rule_field_descriptor);
+      uint8_arrays[card_rule_field_descriptor + index_rule_field_descriptor] =
+          rule_field_descriptor.card_target_value;
+    }
+
+    fields_byte_position +=
+        __get_compiled_rule_byte_len(card_rule_field_descriptor);
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_compiled_rules(compiled_rules_t *compiled_rules) {
+  free(compiled_rules->rules);
+  free(compiled_rules->fields);
+  memset(compiled_rules, 0x00, sizeof(compiled_rules_t));
+}
+
+/* ********************************************************************** */
+
+void get_compiled_rule_descriptor(rule_descriptor_t      *rule_descriptor,
+                                  const unsigned int      index,
+                                  const compiled_rules_t *compiled_rules) {
+  const compiled_rule_t *compiled_rule;
+
+  compiled_rule = &compiled_rules->rules[index];
+
+  rule_descriptor->offset = compiled_rule->offset;
+  rule_descriptor->id     = compiled_rule->id;
+  rule_descriptor->nature = compiled_rule->nature;
+  rule_descriptor->card_rule_field_descriptor =
+      compiled_rule->card_rule_field_descriptor;
+  rule_descriptor->compiled_rule = compiled_rule;
+}
+
+/* ********************************************************************** */
+
+void get_compiled_rule_field_descriptor(
+    rule_field_descriptor_t *rule_field_descriptor, const unsigned int index,
+    const compiled_rule_t *compiled_rule) {
+  rule_field_descriptor->sid     = compiled_rule->sids[index];
+  rule_field_descriptor->len     = compiled_rule->lens[index];
+  rule_field_descriptor->pos     = compiled_rule->positions[index];
+  rule_field_descriptor->msb_len = compiled_rule->msb_lens[index];
+  unpack_di_mo_cda(&rule_field_descriptor->di, &rule_field_descriptor->mo,
+                   &rule_field_descriptor->cda,
+                   compiled_rule->di_mo_cdas[index]);
+  rule_field_descriptor->card_target_value =
+      compiled_rule->card_target_values[index];
+  rule_field_descriptor->first_target_value_offset =
+      compiled_rule->target_value_offsets[index];
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static size_t __get_compiled_rule_byte_len(
+    const uint8_t card_rule_field_descriptor) {
+  size_t byte_len;
+
+  // 5 uint16_t and 2 uint8_t arrays
+  byte_len = 12 * (size_t) card_rule_field_descriptor;
+
+  return (byte_len + CACHE_LINE_BYTE_LEN - 1) / CACHE_LINE_BYTE_LEN *
+         CACHE_LINE_BYTE_LEN;
+}
+
+/* ********************************************************************** */
+
+static uint8_t __pack_di_mo_cda(
+    const rule_field_descriptor_t *rule_field_descriptor) {
+  return (uint8_t) ((rule_field_descriptor->di << 5) |
+                    (rule_field_descriptor->mo << 3) |
+                    rule_field_descriptor->cda);
+}
\ No newline at end of file
@@ -20,13 +20,28 @@
  * @param packet_byte_len Byte length of the packet to compress.
  * @param context Pointer to the SCHC Context used to perform compression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
+ * @param compiled_rules Pointer to the Compiled Rules of the context, or NULL
+ * to decode descriptors from the context.
+ * @param candidate_rules Bitmask of the Rules that may compress the packet,
+ * see match_rules(...), or NULL to try every Rule.
+ * @param mapping_tables Pointer to the Mapping Tables of the context, or NULL
+ * to compare Mapping Sent Fields with every Target Value.
+ * @param rule_programs Pointer to the Rule Programs of the context, or NULL to
+ * compress Rule Field Descriptor by Rule Field Descriptor.
+ * @param rule_index Pointer to the index of the Rule that compressed the
+ * packet, to set, or NULL.
  * @return The final byte length of the compressed SCHC packet.
  */
 static size_t __compression_handler(
     uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
     const direction_indicator_t packet_direction, const uint8_t* packet,
     const size_t packet_byte_len, const uint8_t* context,
-    const size_t context_byte_len);
+    const size_t context_byte_len, const int is_validated_context,
+    const compiled_rules_t* compiled_rules, const uint64_t* candidate_rules,
+    const mapping_tables_t* mapping_tables,
+    const rule_programs_t* rule_programs, unsigned int* rule_index);
 
 /**
  * @brief Adds SCHC Rule ID at the beginning of the SCHC Packet (Compression
@@ -78,6 +93,9 @@ static int __no_compression(uint8_t*     schc_packet,
  * packet.
  * @param context Pointer to the SCHC Context used to perform compression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
+ * @param mapping_tables Pointer to the Mapping Tables of the context, or NULL.
  * @return The compression status code, 1 for success, otherwise 0.
  */
 static int __compression(uint8_t*                    schc_packet,
@@ -86,25 +104,59 @@ static int __compression(uint8_t*                    schc_packet,
                          const direction_indicator_t packet_direction,
                          const uint8_t* packet, const size_t packet_byte_len,
                          const rule_descriptor_t* rule_descriptor,
-                         const uint8_t* context, const size_t context_byte_len);
+                         const uint8_t* context, const size_t context_byte_len,
+                         const int               is_validated_context,
+                         const mapping_tables_t* mapping_tables);
 
 /**
  * @brief Handles fields with Variable-Length during compression, basically CoAP
  * Token and Options.
  *
- * @details RFC 8724, Section 7.4.2.
+ * @details RFC 8724, Section 7.4.2. The length of the Field Residue is sent
+ * in bytes, see write_variable_length(...).
  *
  * @param schc_packet Pointer to the SCHC Packet to fill.
  * @param schc_packet_max_byte_len Maximum byte length of the schc_packet.
  * @param bit_position Pointer to the current position, from where to add the
  * content.
- * @param variable_len Bit length of the Variable-Length Field.
+ * @param variable_len Bit length of the Variable-Length Field, a multiple of 8.
  * @return The compression status code, 1 for success, otherwise 0.
  */
 static int __variable_length_encoding(uint8_t*     schc_packet,
                                       const size_t schc_packet_max_byte_len,
                                       size_t*      bit_position,
-                                      const int    variable_len);
+                                      const size_t variable_len);
+
+/**
+ * @brief Moves the Packet bit position to the Value of the next CoAP Option,
+ * for a Rule Field Descriptor standing for a whole CoAP Option.
+ *
+ * @details The CoAP Options are parsed once, on the first such Rule Field
+ * Descriptor, then consumed in packet order. A Field Position other than 0
+ * binds the Rule Field Descriptor to that occurrence of the Option, e.g. the
+ * second Uri-Path segment. The Option Delta and Option Length of the Option
+ * are not sent, the decompressor deduces them.
+ *
+ * @param packet_bit_position Pointer to the current bit position in the
+ * Packet, moved to the Option Value.
+ * @param option_value_len Pointer to the bit length of the Option Value.
+ * @param coap_options Pointer to the list of CoAP Options of the Packet.
+ * @param index_coap_option Pointer to the index of the next CoAP Option, or
+ * COAP_MAX_OPTIONS if the Options are not parsed yet.
+ * @param coap_option_number Pointer to the Number of the last CoAP Option.
+ * @param rule_field_descriptor Pointer to the Rule Field Descriptor.
+ * @param packet Pointer to the Packet.
+ * @param packet_byte_len Byte length of the packet.
+ * @return The compression status code, 1 for success, otherwise 0 if the next
+ * Option does not have the Option Number and Field Position of the Rule Field
+ * Descriptor.
+ */
+static int __get_coap_option(
+    size_t* packet_bit_position, size_t* option_value_len,
+    coap_options_t* coap_options, size_t* index_coap_option,
+    uint16_t*                      coap_option_number,
+    const rule_field_descriptor_t* rule_field_descriptor,
+    const uint8_t* packet, const size_t packet_byte_len);
 
 /* ********************************************************************** */
 /*                         Main compress function                         */
@@ -118,7 +170,123 @@ size_t compress(uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
 
   schc_packet_byte_len = __compression_handler(
       schc_packet, schc_packet_max_byte_len, packet_direction, packet,
-      packet_byte_len, context, context_byte_len);
+      packet_byte_len, context, context_byte_len, 0, NULL, NULL, NULL, NULL,
+      NULL);
+
+  return schc_packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+size_t compress_validated(uint8_t*                    schc_packet,
+                          const size_t                schc_packet_max_byte_len,
+                          const direction_indicator_t packet_direction,
+                          const uint8_t* packet, const size_t packet_byte_len,
+                          const validated_context_t* validated_context) {
+  size_t schc_packet_byte_len;
+
+  schc_packet_byte_len = __compression_handler(
+      schc_packet, schc_packet_max_byte_len, packet_direction, packet,
+      packet_byte_len, validated_context->context,
+      validated_context->context_byte_len, 1, NULL, NULL, NULL, NULL, NULL);
+
+  return schc_packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+size_t compress_compiled(uint8_t*                    schc_packet,
+                         const size_t                schc_packet_max_byte_len,
+                         const direction_indicator_t packet_direction,
+                         const uint8_t* packet, const size_t packet_byte_len,
+                         const compiled_context_t* compiled_context) {
+  size_t   schc_packet_byte_len;
+  uint64_t candidate_rules[RULE_MATCHER_MASK_WORDS];
+
+  if (packet_direction == DI_BI) {
+    return 0;
+  }
+
+  // Rules whose MO_EQUAL Fields differ from the packet are not tried
+  match_rules(candidate_rules,
+              &compiled_context->rule_matchers[packet_direction], packet,
+              packet_byte_len);
+
+  schc_packet_byte_len = __compression_handler(
+      schc_packet, schc_packet_max_byte_len, packet_direction, packet,
+      packet_byte_len, compiled_context->validated_context.context,
+      compiled_context->validated_context.context_byte_len, 1,
+      &compiled_context->compiled_rules, candidate_rules,
+      &compiled_context->mapping_tables, &compiled_context->rule_programs,
+      NULL);
+
+  return schc_packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+size_t compress_compiled_cached(
+    uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
+    const direction_indicator_t packet_direction, const uint8_t* packet,
+    const size_t packet_byte_len, const compiled_context_t* compiled_context,
+    flow_cache_t* flow_cache) {
+  size_t                schc_packet_byte_len;
+  uint32_t              flow_hash;
+  uint16_t              cached_rule;
+  unsigned int          rule_index;
+  uint64_t              candidate_rules[RULE_MATCHER_MASK_WORDS];
+  uint64_t              cached_rules[RULE_MATCHER_MASK_WORDS];
+  const rule_matcher_t* rule_matcher;
+
+  if (packet_direction == DI_BI) {
+    return 0;
+  }
+
+  if (!get_flow_hash(&flow_hash, packet, packet_byte_len)) {
+    return compress_compiled(schc_packet, schc_packet_max_byte_len,
+                             packet_direction, packet, packet_byte_len,
+                             compiled_context);
+  }
+
+  rule_matcher = &compiled_context->rule_matchers[packet_direction];
+  match_rules(candidate_rules, rule_matcher, packet, packet_byte_len);
+
+  // The cached Rule is tried alone if no earlier candidate Rule may compress
+  // the packet, otherwise the first Rule to compress it could be another one
+  cached_rule = get_flow_rule(flow_cache, flow_hash);
+  if (cached_rule < rule_matcher->card_rules &&
+      ((candidate_rules[cached_rule / 64] >> (cached_rule % 64)) & 1) &&
+      !is_rule_shadowed(rule_matcher, candidate_rules, cached_rule)) {
+    memset(cached_rules, 0x00, sizeof(cached_rules));
+    cached_rules[cached_rule / 64] = (uint64_t) 1 << (cached_rule % 64);
+
+    schc_packet_byte_len = __compression_handler(
+        schc_packet, schc_packet_max_byte_len, packet_direction, packet,
+        packet_byte_len, compiled_context->validated_context.context,
+        compiled_context->validated_context.context_byte_len, 1,
+        &compiled_context->compiled_rules, cached_rules,
+        &compiled_context->mapping_tables, &compiled_context->rule_programs,
+        NULL);
+    if (schc_packet_byte_len > 0) {
+      flow_cache->card_hits++;
+      return schc_packet_byte_len;
+    }
+
+    candidate_rules[cached_rule / 64] &= ~((uint64_t) 1 << (cached_rule % 64));
+  }
+
+  flow_cache->card_misses++;
+  schc_packet_byte_len = __compression_handler(
+      schc_packet, schc_packet_max_byte_len, packet_direction, packet,
+      packet_byte_len, compiled_context->validated_context.context,
+      compiled_context->validated_context.context_byte_len, 1,
+      &compiled_context->compiled_rules, candidate_rules,
+      &compiled_context->mapping_tables, &compiled_context->rule_programs,
+      &rule_index);
+
+  set_flow_rule(flow_cache, flow_hash,
+                (schc_packet_byte_len > 0) ? (uint16_t) rule_index
+                                           : FLOW_CACHE_RULE_NONE);
 
   return schc_packet_byte_len;
 }
@@ -131,17 +299,25 @@ static size_t __compression_handler(
     uint8_t* schc_packet, const size_t schc_packet_max_byte_len,
     const direction_indicator_t packet_direction, const uint8_t* packet,
     const size_t packet_byte_len, const uint8_t* context,
-    const size_t context_byte_len) {
+    const size_t context_byte_len, const int is_validated_context,
+    const compiled_rules_t* compiled_rules, const uint64_t* candidate_rules,
+    const mapping_tables_t* mapping_tables,
+    const rule_programs_t* rule_programs, unsigned int* rule_index) {
   int     schc_compression_status;
   int     index_rule_descriptor;
   uint8_t card_rule_descriptor;
   size_t  bit_position;  // Usefull to append field_residue and determine the
                          // total byte length of the final schc_packet
-  rule_descriptor_t* rule_descriptor;
+  rule_descriptor_t*    rule_descriptor;
+  const rule_program_t* rule_program;
 
   schc_compression_status = 0;  // Set to false
   index_rule_descriptor   = 0;
-  card_rule_descriptor    = context[CARD_RULE_DESCRIPTOR_OFFSET];
+
+  if (context_byte_len <= CARD_RULE_DESCRIPTOR_OFFSET) {
+    return 0;
+  }
+  card_rule_descriptor = context[CARD_RULE_DESCRIPTOR_OFFSET];
 
   // Allocate rule_descriptor from the pool
   rule_descriptor = (rule_descriptor_t*) pool_alloc(sizeof(rule_descriptor_t));
@@ -150,13 +326,28 @@ static size_t __compression_handler(
   // might not reach the default case before the last index feasible
   while (index_rule_descriptor < card_rule_descriptor &&
          !schc_compression_status) {
-    // Init
+    if (candidate_rules != NULL &&
+        !((candidate_rules[index_rule_descriptor / 64] >>
+           (index_rule_descriptor % 64)) &
+          1)) {
+      index_rule_descriptor++;
+      continue;
+    }
+
+    // Writes overwrite what the previous Rule left, rewinding is enough
     bit_position = 0;
-    memset(schc_packet, 0x00, schc_packet_max_byte_len);
 
     // Get Rule Descriptor
-    schc_compression_status = get_rule_descriptor(
-        rule_descriptor, index_rule_descriptor, context, context_byte_len);
+    if (compiled_rules != NULL) {
+      get_compiled_rule_descriptor(rule_descriptor, index_rule_descriptor,
+                                   compiled_rules);
+    } else if (is_validated_context) {
+      get_rule_descriptor_unchecked(rule_descriptor, index_rule_descriptor,
+                                    context);
+    } else if (!get_rule_descriptor(rule_descriptor, index_rule_descriptor,
+                                    context, context_byte_len)) {
+      break;
+    }
 
     // SCHC Rule ID
     schc_compression_status =
@@ -170,14 +361,28 @@ static size_t __compression_handler(
     // SCHC Packet filling
     switch (rule_descriptor->nature) {
       case NATURE_COMPRESSION:
-        schc_compression_status =
-            __compression(schc_packet, schc_packet_max_byte_len, &bit_position,
-                          packet_direction, packet, packet_byte_len,
-                          rule_descriptor, context, context_byte_len);
+        // A Rule with a Program is compressed without decoding its Rule Field
+        // Descriptors
+        rule_program = (rule_programs != NULL)
+                           ? get_rule_program(rule_programs,
+                                              index_rule_descriptor,
+                                              packet_direction, 0)
+                           : NULL;
+        if (rule_program != NULL) {
+          schc_compression_status = run_compression_program(
+              schc_packet, schc_packet_max_byte_len, &bit_position, packet,
+              packet_byte_len, rule_program, rule_programs);
+        } else {
+          schc_compression_status = __compression(
+              schc_packet, schc_packet_max_byte_len, &bit_position,
+              packet_direction, packet, packet_byte_len, rule_descriptor,
+              context, context_byte_len, is_validated_context, mapping_tables);
+        }
         break;
 
       case NATURE_FRAGMENTATION:
-        // Not implemented yet
+        // Fragmentation Rules do not compress packets, SCHC Packets are
+        // fragmented once compressed, see fragmentation.h
         schc_compression_status = 0;
         break;
 
@@ -196,6 +401,9 @@ static size_t __compression_handler(
   pool_dealloc(rule_descriptor, sizeof(rule_descriptor_t));
 
   if (schc_compression_status) {
+    if (rule_index != NULL) {
+      *rule_index = (unsigned int) index_rule_descriptor - 1;
+    }
     return BYTE_LENGTH(bit_position);
   }
 
@@ -213,7 +421,7 @@ static int __add_schc_rule_id(uint8_t*     schc_packet,
 
   rule_len = bits_counter(card_rule_descriptor - 1);
 
-  schc_compression_status = add_byte_to_buffer(
+  schc_compression_status = write_byte_to_buffer(
       schc_packet, schc_packet_max_byte_len, bit_position, rule_id, rule_len);
 
   return schc_compression_status;
@@ -228,8 +436,8 @@ static int __no_compression(uint8_t*     schc_packet,
   int schc_compression_status;
 
   schc_compression_status =
-      add_bits_to_buffer(schc_packet, schc_packet_max_byte_len, bit_position,
-                         packet, 8 * packet_byte_len);
+      write_bits_to_buffer(schc_packet, schc_packet_max_byte_len,
+                           bit_position, packet, 8 * packet_byte_len);
 
   return schc_compression_status;
 }
@@ -243,7 +451,9 @@ static int __compression(uint8_t*                    schc_packet,
                          const uint8_t* packet, const size_t packet_byte_len,
                          const rule_descriptor_t* rule_descriptor,
                          const uint8_t*           context,
-                         const size_t             context_byte_len) {
+                         const size_t             context_byte_len,
+                         const int                is_validated_context,
+                         const mapping_tables_t*  mapping_tables) {
   int                      schc_compression_status;
   int                      index_rule_field_descriptor;
   size_t                   packet_bit_position;
@@ -251,11 +461,15 @@ static int __compression(uint8_t*                    schc_packet,
   size_t                   schc_len_to_add;
   size_t                   field_residue_byte_len;
   size_t                   extracted_field_byte_len;
+  size_t                   index_coap_option;
   uint8_t                  coap_tkl;
   uint16_t                 coap_option_delta;
   uint16_t                 coap_option_length;
+  uint16_t                 coap_option_number;
   uint8_t*                 field_residue;
   uint8_t*                 extracted_field;
+  const mapping_table_t*   mapping_table;
+  coap_options_t*          coap_options;
   rule_field_descriptor_t* rule_field_descriptor;
 
   // Init
@@ -265,8 +479,12 @@ static int __compression(uint8_t*                    schc_packet,
   coap_tkl                    = 0x00;
   coap_option_delta           = 0x0000;
   coap_option_length          = 0x0000;
+  coap_option_number          = 0x0000;
+  index_coap_option           = COAP_MAX_OPTIONS;
   field_residue               = NULL;
   extracted_field             = NULL;
+  mapping_table               = NULL;
+  coap_options                = NULL;
   rule_field_descriptor       = NULL;
 
   // Allocate rule_field_descriptor from the pool
@@ -277,12 +495,22 @@ static int __compression(uint8_t*                    schc_packet,
              rule_descriptor->card_rule_field_descriptor &&
          schc_compression_status) {
     // Get Rule Field Descriptor
-    schc_compression_status = get_rule_field_descriptor(
-        rule_field_descriptor, index_rule_field_descriptor,
-        rule_descriptor->offset, context, context_byte_len);
+    if (rule_descriptor->compiled_rule != NULL) {
+      get_compiled_rule_field_descriptor(rule_field_descriptor,
+                                         index_rule_field_descriptor,
+                                         rule_descriptor->compiled_rule);
+    } else if (is_validated_context) {
+      get_rule_field_descriptor_unchecked(
+          rule_field_descriptor, index_rule_field_descriptor,
+          rule_descriptor->offset, context);
+    } else {
+      schc_compression_status = get_rule_field_descriptor(
+          rule_field_descriptor, index_rule_field_descriptor,
+          rule_descriptor->offset, context, context_byte_len);
 
-    if (!schc_compression_status) {
-      break;
+      if (!schc_compression_status) {
+        break;
+      }
     }
 
     // Check if the Rule Field Descriptor DI corresponds to the Packet DI
@@ -293,7 +521,21 @@ static int __compression(uint8_t*                    schc_packet,
     }
 
     // Set the bit length to extract
-    if (rule_field_descriptor->len == 0) {
+    if (get_coap_option_number(rule_field_descriptor->sid) > 0) {
+      // Allocate coap_options from the pool
+      if (coap_options == NULL) {
+        coap_options = (coap_options_t*) pool_alloc(sizeof(coap_options_t));
+      }
+
+      schc_compression_status = __get_coap_option(
+          &packet_bit_position, &schc_len_to_add, coap_options,
+          &index_coap_option, &coap_option_number, rule_field_descriptor,
+          packet, packet_byte_len);
+
+      if (!schc_compression_status) {
+        break;
+      }
+    } else if (rule_field_descriptor->len == 0) {
       if (rule_field_descriptor->sid == SID_COAP_TOKEN) {
         schc_len_to_add = 8 * coap_tkl;
       } else if (rule_field_descriptor->sid == SID_COAP_OPTION_DELTA_EXTENDED) {
@@ -322,6 +564,9 @@ static int __compression(uint8_t*                    schc_packet,
                      &packet_bit_position, packet, packet_byte_len);
 
     if (!schc_compression_status) {
+      // e.g. a packet shorter than the Fields of the Rule. The pool lives as
+      // long as the thread, nothing must be left allocated.
+      pool_dealloc(extracted_field, sizeof(uint8_t) * extracted_field_byte_len);
       break;
     }
 
@@ -339,6 +584,10 @@ static int __compression(uint8_t*                    schc_packet,
       set_coap_option_variable_length(&coap_option_length, extracted_field,
                                       extracted_field_byte_len,
                                       rule_field_descriptor->sid);
+    } else if (rule_field_descriptor->sid == SID_COAP_OPTION_VALUE) {
+      // The Options that follow are parsed again from the new position
+      coap_option_number += coap_option_delta;
+      index_coap_option   = COAP_MAX_OPTIONS;
     }
 
     // Compress the extracted_field
@@ -374,10 +623,21 @@ static int __compression(uint8_t*                    schc_packet,
         field_residue =
             (uint8_t*) pool_alloc(sizeof(uint8_t) * field_residue_byte_len);
 
-        // Apply Mapping Sent on the extracted_field
-        schc_compression_status =
-            CDA_mapping_sent(field_residue, extracted_field,
-                             rule_field_descriptor, context, context_byte_len);
+        // Apply Mapping Sent on the extracted_field, with a binary search in
+        // its Mapping Table if it has one
+        mapping_table = (mapping_tables != NULL)
+                            ? get_mapping_table(mapping_tables,
+                                                rule_field_descriptor)
+                            : NULL;
+        if (mapping_table != NULL) {
+          schc_compression_status = lookup_mapping_table(
+              field_residue, extracted_field, mapping_table, context);
+        } else {
+          schc_compression_status =
+              CDA_mapping_sent(field_residue, extracted_field,
+                               rule_field_descriptor, context,
+                               context_byte_len);
+        }
         break;
 
       case CDA_NOT_SENT:
@@ -412,41 +672,38 @@ static int __compression(uint8_t*                    schc_packet,
     }
 
     // Add Field Residue or Extracted Field to SCHC Packet
-    if (schc_len_to_add > 0) {
-      if (rule_field_descriptor->cda == CDA_VALUE_SENT &&
-          schc_compression_status) {
-        schc_compression_status =
-            add_bits_to_buffer(schc_packet, schc_packet_max_byte_len,
-                               bit_position, extracted_field, schc_len_to_add);
-      } else if (rule_field_descriptor->cda != CDA_VALUE_SENT &&
-                 !schc_compression_status) {
-        // This statement is only in case of error. Indeed, if compression
-        // status is false. We still need to deallocate field_residue.
-        pool_dealloc(field_residue, sizeof(uint8_t) * field_residue_byte_len);
-      } else {
-        schc_compression_status =
-            add_bits_to_buffer(schc_packet, schc_packet_max_byte_len,
-                               bit_position, field_residue, schc_len_to_add);
+    if (schc_len_to_add > 0 && schc_compression_status) {
+      schc_compression_status = write_bits_to_buffer(
+          schc_packet, schc_packet_max_byte_len, bit_position,
+          rule_field_descriptor->cda == CDA_VALUE_SENT ? extracted_field
+                                                       : field_residue,
+          schc_len_to_add);
+    }
 
-        // Deallocate field_residue from the pool
-        pool_dealloc(field_residue, sizeof(uint8_t) * field_residue_byte_len);
-      }
+    // Deallocate field_residue, whatever the status and even if empty, then
+    // extracted_field from the pool
+    if (field_residue != NULL) {
+      pool_dealloc(field_residue, sizeof(uint8_t) * field_residue_byte_len);
+      field_residue = NULL;
     }
+    pool_dealloc(extracted_field, sizeof(uint8_t) * extracted_field_byte_len);
 
     // Move to next Rule Field Descriptor index
     index_rule_field_descriptor++;
-
-    // Deallocate extracted_field from the pool
-    pool_dealloc(extracted_field, sizeof(uint8_t) * extracted_field_byte_len);
   }
 
   // Add payload at the end of the SCHC Packet.
   if (schc_compression_status) {
     payload_byte_position = BYTE_LENGTH(packet_bit_position);
     schc_compression_status =
-        add_bits_to_buffer(schc_packet, schc_packet_max_byte_len, bit_position,
-                           packet + payload_byte_position,
-                           8 * (packet_byte_len - payload_byte_position));
+        write_bits_to_buffer(schc_packet, schc_packet_max_byte_len,
+                             bit_position, packet + payload_byte_position,
+                             8 * (packet_byte_len - payload_byte_position));
+  }
+
+  // Deallocate coap_options from the pool
+  if (coap_options != NULL) {
+    pool_dealloc(coap_options, sizeof(coap_options_t));
   }
 
   // Deallocate rule_field_descriptor from the pool
@@ -460,41 +717,54 @@ static int __compression(uint8_t*                    schc_packet,
 static int __variable_length_encoding(uint8_t*     schc_packet,
                                       const size_t schc_packet_max_byte_len,
                                       size_t*      bit_position,
-                                      const int    variable_len) {
-  int      schc_compression_status;
-  size_t   variable_length_len;
-  uint8_t* variable_length_residue;
-
-  // Steps:
-  // 1. Allocate the right memory space in order to determine the Variable
-  // Length Residue.
-  // 2. Determine the corresponding Residue.
-  // 3. Add the Residue to the SCHC Packet.
-  if (variable_len < 15) {
-    variable_length_residue    = (uint8_t*) pool_alloc(sizeof(uint8_t));
-    variable_length_len        = 4;
-    variable_length_residue[0] = variable_len;
-  } else if (variable_len < 255) {
-    variable_length_residue    = (uint8_t*) pool_alloc(sizeof(uint8_t) * 2);
-    variable_length_len        = 12;
-    variable_length_residue[0] = 0x0f;
-    variable_length_residue[1] = variable_len;
-  } else {
-    variable_length_residue    = (uint8_t*) pool_alloc(sizeof(uint8_t) * 4);
-    variable_length_len        = 28;
-    variable_length_residue[0] = 0x0f;
-    variable_length_residue[1] = 0xff;
-    variable_length_residue[2] = (uint8_t) (variable_len >> 8);
-    variable_length_residue[3] = (uint8_t) (variable_len & 0xff);
+                                      const size_t variable_len) {
+  // The length is sent in bytes, which CoAP Tokens and Options always are
+  if (variable_len % 8 != 0) {
+    return 0;
   }
 
-  schc_compression_status =
-      add_bits_to_buffer(schc_packet, schc_packet_max_byte_len, bit_position,
-                         variable_length_residue, variable_length_len);
+  return write_variable_length(schc_packet, schc_packet_max_byte_len,
+                               bit_position, variable_len / 8);
+}
 
-  // Deallocate variable_length_residue from the pool
-  pool_dealloc(variable_length_residue,
-               sizeof(uint8_t) * BYTE_LENGTH(variable_length_len));
+/* ********************************************************************** */
 
-  return schc_compression_status;
+static int __get_coap_option(
+    size_t* packet_bit_position, size_t* option_value_len,
+    coap_options_t* coap_options, size_t* index_coap_option,
+    uint16_t*                      coap_option_number,
+    const rule_field_descriptor_t* rule_field_descriptor,
+    const uint8_t* packet, const size_t packet_byte_len) {
+  coap_option_t* coap_option;
+
+  // Parse the CoAP Options once, they start on a byte boundary
+  if (*index_coap_option == COAP_MAX_OPTIONS) {
+    if (*packet_bit_position % 8 != 0 ||
+        !parse_coap_options(coap_options, packet, packet_byte_len,
+                            *packet_bit_position / 8, *coap_option_number)) {
+      return 0;
+    }
+    *index_coap_option = 0;
+  }
+
+  if (*index_coap_option >= coap_options->card_options) {
+    return 0;
+  }
+
+  coap_option = &coap_options->options[*index_coap_option];
+  if (coap_option->number !=
+          get_coap_option_number(rule_field_descriptor->sid) ||
+      (rule_field_descriptor->pos != 0 &&
+       rule_field_descriptor->pos != coap_option->position) ||
+      (rule_field_descriptor->len != 0 &&
+       rule_field_descriptor->len != 8 * coap_option->length)) {
+    return 0;
+  }
+
+  *packet_bit_position = 8 * coap_option->value_offset;
+  *option_value_len    = 8 * coap_option->length;
+  *coap_option_number  = coap_option->number;
+  (*index_coap_option)++;
+
+  return 1;
 }
\ No newline at end of file
@@ -1,6 +1,27 @@
 #include "context.h"
+#include "fragmentation_descriptor.h"
+#include "utils/binary.h"
 #include "utils/memory.h"
 
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks that a Rule Descriptor and all its Rule Field Descriptors are
+ * consistent.
+ *
+ * @param rule_descriptor_offset Offset of the Rule Descriptor in the context.
+ * @param context Pointer to the SCHC Context.
+ * @param context_byte_len Byte length of the context.
+ * @return The validation status code, 1 for success, otherwise 0.
+ */
+static int __validate_rule_descriptor(const uint16_t rule_descriptor_offset,
+                                      const uint8_t *context,
+                                      const size_t   context_byte_len);
+
 /* ********************************************************************** */
 
 int get_cardinal_compute_entries(const rule_descriptor_t *rule_descriptor,
@@ -38,4 +59,97 @@ int get_cardinal_compute_entries(const rule_descriptor_t *rule_descriptor,
   pool_dealloc(rule_field_descriptor, sizeof(rule_field_descriptor_t));
 
   return card_compute_entries;
+}
+
+/* ********************************************************************** */
+
+int context_validate(validated_context_t *validated_context,
+                     const uint8_t *context, const size_t context_byte_len) {
+  uint8_t  card_rule_descriptor;
+  uint8_t  rule_id;
+  size_t   rule_id_len;
+  uint16_t rule_descriptor_offset;
+  uint8_t  used_rule_ids[32];  // One bit per possible Rule ID
+
+  validated_context->context          = NULL;
+  validated_context->context_byte_len = 0;
+
+  if (context == NULL || context_byte_len <= CARD_RULE_DESCRIPTOR_OFFSET) {
+    return 0;
+  }
+
+  card_rule_descriptor = context[CARD_RULE_DESCRIPTOR_OFFSET];
+  if (card_rule_descriptor == 0 ||
+      2 + 2 * (size_t) card_rule_descriptor > context_byte_len) {
+    return 0;
+  }
+
+  rule_id_len = bits_counter(card_rule_descriptor - 1);
+  memset(used_rule_ids, 0x00, sizeof(used_rule_ids));
+
+  for (unsigned int index = 0; index < card_rule_descriptor; index++) {
+    rule_descriptor_offset =
+        merge_uint8_t(context[2 + 2 * index], context[2 + 2 * index + 1]);
+
+    if (!__validate_rule_descriptor(rule_descriptor_offset, context,
+                                    context_byte_len)) {
+      return 0;
+    }
+
+    // The Rule ID is sent on rule_id_len bits and identifies a single Rule
+    // Descriptor during decompression
+    rule_id = context[rule_descriptor_offset];
+    if ((rule_id >> rule_id_len) != 0 ||
+        (used_rule_ids[rule_id / 8] >> (rule_id % 8)) & 0x01) {
+      return 0;
+    }
+    used_rule_ids[rule_id / 8] |= (uint8_t) (1 << (rule_id % 8));
+  }
+
+  validated_context->context          = context;
+  validated_context->context_byte_len = context_byte_len;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __validate_rule_descriptor(const uint16_t rule_descriptor_offset,
+                                      const uint8_t *context,
+                                      const size_t   context_byte_len) {
+  uint8_t  card_rule_field_descriptor;
+  uint16_t rule_field_descriptor_offset;
+  size_t   position;
+
+  // ID, Nature and number of Rule Field Descriptors
+  if ((size_t) rule_descriptor_offset + 3 > context_byte_len ||
+      context[rule_descriptor_offset + 1] > NATURE_FRAGMENTATION) {
+    return 0;
+  }
+
+  if (context[rule_descriptor_offset + 1] == NATURE_FRAGMENTATION) {
+    return validate_fragmentation_descriptor(rule_descriptor_offset, context,
+                                             context_byte_len);
+  }
+
+  card_rule_field_descriptor = context[rule_descriptor_offset + 2];
+  position                   = (size_t) rule_descriptor_offset + 3;
+  if (position + 2 * (size_t) card_rule_field_descriptor > context_byte_len) {
+    return 0;
+  }
+
+  for (uint8_t index = 0; index < card_rule_field_descriptor; index++) {
+    rule_field_descriptor_offset =
+        merge_uint8_t(context[position + 2 * index],
+                      context[position + 2 * index + 1]);
+
+    if (!validate_rule_field_descriptor(rule_field_descriptor_offset, context,
+                                        context_byte_len)) {
+      return 0;
+    }
+  }
+
+  return 1;
 }
\ No newline at end of file
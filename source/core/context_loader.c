@@ -0,0 +1,65 @@
+#include "context_loader.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* ********************************************************************** */
+
+int load_context_file(validated_context_t *validated_context,
+                      const char          *path) {
+  int         fd;
+  void       *mapping;
+  size_t      context_byte_len;
+  struct stat file_stat;
+
+  validated_context->context          = NULL;
+  validated_context->context_byte_len = 0;
+
+  fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return 0;
+  }
+
+  if (fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0) {
+    close(fd);
+    return 0;
+  }
+  context_byte_len = (size_t) file_stat.st_size;
+
+  // The pages of a private read-only mapping are never copied, so every process
+  // using the same Context file still shares them through the page cache. Being
+  // private does not shield them from the file: a write to it shows through,
+  // and truncating it faults the reads, hence the requirement of
+  // context_loader.h that the file is not modified while it is mapped. The
+  // descriptor is not needed once the mapping exists.
+  mapping = mmap(NULL, context_byte_len, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+
+  if (mapping == MAP_FAILED) {
+    return 0;
+  }
+
+  if (!context_validate(validated_context, (const uint8_t *) mapping,
+                        context_byte_len)) {
+    munmap(mapping, context_byte_len);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void unload_context_file(validated_context_t *validated_context) {
+  if (validated_context->context == NULL) {
+    return;
+  }
+
+  munmap((void *) validated_context->context,
+         validated_context->context_byte_len);
+
+  validated_context->context          = NULL;
+  validated_context->context_byte_len = 0;
+}
\ No newline at end of file
@@ -0,0 +1,590 @@
+#include "context_registry.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Replaces the Compiled Context of a slot and releases the previous
+ * one.
+ *
+ * @details The writer mutex must be held. compiled_context must already
+ * account for the reference held by the slot.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param context_id The Context ID of the slot.
+ * @param compiled_context Pointer to the new Compiled Context, or NULL.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __replace_context(context_registry_t *registry,
+                             const uint8_t       context_id,
+                             compiled_context_t *compiled_context);
+
+/**
+ * @brief Finds a published Compiled Context holding the same Rules.
+ *
+ * @details The writer mutex must be held.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param compiled_context Pointer to the Compiled Context to look for.
+ * @return A pointer to the published Compiled Context, or NULL.
+ */
+static compiled_context_t *__find_same_rules(
+    context_registry_t *registry, const compiled_context_t *compiled_context);
+
+/**
+ * @brief Adds an unpublished object to the list of retired objects, along
+ * with the current epoch, and moves to the next epoch.
+ *
+ * @details The writer mutex must be held. The object must already be
+ * unpublished: readers that lock from the next epoch on cannot reach it.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @param retired Pointer to the retired entry to fill, allocated beforehand
+ * so that the retirement itself cannot fail.
+ * @param object Pointer to the object to retire.
+ * @param free_object Function freeing object.
+ */
+static void __retire_object(context_registry_t *registry,
+                            retired_object_t *retired, void *object,
+                            void (*free_object)(void *));
+
+/**
+ * @brief Frees the retired objects that no reader can reference anymore.
+ *
+ * @details The writer mutex must be held.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @return The number of retired objects still waiting for readers.
+ */
+static size_t __reclaim_objects(context_registry_t *registry);
+
+/**
+ * @brief Frees a retired Compiled Context.
+ *
+ * @param object Pointer to the Compiled Context.
+ */
+static void __free_compiled_context(void *object);
+
+/**
+ * @brief Allocates an empty Device Table.
+ *
+ * @param capacity Number of entries, a power of 2.
+ * @return A pointer to the Device Table, or NULL if memory is exhausted.
+ */
+static device_table_t *__create_device_table(const size_t capacity);
+
+/**
+ * @brief Publishes a Device Table twice as large as the current one.
+ *
+ * @details The writer mutex must be held. The larger table is filled before
+ * being published, readers of the current one are not disturbed.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __grow_device_table(context_registry_t *registry);
+
+/**
+ * @brief Finds the entry of a device, or the free entry where it would be
+ * inserted.
+ *
+ * @param device_table Pointer to the Device Table.
+ * @param device_id The device ID.
+ * @return A pointer to the entry, NULL only if the table is full.
+ */
+static device_entry_t *__find_device_entry(device_table_t *device_table,
+                                           const uint64_t  device_id);
+
+/**
+ * @brief Mixes the bits of a device ID (splitmix64 finalizer), so that
+ * sequential IDs spread over the Device Table.
+ *
+ * @param device_id The device ID.
+ * @return The hash of the device ID.
+ */
+static uint64_t __hash_device_id(uint64_t device_id);
+
+/* ********************************************************************** */
+
+context_registry_t *create_context_registry(void) {
+  context_registry_t *registry;
+  device_table_t     *device_table;
+
+  // Readers are aligned on cache lines, so is the registry
+  registry = (context_registry_t *) aligned_alloc(_Alignof(context_registry_t),
+                                                  sizeof(context_registry_t));
+  if (registry == NULL) {
+    return NULL;
+  }
+  memset(registry, 0x00, sizeof(context_registry_t));
+
+  device_table = __create_device_table(DEVICE_TABLE_MIN_CAPACITY);
+  if (device_table == NULL) {
+    free(registry);
+    return NULL;
+  }
+
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_SLOTS; index++) {
+    atomic_init(&registry->slots[index], NULL);
+  }
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_MAX_READERS; index++) {
+    atomic_init(&registry->readers[index].epoch, CONTEXT_READER_OFFLINE);
+  }
+  atomic_init(&registry->device_table, device_table);
+  atomic_init(&registry->global_epoch, 0);
+
+  if (pthread_mutex_init(&registry->writer_mutex, NULL) != 0) {
+    free(device_table);
+    free(registry);
+    return NULL;
+  }
+
+  return registry;
+}
+
+/* ********************************************************************** */
+
+void destroy_context_registry(context_registry_t *registry) {
+  compiled_context_t *compiled_context;
+  retired_object_t   *retired;
+
+  if (registry == NULL) {
+    return;
+  }
+
+  // A shared Compiled Context is freed with its last reference
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_SLOTS; index++) {
+    compiled_context = atomic_load(&registry->slots[index]);
+    if (compiled_context != NULL && --compiled_context->card_references == 0) {
+      free_compiled_context(compiled_context);
+    }
+  }
+
+  while (registry->retired != NULL) {
+    retired           = registry->retired;
+    registry->retired = retired->next;
+    retired->free_object(retired->object);
+    free(retired);
+  }
+
+  free(atomic_load(&registry->device_table));
+  pthread_mutex_destroy(&registry->writer_mutex);
+  free(registry);
+}
+
+/* ********************************************************************** */
+
+context_reader_t *register_context_reader(context_registry_t *registry) {
+  context_reader_t *reader;
+
+  reader = NULL;
+
+  pthread_mutex_lock(&registry->writer_mutex);
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_MAX_READERS; index++) {
+    if (!registry->readers[index].in_use) {
+      reader         = &registry->readers[index];
+      reader->in_use = 1;
+      atomic_store(&reader->epoch, CONTEXT_READER_OFFLINE);
+      break;
+    }
+  }
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return reader;
+}
+
+/* ********************************************************************** */
+
+void unregister_context_reader(context_registry_t *registry,
+                               context_reader_t   *reader) {
+  pthread_mutex_lock(&registry->writer_mutex);
+  atomic_store(&reader->epoch, CONTEXT_READER_OFFLINE);
+  reader->in_use = 0;
+  pthread_mutex_unlock(&registry->writer_mutex);
+}
+
+/* ********************************************************************** */
+
+void context_reader_lock(context_registry_t *registry,
+                         context_reader_t   *reader) {
+  // Sequentially consistent: the epoch must be visible to writers before any
+  // slot is read, otherwise a writer could free a Context loaded afterwards
+  atomic_store(&reader->epoch, atomic_load(&registry->global_epoch));
+}
+
+/* ********************************************************************** */
+
+void context_reader_unlock(context_reader_t *reader) {
+  atomic_store_explicit(&reader->epoch, CONTEXT_READER_OFFLINE,
+                        memory_order_release);
+}
+
+/* ********************************************************************** */
+
+const compiled_context_t *get_published_context(
+    context_registry_t *registry, const uint8_t context_id) {
+  return atomic_load_explicit(&registry->slots[context_id],
+                              memory_order_acquire);
+}
+
+/* ********************************************************************** */
+
+const compiled_context_t *get_device_context(context_registry_t *registry,
+                                             const uint64_t      device_id) {
+  device_table_t *device_table;
+  device_entry_t *device_entry;
+  uint16_t        context_id;
+
+  device_table =
+      atomic_load_explicit(&registry->device_table, memory_order_acquire);
+  device_entry = __find_device_entry(device_table, device_id);
+  if (device_entry == NULL ||
+      atomic_load_explicit(&device_entry->device_id, memory_order_acquire) !=
+          device_id) {
+    return NULL;
+  }
+
+  context_id =
+      atomic_load_explicit(&device_entry->context_id, memory_order_acquire);
+  if (context_id == DEVICE_UNBOUND) {
+    return NULL;
+  }
+
+  return get_published_context(registry, (uint8_t) context_id);
+}
+
+/* ********************************************************************** */
+
+int publish_context(context_registry_t *registry,
+                    compiled_context_t *compiled_context) {
+  int                 status;
+  uint8_t             context_id;
+  compiled_context_t *same_rules_context;
+
+  if (compiled_context == NULL) {
+    return 0;
+  }
+  context_id = compiled_context->context[0];
+
+  pthread_mutex_lock(&registry->writer_mutex);
+
+  // Share the Compiled Context of another Context ID with the same Rules
+  same_rules_context = __find_same_rules(registry, compiled_context);
+  if (same_rules_context != NULL) {
+    free_compiled_context(compiled_context);
+    compiled_context = same_rules_context;
+  }
+
+  compiled_context->card_references++;
+  status = __replace_context(registry, context_id, compiled_context);
+  if (!status && --compiled_context->card_references == 0) {
+    free_compiled_context(compiled_context);
+  }
+  __reclaim_objects(registry);
+
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+int withdraw_context(context_registry_t *registry, const uint8_t context_id) {
+  int status;
+
+  pthread_mutex_lock(&registry->writer_mutex);
+  status = atomic_load(&registry->slots[context_id]) != NULL &&
+           __replace_context(registry, context_id, NULL);
+  __reclaim_objects(registry);
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+int bind_device(context_registry_t *registry, const uint64_t device_id,
+                const uint8_t context_id) {
+  device_table_t *device_table;
+  device_entry_t *device_entry;
+
+  if (device_id == DEVICE_ID_EMPTY) {
+    return 0;
+  }
+
+  pthread_mutex_lock(&registry->writer_mutex);
+
+  device_table = atomic_load(&registry->device_table);
+  device_entry = __find_device_entry(device_table, device_id);
+
+  // An already known device only has its Context ID updated
+  if (device_entry != NULL &&
+      atomic_load(&device_entry->device_id) == device_id) {
+    atomic_store(&device_entry->context_id, context_id);
+    pthread_mutex_unlock(&registry->writer_mutex);
+    return 1;
+  }
+
+  // Keep at least half of the entries free, so that probing stays short
+  if (2 * (device_table->card_used + 1) > device_table->capacity) {
+    if (!__grow_device_table(registry)) {
+      pthread_mutex_unlock(&registry->writer_mutex);
+      return 0;
+    }
+
+    device_table = atomic_load(&registry->device_table);
+    device_entry = __find_device_entry(device_table, device_id);
+  }
+
+  // The Context ID is stored first: a reader that sees the device ID also
+  // sees its Context ID
+  atomic_store(&device_entry->context_id, context_id);
+  atomic_store(&device_entry->device_id, device_id);
+  device_table->card_used++;
+
+  __reclaim_objects(registry);
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int unbind_device(context_registry_t *registry, const uint64_t device_id) {
+  int             status;
+  device_entry_t *device_entry;
+
+  pthread_mutex_lock(&registry->writer_mutex);
+
+  device_entry =
+      __find_device_entry(atomic_load(&registry->device_table), device_id);
+  status = device_entry != NULL &&
+           atomic_load(&device_entry->device_id) == device_id &&
+           atomic_load(&device_entry->context_id) != DEVICE_UNBOUND;
+  if (status) {
+    atomic_store(&device_entry->context_id, DEVICE_UNBOUND);
+  }
+
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+size_t reclaim_contexts(context_registry_t *registry) {
+  size_t card_retired;
+
+  pthread_mutex_lock(&registry->writer_mutex);
+  card_retired = __reclaim_objects(registry);
+  pthread_mutex_unlock(&registry->writer_mutex);
+
+  return card_retired;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __replace_context(context_registry_t *registry,
+                             const uint8_t       context_id,
+                             compiled_context_t *compiled_context) {
+  compiled_context_t *previous_context;
+  retired_object_t   *retired;
+
+  previous_context = atomic_load(&registry->slots[context_id]);
+  retired          = NULL;
+
+  // The previous Compiled Context is retired with its last reference. The
+  // retired entry is allocated first, so that a failure leaves the slot
+  // untouched.
+  if (previous_context != NULL && previous_context != compiled_context &&
+      previous_context->card_references == 1) {
+    retired = (retired_object_t *) malloc(sizeof(retired_object_t));
+    if (retired == NULL) {
+      return 0;
+    }
+  }
+
+  atomic_store(&registry->slots[context_id], compiled_context);
+
+  if (previous_context != NULL) {
+    previous_context->card_references--;
+  }
+  if (retired != NULL) {
+    __retire_object(registry, retired, previous_context,
+                    __free_compiled_context);
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static compiled_context_t *__find_same_rules(
+    context_registry_t *registry, const compiled_context_t *compiled_context) {
+  compiled_context_t *published_context;
+
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_SLOTS; index++) {
+    published_context = atomic_load(&registry->slots[index]);
+
+    if (published_context != NULL &&
+        compiled_context_same_rules(published_context, compiled_context)) {
+      return published_context;
+    }
+  }
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+static void __retire_object(context_registry_t *registry,
+                            retired_object_t *retired, void *object,
+                            void (*free_object)(void *)) {
+  // Readers that lock from now on observe a newer epoch, hence cannot hold
+  // object anymore
+  retired->object       = object;
+  retired->free_object  = free_object;
+  retired->retire_epoch = atomic_fetch_add(&registry->global_epoch, 1);
+  retired->next         = registry->retired;
+  registry->retired     = retired;
+  registry->card_retired++;
+}
+
+/* ********************************************************************** */
+
+static size_t __reclaim_objects(context_registry_t *registry) {
+  uint64_t           min_reader_epoch;
+  uint64_t           reader_epoch;
+  retired_object_t **link;
+  retired_object_t  *retired;
+
+  // Oldest epoch still observed by a reader in a critical section
+  min_reader_epoch = CONTEXT_READER_OFFLINE;
+  for (unsigned int index = 0; index < CONTEXT_REGISTRY_MAX_READERS; index++) {
+    reader_epoch = atomic_load(&registry->readers[index].epoch);
+    if (reader_epoch < min_reader_epoch) {
+      min_reader_epoch = reader_epoch;
+    }
+  }
+
+  link = &registry->retired;
+  while (*link != NULL) {
+    retired = *link;
+
+    if (retired->retire_epoch < min_reader_epoch) {
+      *link = retired->next;
+      retired->free_object(retired->object);
+      free(retired);
+      registry->card_retired--;
+    } else {
+      link = &retired->next;
+    }
+  }
+
+  return registry->card_retired;
+}
+
+/* ********************************************************************** */
+
+static void __free_compiled_context(void *object) {
+  free_compiled_context((compiled_context_t *) object);
+}
+
+/* ********************************************************************** */
+
+static device_table_t *__create_device_table(const size_t capacity) {
+  device_table_t *device_table;
+
+  device_table = (device_table_t *) malloc(sizeof(device_table_t) +
+                                           capacity * sizeof(device_entry_t));
+  if (device_table == NULL) {
+    return NULL;
+  }
+
+  device_table->capacity  = capacity;
+  device_table->card_used = 0;
+  for (size_t index = 0; index < capacity; index++) {
+    atomic_init(&device_table->entries[index].device_id, DEVICE_ID_EMPTY);
+    atomic_init(&device_table->entries[index].context_id, DEVICE_UNBOUND);
+  }
+
+  return device_table;
+}
+
+/* ********************************************************************** */
+
+static int __grow_device_table(context_registry_t *registry) {
+  uint64_t          entry_device_id;
+  device_table_t   *device_table;
+  device_table_t   *larger_device_table;
+  device_entry_t   *larger_device_entry;
+  retired_object_t *retired;
+
+  device_table        = atomic_load(&registry->device_table);
+  larger_device_table = __create_device_table(2 * device_table->capacity);
+  retired = (retired_object_t *) malloc(sizeof(retired_object_t));
+  if (larger_device_table == NULL || retired == NULL) {
+    free(larger_device_table);
+    free(retired);
+    return 0;
+  }
+
+  for (size_t index = 0; index < device_table->capacity; index++) {
+    entry_device_id = atomic_load(&device_table->entries[index].device_id);
+    if (entry_device_id == DEVICE_ID_EMPTY) {
+      continue;
+    }
+
+    larger_device_entry =
+        __find_device_entry(larger_device_table, entry_device_id);
+    atomic_store(&larger_device_entry->context_id,
+                 atomic_load(&device_table->entries[index].context_id));
+    atomic_store(&larger_device_entry->device_id, entry_device_id);
+  }
+  larger_device_table->card_used = device_table->card_used;
+
+  atomic_store(&registry->device_table, larger_device_table);
+  __retire_object(registry, retired, device_table, free);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static device_entry_t *__find_device_entry(device_table_t *device_table,
+                                           const uint64_t  device_id) {
+  size_t   mask;
+  size_t   index;
+  uint64_t entry_device_id;
+
+  mask  = device_table->capacity - 1;
+  index = (size_t) __hash_device_id(device_id) & mask;
+
+  for (size_t probe = 0; probe < device_table->capacity; probe++) {
+    entry_device_id = atomic_load_explicit(
+        &device_table->entries[index].device_id, memory_order_acquire);
+
+    if (entry_device_id == device_id || entry_device_id == DEVICE_ID_EMPTY) {
+      return &device_table->entries[index];
+    }
+
+    index = (index + 1) & mask;
+  }
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+static uint64_t __hash_device_id(uint64_t device_id) {
+  device_id = (device_id ^ (device_id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  device_id = (device_id ^ (device_id >> 27)) * 0x94d049bb133111ebULL;
+
+  return device_id ^ (device_id >> 31);
+}
\ No newline at end of file
@@ -20,13 +20,21 @@
  * @param schc_packet_byte_len Byte length of the schc_packet to decompress.
  * @param context Pointer to the SCHC Context used to perform decompression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
+ * @param compiled_rules Pointer to the Compiled Rules of the context, or NULL
+ * to decode descriptors from the context.
+ * @param rule_programs Pointer to the Rule Programs of the Compiled Rules, or
+ * NULL to decompress Rule Field Descriptor by Rule Field Descriptor.
  * @return The final byte length of the decompressed SCHC Packet.
  */
 static size_t __decompression_handler(
     uint8_t *packet, const size_t packet_max_byte_len,
     const direction_indicator_t packet_direction, const uint8_t *schc_packet,
     const size_t schc_packet_byte_len, const uint8_t *context,
-    const size_t context_byte_len);
+    const size_t context_byte_len, const int is_validated_context,
+    const compiled_rules_t *compiled_rules,
+    const rule_programs_t  *rule_programs);
 
 /**
  * @brief Gets the Rule Descriptor used to perform compression and therefore
@@ -38,14 +46,16 @@ static size_t __decompression_handler(
  * @param bit_position Pointer to the current bit position of schc_packet.
  * @param context Pointer to the SCHC Context used to perform decompression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
+ * @param compiled_rules Pointer to the Compiled Rules of the context, or NULL.
  * @return The decompression status code, 1 for success, otherwise 0.
  */
-static int __get_schc_rule_descriptor(rule_descriptor_t *rule_descriptor,
-                                      const uint8_t     *schc_packet,
-                                      const size_t       schc_packet_byte_len,
-                                      size_t            *bit_position,
-                                      const uint8_t     *context,
-                                      const size_t       context_byte_len);
+static int __get_schc_rule_descriptor(
+    rule_descriptor_t *rule_descriptor, const uint8_t *schc_packet,
+    const size_t schc_packet_byte_len, size_t *bit_position,
+    const uint8_t *context, const size_t context_byte_len,
+    const int is_validated_context, const compiled_rules_t *compiled_rules);
 
 /**
  * @brief Handles Packets compressed with SCHC No-compression Nature.
@@ -76,6 +86,8 @@ static int __no_compression(uint8_t *packet, const size_t packet_max_byte_len,
  * @param rule_descriptor Pointer to the Rule Descriptor used to decompress.
  * @param context Pointer to the SCHC Context used to perform decompression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
  * @return The decompression status code, 1 for success, otherwise 0.
  */
 static int __compression(uint8_t *packet, const size_t packet_max_byte_len,
@@ -85,22 +97,32 @@ static int __compression(uint8_t *packet, const size_t packet_max_byte_len,
                          const uint8_t              *schc_packet,
                          const size_t                schc_packet_byte_len,
                          const rule_descriptor_t    *rule_descriptor,
-                         const uint8_t *context, const size_t context_byte_len);
+                         const uint8_t *context, const size_t context_byte_len,
+                         const int is_validated_context);
 
 /**
- * @brief Moves SCHC bit position according to the Variable-Length encoded
- * value.
+ * @brief Reads the length of a Variable-Length Field Residue from the SCHC
+ * Packet.
  *
+ * @details RFC 8724, Section 7.4.2. Only fields with a null length sent by
+ * CDA_LSB or CDA_VALUE_SENT carry a length, in bytes, which replaces the one
+ * deduced from the CoAP TKL or Option Length. The other fields are left
+ * untouched.
+ *
+ * @param decompressed_field_len Pointer to the bit length of the decompressed
+ * field to update.
  * @param schc_packet_bit_position Pointer to the current bit position of the
  * SCHC Packet.
+ * @param schc_packet Pointer to the SCHC Packet.
+ * @param schc_packet_byte_len Byte length of the SCHC Packet.
  * @param rule_field_descriptor Pointer to the Rule Field Descriptor of the
  * current field.
- * @param decompressed_field_len Bit length of the decompressed field.
+ * @return The decompression status code, 1 for success, otherwise 0.
  */
-static void __variable_length_decoding(
-    size_t                        *schc_packet_bit_position,
-    const rule_field_descriptor_t *rule_field_descriptor,
-    const size_t                   decompressed_field_len);
+static int __variable_length_decoding(
+    size_t *decompressed_field_len, size_t *schc_packet_bit_position,
+    const uint8_t *schc_packet, const size_t schc_packet_byte_len,
+    const rule_field_descriptor_t *rule_field_descriptor);
 
 /**
  * @brief Updates the Compute Values in the Packet.
@@ -113,6 +135,8 @@ static void __variable_length_decoding(
  * @param rule_descriptor Pointer to the current Rule Descriptor.
  * @param context Pointer to the SCHC Context used to perform decompression.
  * @param context_byte_len Byte length of the context.
+ * @param is_validated_context 1 if the context went through
+ * context_validate(...), in which case descriptors are read unchecked.
  * @return The decompression status code, 1 for success, otherwise 0.
  */
 static int __update_compute_entries(uint8_t         *packet,
@@ -121,7 +145,8 @@ static int __update_compute_entries(uint8_t         *packet,
                                     const int        card_compute_entries,
                                     const rule_descriptor_t *rule_descriptor,
                                     const uint8_t           *context,
-                                    const size_t             context_byte_len);
+                                    const size_t             context_byte_len,
+                                    const int is_validated_context);
 
 /* ********************************************************************** */
 /*                        Main decompress function                        */
@@ -136,7 +161,42 @@ size_t decompress(uint8_t *packet, const size_t packet_max_byte_len,
 
   packet_byte_len = __decompression_handler(
       packet, packet_max_byte_len, packet_direction, schc_packet,
-      schc_packet_byte_len, context, context_byte_len);
+      schc_packet_byte_len, context, context_byte_len, 0, NULL, NULL);
+
+  return packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+size_t decompress_validated(uint8_t *packet, const size_t packet_max_byte_len,
+                            const direction_indicator_t packet_direction,
+                            const uint8_t              *schc_packet,
+                            const size_t                schc_packet_byte_len,
+                            const validated_context_t  *validated_context) {
+  size_t packet_byte_len;
+
+  packet_byte_len = __decompression_handler(
+      packet, packet_max_byte_len, packet_direction, schc_packet,
+      schc_packet_byte_len, validated_context->context,
+      validated_context->context_byte_len, 1, NULL, NULL);
+
+  return packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+size_t decompress_compiled(uint8_t *packet, const size_t packet_max_byte_len,
+                           const direction_indicator_t packet_direction,
+                           const uint8_t              *schc_packet,
+                           const size_t                schc_packet_byte_len,
+                           const compiled_context_t   *compiled_context) {
+  size_t packet_byte_len;
+
+  packet_byte_len = __decompression_handler(
+      packet, packet_max_byte_len, packet_direction, schc_packet,
+      schc_packet_byte_len, compiled_context->validated_context.context,
+      compiled_context->validated_context.context_byte_len, 1,
+      &compiled_context->compiled_rules, &compiled_context->rule_programs);
 
   return packet_byte_len;
 }
@@ -149,17 +209,25 @@ static size_t __decompression_handler(
     uint8_t *packet, const size_t packet_max_byte_len,
     const direction_indicator_t packet_direction, const uint8_t *schc_packet,
     const size_t schc_packet_byte_len, const uint8_t *context,
-    const size_t context_byte_len) {
+    const size_t context_byte_len, const int is_validated_context,
+    const compiled_rules_t *compiled_rules,
+    const rule_programs_t  *rule_programs) {
   int                schc_decompression_status;
   size_t             schc_packet_bit_position;
   size_t             packet_bit_position;
-  size_t             packet_byte_len;
-  rule_descriptor_t *rule_descriptor;
+  size_t                packet_byte_len;
+  rule_descriptor_t    *rule_descriptor;
+  const rule_program_t *rule_program;
 
   schc_packet_bit_position = 0;
   packet_bit_position      = 0;
   packet_byte_len          = 0;
 
+  if (context_byte_len <= CARD_RULE_DESCRIPTOR_OFFSET ||
+      schc_packet_byte_len == 0) {
+    return 0;
+  }
+
   // Allocate rule_descriptor from the pool
   rule_descriptor = (rule_descriptor_t *) pool_alloc(sizeof(rule_descriptor_t));
 
@@ -167,9 +235,12 @@ static size_t __decompression_handler(
   // packet.
   schc_decompression_status = __get_schc_rule_descriptor(
       rule_descriptor, schc_packet, schc_packet_byte_len,
-      &schc_packet_bit_position, context, context_byte_len);
+      &schc_packet_bit_position, context, context_byte_len,
+      is_validated_context, compiled_rules);
 
   if (!schc_decompression_status) {
+    // Deallocate rule_descriptor from the pool
+    pool_dealloc(rule_descriptor, sizeof(rule_descriptor_t));
     return schc_decompression_status;
   }
 
@@ -179,10 +250,26 @@ static size_t __decompression_handler(
   // Packet filling
   switch (rule_descriptor->nature) {
     case NATURE_COMPRESSION:
-      schc_decompression_status = __compression(
-          packet, packet_max_byte_len, &packet_bit_position,
-          schc_packet_bit_position, packet_direction, schc_packet,
-          schc_packet_byte_len, rule_descriptor, context, context_byte_len);
+      // A Rule with a Program is decompressed without decoding its Rule Field
+      // Descriptors
+      rule_program = (rule_programs != NULL)
+                         ? get_rule_program(rule_programs,
+                                            rule_descriptor->compiled_rule -
+                                                compiled_rules->rules,
+                                            packet_direction, 1)
+                         : NULL;
+      if (rule_program != NULL) {
+        schc_decompression_status = run_decompression_program(
+            packet, packet_max_byte_len, &packet_bit_position,
+            schc_packet_bit_position, schc_packet, schc_packet_byte_len,
+            rule_program, context);
+      } else {
+        schc_decompression_status = __compression(
+            packet, packet_max_byte_len, &packet_bit_position,
+            schc_packet_bit_position, packet_direction, schc_packet,
+            schc_packet_byte_len, rule_descriptor, context, context_byte_len,
+            is_validated_context);
+      }
 
       if (schc_decompression_status) {
         packet_byte_len = BYTE_LENGTH(packet_bit_position);
@@ -191,7 +278,8 @@ static size_t __decompression_handler(
       break;
 
     case NATURE_FRAGMENTATION:
-      // Not implemented yet
+      // SCHC Fragments are reassembled into a SCHC Packet before being
+      // decompressed, see fragmentation.h
       schc_decompression_status = 0;
       break;
 
@@ -215,12 +303,11 @@ static size_t __decompression_handler(
 
 /* ********************************************************************** */
 
-static int __get_schc_rule_descriptor(rule_descriptor_t *rule_descriptor,
-                                      const uint8_t     *schc_packet,
-                                      const size_t       schc_packet_byte_len,
-                                      size_t            *bit_position,
-                                      const uint8_t     *context,
-                                      const size_t       context_byte_len) {
+static int __get_schc_rule_descriptor(
+    rule_descriptor_t *rule_descriptor, const uint8_t *schc_packet,
+    const size_t schc_packet_byte_len, size_t *bit_position,
+    const uint8_t *context, const size_t context_byte_len,
+    const int is_validated_context, const compiled_rules_t *compiled_rules) {
   uint8_t card_rule_descriptor;
   uint8_t schc_packet_rule_id;
   size_t  rule_len;
@@ -232,8 +319,16 @@ static int __get_schc_rule_descriptor(rule_descriptor_t *rule_descriptor,
   for (uint8_t index_rule_descriptor = 0;
        index_rule_descriptor < card_rule_descriptor; index_rule_descriptor++) {
     // Get Rule Descriptor
-    get_rule_descriptor(rule_descriptor, index_rule_descriptor, context,
-                        context_byte_len);
+    if (compiled_rules != NULL) {
+      get_compiled_rule_descriptor(rule_descriptor, index_rule_descriptor,
+                                   compiled_rules);
+    } else if (is_validated_context) {
+      get_rule_descriptor_unchecked(rule_descriptor, index_rule_descriptor,
+                                    context);
+    } else if (!get_rule_descriptor(rule_descriptor, index_rule_descriptor,
+                                    context, context_byte_len)) {
+      return 0;
+    }
 
     if (schc_packet_rule_id == rule_descriptor->id) {
       *bit_position += rule_len;
@@ -264,11 +359,12 @@ static int __compression(
     size_t *packet_bit_position, size_t schc_packet_bit_position,
     const direction_indicator_t packet_direction, const uint8_t *schc_packet,
     const size_t schc_packet_byte_len, const rule_descriptor_t *rule_descriptor,
-    const uint8_t *context, const size_t context_byte_len) {
+    const uint8_t *context, const size_t context_byte_len,
+    const int is_validated_context) {
   int                      schc_decompression_status;
   int                      index_rule_field_descriptor;
   int                      index_compute_entry;
-  int                      card_compute_entries;
+  int                      max_compute_entries;
   size_t                   payload_byte_position;
   size_t                   decompressed_field_len;
   size_t                   schc_len_to_decompress;
@@ -276,9 +372,13 @@ static int __compression(
   size_t                   extracted_field_residue_byte_len;
   size_t                   decompressed_field_byte_len;
   size_t                   payload_byte_len;
+  size_t                   payload_bit_len;
   uint8_t                  coap_tkl;
   uint16_t                 coap_option_delta;
   uint16_t                 coap_option_length;
+  uint16_t                 coap_option_number;
+  uint16_t                 coap_option_position;
+  uint16_t                 option_number;
   uint16_t                 target_value_offset;
   uint8_t                 *extracted_field_residue;
   uint8_t                 *decompressed_field;
@@ -289,22 +389,25 @@ static int __compression(
   schc_decompression_status   = 1;
   index_rule_field_descriptor = 0;
   index_compute_entry         = 0;
-  card_compute_entries =
-      get_cardinal_compute_entries(rule_descriptor, context, context_byte_len);
-  msb_bit_position        = 0;
-  coap_tkl                = 0x00;
-  coap_option_delta       = 0x0000;
-  coap_option_length      = 0x0000;
-  extracted_field_residue = NULL;
-  decompressed_field      = NULL;
-  payload                 = NULL;
-  rule_field_descriptor   = NULL;
-  compute_entries         = NULL;
-
-  // Allocate compute_entries from the pool
-  if (card_compute_entries > 0) {
+  max_compute_entries         = rule_descriptor->card_rule_field_descriptor;
+  msb_bit_position            = 0;
+  coap_tkl                    = 0x00;
+  coap_option_delta           = 0x0000;
+  coap_option_length          = 0x0000;
+  coap_option_number          = 0x0000;
+  coap_option_position        = 0x0000;
+  extracted_field_residue     = NULL;
+  decompressed_field          = NULL;
+  payload                     = NULL;
+  rule_field_descriptor       = NULL;
+  compute_entries             = NULL;
+
+  // Allocate compute_entries from the pool. Every Rule Field Descriptor may
+  // use CDA_COMPUTE, which avoids a first pass over the Rule Descriptor to
+  // count them.
+  if (max_compute_entries > 0) {
     compute_entries = (compute_entry_t *) pool_alloc(sizeof(compute_entry_t) *
-                                                     card_compute_entries);
+                                                     max_compute_entries);
   }
 
   // Allocate rule_field_descriptor from the pool
@@ -315,12 +418,22 @@ static int __compression(
              rule_descriptor->card_rule_field_descriptor &&
          schc_decompression_status) {
     // Get Rule Field Descriptor
-    schc_decompression_status = get_rule_field_descriptor(
-        rule_field_descriptor, index_rule_field_descriptor,
-        rule_descriptor->offset, context, context_byte_len);
+    if (rule_descriptor->compiled_rule != NULL) {
+      get_compiled_rule_field_descriptor(rule_field_descriptor,
+                                         index_rule_field_descriptor,
+                                         rule_descriptor->compiled_rule);
+    } else if (is_validated_context) {
+      get_rule_field_descriptor_unchecked(
+          rule_field_descriptor, index_rule_field_descriptor,
+          rule_descriptor->offset, context);
+    } else {
+      schc_decompression_status = get_rule_field_descriptor(
+          rule_field_descriptor, index_rule_field_descriptor,
+          rule_descriptor->offset, context, context_byte_len);
 
-    if (!schc_decompression_status) {
-      break;
+      if (!schc_decompression_status) {
+        break;
+      }
     }
 
     // Check if the Rule Field Descriptor DI corresponds to the packet DI
@@ -344,20 +457,27 @@ static int __compression(
       } else if (rule_field_descriptor->sid == SID_COAP_OPTION_VALUE) {
         decompressed_field_len = get_coap_option_bit_length(
             coap_option_length, rule_field_descriptor->sid);
+      } else {  // A whole CoAP Option, its length is sent
+        decompressed_field_len = 0;
       }
     } else {
       decompressed_field_len = rule_field_descriptor->len;
     }
 
+    // Variable-Length Decoding
+    schc_decompression_status = __variable_length_decoding(
+        &decompressed_field_len, &schc_packet_bit_position, schc_packet,
+        schc_packet_byte_len, rule_field_descriptor);
+
+    if (!schc_decompression_status) {
+      break;
+    }
+
     // Allocate decompressed_field from the pool
     decompressed_field_byte_len = BYTE_LENGTH(decompressed_field_len);
     decompressed_field =
         (uint8_t *) pool_alloc(sizeof(uint8_t) * decompressed_field_byte_len);
 
-    // Variable-Length Decoding
-    __variable_length_decoding(&schc_packet_bit_position, rule_field_descriptor,
-                               decompressed_field_len);
-
     switch (rule_field_descriptor->cda) {
       case CDA_LSB:
         // Add MSB part from the Context to the decompressed_field
@@ -365,9 +485,16 @@ static int __compression(
                context + rule_field_descriptor->first_target_value_offset,
                BYTE_LENGTH(rule_field_descriptor->msb_len));
 
+        // The LSB part is ORed into the bytes following the MSB part, they
+        // must be cleared as the pool memory is not
+        memset(decompressed_field + BYTE_LENGTH(rule_field_descriptor->msb_len),
+               0x00,
+               decompressed_field_byte_len -
+                   BYTE_LENGTH(rule_field_descriptor->msb_len));
+
         // Update the bit length
         schc_len_to_decompress =
-            rule_field_descriptor->len - rule_field_descriptor->msb_len;
+            decompressed_field_len - rule_field_descriptor->msb_len;
 
         // Allocate extracted_field_residue from the pool
         extracted_field_residue_byte_len = BYTE_LENGTH(schc_len_to_decompress);
@@ -381,6 +508,9 @@ static int __compression(
             schc_packet_byte_len);
 
         if (!schc_decompression_status) {
+          // Deallocate extracted_field_residue from the pool
+          pool_dealloc(extracted_field_residue,
+                       sizeof(uint8_t) * extracted_field_residue_byte_len);
           break;
         }
 
@@ -418,7 +548,18 @@ static int __compression(
             schc_len_to_decompress, &schc_packet_bit_position, schc_packet,
             schc_packet_byte_len);
 
+        // The mapping index comes from the SCHC Packet, it is the only offset
+        // that the Context validation cannot prove to be in range
+        if (schc_decompression_status &&
+            *extracted_field_residue >=
+                rule_field_descriptor->card_target_value) {
+          schc_decompression_status = 0;
+        }
+
         if (!schc_decompression_status) {
+          // Deallocate extracted_field_residue from the pool
+          pool_dealloc(extracted_field_residue,
+                       sizeof(uint8_t) * extracted_field_residue_byte_len);
           break;
         }
 
@@ -433,8 +574,15 @@ static int __compression(
               context[rule_field_descriptor->first_target_value_offset +
                       2 * (*extracted_field_residue) + 1]);
         }
-        memcpy(decompressed_field, context + target_value_offset,
-               decompressed_field_byte_len);
+
+        // A Variable-Length Field takes its length from the SCHC Packet
+        if ((size_t) target_value_offset + decompressed_field_byte_len <=
+            context_byte_len) {
+          memcpy(decompressed_field, context + target_value_offset,
+                 decompressed_field_byte_len);
+        } else {
+          schc_decompression_status = 0;
+        }
 
         // Deallocate extracted_field_residue from the pool
         pool_dealloc(extracted_field_residue,
@@ -443,6 +591,14 @@ static int __compression(
         break;
 
       case CDA_NOT_SENT:
+        // A Variable-Length Field takes its length from the SCHC Packet
+        if ((size_t) rule_field_descriptor->first_target_value_offset +
+                decompressed_field_byte_len >
+            context_byte_len) {
+          schc_decompression_status = 0;
+          break;
+        }
+
         // Copy Target Value from Context to decompressed_field
         memcpy(decompressed_field,
                context + rule_field_descriptor->first_target_value_offset,
@@ -471,6 +627,9 @@ static int __compression(
     }
 
     if (!schc_decompression_status) {
+      // Deallocate decompressed_field from the pool
+      pool_dealloc(decompressed_field,
+                   sizeof(uint8_t) * decompressed_field_byte_len);
       break;
     }
 
@@ -488,12 +647,39 @@ static int __compression(
       set_coap_option_variable_length(&coap_option_length, decompressed_field,
                                       decompressed_field_byte_len,
                                       rule_field_descriptor->sid);
+    } else if (rule_field_descriptor->sid == SID_COAP_OPTION_VALUE) {
+      coap_option_number += coap_option_delta;
+      coap_option_position =
+          coap_option_delta == 0 ? coap_option_position + 1 : 1;
+    }
+
+    // A whole CoAP Option gets its Option Delta and Option Length back, Options
+    // being sorted by Option Number, then by Field Position
+    option_number = get_coap_option_number(rule_field_descriptor->sid);
+    if (option_number > 0) {
+      coap_option_position = option_number == coap_option_number
+                                 ? coap_option_position + 1
+                                 : 1;
+      if (option_number < coap_option_number ||
+          (rule_field_descriptor->pos != 0 &&
+           rule_field_descriptor->pos != coap_option_position) ||
+          decompressed_field_len % 8 != 0 ||
+          decompressed_field_len / 8 > UINT16_MAX) {
+        schc_decompression_status = 0;
+      } else {
+        schc_decompression_status = add_coap_option_header(
+            packet, packet_max_byte_len, packet_bit_position,
+            option_number - coap_option_number, decompressed_field_len / 8);
+        coap_option_number = option_number;
+      }
     }
 
     // Add decompressed_field into packet
-    schc_decompression_status =
-        add_bits_to_buffer(packet, packet_max_byte_len, packet_bit_position,
-                           decompressed_field, decompressed_field_len);
+    if (schc_decompression_status) {
+      schc_decompression_status =
+          add_bits_to_buffer(packet, packet_max_byte_len, packet_bit_position,
+                             decompressed_field, decompressed_field_len);
+    }
 
     // Deallocate decompressed_field from the pool
     pool_dealloc(decompressed_field,
@@ -514,55 +700,67 @@ static int __compression(
 
     // Copy payload content and remove unnecessary part
     memcpy(payload, schc_packet + payload_byte_position, payload_byte_len);
+    payload_bit_len = 8 * payload_byte_len;
     if (schc_packet_bit_position % 8 != 0) {
       right_shift(payload, payload_byte_len,
                   8 - (schc_packet_bit_position % 8));
-      memmove(payload, payload + 1, payload_byte_len--);
+      // payload_byte_len stays the allocated length, to be given back whole
+      memmove(payload, payload + 1, payload_byte_len - 1);
+      payload_bit_len -= 8;
     }
 
     // Add payload at the end of the packet
     schc_decompression_status =
         add_bits_to_buffer(packet, packet_max_byte_len, packet_bit_position,
-                           payload, 8 * (payload_byte_len));
+                           payload, payload_bit_len);
 
     // Deallocate payload from the pool
     pool_dealloc(payload, sizeof(uint8_t) * payload_byte_len);
 
-    // Handle Compute Entries
-    if (card_compute_entries > 0) {
-      // Update Compute entries
-      if (schc_decompression_status) {
-        schc_decompression_status = __update_compute_entries(
-            packet, BYTE_LENGTH(*packet_bit_position), compute_entries,
-            card_compute_entries, rule_descriptor, context, context_byte_len);
-      }
-
-      // Deallocate compute_entries from the pool
-      pool_dealloc(compute_entries,
-                   sizeof(compute_entry_t) * card_compute_entries);
+    // Update Compute entries
+    if (index_compute_entry > 0 && schc_decompression_status) {
+      schc_decompression_status = __update_compute_entries(
+          packet, BYTE_LENGTH(*packet_bit_position), compute_entries,
+          index_compute_entry, rule_descriptor, context, context_byte_len,
+          is_validated_context);
     }
   }
 
+  // Deallocate compute_entries from the pool
+  if (max_compute_entries > 0) {
+    pool_dealloc(compute_entries,
+                 sizeof(compute_entry_t) * max_compute_entries);
+  }
+
   return schc_decompression_status;
 }
 
 /* ********************************************************************** */
 
-static void __variable_length_decoding(
-    size_t                        *schc_packet_bit_position,
-    const rule_field_descriptor_t *rule_field_descriptor,
-    const size_t                   decompressed_field_len) {
-  if ((rule_field_descriptor->cda == CDA_LSB ||
-       rule_field_descriptor->cda == CDA_VALUE_SENT) &&
-      rule_field_descriptor->len == 0) {
-    if (decompressed_field_len < 15) {
-      *schc_packet_bit_position += 4;
-    } else if (decompressed_field_len < 255) {
-      *schc_packet_bit_position += 12;
-    } else {
-      *schc_packet_bit_position += 28;
-    }
+static int __variable_length_decoding(
+    size_t *decompressed_field_len, size_t *schc_packet_bit_position,
+    const uint8_t *schc_packet, const size_t schc_packet_byte_len,
+    const rule_field_descriptor_t *rule_field_descriptor) {
+  size_t residue_len;
+
+  if ((rule_field_descriptor->cda != CDA_LSB &&
+       rule_field_descriptor->cda != CDA_VALUE_SENT) ||
+      rule_field_descriptor->len != 0) {
+    return 1;
+  }
+
+  if (!read_variable_length(&residue_len, schc_packet_bit_position,
+                            schc_packet, schc_packet_byte_len)) {
+    return 0;
+  }
+
+  // The LSB Residue follows the MSB part of the Target Value
+  *decompressed_field_len = 8 * residue_len;
+  if (rule_field_descriptor->cda == CDA_LSB) {
+    *decompressed_field_len += rule_field_descriptor->msb_len;
   }
+
+  return 1;
 }
 
 /* ********************************************************************** */
@@ -573,7 +771,8 @@ static int __update_compute_entries(uint8_t         *packet,
                                     const int        card_compute_entries,
                                     const rule_descriptor_t *rule_descriptor,
                                     const uint8_t           *context,
-                                    const size_t             context_byte_len) {
+                                    const size_t             context_byte_len,
+                                    const int is_validated_context) {
   int                      schc_decompression_status;
   int                      index_compute_entry;
   size_t                   current_bit_position;
@@ -593,10 +792,22 @@ static int __update_compute_entries(uint8_t         *packet,
   while (index_compute_entry < card_compute_entries &&
          schc_decompression_status) {
     // Get Rule Field Descriptor
-    schc_decompression_status = get_rule_field_descriptor(
-        rule_field_descriptor,
-        compute_entries[index_compute_entry].index_rule_field_descriptor,
-        rule_descriptor->offset, context, context_byte_len);
+    if (rule_descriptor->compiled_rule != NULL) {
+      get_compiled_rule_field_descriptor(
+          rule_field_descriptor,
+          compute_entries[index_compute_entry].index_rule_field_descriptor,
+          rule_descriptor->compiled_rule);
+    } else if (is_validated_context) {
+      get_rule_field_descriptor_unchecked(
+          rule_field_descriptor,
+          compute_entries[index_compute_entry].index_rule_field_descriptor,
+          rule_descriptor->offset, context);
+    } else {
+      schc_decompression_status = get_rule_field_descriptor(
+          rule_field_descriptor,
+          compute_entries[index_compute_entry].index_rule_field_descriptor,
+          rule_descriptor->offset, context, context_byte_len);
+    }
 
     if ((rule_field_descriptor->sid == SID_IPV6_PAYLOAD_LENGTH ||
          rule_field_descriptor->sid == SID_UDP_LENGTH ||
@@ -0,0 +1,127 @@
+#include "flow_cache.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define IPV6_HEADER_BYTE_LEN    40  // IPv6 header without extension
+#define IPV6_NEXT_HEADER_OFFSET 6   // Next Header byte
+#define IPV6_ADDRESSES_OFFSET   8   // Source then Destination Address
+#define IPV6_ADDRESSES_BYTE_LEN 32  // Source and Destination Addresses
+#define IPV6_NEXT_HEADER_UDP    17  // UDP Next Header
+#define UDP_PORTS_BYTE_LEN      4   // Source and Destination Ports
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Adds bytes to a FNV-1a hash.
+ *
+ * @param hash The hash so far.
+ * @param buffer Pointer to the bytes to hash.
+ * @param byte_len Byte length of the buffer.
+ * @return The 32-bit hash.
+ */
+static uint32_t __fnv1a_hash(uint32_t hash, const uint8_t *buffer,
+                             const size_t byte_len);
+
+/* ********************************************************************** */
+
+int init_flow_cache(flow_cache_t *flow_cache, const size_t capacity) {
+  memset(flow_cache, 0x00, sizeof(flow_cache_t));
+
+  flow_cache->capacity = 1;
+  while (flow_cache->capacity < capacity) {
+    flow_cache->capacity <<= 1;
+  }
+
+  flow_cache->entries = (flow_cache_entry_t *) malloc(
+      flow_cache->capacity * sizeof(flow_cache_entry_t));
+  if (flow_cache->entries == NULL) {
+    flow_cache->capacity = 0;
+    return 0;
+  }
+  clear_flow_cache(flow_cache);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_flow_cache(flow_cache_t *flow_cache) {
+  free(flow_cache->entries);
+  memset(flow_cache, 0x00, sizeof(flow_cache_t));
+}
+
+/* ********************************************************************** */
+
+void clear_flow_cache(flow_cache_t *flow_cache) {
+  for (size_t index = 0; index < flow_cache->capacity; index++) {
+    flow_cache->entries[index].flow_hash  = 0;
+    flow_cache->entries[index].rule_index = FLOW_CACHE_RULE_NONE;
+  }
+}
+
+/* ********************************************************************** */
+
+int get_flow_hash(uint32_t *flow_hash, const uint8_t *packet,
+                  const size_t packet_byte_len) {
+  uint32_t hash;
+
+  if (packet_byte_len < IPV6_HEADER_BYTE_LEN || (packet[0] >> 4) != 6) {
+    return 0;
+  }
+
+  hash = __fnv1a_hash(2166136261u, packet + IPV6_NEXT_HEADER_OFFSET, 1);
+  hash = __fnv1a_hash(hash, packet + IPV6_ADDRESSES_OFFSET,
+                      IPV6_ADDRESSES_BYTE_LEN);
+
+  // The CoAP endpoint is given by the UDP ports
+  if (packet[IPV6_NEXT_HEADER_OFFSET] == IPV6_NEXT_HEADER_UDP &&
+      packet_byte_len >= IPV6_HEADER_BYTE_LEN + UDP_PORTS_BYTE_LEN) {
+    hash = __fnv1a_hash(hash, packet + IPV6_HEADER_BYTE_LEN,
+                        UDP_PORTS_BYTE_LEN);
+  }
+
+  *flow_hash = hash;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+uint16_t get_flow_rule(const flow_cache_t *flow_cache,
+                       const uint32_t      flow_hash) {
+  const flow_cache_entry_t *entry;
+
+  entry = &flow_cache->entries[flow_hash & (flow_cache->capacity - 1)];
+  if (entry->flow_hash != flow_hash) {
+    return FLOW_CACHE_RULE_NONE;
+  }
+
+  return entry->rule_index;
+}
+
+/* ********************************************************************** */
+
+void set_flow_rule(flow_cache_t *flow_cache, const uint32_t flow_hash,
+                   const uint16_t rule_index) {
+  flow_cache_entry_t *entry;
+
+  entry = &flow_cache->entries[flow_hash & (flow_cache->capacity - 1)];
+  entry->flow_hash  = flow_hash;
+  entry->rule_index = rule_index;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static uint32_t __fnv1a_hash(uint32_t hash, const uint8_t *buffer,
+                             const size_t byte_len) {
+  for (size_t index = 0; index < byte_len; index++) {
+    hash = (hash ^ buffer[index]) * 16777619u;
+  }
+
+  return hash;
+}
\ No newline at end of file
@@ -0,0 +1,1554 @@
+#include "fragmentation.h"
+#include "utils/binary.h"
+#include "utils/crc.h"
+#include "utils/memory.h"
+
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Gets the FCN value of an All-1 SCHC Fragment.
+ *
+ * @param descriptor Pointer to the Fragmentation Rule.
+ * @return The All-1 FCN.
+ */
+static uint8_t __all_1_fcn(const fragmentation_descriptor_t *descriptor);
+
+/**
+ * @brief Gets the W value of abort messages, all bits set to 1.
+ *
+ * @param descriptor Pointer to the Fragmentation Rule.
+ * @return The All-1 W.
+ */
+static uint8_t __all_1_w(const fragmentation_descriptor_t *descriptor);
+
+/**
+ * @brief Checks if a tile is set in a bitmap.
+ *
+ * @param bitmap Pointer to the bitmap.
+ * @param index Index of the tile.
+ * @return 1 if the tile is set, otherwise 0.
+ */
+static int __get_tile_bit(const uint8_t *bitmap, const size_t index);
+
+/**
+ * @brief Sets a tile in a bitmap.
+ *
+ * @param bitmap Pointer to the bitmap.
+ * @param index Index of the tile.
+ */
+static void __set_tile_bit(uint8_t *bitmap, const size_t index);
+
+/**
+ * @brief Gets the bitmap of received tiles of a reassembly buffer.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool.
+ * @param buffer Pointer to the reassembly buffer.
+ * @return A pointer to the bitmap.
+ */
+static uint8_t *__get_reassembly_bitmap(
+    const reassembly_pool_t *reassembly_pool, const uint8_t *buffer);
+
+/**
+ * @brief Computes the hash of a device ID.
+ *
+ * @param device_id The device ID.
+ * @return The hash of the device ID.
+ */
+static uint64_t __hash_device_id(uint64_t device_id);
+
+/**
+ * @brief Finds the Device Table entry of a device, open addressing with
+ * linear probing.
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool.
+ * @param device_id The device ID.
+ * @return The position of the entry of the device, or of the empty entry where
+ * it goes if it holds no buffer.
+ */
+static size_t __find_reassembly_device(const reassembly_pool_t *reassembly_pool,
+                                       const uint64_t           device_id);
+
+/**
+ * @brief Removes an entry of the Device Table, moving back the entries that
+ * follow it so that no lookup stops early (backward shift deletion).
+ *
+ * @param reassembly_pool Pointer to the Reassembly Pool.
+ * @param position Position of the entry.
+ */
+static void __remove_reassembly_device(reassembly_pool_t *reassembly_pool,
+                                       size_t             position);
+
+/**
+ * @brief Gets the number of tiles a reassembly buffer of a receiver holds,
+ * the last one possibly shorter than a tile. The bitmap of the buffer has no
+ * bit beyond.
+ *
+ * @param receiver Pointer to the receiver.
+ * @return The number of tiles.
+ */
+static size_t __get_tile_capacity(const fragmentation_receiver_t *receiver);
+
+/**
+ * @brief Reads a field of at most 8 bits from a SCHC message.
+ *
+ * @param value Pointer to the value to fill.
+ * @param bit_len Bit length of the field.
+ * @param bit_position Pointer to the current bit position in the message.
+ * @param fragment Pointer to the SCHC message.
+ * @param fragment_byte_len Byte length of the message.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __read_field(uint8_t *value, const size_t bit_len,
+                        size_t *bit_position, const uint8_t *fragment,
+                        const size_t fragment_byte_len);
+
+/**
+ * @brief Writes the header of a SCHC Fragment or of a SCHC ACK.
+ *
+ * @param message Pointer to the SCHC message to fill, zeroed beforehand.
+ * @param message_byte_len Byte length of the message.
+ * @param bit_position Pointer to the current bit position in the message.
+ * @param descriptor Pointer to the Fragmentation Rule.
+ * @param dtag Datagram Tag.
+ * @param w Window.
+ * @param last_field FCN of a SCHC Fragment, C bit of a SCHC ACK.
+ * @param last_field_len Bit length of last_field.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __write_header(uint8_t *message, const size_t message_byte_len,
+                          size_t                           *bit_position,
+                          const fragmentation_descriptor_t *descriptor,
+                          const uint8_t dtag, const uint8_t w,
+                          const uint8_t last_field,
+                          const size_t  last_field_len);
+
+/**
+ * @brief Builds a SCHC Fragment of the SCHC Packet of a sender.
+ *
+ * @param sender Pointer to the Fragmentation Sender.
+ * @param fragment Pointer to the SCHC Fragment to fill.
+ * @param fragment_max_byte_len Maximum byte length of the fragment.
+ * @param w Window.
+ * @param fcn Fragment Compressed Number.
+ * @param has_rcs 1 if the RCS follows the header, otherwise 0.
+ * @param byte_position Position of the payload in the SCHC Packet.
+ * @param payload_byte_len Byte length of the payload.
+ * @return The byte length of the fragment, 0 if it exceeds
+ * fragment_max_byte_len.
+ */
+static size_t __build_fragment(const fragmentation_sender_t *sender,
+                               uint8_t                      *fragment,
+                               const size_t fragment_max_byte_len,
+                               const uint8_t w, const uint8_t fcn,
+                               const int    has_rcs,
+                               const size_t byte_position,
+                               const size_t payload_byte_len);
+
+/**
+ * @brief Builds the next Regular SCHC Fragment of a window, starting from a
+ * tile and made of tiles that are set in a bitmap.
+ *
+ * @param sender Pointer to the Fragmentation Sender.
+ * @param fragment Pointer to the SCHC Fragment to fill.
+ * @param fragment_max_byte_len Maximum byte length of the fragment.
+ * @param tile_index Index of the first tile.
+ * @param bitmap Pointer to the bitmap of the window of tile_index, whose bits
+ * are cleared as tiles are added, or NULL to add consecutive tiles.
+ * @return The byte length of the fragment, 0 if fragment_max_byte_len cannot
+ * carry a tile.
+ */
+static size_t __build_tiles_fragment(fragmentation_sender_t *sender,
+                                     uint8_t                *fragment,
+                                     const size_t fragment_max_byte_len,
+                                     const size_t tile_index,
+                                     uint8_t     *bitmap);
+
+/**
+ * @brief Handles the expiry of the Retransmission Timer of a sender.
+ *
+ * @param timer Pointer to the Retransmission Timer.
+ */
+static void __retransmission_timeout(wheel_timer_t *timer);
+
+/**
+ * @brief Handles the expiry of the Inactivity Timer of a receiver.
+ *
+ * @param timer Pointer to the Inactivity Timer.
+ */
+static void __inactivity_timeout(wheel_timer_t *timer);
+
+/**
+ * @brief Adds a No-ACK SCHC Fragment to the reassembly.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ * @param header Pointer to the header of the fragment.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @return The reassembly status.
+ */
+static reassembly_status_t __receive_no_ack_fragment(
+    fragmentation_receiver_t *receiver, const fragment_header_t *header,
+    const uint8_t *fragment, const size_t fragment_byte_len);
+
+/**
+ * @brief Adds an ACK-on-Error SCHC Fragment or SCHC ACK REQ to the
+ * reassembly.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ * @param header Pointer to the header of the fragment.
+ * @param fragment Pointer to the SCHC Fragment.
+ * @param fragment_byte_len Byte length of the fragment.
+ * @return The reassembly status.
+ */
+static reassembly_status_t __receive_ack_on_error_fragment(
+    fragmentation_receiver_t *receiver, const fragment_header_t *header,
+    const uint8_t *fragment, const size_t fragment_byte_len);
+
+/**
+ * @brief Starts the reassembly of a new SCHC Packet.
+ *
+ * @param receiver Pointer to the Fragmentation Receiver.
+ * @param dtag Datagram Tag of the SCHC Packet.
+ * @return The status code, 1 for success, 0 if no reassembly buffer is left
+ * for the device.
+ */
+static int __start_reassembly(fragmentation_receiver_t *receiver,
+                              const uint8_t             dtag);
+
+/**
+ * @brief Copies bytes at a bit position of a zeroed buffer.
+ *
+ * @param buffer Pointer to the buffer to fill, with at least
+ * BYTE_LENGTH(bit_position + 8 * byte_len) bytes.
+ * @param bit_position Bit position of the first byte in buffer.
+ * @param content Pointer to the bytes to copy.
+ * @param byte_len Number of bytes to copy.
+ */
+static void __write_bytes(uint8_t *buffer, const size_t bit_position,
+                          const uint8_t *content, const size_t byte_len);
+
+/**
+ * @brief Copies bytes starting at a bit position of a buffer.
+ *
+ * @param content Pointer to the bytes to fill.
+ * @param buffer Pointer to the buffer to read, with at least
+ * BYTE_LENGTH(bit_position + 8 * byte_len) bytes.
+ * @param bit_position Bit position of the first byte in buffer.
+ * @param byte_len Number of bytes to copy.
+ */
+static void __read_bytes(uint8_t *content, const uint8_t *buffer,
+                         const size_t bit_position, const size_t byte_len);
+
+/* ********************************************************************** */
+
+int init_reassembly_pool(reassembly_pool_t *reassembly_pool,
+                         const size_t card_buffers,
+                         const size_t buffer_byte_len,
+                         const size_t max_buffers_per_device) {
+  size_t devices_capacity;
+
+  if (card_buffers == 0 || buffer_byte_len == 0 ||
+      max_buffers_per_device == 0) {
+    return 0;
+  }
+
+  // At most half of the Device Table is used, a device per buffer
+  for (devices_capacity = 2; devices_capacity < 2 * card_buffers;
+       devices_capacity *= 2) {
+  }
+
+  // Allocate owners from the pool
+  reassembly_pool->owners =
+      (uint64_t *) pool_alloc(card_buffers * sizeof(uint64_t));
+  if (reassembly_pool->owners == NULL) {
+    return 0;
+  }
+
+  // Allocate free buffers from the pool
+  reassembly_pool->free_buffers =
+      (size_t *) pool_alloc(card_buffers * sizeof(size_t));
+  if (reassembly_pool->free_buffers == NULL) {
+    // Deallocate owners from the pool
+    pool_dealloc(reassembly_pool->owners, card_buffers * sizeof(uint64_t));
+    return 0;
+  }
+
+  // Allocate devices from the pool
+  reassembly_pool->devices = (reassembly_device_t *) pool_alloc(
+      devices_capacity * sizeof(reassembly_device_t));
+  if (reassembly_pool->devices == NULL) {
+    // Deallocate free buffers and owners from the pool
+    pool_dealloc(reassembly_pool->free_buffers,
+                 card_buffers * sizeof(size_t));
+    pool_dealloc(reassembly_pool->owners, card_buffers * sizeof(uint64_t));
+    return 0;
+  }
+
+  // Allocate bitmaps from the pool
+  reassembly_pool->bitmaps =
+      (uint8_t *) pool_alloc(card_buffers * BYTE_LENGTH(buffer_byte_len));
+  if (reassembly_pool->bitmaps == NULL) {
+    // Deallocate devices, free buffers and owners from the pool
+    pool_dealloc(reassembly_pool->devices,
+                 devices_capacity * sizeof(reassembly_device_t));
+    pool_dealloc(reassembly_pool->free_buffers,
+                 card_buffers * sizeof(size_t));
+    pool_dealloc(reassembly_pool->owners, card_buffers * sizeof(uint64_t));
+    return 0;
+  }
+
+  // Allocate memory from the pool
+  reassembly_pool->memory =
+      (uint8_t *) pool_alloc(card_buffers * buffer_byte_len);
+  if (reassembly_pool->memory == NULL) {
+    // Deallocate bitmaps, devices, free buffers and owners from the pool
+    pool_dealloc(reassembly_pool->bitmaps,
+                 card_buffers * BYTE_LENGTH(buffer_byte_len));
+    pool_dealloc(reassembly_pool->devices,
+                 devices_capacity * sizeof(reassembly_device_t));
+    pool_dealloc(reassembly_pool->free_buffers,
+                 card_buffers * sizeof(size_t));
+    pool_dealloc(reassembly_pool->owners, card_buffers * sizeof(uint64_t));
+    return 0;
+  }
+
+  // The first buffer is on top of the free buffers
+  for (size_t index = 0; index < card_buffers; index++) {
+    reassembly_pool->owners[index]       = REASSEMBLY_BUFFER_FREE;
+    reassembly_pool->free_buffers[index] = card_buffers - 1 - index;
+  }
+  for (size_t index = 0; index < devices_capacity; index++) {
+    reassembly_pool->devices[index].device_id    = REASSEMBLY_BUFFER_FREE;
+    reassembly_pool->devices[index].card_buffers = 0;
+  }
+
+  reassembly_pool->buffer_byte_len        = buffer_byte_len;
+  reassembly_pool->card_buffers           = card_buffers;
+  reassembly_pool->card_free_buffers      = card_buffers;
+  reassembly_pool->devices_capacity       = devices_capacity;
+  reassembly_pool->max_buffers_per_device = max_buffers_per_device;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_reassembly_pool(reassembly_pool_t *reassembly_pool) {
+  // Deallocate memory from the pool
+  pool_dealloc(reassembly_pool->memory, reassembly_pool->card_buffers *
+                                            reassembly_pool->buffer_byte_len);
+
+  // Deallocate bitmaps from the pool
+  pool_dealloc(reassembly_pool->bitmaps,
+               reassembly_pool->card_buffers *
+                   BYTE_LENGTH(reassembly_pool->buffer_byte_len));
+
+  // Deallocate devices from the pool
+  pool_dealloc(reassembly_pool->devices, reassembly_pool->devices_capacity *
+                                             sizeof(reassembly_device_t));
+
+  // Deallocate free buffers from the pool
+  pool_dealloc(reassembly_pool->free_buffers,
+               reassembly_pool->card_buffers * sizeof(size_t));
+
+  // Deallocate owners from the pool
+  pool_dealloc(reassembly_pool->owners,
+               reassembly_pool->card_buffers * sizeof(uint64_t));
+
+  memset(reassembly_pool, 0x00, sizeof(reassembly_pool_t));
+}
+
+/* ********************************************************************** */
+
+uint8_t *acquire_reassembly_buffer(reassembly_pool_t *reassembly_pool,
+                                   const uint64_t     device_id) {
+  reassembly_device_t *device;
+  size_t               index;
+
+  if (device_id == REASSEMBLY_BUFFER_FREE ||
+      reassembly_pool->card_free_buffers == 0) {
+    return NULL;
+  }
+
+  device = &reassembly_pool
+                ->devices[__find_reassembly_device(reassembly_pool, device_id)];
+  if (device->card_buffers >= reassembly_pool->max_buffers_per_device) {
+    return NULL;
+  }
+  device->device_id = device_id;
+  device->card_buffers++;
+
+  index = reassembly_pool->free_buffers[--reassembly_pool->card_free_buffers];
+  reassembly_pool->owners[index] = device_id;
+
+  return reassembly_pool->memory + index * reassembly_pool->buffer_byte_len;
+}
+
+/* ********************************************************************** */
+
+void release_reassembly_buffer(reassembly_pool_t *reassembly_pool,
+                               uint8_t           *buffer) {
+  size_t index;
+  size_t position;
+
+  index = (size_t) (buffer - reassembly_pool->memory) /
+          reassembly_pool->buffer_byte_len;
+
+  position =
+      __find_reassembly_device(reassembly_pool, reassembly_pool->owners[index]);
+  if (--reassembly_pool->devices[position].card_buffers == 0) {
+    __remove_reassembly_device(reassembly_pool, position);
+  }
+
+  reassembly_pool->owners[index] = REASSEMBLY_BUFFER_FREE;
+  reassembly_pool->free_buffers[reassembly_pool->card_free_buffers++] = index;
+}
+
+/* ********************************************************************** */
+
+int parse_fragment_header(fragment_header_t                *header,
+                          const fragmentation_descriptor_t *descriptor,
+                          const uint8_t                    *fragment,
+                          const size_t                      fragment_byte_len) {
+  size_t bit_position;
+
+  bit_position = 0;
+  if (!__read_field(&header->rule_id, descriptor->rule_id_len, &bit_position,
+                    fragment, fragment_byte_len) ||
+      !__read_field(&header->dtag, descriptor->dtag_len, &bit_position,
+                    fragment, fragment_byte_len) ||
+      !__read_field(&header->w, descriptor->w_len, &bit_position, fragment,
+                    fragment_byte_len) ||
+      !__read_field(&header->fcn, descriptor->fcn_len, &bit_position,
+                    fragment, fragment_byte_len)) {
+    return 0;
+  }
+
+  header->bit_len = bit_position;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int get_fragment_descriptor(fragmentation_descriptor_t *descriptor,
+                            const uint8_t              *fragment,
+                            const size_t                fragment_byte_len,
+                            const uint8_t              *context,
+                            const size_t                context_byte_len) {
+  rule_descriptor_t rule_descriptor;
+  uint8_t           card_rule_descriptor;
+  uint8_t           rule_id;
+  size_t            bit_position;
+
+  if (context_byte_len <= CARD_RULE_DESCRIPTOR_OFFSET ||
+      context[CARD_RULE_DESCRIPTOR_OFFSET] == 0) {
+    return 0;
+  }
+
+  card_rule_descriptor = context[CARD_RULE_DESCRIPTOR_OFFSET];
+  bit_position         = 0;
+  if (!__read_field(&rule_id, bits_counter(card_rule_descriptor - 1),
+                    &bit_position, fragment, fragment_byte_len)) {
+    return 0;
+  }
+
+  for (unsigned int index = 0; index < card_rule_descriptor; index++) {
+    if (get_rule_descriptor(&rule_descriptor, index, context,
+                            context_byte_len) &&
+        rule_descriptor.id == rule_id) {
+      return get_fragmentation_descriptor(descriptor, &rule_descriptor, context,
+                                          context_byte_len);
+    }
+  }
+
+  return 0;
+}
+
+/* ********************************************************************** */
+
+int init_fragmentation_sender(fragmentation_sender_t           *sender,
+                              const fragmentation_descriptor_t *descriptor,
+                              const uint8_t                     dtag,
+                              const uint8_t                    *schc_packet,
+                              const size_t   schc_packet_byte_len,
+                              timer_wheel_t *timer_wheel,
+                              const uint64_t retransmission_ticks) {
+  size_t card_tiles;
+  size_t card_windows;
+
+  if (descriptor->mode == FRAGMENTATION_ACK_ALWAYS ||
+      schc_packet_byte_len == 0 || (dtag >> descriptor->dtag_len) != 0) {
+    return 0;
+  }
+
+  card_tiles = (schc_packet_byte_len + descriptor->tile_byte_len - 1) /
+               descriptor->tile_byte_len;
+
+  // Windows are numbered on w_len bits, W is never wrapped
+  if (descriptor->mode == FRAGMENTATION_ACK_ON_ERROR) {
+    card_windows = (card_tiles + descriptor->window_size - 1) /
+                   descriptor->window_size;
+    if (timer_wheel == NULL ||
+        card_windows > ((size_t) 1 << descriptor->w_len)) {
+      return 0;
+    }
+  }
+
+  sender->descriptor            = *descriptor;
+  sender->schc_packet           = schc_packet;
+  sender->schc_packet_byte_len  = schc_packet_byte_len;
+  sender->byte_position         = 0;
+  sender->card_tiles            = card_tiles;
+  sender->rcs                   = crc32(schc_packet, schc_packet_byte_len);
+  sender->dtag                  = dtag;
+  sender->is_complete           = 0;
+  sender->is_aborted            = 0;
+  sender->step                  = SENDER_SEND_TILES;
+  sender->last_window           = 0;
+  sender->retransmission_window = 0;
+  sender->card_ack_requests     = 0;
+  sender->timer_wheel           = timer_wheel;
+  sender->retransmission_ticks  = retransmission_ticks;
+  memset(sender->retransmission_bitmap, 0x00,
+         sizeof(sender->retransmission_bitmap));
+  init_wheel_timer(&sender->retransmission_timer, __retransmission_timeout,
+                   sender);
+
+  if (descriptor->mode == FRAGMENTATION_ACK_ON_ERROR) {
+    sender->last_window =
+        (uint8_t) ((card_tiles - 1) / descriptor->window_size);
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+size_t get_next_fragment(fragmentation_sender_t *sender, uint8_t *fragment,
+                         const size_t fragment_max_byte_len) {
+  const fragmentation_descriptor_t *descriptor;
+  size_t                            header_bit_len;
+  size_t                            remaining_byte_len;
+  size_t                            payload_byte_len;
+  size_t                            last_tile_byte_position;
+  size_t                            fragment_byte_len;
+  size_t                            tile_index;
+  size_t                            bit_index;
+
+  descriptor = &sender->descriptor;
+
+  if (descriptor->mode == FRAGMENTATION_ACK_ON_ERROR) {
+    switch (sender->step) {
+      case SENDER_SEND_TILES:
+        fragment_byte_len = __build_tiles_fragment(
+            sender, fragment, fragment_max_byte_len,
+            sender->byte_position / descriptor->tile_byte_len, NULL);
+        if (sender->byte_position == sender->schc_packet_byte_len) {
+          sender->step = SENDER_SEND_ALL_1;
+        }
+        return fragment_byte_len;
+
+      case SENDER_RESEND_TILES:
+        for (bit_index = 0; bit_index < descriptor->window_size &&
+                            !__get_tile_bit(sender->retransmission_bitmap,
+                                            bit_index);
+             bit_index++) {
+        }
+
+        if (bit_index < descriptor->window_size) {
+          tile_index =
+              sender->retransmission_window * descriptor->window_size +
+              bit_index;
+          return __build_tiles_fragment(sender, fragment,
+                                        fragment_max_byte_len, tile_index,
+                                        sender->retransmission_bitmap);
+        }
+
+        // The All-1 fragment asks for a SCHC ACK of the last window
+        sender->step = sender->retransmission_window == sender->last_window
+                           ? SENDER_SEND_ALL_1
+                           : SENDER_SEND_ACK_REQ;
+        return get_next_fragment(sender, fragment, fragment_max_byte_len);
+
+      case SENDER_SEND_ALL_1:
+        fragment_byte_len = __build_fragment(
+            sender, fragment, fragment_max_byte_len, sender->last_window,
+            __all_1_fcn(descriptor), 1, 0, 0);
+        if (fragment_byte_len > 0) {
+          sender->step = SENDER_WAIT_ACK;
+          start_wheel_timer(sender->timer_wheel,
+                            &sender->retransmission_timer,
+                            sender->retransmission_ticks);
+        }
+        return fragment_byte_len;
+
+      case SENDER_SEND_ACK_REQ:
+        // An All-0 fragment without any tile
+        fragment_byte_len =
+            __build_fragment(sender, fragment, fragment_max_byte_len,
+                             sender->last_window, 0, 0, 0, 0);
+        if (fragment_byte_len > 0) {
+          sender->step = SENDER_WAIT_ACK;
+          start_wheel_timer(sender->timer_wheel,
+                            &sender->retransmission_timer,
+                            sender->retransmission_ticks);
+        }
+        return fragment_byte_len;
+
+      case SENDER_SEND_ABORT:
+        // An All-1 fragment without RCS
+        fragment_byte_len = __build_fragment(
+            sender, fragment, fragment_max_byte_len, __all_1_w(descriptor),
+            __all_1_fcn(descriptor), 0, 0, 0);
+        if (fragment_byte_len > 0) {
+          sender->step = SENDER_DONE;
+        }
+        return fragment_byte_len;
+
+      default:  // SENDER_WAIT_ACK, SENDER_DONE
+        return 0;
+    }
+  }
+
+  header_bit_len = descriptor->rule_id_len + descriptor->dtag_len +
+                   descriptor->w_len + descriptor->fcn_len;
+
+  if (sender->is_complete ||
+      8 * fragment_max_byte_len < header_bit_len + RCS_BIT_LEN) {
+    return 0;
+  }
+
+  remaining_byte_len = sender->schc_packet_byte_len - sender->byte_position;
+
+  if (8 * remaining_byte_len <=
+      8 * fragment_max_byte_len - header_bit_len - RCS_BIT_LEN) {
+    // The remaining tiles fit in the All-1 fragment
+    fragment_byte_len = __build_fragment(
+        sender, fragment, fragment_max_byte_len, 0, __all_1_fcn(descriptor), 1,
+        sender->byte_position, remaining_byte_len);
+    sender->byte_position += remaining_byte_len;
+    sender->is_complete = 1;
+    return fragment_byte_len;
+  }
+
+  // As many whole tiles as possible, the last tile is left for the All-1
+  payload_byte_len = (8 * fragment_max_byte_len - header_bit_len) / 8;
+  payload_byte_len -= payload_byte_len % descriptor->tile_byte_len;
+
+  last_tile_byte_position =
+      ((sender->schc_packet_byte_len - 1) / descriptor->tile_byte_len) *
+      descriptor->tile_byte_len;
+  if (sender->byte_position + payload_byte_len > last_tile_byte_position) {
+    payload_byte_len = last_tile_byte_position - sender->byte_position;
+  }
+
+  if (payload_byte_len == 0) {
+    return 0;
+  }
+
+  fragment_byte_len =
+      __build_fragment(sender, fragment, fragment_max_byte_len, 0, 0, 0,
+                       sender->byte_position, payload_byte_len);
+  sender->byte_position += payload_byte_len;
+
+  return fragment_byte_len;
+}
+
+/* ********************************************************************** */
+
+int receive_ack(fragmentation_sender_t *sender, const uint8_t *ack,
+                const size_t ack_byte_len) {
+  const fragmentation_descriptor_t *descriptor;
+  uint8_t                           rule_id;
+  uint8_t                           dtag;
+  uint8_t                           w;
+  uint8_t                           c;
+  uint8_t                           bit;
+  size_t                            bit_position;
+  size_t                            bitmap_bit_len;
+  size_t                            tile_index;
+  int                               is_missing_tile;
+
+  descriptor = &sender->descriptor;
+
+  if (descriptor->mode != FRAGMENTATION_ACK_ON_ERROR ||
+      sender->step == SENDER_DONE) {
+    return 0;
+  }
+
+  bit_position = 0;
+  if (!__read_field(&rule_id, descriptor->rule_id_len, &bit_position, ack,
+                    ack_byte_len) ||
+      !__read_field(&dtag, descriptor->dtag_len, &bit_position, ack,
+                    ack_byte_len) ||
+      !__read_field(&w, descriptor->w_len, &bit_position, ack,
+                    ack_byte_len) ||
+      !__read_field(&c, 1, &bit_position, ack, ack_byte_len) ||
+      rule_id != descriptor->rule_id || dtag != sender->dtag) {
+    return 0;
+  }
+
+  // A Receiver-Abort ends with at least a byte of 1 bits
+  if (c == 1 && w == __all_1_w(descriptor) &&
+      8 * ack_byte_len - bit_position >= 8) {
+    bit = 1;
+    while (bit == 1 && bit_position < 8 * ack_byte_len) {
+      __read_field(&bit, 1, &bit_position, ack, ack_byte_len);
+    }
+    if (bit == 1) {
+      stop_wheel_timer(sender->timer_wheel, &sender->retransmission_timer);
+      sender->is_aborted = 1;
+      sender->step       = SENDER_DONE;
+      return 1;
+    }
+  }
+
+  // Only the All-1 fragment and ACK REQs are answered
+  if (sender->step != SENDER_WAIT_ACK || w > sender->last_window) {
+    return 0;
+  }
+
+  stop_wheel_timer(sender->timer_wheel, &sender->retransmission_timer);
+
+  if (c == 1) {
+    sender->is_complete = 1;
+    sender->step        = SENDER_DONE;
+    return 1;
+  }
+
+  // Compressed bitmap: the bits left out are 1
+  bitmap_bit_len = 8 * ack_byte_len - bit_position;
+  if (bitmap_bit_len > descriptor->window_size) {
+    bitmap_bit_len = descriptor->window_size;
+  }
+
+  memset(sender->retransmission_bitmap, 0x00,
+         sizeof(sender->retransmission_bitmap));
+  is_missing_tile = 0;
+
+  for (size_t index = 0; index < bitmap_bit_len; index++) {
+    __read_field(&bit, 1, &bit_position, ack, ack_byte_len);
+    tile_index = (size_t) w * descriptor->window_size + index;
+    if (bit == 0 && tile_index < sender->card_tiles) {
+      __set_tile_bit(sender->retransmission_bitmap, index);
+      is_missing_tile = 1;
+    }
+  }
+
+  if (is_missing_tile) {
+    sender->card_ack_requests     = 0;
+    sender->retransmission_window = w;
+    sender->step                  = SENDER_RESEND_TILES;
+    return 1;
+  }
+
+  // Nothing is missing but the reassembly is not complete: the All-1 fragment
+  // was lost or the RCS does not match
+  if (sender->card_ack_requests >= descriptor->max_ack_requests) {
+    sender->step = SENDER_SEND_ABORT;
+  } else {
+    sender->card_ack_requests++;
+    sender->step = w == sender->last_window ? SENDER_SEND_ALL_1
+                                            : SENDER_SEND_ACK_REQ;
+  }
+  sender->is_aborted = sender->step == SENDER_SEND_ABORT;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void reset_fragmentation_sender(fragmentation_sender_t *sender) {
+  if (sender->timer_wheel != NULL) {
+    stop_wheel_timer(sender->timer_wheel, &sender->retransmission_timer);
+  }
+  sender->step = SENDER_DONE;
+}
+
+/* ********************************************************************** */
+
+int init_fragmentation_receiver(fragmentation_receiver_t         *receiver,
+                                const fragmentation_descriptor_t *descriptor,
+                                reassembly_pool_t *reassembly_pool,
+                                const uint64_t     device_id,
+                                timer_wheel_t     *timer_wheel,
+                                const uint64_t     inactivity_ticks) {
+  if (descriptor->mode == FRAGMENTATION_ACK_ALWAYS ||
+      device_id == REASSEMBLY_BUFFER_FREE) {
+    return 0;
+  }
+
+  memset(receiver, 0x00, sizeof(fragmentation_receiver_t));
+
+  receiver->descriptor       = *descriptor;
+  receiver->reassembly_pool  = reassembly_pool;
+  receiver->device_id        = device_id;
+  receiver->crc              = CRC32_INIT;
+  receiver->timer_wheel      = timer_wheel;
+  receiver->inactivity_ticks = inactivity_ticks;
+  init_wheel_timer(&receiver->inactivity_timer, __inactivity_timeout,
+                   receiver);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+reassembly_status_t receive_fragment(fragmentation_receiver_t *receiver,
+                                     const uint8_t            *fragment,
+                                     const size_t fragment_byte_len) {
+  fragment_header_t header;
+
+  if (!parse_fragment_header(&header, &receiver->descriptor, fragment,
+                             fragment_byte_len) ||
+      header.rule_id != receiver->descriptor.rule_id) {
+    return REASSEMBLY_ERROR;
+  }
+
+  if (receiver->timer_wheel != NULL) {
+    start_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer,
+                      receiver->inactivity_ticks);
+  }
+
+  if (receiver->descriptor.mode == FRAGMENTATION_ACK_ON_ERROR) {
+    return __receive_ack_on_error_fragment(receiver, &header, fragment,
+                                           fragment_byte_len);
+  }
+
+  return __receive_no_ack_fragment(receiver, &header, fragment,
+                                   fragment_byte_len);
+}
+
+/* ********************************************************************** */
+
+size_t get_next_ack(fragmentation_receiver_t *receiver, uint8_t *ack,
+                    const size_t ack_max_byte_len) {
+  const fragmentation_descriptor_t *descriptor;
+  size_t                            bit_position;
+  size_t                            header_bit_len;
+  size_t                            ack_byte_len;
+  size_t                            bitmap_bit_len;
+  size_t                            last_missing_bit;
+  size_t                            tile_index;
+  size_t                            tile_capacity;
+  size_t                            window_end;
+  size_t                            window;
+  int                               is_missing_tile;
+
+  descriptor     = &receiver->descriptor;
+  header_bit_len = descriptor->rule_id_len + descriptor->dtag_len +
+                   descriptor->w_len + 1;
+
+  if (receiver->is_abort_pending) {
+    // Padding of 1 bits, then a byte of 1 bits
+    ack_byte_len = BYTE_LENGTH(header_bit_len) + 1;
+    if (ack_byte_len > ack_max_byte_len) {
+      return 0;
+    }
+    memset(ack, 0x00, ack_byte_len);
+    bit_position = 0;
+    __write_header(ack, ack_byte_len, &bit_position, descriptor,
+                   receiver->dtag, __all_1_w(descriptor), 1, 1);
+    while (bit_position < 8 * ack_byte_len) {
+      add_byte_to_buffer(ack, ack_byte_len, &bit_position, 1, 1);
+    }
+    receiver->is_abort_pending = 0;
+    return ack_byte_len;
+  }
+
+  if (!receiver->is_ack_pending) {
+    return 0;
+  }
+
+  if (receiver->is_complete) {
+    ack_byte_len = BYTE_LENGTH(header_bit_len);
+    if (ack_byte_len > ack_max_byte_len) {
+      return 0;
+    }
+    memset(ack, 0x00, ack_byte_len);
+    bit_position = 0;
+    __write_header(ack, ack_byte_len, &bit_position, descriptor,
+                   receiver->dtag, receiver->last_window, 1, 1);
+    receiver->is_ack_pending = 0;
+    return ack_byte_len;
+  }
+
+  // Lowest window missing tiles, otherwise the last window known. The windows
+  // received are within the reassembly buffer, whose tiles bound the bitmap.
+  tile_capacity   = __get_tile_capacity(receiver);
+  window          = 0;
+  is_missing_tile = 0;
+  while (!is_missing_tile && window <= receiver->last_window) {
+    window_end = window < receiver->last_window
+                     ? (window + 1) * descriptor->window_size
+                     : receiver->card_tiles;
+    if (window_end > tile_capacity) {
+      window_end = tile_capacity;
+    }
+    for (tile_index = window * descriptor->window_size;
+         tile_index < window_end && !is_missing_tile; tile_index++) {
+      is_missing_tile = !__get_tile_bit(receiver->bitmap, tile_index);
+    }
+    if (!is_missing_tile) {
+      window++;
+    }
+  }
+  if (!is_missing_tile) {
+    window = receiver->last_window;
+  }
+
+  // Trailing 1 bits are left out as long as the SCHC ACK stays byte-aligned
+  last_missing_bit = 0;
+  for (size_t index = 0; index < descriptor->window_size; index++) {
+    tile_index = window * descriptor->window_size + index;
+    if (receiver->bitmap == NULL || tile_index >= tile_capacity ||
+        !__get_tile_bit(receiver->bitmap, tile_index)) {
+      last_missing_bit = index + 1;
+    }
+  }
+  bitmap_bit_len = last_missing_bit;
+  while (bitmap_bit_len < descriptor->window_size &&
+         (header_bit_len + bitmap_bit_len) % 8 != 0) {
+    bitmap_bit_len++;
+  }
+
+  ack_byte_len = BYTE_LENGTH(header_bit_len + bitmap_bit_len);
+  if (ack_byte_len > ack_max_byte_len) {
+    return 0;
+  }
+  memset(ack, 0x00, ack_byte_len);
+  bit_position = 0;
+  __write_header(ack, ack_byte_len, &bit_position, descriptor, receiver->dtag,
+                 (uint8_t) window, 0, 1);
+  for (size_t index = 0; index < bitmap_bit_len; index++) {
+    tile_index = window * descriptor->window_size + index;
+    add_byte_to_buffer(ack, ack_byte_len, &bit_position,
+                       receiver->bitmap != NULL && tile_index < tile_capacity &&
+                           __get_tile_bit(receiver->bitmap, tile_index),
+                       1);
+  }
+  receiver->is_ack_pending = 0;
+
+  return ack_byte_len;
+}
+
+/* ********************************************************************** */
+
+void reset_fragmentation_receiver(fragmentation_receiver_t *receiver) {
+  if (receiver->buffer != NULL) {
+    release_reassembly_buffer(receiver->reassembly_pool, receiver->buffer);
+  }
+
+  if (receiver->timer_wheel != NULL) {
+    stop_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer);
+  }
+
+  // A complete ACK-on-Error SCHC Packet is still acknowledged afterwards
+  if (receiver->descriptor.mode != FRAGMENTATION_ACK_ON_ERROR) {
+    receiver->is_complete = 0;
+  }
+
+  receiver->buffer              = NULL;
+  receiver->bitmap              = NULL;
+  receiver->byte_len            = 0;
+  receiver->crc                 = CRC32_INIT;
+  receiver->card_tiles          = 0;
+  receiver->card_received_tiles = 0;
+  receiver->is_all_1_received   = 0;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static uint8_t __all_1_fcn(const fragmentation_descriptor_t *descriptor) {
+  return (uint8_t) ((1u << descriptor->fcn_len) - 1);
+}
+
+/* ********************************************************************** */
+
+static uint8_t __all_1_w(const fragmentation_descriptor_t *descriptor) {
+  return (uint8_t) ((1u << descriptor->w_len) - 1);
+}
+
+/* ********************************************************************** */
+
+static int __get_tile_bit(const uint8_t *bitmap, const size_t index) {
+  return (bitmap[index / 8] >> (7 - index % 8)) & 0x01;
+}
+
+/* ********************************************************************** */
+
+static void __set_tile_bit(uint8_t *bitmap, const size_t index) {
+  bitmap[index / 8] |= (uint8_t) (0x80 >> (index % 8));
+}
+
+/* ********************************************************************** */
+
+static uint8_t *__get_reassembly_bitmap(
+    const reassembly_pool_t *reassembly_pool, const uint8_t *buffer) {
+  size_t index;
+
+  index = (size_t) (buffer - reassembly_pool->memory) /
+          reassembly_pool->buffer_byte_len;
+
+  return reassembly_pool->bitmaps +
+         index * BYTE_LENGTH(reassembly_pool->buffer_byte_len);
+}
+
+/* ********************************************************************** */
+
+static uint64_t __hash_device_id(uint64_t device_id) {
+  device_id = (device_id ^ (device_id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  device_id = (device_id ^ (device_id >> 27)) * 0x94d049bb133111ebULL;
+
+  return device_id ^ (device_id >> 31);
+}
+
+/* ********************************************************************** */
+
+static size_t __find_reassembly_device(const reassembly_pool_t *reassembly_pool,
+                                       const uint64_t           device_id) {
+  size_t mask;
+  size_t position;
+
+  mask     = reassembly_pool->devices_capacity - 1;
+  position = (size_t) __hash_device_id(device_id) & mask;
+  while (reassembly_pool->devices[position].device_id != device_id &&
+         reassembly_pool->devices[position].device_id !=
+             REASSEMBLY_BUFFER_FREE) {
+    position = (position + 1) & mask;
+  }
+
+  return position;
+}
+
+/* ********************************************************************** */
+
+static void __remove_reassembly_device(reassembly_pool_t *reassembly_pool,
+                                       size_t             position) {
+  reassembly_device_t *devices;
+  size_t               mask;
+  size_t               hole;
+  size_t               home;
+
+  devices = reassembly_pool->devices;
+  mask    = reassembly_pool->devices_capacity - 1;
+  hole    = position;
+
+  while (1) {
+    position = (position + 1) & mask;
+    if (devices[position].device_id == REASSEMBLY_BUFFER_FREE) {
+      break;
+    }
+
+    // The entry moves to the hole unless its home lies cyclically in
+    // (hole, position]
+    home = (size_t) __hash_device_id(devices[position].device_id) & mask;
+    if (((position - home) & mask) >= ((position - hole) & mask)) {
+      devices[hole] = devices[position];
+      hole          = position;
+    }
+  }
+
+  devices[hole].device_id    = REASSEMBLY_BUFFER_FREE;
+  devices[hole].card_buffers = 0;
+}
+
+/* ********************************************************************** */
+
+static size_t __get_tile_capacity(const fragmentation_receiver_t *receiver) {
+  return (receiver->reassembly_pool->buffer_byte_len +
+          receiver->descriptor.tile_byte_len - 1) /
+         receiver->descriptor.tile_byte_len;
+}
+
+/* ********************************************************************** */
+
+static int __read_field(uint8_t *value, const size_t bit_len,
+                        size_t *bit_position, const uint8_t *fragment,
+                        const size_t fragment_byte_len) {
+  uint8_t content[2];  // extract_bits(...) may use an extra byte
+
+  *value = 0;
+  if (bit_len == 0) {
+    return 1;
+  }
+
+  if (!extract_bits(content, sizeof(content), bit_len, bit_position, fragment,
+                    fragment_byte_len)) {
+    return 0;
+  }
+  *value = content[0];
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static int __write_header(uint8_t *message, const size_t message_byte_len,
+                          size_t                           *bit_position,
+                          const fragmentation_descriptor_t *descriptor,
+                          const uint8_t dtag, const uint8_t w,
+                          const uint8_t last_field,
+                          const size_t  last_field_len) {
+  const uint8_t fields[4]     = {descriptor->rule_id, dtag, w, last_field};
+  const size_t  field_lens[4] = {descriptor->rule_id_len, descriptor->dtag_len,
+                                 descriptor->w_len, last_field_len};
+
+  for (size_t index = 0; index < 4; index++) {
+    if (field_lens[index] > 0 &&
+        !add_byte_to_buffer(message, message_byte_len, bit_position,
+                            fields[index], field_lens[index])) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static size_t __build_fragment(const fragmentation_sender_t *sender,
+                               uint8_t                      *fragment,
+                               const size_t fragment_max_byte_len,
+                               const uint8_t w, const uint8_t fcn,
+                               const int    has_rcs,
+                               const size_t byte_position,
+                               const size_t payload_byte_len) {
+  const fragmentation_descriptor_t *descriptor;
+  size_t                            fragment_byte_len;
+  size_t                            bit_position;
+
+  descriptor        = &sender->descriptor;
+  fragment_byte_len = BYTE_LENGTH(
+      descriptor->rule_id_len + descriptor->dtag_len + descriptor->w_len +
+      descriptor->fcn_len + (has_rcs ? RCS_BIT_LEN : 0) + 8 * payload_byte_len);
+  if (fragment_byte_len > fragment_max_byte_len) {
+    return 0;
+  }
+
+  memset(fragment, 0x00, fragment_byte_len);
+
+  bit_position = 0;
+  __write_header(fragment, fragment_byte_len, &bit_position, descriptor,
+                 sender->dtag, w, fcn, descriptor->fcn_len);
+
+  if (has_rcs) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+      add_byte_to_buffer(fragment, fragment_byte_len, &bit_position,
+                         (uint8_t) (sender->rcs >> shift), 8);
+    }
+  }
+
+  // Tiles go straight from the SCHC Packet to the fragment
+  __write_bytes(fragment, bit_position, sender->schc_packet + byte_position,
+                payload_byte_len);
+
+  return fragment_byte_len;
+}
+
+/* ********************************************************************** */
+
+static size_t __build_tiles_fragment(fragmentation_sender_t *sender,
+                                     uint8_t                *fragment,
+                                     const size_t fragment_max_byte_len,
+                                     const size_t tile_index,
+                                     uint8_t     *bitmap) {
+  const fragmentation_descriptor_t *descriptor;
+  size_t                            header_bit_len;
+  size_t                            max_card_tiles;
+  size_t                            card_tiles;
+  size_t                            window_position;
+  size_t                            byte_position;
+  size_t                            payload_byte_len;
+  size_t                            fragment_byte_len;
+
+  descriptor     = &sender->descriptor;
+  header_bit_len = descriptor->rule_id_len + descriptor->dtag_len +
+                   descriptor->w_len + descriptor->fcn_len;
+
+  if (8 * fragment_max_byte_len < header_bit_len) {
+    return 0;
+  }
+
+  max_card_tiles = (8 * fragment_max_byte_len - header_bit_len) /
+                   (8 * descriptor->tile_byte_len);
+  window_position = tile_index % descriptor->window_size;
+
+  // Consecutive tiles of the same window, the last one may be shorter
+  card_tiles = 0;
+  while (card_tiles < max_card_tiles &&
+         window_position + card_tiles < descriptor->window_size &&
+         tile_index + card_tiles < sender->card_tiles &&
+         (bitmap == NULL ||
+          __get_tile_bit(bitmap, window_position + card_tiles))) {
+    card_tiles++;
+  }
+
+  // The last tile may be shorter and fit where a whole tile does not
+  if (card_tiles == 0 && tile_index == sender->card_tiles - 1) {
+    card_tiles = 1;
+  }
+  if (card_tiles == 0) {
+    return 0;
+  }
+
+  byte_position    = tile_index * descriptor->tile_byte_len;
+  payload_byte_len = card_tiles * descriptor->tile_byte_len;
+  if (byte_position + payload_byte_len > sender->schc_packet_byte_len) {
+    payload_byte_len = sender->schc_packet_byte_len - byte_position;
+  }
+
+  fragment_byte_len = __build_fragment(
+      sender, fragment, fragment_max_byte_len,
+      (uint8_t) (tile_index / descriptor->window_size),
+      (uint8_t) (descriptor->window_size - 1 - window_position), 0,
+      byte_position, payload_byte_len);
+  if (fragment_byte_len == 0) {
+    return 0;
+  }
+
+  if (bitmap != NULL) {
+    for (size_t index = 0; index < card_tiles; index++) {
+      bitmap[(window_position + index) / 8] &=
+          (uint8_t) ~(0x80 >> ((window_position + index) % 8));
+    }
+  } else {
+    sender->byte_position = byte_position + payload_byte_len;
+  }
+
+  return fragment_byte_len;
+}
+
+/* ********************************************************************** */
+
+static void __retransmission_timeout(wheel_timer_t *timer) {
+  fragmentation_sender_t *sender;
+
+  sender = (fragmentation_sender_t *) timer->owner;
+
+  if (sender->step != SENDER_WAIT_ACK) {
+    return;
+  }
+
+  // Ask again for the SCHC ACK, MAX_ACK_REQUESTS times at most
+  if (sender->card_ack_requests >= sender->descriptor.max_ack_requests) {
+    sender->step       = SENDER_SEND_ABORT;
+    sender->is_aborted = 1;
+  } else {
+    sender->card_ack_requests++;
+    sender->step = SENDER_SEND_ACK_REQ;
+  }
+}
+
+/* ********************************************************************** */
+
+static void __inactivity_timeout(wheel_timer_t *timer) {
+  fragmentation_receiver_t *receiver;
+
+  receiver = (fragmentation_receiver_t *) timer->owner;
+
+  if (receiver->buffer == NULL) {
+    return;
+  }
+
+  reset_fragmentation_receiver(receiver);
+
+  if (receiver->descriptor.mode == FRAGMENTATION_ACK_ON_ERROR) {
+    receiver->is_ack_pending   = 0;
+    receiver->is_abort_pending = 1;
+  }
+}
+
+/* ********************************************************************** */
+
+static reassembly_status_t __receive_no_ack_fragment(
+    fragmentation_receiver_t *receiver, const fragment_header_t *header,
+    const uint8_t *fragment, const size_t fragment_byte_len) {
+  size_t   bit_position;
+  size_t   payload_byte_len;
+  uint32_t rcs;
+  uint8_t  rcs_byte;
+  int      is_all_1;
+
+  // A new DTag, or a fragment after a complete SCHC Packet, starts over
+  if (receiver->buffer != NULL &&
+      (receiver->is_complete || header->dtag != receiver->dtag)) {
+    reset_fragmentation_receiver(receiver);
+  }
+
+  if (receiver->buffer == NULL && !__start_reassembly(receiver, header->dtag)) {
+    return REASSEMBLY_ERROR;
+  }
+
+  // No-ACK numbers regular fragments All-0
+  is_all_1     = header->fcn == __all_1_fcn(&receiver->descriptor);
+  bit_position = header->bit_len;
+  rcs          = 0;
+
+  if (!is_all_1 && header->fcn != 0) {
+    reset_fragmentation_receiver(receiver);
+    return REASSEMBLY_ERROR;
+  }
+
+  if (is_all_1) {
+    for (int index = 0; index < RCS_BIT_LEN / 8; index++) {
+      if (!__read_field(&rcs_byte, 8, &bit_position, fragment,
+                        fragment_byte_len)) {
+        reset_fragmentation_receiver(receiver);
+        return REASSEMBLY_ERROR;
+      }
+      rcs = (rcs << 8) | rcs_byte;
+    }
+  }
+
+  // Padding is shorter than a byte, whereas tiles are whole bytes
+  payload_byte_len = (8 * fragment_byte_len - bit_position) / 8;
+
+  if ((!is_all_1 && (payload_byte_len == 0 ||
+                     payload_byte_len % receiver->descriptor.tile_byte_len)) ||
+      receiver->byte_len + payload_byte_len >
+          receiver->reassembly_pool->buffer_byte_len) {
+    reset_fragmentation_receiver(receiver);
+    return REASSEMBLY_ERROR;
+  }
+
+  __read_bytes(receiver->buffer + receiver->byte_len, fragment, bit_position,
+               payload_byte_len);
+  receiver->crc = crc32_update(
+      receiver->crc, receiver->buffer + receiver->byte_len, payload_byte_len);
+  receiver->byte_len += payload_byte_len;
+
+  if (!is_all_1) {
+    return REASSEMBLY_IN_PROGRESS;
+  }
+
+  if (crc32_final(receiver->crc) != rcs) {
+    reset_fragmentation_receiver(receiver);
+    return REASSEMBLY_ERROR;
+  }
+
+  receiver->is_complete = 1;
+  if (receiver->timer_wheel != NULL) {
+    stop_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer);
+  }
+
+  return REASSEMBLY_COMPLETE;
+}
+
+/* ********************************************************************** */
+
+static reassembly_status_t __receive_ack_on_error_fragment(
+    fragmentation_receiver_t *receiver, const fragment_header_t *header,
+    const uint8_t *fragment, const size_t fragment_byte_len) {
+  const fragmentation_descriptor_t *descriptor;
+  size_t                            bit_position;
+  size_t                            payload_byte_len;
+  size_t                            tile_index;
+  size_t                            card_tiles;
+  size_t                            byte_position;
+  uint32_t                          rcs;
+  uint8_t                           rcs_byte;
+  int                               is_all_1;
+
+  descriptor   = &receiver->descriptor;
+  is_all_1     = header->fcn == __all_1_fcn(descriptor);
+  bit_position = header->bit_len;
+
+  // A Sender-Abort is an All-1 fragment too short for the RCS
+  if (is_all_1 && 8 * fragment_byte_len - bit_position < RCS_BIT_LEN) {
+    reset_fragmentation_receiver(receiver);
+    receiver->is_complete    = 0;
+    receiver->is_ack_pending = 0;
+    return REASSEMBLY_ERROR;
+  }
+
+  payload_byte_len = (8 * fragment_byte_len - bit_position) / 8;
+
+  // The SCHC ACK was lost, the All-1 fragment or an ACK REQ asks for it again
+  if (receiver->is_complete) {
+    if (header->dtag == receiver->dtag && (is_all_1 || payload_byte_len == 0)) {
+      if (receiver->timer_wheel != NULL) {
+        stop_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer);
+      }
+      receiver->is_ack_pending = 1;
+      return REASSEMBLY_IN_PROGRESS;
+    }
+    reset_fragmentation_receiver(receiver);
+    receiver->is_complete = 0;
+  }
+
+  if (receiver->buffer != NULL && header->dtag != receiver->dtag) {
+    reset_fragmentation_receiver(receiver);
+  }
+
+  if (receiver->buffer == NULL && !__start_reassembly(receiver, header->dtag)) {
+    return REASSEMBLY_ERROR;
+  }
+
+  // A window without a tile in the reassembly buffer cannot be acknowledged
+  if ((size_t) header->w * descriptor->window_size >=
+      __get_tile_capacity(receiver)) {
+    reset_fragmentation_receiver(receiver);
+    return REASSEMBLY_ERROR;
+  }
+
+  if (is_all_1) {
+    rcs = 0;
+    for (int index = 0; index < RCS_BIT_LEN / 8; index++) {
+      __read_field(&rcs_byte, 8, &bit_position, fragment, fragment_byte_len);
+      rcs = (rcs << 8) | rcs_byte;
+    }
+    receiver->rcs               = rcs;
+    receiver->last_window       = header->w;
+    receiver->is_all_1_received = 1;
+  } else if (payload_byte_len > 0) {
+    if (header->fcn >= descriptor->window_size) {
+      reset_fragmentation_receiver(receiver);
+      return REASSEMBLY_ERROR;
+    }
+
+    tile_index = (size_t) header->w * descriptor->window_size +
+                 (descriptor->window_size - 1 - header->fcn);
+    byte_position = tile_index * descriptor->tile_byte_len;
+    if (byte_position + payload_byte_len >
+        receiver->reassembly_pool->buffer_byte_len) {
+      reset_fragmentation_receiver(receiver);
+      return REASSEMBLY_ERROR;
+    }
+
+    __read_bytes(receiver->buffer + byte_position, fragment, bit_position,
+                 payload_byte_len);
+
+    card_tiles = (payload_byte_len + descriptor->tile_byte_len - 1) /
+                 descriptor->tile_byte_len;
+    for (size_t index = tile_index; index < tile_index + card_tiles; index++) {
+      if (!__get_tile_bit(receiver->bitmap, index)) {
+        __set_tile_bit(receiver->bitmap, index);
+        receiver->card_received_tiles++;
+      }
+    }
+
+    if (tile_index + card_tiles >= receiver->card_tiles) {
+      receiver->card_tiles = tile_index + card_tiles;
+      receiver->last_tile_byte_len =
+          payload_byte_len - (card_tiles - 1) * descriptor->tile_byte_len;
+    }
+    if (!receiver->is_all_1_received && header->w > receiver->last_window) {
+      receiver->last_window = header->w;
+    }
+
+    // Tiles are only acknowledged on request
+    return REASSEMBLY_IN_PROGRESS;
+  }
+
+  // All-1 fragment or ACK REQ, the windows after the last tile received may
+  // have been lost altogether
+  if (header->w > receiver->last_window) {
+    receiver->last_window = header->w;
+  }
+  receiver->is_ack_pending = 1;
+
+  if (!receiver->is_all_1_received || receiver->card_tiles == 0 ||
+      receiver->card_received_tiles != receiver->card_tiles) {
+    return REASSEMBLY_IN_PROGRESS;
+  }
+
+  receiver->byte_len =
+      (receiver->card_tiles - 1) * descriptor->tile_byte_len +
+      receiver->last_tile_byte_len;
+  if (crc32(receiver->buffer, receiver->byte_len) != receiver->rcs) {
+    return REASSEMBLY_IN_PROGRESS;
+  }
+
+  receiver->is_complete = 1;
+  if (receiver->timer_wheel != NULL) {
+    stop_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer);
+  }
+
+  return REASSEMBLY_COMPLETE;
+}
+
+/* ********************************************************************** */
+
+static int __start_reassembly(fragmentation_receiver_t *receiver,
+                              const uint8_t             dtag) {
+  receiver->buffer = acquire_reassembly_buffer(receiver->reassembly_pool,
+                                               receiver->device_id);
+  if (receiver->buffer == NULL) {
+    if (receiver->timer_wheel != NULL) {
+      stop_wheel_timer(receiver->timer_wheel, &receiver->inactivity_timer);
+    }
+    return 0;
+  }
+
+  receiver->bitmap =
+      __get_reassembly_bitmap(receiver->reassembly_pool, receiver->buffer);
+  if (receiver->descriptor.mode == FRAGMENTATION_ACK_ON_ERROR) {
+    memset(receiver->bitmap, 0x00,
+           BYTE_LENGTH(receiver->reassembly_pool->buffer_byte_len));
+  }
+
+  receiver->byte_len            = 0;
+  receiver->crc                 = CRC32_INIT;
+  receiver->card_tiles          = 0;
+  receiver->card_received_tiles = 0;
+  receiver->last_tile_byte_len  = 0;
+  receiver->dtag                = dtag;
+  receiver->last_window         = 0;
+  receiver->is_all_1_received   = 0;
+  receiver->is_ack_pending      = 0;
+  receiver->is_abort_pending    = 0;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __write_bytes(uint8_t *buffer, const size_t bit_position,
+                          const uint8_t *content, const size_t byte_len) {
+  size_t byte_pos;
+  size_t bit_offset;
+
+  byte_pos   = bit_position / 8;
+  bit_offset = bit_position % 8;
+
+  if (bit_offset == 0) {
+    memcpy(buffer + byte_pos, content, byte_len);
+    return;
+  }
+
+  for (size_t index = 0; index < byte_len; index++) {
+    buffer[byte_pos + index] |= content[index] >> bit_offset;
+    buffer[byte_pos + index + 1] =
+        (uint8_t) (content[index] << (8 - bit_offset));
+  }
+}
+
+/* ********************************************************************** */
+
+static void __read_bytes(uint8_t *content, const uint8_t *buffer,
+                         const size_t bit_position, const size_t byte_len) {
+  size_t byte_pos;
+  size_t bit_offset;
+
+  byte_pos   = bit_position / 8;
+  bit_offset = bit_position % 8;
+
+  if (bit_offset == 0) {
+    memcpy(content, buffer + byte_pos, byte_len);
+    return;
+  }
+
+  for (size_t index = 0; index < byte_len; index++) {
+    content[index] =
+        (uint8_t) ((buffer[byte_pos + index] << bit_offset) |
+                   (buffer[byte_pos + index + 1] >> (8 - bit_offset)));
+  }
+}
\ No newline at end of file
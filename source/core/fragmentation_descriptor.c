@@ -0,0 +1,77 @@
+#include "fragmentation_descriptor.h"
+#include "utils/binary.h"
+
+/* ********************************************************************** */
+
+int get_fragmentation_descriptor(
+    fragmentation_descriptor_t *fragmentation_descriptor,
+    const rule_descriptor_t *rule_descriptor, const uint8_t *context,
+    const size_t context_byte_len) {
+  size_t position;
+
+  if (rule_descriptor->nature != NATURE_FRAGMENTATION ||
+      !validate_fragmentation_descriptor(rule_descriptor->offset, context,
+                                         context_byte_len)) {
+    return 0;
+  }
+
+  position = (size_t) rule_descriptor->offset + 3;
+
+  fragmentation_descriptor->rule_id = rule_descriptor->id;
+  fragmentation_descriptor->rule_id_len =
+      bits_counter(context[CARD_RULE_DESCRIPTOR_OFFSET] - 1);
+  fragmentation_descriptor->mode             = context[position];
+  fragmentation_descriptor->di               = context[position + 1];
+  fragmentation_descriptor->dtag_len         = context[position + 2];
+  fragmentation_descriptor->w_len            = context[position + 3];
+  fragmentation_descriptor->fcn_len          = context[position + 4];
+  fragmentation_descriptor->window_size      = context[position + 5];
+  fragmentation_descriptor->max_ack_requests = context[position + 6];
+  fragmentation_descriptor->tile_byte_len =
+      merge_uint8_t(context[position + 7], context[position + 8]);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int validate_fragmentation_descriptor(const uint16_t rule_descriptor_offset,
+                                      const uint8_t *context,
+                                      const size_t   context_byte_len) {
+  size_t   position;
+  uint8_t  mode;
+  uint8_t  di;
+  uint8_t  w_len;
+  uint8_t  fcn_len;
+  uint8_t  window_size;
+  uint16_t tile_byte_len;
+
+  // A Fragmentation Rule has no Rule Field Descriptor
+  position = (size_t) rule_descriptor_offset + 3;
+  if (position + FRAGMENTATION_DESCRIPTOR_BYTE_LEN > context_byte_len ||
+      context[rule_descriptor_offset + 2] != 0) {
+    return 0;
+  }
+
+  mode          = context[position];
+  di            = context[position + 1];
+  w_len         = context[position + 3];
+  fcn_len       = context[position + 4];
+  window_size   = context[position + 5];
+  tile_byte_len = merge_uint8_t(context[position + 7], context[position + 8]);
+
+  // Fragments travel in a single direction, every field fits in a byte
+  if (mode > FRAGMENTATION_ACK_ON_ERROR || di > DI_DW ||
+      context[position + 2] > 8 || w_len > 8 || fcn_len == 0 ||
+      fcn_len > 8 || tile_byte_len == 0) {
+    return 0;
+  }
+
+  // No-ACK numbers no window, the other modes count tiles down from
+  // WINDOW_SIZE - 1, the All-1 FCN being reserved
+  if (mode == FRAGMENTATION_NO_ACK) {
+    return w_len == 0;
+  }
+
+  return w_len > 0 && window_size > 0 && window_size < (1u << fcn_len);
+}
\ No newline at end of file
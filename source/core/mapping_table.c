@@ -0,0 +1,318 @@
+#include "mapping_table.h"
+#include "utils/binary.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks if a Rule Field Descriptor of a Compiled Rule gets a Mapping
+ * Table.
+ *
+ * @param compiled_rule Pointer to the Compiled Rule.
+ * @param index Index of the Rule Field Descriptor.
+ * @return 1 if the Rule Field Descriptor gets a Mapping Table, otherwise 0.
+ */
+static int __has_mapping_table(const compiled_rule_t *compiled_rule,
+                               const unsigned int     index);
+
+/**
+ * @brief Compares the first byte and the following ones of a Field with a
+ * Target Value.
+ *
+ * @param first_byte First byte of the Field, masked.
+ * @param next_bytes Pointer to the following bytes of the Field.
+ * @param target_value Pointer to the Target Value.
+ * @param byte_len Byte length of the Field.
+ * @return A negative value, 0 or a positive value if the Field is lower, equal
+ * or greater than the Target Value.
+ */
+static int __compare_target_value(const uint8_t  first_byte,
+                                  const uint8_t *next_bytes,
+                                  const uint8_t *target_value,
+                                  const size_t   byte_len);
+
+/**
+ * @brief Fills a Mapping Table from its list of Target Values.
+ *
+ * @param mapping_table Pointer to the Mapping Table, with its list offset,
+ * Field Length, cardinality and entries set.
+ * @param context Pointer to the validated SCHC Context.
+ */
+static void __fill_mapping_table(mapping_table_t *mapping_table,
+                                 const uint8_t   *context);
+
+/**
+ * @brief Compares a list offset with the one of a Mapping Table.
+ *
+ * @param first_target_value_offset Offset of the list.
+ * @param mapping_table Pointer to the Mapping Table.
+ * @return A negative value, 0 or a positive value if the list comes before,
+ * with or after the one of the Mapping Table.
+ */
+static int __compare_mapping_table(const uint16_t first_target_value_offset,
+                                   const mapping_table_t *mapping_table);
+
+/* ********************************************************************** */
+
+int init_mapping_tables(mapping_tables_t       *mapping_tables,
+                        const compiled_rules_t *compiled_rules,
+                        const uint8_t          *context) {
+  size_t                 card_tables;
+  size_t                 card_entries;
+  size_t                 index_table;
+  const compiled_rule_t *compiled_rule;
+  mapping_table_t        mapping_table;
+
+  memset(mapping_tables, 0x00, sizeof(mapping_tables_t));
+
+  // Upper bounds, Rules sharing a list are only counted once below
+  card_tables  = 0;
+  card_entries = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    compiled_rule = &compiled_rules->rules[index];
+    for (unsigned int index_rule_field_descriptor = 0;
+         index_rule_field_descriptor <
+         compiled_rule->card_rule_field_descriptor;
+         index_rule_field_descriptor++) {
+      if (__has_mapping_table(compiled_rule, index_rule_field_descriptor)) {
+        card_tables++;
+        card_entries +=
+            compiled_rule->card_target_values[index_rule_field_descriptor];
+      }
+    }
+  }
+
+  if (card_tables == 0) {
+    return 1;
+  }
+
+  mapping_tables->tables =
+      (mapping_table_t *) malloc(card_tables * sizeof(mapping_table_t));
+  mapping_tables->entries =
+      (mapping_entry_t *) malloc(card_entries * sizeof(mapping_entry_t));
+  if (mapping_tables->tables == NULL || mapping_tables->entries == NULL) {
+    destroy_mapping_tables(mapping_tables);
+    return 0;
+  }
+
+  card_entries = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    compiled_rule = &compiled_rules->rules[index];
+    for (unsigned int index_rule_field_descriptor = 0;
+         index_rule_field_descriptor <
+         compiled_rule->card_rule_field_descriptor;
+         index_rule_field_descriptor++) {
+      if (!__has_mapping_table(compiled_rule, index_rule_field_descriptor)) {
+        continue;
+      }
+      mapping_table.first_target_value_offset =
+          compiled_rule->target_value_offsets[index_rule_field_descriptor];
+      mapping_table.len = compiled_rule->lens[index_rule_field_descriptor];
+      mapping_table.card_target_value =
+          compiled_rule->card_target_values[index_rule_field_descriptor];
+
+      // Tables are kept sorted, a shared list already has its table
+      index_table = mapping_tables->card_tables;
+      while (index_table > 0 &&
+             __compare_mapping_table(
+                 mapping_table.first_target_value_offset,
+                 &mapping_tables->tables[index_table - 1]) < 0) {
+        index_table--;
+      }
+      if (index_table > 0 &&
+          __compare_mapping_table(mapping_table.first_target_value_offset,
+                                  &mapping_tables->tables[index_table - 1]) ==
+              0) {
+        continue;
+      }
+
+      mapping_table.entries = mapping_tables->entries + card_entries;
+      __fill_mapping_table(&mapping_table, context);
+      card_entries += mapping_table.card_entries;
+
+      memmove(&mapping_tables->tables[index_table + 1],
+              &mapping_tables->tables[index_table],
+              (mapping_tables->card_tables - index_table) *
+                  sizeof(mapping_table_t));
+      mapping_tables->tables[index_table] = mapping_table;
+      mapping_tables->card_tables++;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_mapping_tables(mapping_tables_t *mapping_tables) {
+  free(mapping_tables->tables);
+  free(mapping_tables->entries);
+  memset(mapping_tables, 0x00, sizeof(mapping_tables_t));
+}
+
+/* ********************************************************************** */
+
+const mapping_table_t *get_mapping_table(
+    const mapping_tables_t        *mapping_tables,
+    const rule_field_descriptor_t *rule_field_descriptor) {
+  size_t low;
+  size_t high;
+  size_t middle;
+  int    comparison;
+
+  low  = 0;
+  high = mapping_tables->card_tables;
+  while (low < high) {
+    middle     = low + (high - low) / 2;
+    comparison = __compare_mapping_table(
+        rule_field_descriptor->first_target_value_offset,
+        &mapping_tables->tables[middle]);
+
+    if (comparison == 0) {
+      return &mapping_tables->tables[middle];
+    } else if (comparison < 0) {
+      high = middle;
+    } else {
+      low = middle + 1;
+    }
+  }
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+int lookup_mapping_table(uint8_t *mapping_index, const uint8_t *field,
+                         const mapping_table_t *mapping_table,
+                         const uint8_t         *context) {
+  size_t  low;
+  size_t  high;
+  size_t  middle;
+  size_t  byte_len;
+  uint8_t first_byte;
+
+  byte_len   = BYTE_LENGTH(mapping_table->len);
+  first_byte = field[0] & mapping_table->mask;
+
+  // Lowest entry not lower than the Field, the lowest index among equal ones
+  low  = 0;
+  high = mapping_table->card_entries;
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    if (__compare_target_value(
+            first_byte, field + 1,
+            context + mapping_table->entries[middle].target_value_offset,
+            byte_len) > 0) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+
+  if (low == mapping_table->card_entries ||
+      __compare_target_value(
+          first_byte, field + 1,
+          context + mapping_table->entries[low].target_value_offset,
+          byte_len) != 0) {
+    return 0;
+  }
+
+  *mapping_index = mapping_table->entries[low].index;
+  return 1;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __has_mapping_table(const compiled_rule_t *compiled_rule,
+                               const unsigned int     index) {
+  direction_indicator_t              di;
+  matching_operator_t                mo;
+  compression_decompression_action_t cda;
+
+  unpack_di_mo_cda(&di, &mo, &cda, compiled_rule->di_mo_cdas[index]);
+
+  // Variable-Length Fields are compared on their first byte, see
+  // __MO_equal_from_offset(...), and are left to CDA_mapping_sent(...)
+  return compiled_rule->nature == NATURE_COMPRESSION &&
+         cda == CDA_MAPPING_SENT && compiled_rule->lens[index] > 0 &&
+         compiled_rule->card_target_values[index] > 1;
+}
+
+/* ********************************************************************** */
+
+static int __compare_target_value(const uint8_t  first_byte,
+                                  const uint8_t *next_bytes,
+                                  const uint8_t *target_value,
+                                  const size_t   byte_len) {
+  if (first_byte != target_value[0]) {
+    return first_byte < target_value[0] ? -1 : 1;
+  }
+
+  return memcmp(next_bytes, target_value + 1, byte_len - 1);
+}
+
+/* ********************************************************************** */
+
+static void __fill_mapping_table(mapping_table_t *mapping_table,
+                                 const uint8_t   *context) {
+  size_t          byte_len;
+  size_t          index_entry;
+  uint16_t        target_value_offset;
+  mapping_entry_t entry;
+
+  byte_len = BYTE_LENGTH(mapping_table->len);
+
+  // Same mask as __MO_equal_from_offset(...)
+  mapping_table->mask = (1 << (8 - (mapping_table->len % 8))) - 1;
+  mapping_table->card_entries = 0;
+
+  // Insertion sort, stable so that equal Target Values keep the lowest index
+  // first
+  for (uint8_t index = 0; index < mapping_table->card_target_value;
+       index++) {
+    target_value_offset = merge_uint8_t(
+        context[mapping_table->first_target_value_offset + 2 * index],
+        context[mapping_table->first_target_value_offset + 2 * index + 1]);
+
+    // A first byte outside of the mask never equals a masked Field
+    if (context[target_value_offset] & ~mapping_table->mask) {
+      continue;
+    }
+
+    entry.target_value_offset = target_value_offset;
+    entry.index               = index;
+
+    index_entry = mapping_table->card_entries;
+    while (index_entry > 0 &&
+           __compare_target_value(
+               context[target_value_offset], context + target_value_offset + 1,
+               context +
+                   mapping_table->entries[index_entry - 1].target_value_offset,
+               byte_len) < 0) {
+      mapping_table->entries[index_entry] =
+          mapping_table->entries[index_entry - 1];
+      index_entry--;
+    }
+    mapping_table->entries[index_entry] = entry;
+    mapping_table->card_entries++;
+  }
+}
+
+/* ********************************************************************** */
+
+static int __compare_mapping_table(const uint16_t first_target_value_offset,
+                                   const mapping_table_t *mapping_table) {
+  if (first_target_value_offset != mapping_table->first_target_value_offset) {
+    return first_target_value_offset < mapping_table->first_target_value_offset
+               ? -1
+               : 1;
+  }
+
+  return 0;
+}
\ No newline at end of file
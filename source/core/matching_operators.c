@@ -4,6 +4,24 @@
 
 #include <string.h>
 
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks the Most Significant Bits of a Field longer than the integers
+ * of MO_most_significant_bits(...), with byte shifts.
+ *
+ * @param field Pointer to the Field Value.
+ * @param rule_field_descriptor Pointer to the corresponding Rule Field
+ * Descriptor.
+ * @param context Pointer to the SCHC Context.
+ * @return The matching result, 1 for success, otherwise 0.
+ */
+static int __MO_most_significant_bits_bytes(
+    const uint8_t* field, const rule_field_descriptor_t* rule_field_descriptor,
+    const uint8_t* context);
+
 /* ********************************************************************** */
 
 int MO_equal(const uint8_t*                 field,
@@ -41,39 +59,56 @@ int MO_ignore(void) { return 1; }
 int MO_most_significant_bits(
     const uint8_t* field, const rule_field_descriptor_t* rule_field_descriptor,
     const uint8_t* context, const size_t context_len) {
-  int      status;
-  size_t   msb_field_byte_len;
-  size_t   msb_field_final_byte_len;
-  uint8_t* msb_field;
-
-  msb_field_byte_len = BYTE_LENGTH(rule_field_descriptor->len);
-  // Allocate msb_field from the pool
-  msb_field = (uint8_t*) pool_alloc(sizeof(uint8_t) * msb_field_byte_len);
-
-  memcpy(msb_field, field, msb_field_byte_len);
-  msb_field_final_byte_len =
-      right_shift(msb_field, msb_field_byte_len,
-                  rule_field_descriptor->len - rule_field_descriptor->msb_len);
-
-  if (msb_field_final_byte_len == 0) {
+  size_t    field_byte_len;
+  size_t    lsb_len;
+  size_t    msb_field_byte_len;
+  uint8_t   msb_unused_bits;
+  uint64_t  msb_field;
+#ifdef __SIZEOF_INT128__
+  uint128_t long_msb_field;
+#endif
+
+  field_byte_len = BYTE_LENGTH(rule_field_descriptor->len);
+  lsb_len = rule_field_descriptor->len - rule_field_descriptor->msb_len;
+
+  // As right_shift(...) does not shift by 0 bits, a Field without LSB does not
+  // match
+  if (lsb_len == 0) {
     return 0;
   }
 
-  // Put to zero unnecessary part
-  if (rule_field_descriptor->msb_len % 8 != 0) {
-    msb_field[0] &= (1 << (rule_field_descriptor->msb_len % 8)) - 1;
+  // The MSB are compared on the bytes left once the LSB are shifted out, the
+  // unused bits of the first one being put to zero
+  msb_field_byte_len = field_byte_len - lsb_len / 8;
+  msb_unused_bits    = (rule_field_descriptor->msb_len % 8 != 0)
+                           ? 0xff << (rule_field_descriptor->msb_len % 8)
+                           : 0x00;
+
+  if (field_byte_len <= sizeof(uint64_t)) {
+    msb_field = load_uint64_t(field, field_byte_len) >> lsb_len;
+    msb_field &= ~((uint64_t) msb_unused_bits << 8 * (msb_field_byte_len - 1));
+
+    return msb_field ==
+           load_uint64_t(
+               context + rule_field_descriptor->first_target_value_offset,
+               msb_field_byte_len);
   }
 
-  status = (memcmp(msb_field,
-                   context + rule_field_descriptor->first_target_value_offset,
-                   msb_field_final_byte_len) == 0)
-               ? 1
-               : 0;
+#ifdef __SIZEOF_INT128__
+  if (field_byte_len <= sizeof(uint128_t)) {
+    long_msb_field = load_uint128_t(field, field_byte_len) >> lsb_len;
+    long_msb_field &=
+        ~((uint128_t) msb_unused_bits << 8 * (msb_field_byte_len - 1));
 
-  // Deallocate msb_field from the pool
-  pool_dealloc(msb_field, sizeof(uint8_t) * msb_field_byte_len);
+    return long_msb_field ==
+           load_uint128_t(
+               context + rule_field_descriptor->first_target_value_offset,
+               msb_field_byte_len);
+  }
+#endif
 
-  return status;
+  return __MO_most_significant_bits_bytes(field, rule_field_descriptor,
+                                          context);
 }
 
 /* ********************************************************************** */
@@ -127,5 +162,48 @@ int __MO_equal_from_offset(const uint8_t*                 field,
                           BYTE_LENGTH(rule_field_descriptor->len) - 1) == 0);
   }
 
+  return status;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __MO_most_significant_bits_bytes(
+    const uint8_t* field, const rule_field_descriptor_t* rule_field_descriptor,
+    const uint8_t* context) {
+  int      status;
+  size_t   msb_field_byte_len;
+  size_t   msb_field_final_byte_len;
+  uint8_t* msb_field;
+
+  msb_field_byte_len = BYTE_LENGTH(rule_field_descriptor->len);
+  // Allocate msb_field from the pool
+  msb_field = (uint8_t*) pool_alloc(sizeof(uint8_t) * msb_field_byte_len);
+
+  memcpy(msb_field, field, msb_field_byte_len);
+  msb_field_final_byte_len =
+      right_shift(msb_field, msb_field_byte_len,
+                  rule_field_descriptor->len - rule_field_descriptor->msb_len);
+
+  if (msb_field_final_byte_len == 0) {
+    pool_dealloc(msb_field, sizeof(uint8_t) * msb_field_byte_len);
+    return 0;
+  }
+
+  // Put to zero unnecessary part
+  if (rule_field_descriptor->msb_len % 8 != 0) {
+    msb_field[0] &= (1 << (rule_field_descriptor->msb_len % 8)) - 1;
+  }
+
+  status = (memcmp(msb_field,
+                   context + rule_field_descriptor->first_target_value_offset,
+                   msb_field_final_byte_len) == 0)
+               ? 1
+               : 0;
+
+  // Deallocate msb_field from the pool
+  pool_dealloc(msb_field, sizeof(uint8_t) * msb_field_byte_len);
+
   return status;
 }
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "pipeline.h"
+#include "compression.h"
+#include "decompression.h"
+#include "utils/memory.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Worker thread, processes the pending batches until the Pipeline
+ * stops.
+ *
+ * @param arg Pointer to the Pipeline.
+ * @return NULL.
+ */
+static void *__pipeline_worker(void *arg);
+
+/* ********************************************************************** */
+
+pipeline_t *create_pipeline(const size_t card_workers,
+                            const size_t max_batches_in_flight) {
+  pipeline_t *pipeline;
+
+  if (card_workers == 0 || card_workers > PIPELINE_MAX_WORKERS) {
+    return NULL;
+  }
+
+  // The counters are on their own cache lines
+  pipeline = (pipeline_t *) aligned_alloc(64, sizeof(pipeline_t));
+  if (pipeline == NULL) {
+    return NULL;
+  }
+  memset(pipeline, 0x00, sizeof(pipeline_t));
+
+  if (!init_ring_buffer(&pipeline->pending_batches, max_batches_in_flight)) {
+    free(pipeline);
+    return NULL;
+  }
+
+  pipeline->processed_batches = (_Atomic(pipeline_batch_t *) *) calloc(
+      pipeline->pending_batches.capacity, sizeof(pipeline_batch_t *));
+  if (pipeline->processed_batches == NULL) {
+    destroy_ring_buffer(&pipeline->pending_batches);
+    free(pipeline);
+    return NULL;
+  }
+  for (size_t index = 0; index < pipeline->pending_batches.capacity;
+       index++) {
+    atomic_init(&pipeline->processed_batches[index], NULL);
+  }
+  atomic_init(&pipeline->stop, 0);
+  atomic_init(&pipeline->card_submitted, 0);
+  atomic_init(&pipeline->card_received, 0);
+
+  for (size_t index = 0; index < card_workers; index++) {
+    if (pthread_create(&pipeline->workers[index], NULL, __pipeline_worker,
+                       pipeline) != 0) {
+      destroy_pipeline(pipeline);
+      return NULL;
+    }
+    pipeline->card_workers++;
+  }
+
+  return pipeline;
+}
+
+/* ********************************************************************** */
+
+void destroy_pipeline(pipeline_t *pipeline) {
+  if (pipeline == NULL) {
+    return;
+  }
+
+  atomic_store(&pipeline->stop, 1);
+  for (size_t index = 0; index < pipeline->card_workers; index++) {
+    pthread_join(pipeline->workers[index], NULL);
+  }
+
+  free(pipeline->processed_batches);
+  destroy_ring_buffer(&pipeline->pending_batches);
+  free(pipeline);
+}
+
+/* ********************************************************************** */
+
+int submit_pipeline_batch(pipeline_t *pipeline, pipeline_batch_t *batch) {
+  uint64_t sequence;
+
+  sequence =
+      atomic_load_explicit(&pipeline->card_submitted, memory_order_relaxed);
+  if (sequence - atomic_load_explicit(&pipeline->card_received,
+                                      memory_order_acquire) >=
+      pipeline->pending_batches.capacity) {
+    return 0;
+  }
+
+  // The ring buffer holds at most the batches in flight, it is never full
+  batch->sequence = sequence;
+  if (!ring_buffer_push(&pipeline->pending_batches, batch)) {
+    return 0;
+  }
+  atomic_store_explicit(&pipeline->card_submitted, sequence + 1,
+                        memory_order_release);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+pipeline_batch_t *receive_pipeline_batch(pipeline_t *pipeline) {
+  uint64_t          sequence;
+  pipeline_batch_t *batch;
+
+  sequence =
+      atomic_load_explicit(&pipeline->card_received, memory_order_relaxed);
+  batch = atomic_load_explicit(
+      &pipeline->processed_batches[sequence &
+                                   (pipeline->pending_batches.capacity - 1)],
+      memory_order_acquire);
+  if (batch == NULL) {
+    return NULL;
+  }
+
+  atomic_store_explicit(
+      &pipeline->processed_batches[sequence &
+                                   (pipeline->pending_batches.capacity - 1)],
+      NULL, memory_order_relaxed);
+  atomic_store_explicit(&pipeline->card_received, sequence + 1,
+                        memory_order_release);
+
+  return batch;
+}
+
+/* ********************************************************************** */
+
+void process_pipeline_batch(pipeline_batch_t *batch, flow_cache_t *flow_cache) {
+  pipeline_packet_t *packet;
+
+  for (size_t index = 0; index < batch->card_packets; index++) {
+    packet = &batch->packets[index];
+    if (batch->decompression) {
+      packet->output_byte_len = decompress_compiled(
+          packet->output, packet->output_max_byte_len, batch->direction,
+          packet->packet, packet->packet_byte_len, batch->compiled_context);
+    } else if (flow_cache != NULL) {
+      packet->output_byte_len = compress_compiled_cached(
+          packet->output, packet->output_max_byte_len, batch->direction,
+          packet->packet, packet->packet_byte_len, batch->compiled_context,
+          flow_cache);
+    } else {
+      packet->output_byte_len = compress_compiled(
+          packet->output, packet->output_max_byte_len, batch->direction,
+          packet->packet, packet->packet_byte_len, batch->compiled_context);
+    }
+  }
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static void *__pipeline_worker(void *arg) {
+  pipeline_t       *pipeline;
+  pipeline_batch_t *batch;
+  void             *item;
+
+  pipeline = (pipeline_t *) arg;
+  init_memory_pool();
+
+  while (!atomic_load_explicit(&pipeline->stop, memory_order_relaxed)) {
+    if (!ring_buffer_pop(&pipeline->pending_batches, &item)) {
+      sched_yield();
+      continue;
+    }
+
+    batch = (pipeline_batch_t *) item;
+    process_pipeline_batch(batch, NULL);
+
+    // No other batch in flight has the same slot
+    atomic_store_explicit(
+        &pipeline->processed_batches[batch->sequence &
+                                     (pipeline->pending_batches.capacity -
+                                      1)],
+        batch, memory_order_release);
+  }
+
+  destroy_memory_pool();
+
+  return NULL;
+}
\ No newline at end of file
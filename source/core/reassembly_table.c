@@ -0,0 +1,417 @@
+#include "reassembly_table.h"
+#include "utils/binary.h"
+#include "utils/memory.h"
+
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Computes the hash of a session key.
+ *
+ * @param device_id The device ID.
+ * @param rule_id Rule ID of the Fragmentation Rule.
+ * @param dtag Datagram Tag of the SCHC Packet.
+ * @return The hash of the key.
+ */
+static uint64_t __hash_session_key(uint64_t device_id, const uint8_t rule_id,
+                                   const uint8_t dtag);
+
+/**
+ * @brief Gets the index entry of a session.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param session_index Index of the session.
+ * @return The position of the index entry.
+ */
+static size_t __find_index_entry(const reassembly_table_t *table,
+                                 const uint32_t            session_index);
+
+/**
+ * @brief Removes the index entry of a session, moving back the entries that
+ * follow it so that no lookup stops early (backward shift deletion).
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param session_index Index of the session.
+ */
+static void __remove_index_entry(reassembly_table_t *table,
+                                 const uint32_t      session_index);
+
+/**
+ * @brief Removes a session from the least recently used list.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param session_index Index of the session.
+ */
+static void __unlink_session(reassembly_table_t *table,
+                             const uint32_t      session_index);
+
+/**
+ * @brief Appends a session to the least recently used list, as the most
+ * recently used session.
+ *
+ * @param table Pointer to the Reassembly Table.
+ * @param session_index Index of the session.
+ */
+static void __link_session(reassembly_table_t *table,
+                           const uint32_t      session_index);
+
+/**
+ * @brief Handles the expiry of the Inactivity Timer of a session.
+ *
+ * @param timer Pointer to the Inactivity Timer.
+ */
+static void __session_timeout(wheel_timer_t *timer);
+
+/* ********************************************************************** */
+
+int init_reassembly_table(reassembly_table_t *table, const size_t max_byte_len,
+                          const size_t   buffer_byte_len,
+                          timer_wheel_t *timer_wheel,
+                          const uint64_t inactivity_ticks) {
+  size_t max_sessions;
+  size_t index_capacity;
+
+  if (buffer_byte_len == 0 || timer_wheel == NULL) {
+    return 0;
+  }
+
+  max_sessions =
+      max_byte_len / get_reassembly_session_byte_len(buffer_byte_len);
+  if (max_sessions == 0 || max_sessions >= REASSEMBLY_SESSION_NONE / 2) {
+    return 0;
+  }
+
+  // At most half of the index is used
+  for (index_capacity = 2; index_capacity < 2 * max_sessions;
+       index_capacity *= 2) {
+  }
+
+  // Allocate sessions from the pool
+  table->sessions = (reassembly_session_t *) pool_alloc(
+      max_sessions * sizeof(reassembly_session_t));
+  if (table->sessions == NULL) {
+    return 0;
+  }
+
+  // Allocate index from the pool
+  table->index = (uint32_t *) pool_alloc(index_capacity * sizeof(uint32_t));
+  if (table->index == NULL) {
+    // Deallocate sessions from the pool
+    pool_dealloc(table->sessions, max_sessions * sizeof(reassembly_session_t));
+    return 0;
+  }
+
+  if (!init_reassembly_pool(&table->reassembly_pool, max_sessions,
+                            buffer_byte_len, max_sessions)) {
+    // Deallocate index and sessions from the pool
+    pool_dealloc(table->index, index_capacity * sizeof(uint32_t));
+    pool_dealloc(table->sessions, max_sessions * sizeof(reassembly_session_t));
+    return 0;
+  }
+
+  // Free sessions are chained by their next session
+  for (size_t session_index = 0; session_index < max_sessions;
+       session_index++) {
+    table->sessions[session_index].next =
+        session_index + 1 < max_sessions ? (uint32_t) (session_index + 1)
+                                         : REASSEMBLY_SESSION_NONE;
+  }
+  memset(table->index, REASSEMBLY_INDEX_EMPTY,
+         index_capacity * sizeof(uint32_t));
+
+  table->index_capacity   = index_capacity;
+  table->max_sessions     = max_sessions;
+  table->card_sessions    = 0;
+  table->least_recent     = REASSEMBLY_SESSION_NONE;
+  table->most_recent      = REASSEMBLY_SESSION_NONE;
+  table->first_free       = 0;
+  table->card_evictions   = 0;
+  table->timer_wheel      = timer_wheel;
+  table->inactivity_ticks = inactivity_ticks;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_reassembly_table(reassembly_table_t *table) {
+  while (table->least_recent != REASSEMBLY_SESSION_NONE) {
+    close_reassembly_session(table, &table->sessions[table->least_recent]);
+  }
+
+  destroy_reassembly_pool(&table->reassembly_pool);
+
+  // Deallocate index from the pool
+  pool_dealloc(table->index, table->index_capacity * sizeof(uint32_t));
+
+  // Deallocate sessions from the pool
+  pool_dealloc(table->sessions,
+               table->max_sessions * sizeof(reassembly_session_t));
+
+  memset(table, 0x00, sizeof(reassembly_table_t));
+}
+
+/* ********************************************************************** */
+
+size_t get_reassembly_session_byte_len(const size_t buffer_byte_len) {
+  // Up to 4 index entries per session as the index size is a power of 2, and
+  // the owner, free buffer, Device Table entries, bitmap and buffer of the
+  // Reassembly Pool, whose Device Table size is a power of 2 too
+  return sizeof(reassembly_session_t) + 4 * sizeof(uint32_t) +
+         sizeof(uint64_t) + sizeof(size_t) + 4 * sizeof(reassembly_device_t) +
+         BYTE_LENGTH(buffer_byte_len) + buffer_byte_len;
+}
+
+/* ********************************************************************** */
+
+reassembly_session_t *find_reassembly_session(const reassembly_table_t *table,
+                                              const uint64_t device_id,
+                                              const uint8_t  rule_id,
+                                              const uint8_t  dtag) {
+  reassembly_session_t *session;
+  size_t                mask;
+  size_t                position;
+
+  mask     = table->index_capacity - 1;
+  position = (size_t) __hash_session_key(device_id, rule_id, dtag) & mask;
+
+  while (table->index[position] != REASSEMBLY_INDEX_EMPTY) {
+    session = &table->sessions[table->index[position] - 1];
+    if (session->device_id == device_id && session->rule_id == rule_id &&
+        session->dtag == dtag) {
+      return session;
+    }
+    position = (position + 1) & mask;
+  }
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+reassembly_session_t *get_reassembly_session(
+    reassembly_table_t *table, const fragmentation_descriptor_t *descriptor,
+    const uint64_t device_id, const uint8_t *fragment,
+    const size_t fragment_byte_len) {
+  reassembly_session_t *session;
+  fragment_header_t     header;
+  uint32_t              session_index;
+  size_t                mask;
+  size_t                position;
+
+  if (descriptor->mode == FRAGMENTATION_ACK_ALWAYS ||
+      device_id == REASSEMBLY_BUFFER_FREE ||
+      !parse_fragment_header(&header, descriptor, fragment,
+                             fragment_byte_len) ||
+      header.rule_id != descriptor->rule_id) {
+    return NULL;
+  }
+
+  session =
+      find_reassembly_session(table, device_id, header.rule_id, header.dtag);
+  if (session != NULL) {
+    session_index = (uint32_t) (session - table->sessions);
+    __unlink_session(table, session_index);
+    __link_session(table, session_index);
+    return session;
+  }
+
+  // The table is full, the least recently used session makes room
+  if (table->first_free == REASSEMBLY_SESSION_NONE) {
+    close_reassembly_session(table, &table->sessions[table->least_recent]);
+    table->card_evictions++;
+  }
+
+  session_index     = table->first_free;
+  session           = &table->sessions[session_index];
+  table->first_free = session->next;
+
+  init_fragmentation_receiver(&session->receiver, descriptor,
+                              &table->reassembly_pool, device_id, NULL, 0);
+
+  session->device_id = device_id;
+  session->rule_id   = header.rule_id;
+  session->dtag      = header.dtag;
+  session->table     = table;
+  init_wheel_timer(&session->inactivity_timer, __session_timeout, session);
+
+  mask     = table->index_capacity - 1;
+  position = (size_t) __hash_session_key(device_id, header.rule_id,
+                                         header.dtag) &
+             mask;
+  while (table->index[position] != REASSEMBLY_INDEX_EMPTY) {
+    position = (position + 1) & mask;
+  }
+  table->index[position] = session_index + 1;
+
+  __link_session(table, session_index);
+  table->card_sessions++;
+
+  return session;
+}
+
+/* ********************************************************************** */
+
+reassembly_status_t receive_session_fragment(
+    reassembly_table_t *table, const fragmentation_descriptor_t *descriptor,
+    const uint64_t device_id, const uint8_t *fragment,
+    const size_t fragment_byte_len, reassembly_session_t **session) {
+  reassembly_status_t reassembly_status;
+
+  *session = get_reassembly_session(table, descriptor, device_id, fragment,
+                                    fragment_byte_len);
+  if (*session == NULL) {
+    return REASSEMBLY_ERROR;
+  }
+
+  start_wheel_timer(table->timer_wheel, &(*session)->inactivity_timer,
+                    table->inactivity_ticks);
+
+  reassembly_status =
+      receive_fragment(&(*session)->receiver, fragment, fragment_byte_len);
+  if (reassembly_status == REASSEMBLY_ERROR) {
+    close_reassembly_session(table, *session);
+    *session = NULL;
+  }
+
+  return reassembly_status;
+}
+
+/* ********************************************************************** */
+
+void close_reassembly_session(reassembly_table_t   *table,
+                              reassembly_session_t *session) {
+  uint32_t session_index;
+
+  session_index = (uint32_t) (session - table->sessions);
+
+  reset_fragmentation_receiver(&session->receiver);
+  stop_wheel_timer(table->timer_wheel, &session->inactivity_timer);
+
+  __remove_index_entry(table, session_index);
+  __unlink_session(table, session_index);
+
+  session->next     = table->first_free;
+  table->first_free = session_index;
+  table->card_sessions--;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static uint64_t __hash_session_key(uint64_t device_id, const uint8_t rule_id,
+                                   const uint8_t dtag) {
+  device_id ^= ((uint64_t) rule_id << 8 | dtag) * 0x9e3779b97f4a7c15ULL;
+  device_id = (device_id ^ (device_id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  device_id = (device_id ^ (device_id >> 27)) * 0x94d049bb133111ebULL;
+
+  return device_id ^ (device_id >> 31);
+}
+
+/* ********************************************************************** */
+
+static size_t __find_index_entry(const reassembly_table_t *table,
+                                 const uint32_t            session_index) {
+  const reassembly_session_t *session;
+  size_t                      mask;
+  size_t                      position;
+
+  session  = &table->sessions[session_index];
+  mask     = table->index_capacity - 1;
+  position = (size_t) __hash_session_key(session->device_id, session->rule_id,
+                                         session->dtag) &
+             mask;
+  while (table->index[position] != session_index + 1) {
+    position = (position + 1) & mask;
+  }
+
+  return position;
+}
+
+/* ********************************************************************** */
+
+static void __remove_index_entry(reassembly_table_t *table,
+                                 const uint32_t      session_index) {
+  const reassembly_session_t *session;
+  size_t                      mask;
+  size_t                      hole;
+  size_t                      position;
+  size_t                      home;
+
+  mask     = table->index_capacity - 1;
+  hole     = __find_index_entry(table, session_index);
+  position = hole;
+
+  while (1) {
+    position = (position + 1) & mask;
+    if (table->index[position] == REASSEMBLY_INDEX_EMPTY) {
+      break;
+    }
+
+    session = &table->sessions[table->index[position] - 1];
+    home    = (size_t) __hash_session_key(session->device_id, session->rule_id,
+                                          session->dtag) &
+           mask;
+
+    // The entry moves to the hole unless its home lies cyclically in
+    // (hole, position]
+    if (((position - home) & mask) >= ((position - hole) & mask)) {
+      table->index[hole] = table->index[position];
+      hole               = position;
+    }
+  }
+
+  table->index[hole] = REASSEMBLY_INDEX_EMPTY;
+}
+
+/* ********************************************************************** */
+
+static void __unlink_session(reassembly_table_t *table,
+                             const uint32_t      session_index) {
+  reassembly_session_t *session;
+
+  session = &table->sessions[session_index];
+
+  if (session->previous != REASSEMBLY_SESSION_NONE) {
+    table->sessions[session->previous].next = session->next;
+  } else {
+    table->least_recent = session->next;
+  }
+
+  if (session->next != REASSEMBLY_SESSION_NONE) {
+    table->sessions[session->next].previous = session->previous;
+  } else {
+    table->most_recent = session->previous;
+  }
+}
+
+/* ********************************************************************** */
+
+static void __link_session(reassembly_table_t *table,
+                           const uint32_t      session_index) {
+  reassembly_session_t *session;
+
+  session           = &table->sessions[session_index];
+  session->previous = table->most_recent;
+  session->next     = REASSEMBLY_SESSION_NONE;
+
+  if (table->most_recent != REASSEMBLY_SESSION_NONE) {
+    table->sessions[table->most_recent].next = session_index;
+  } else {
+    table->least_recent = session_index;
+  }
+  table->most_recent = session_index;
+}
+
+/* ********************************************************************** */
+
+static void __session_timeout(wheel_timer_t *timer) {
+  reassembly_session_t *session;
+
+  session = (reassembly_session_t *) timer->owner;
+  close_reassembly_session(session->table, session);
+}
\ No newline at end of file
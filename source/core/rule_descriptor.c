@@ -8,11 +8,31 @@ int get_rule_descriptor(rule_descriptor_t *rule_descriptor,
                         const size_t context_byte_len) {
   uint16_t rule_descriptor_offset;
 
-  if (index >= context[CARD_RULE_DESCRIPTOR_OFFSET] ||
+  if (context_byte_len <= CARD_RULE_DESCRIPTOR_OFFSET ||
+      index >= context[CARD_RULE_DESCRIPTOR_OFFSET] ||
       2 + 2 * index + 1 >= context_byte_len) {
     return 0;
   }
 
+  // ID, Nature and number of Rule Field Descriptors must be in the Context
+  rule_descriptor_offset =
+      merge_uint8_t(context[2 + 2 * index], context[2 + 2 * index + 1]);
+  if ((size_t) rule_descriptor_offset + 2 >= context_byte_len) {
+    return 0;
+  }
+
+  get_rule_descriptor_unchecked(rule_descriptor, index, context);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void get_rule_descriptor_unchecked(rule_descriptor_t *rule_descriptor,
+                                   const unsigned int index,
+                                   const uint8_t     *context) {
+  uint16_t rule_descriptor_offset;
+
   rule_descriptor_offset =
       merge_uint8_t(context[2 + 2 * index], context[2 + 2 * index + 1]);
 
@@ -20,6 +40,5 @@ int get_rule_descriptor(rule_descriptor_t *rule_descriptor,
   rule_descriptor->id     = context[rule_descriptor_offset++];
   rule_descriptor->nature = (nature_t) context[rule_descriptor_offset++];
   rule_descriptor->card_rule_field_descriptor = context[rule_descriptor_offset];
-
-  return 1;
+  rule_descriptor->compiled_rule              = NULL;
 }
\ No newline at end of file
@@ -1,6 +1,33 @@
 #include "rule_field_descriptor.h"
+#include "protocols/headers.h"
 #include "utils/binary.h"
 
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks if a SID is allowed to describe a Variable-Length Field, i.e.
+ * a Field defined with a length of 0.
+ *
+ * @param sid The SID of the Field.
+ * @return 1 if the Field can be Variable-Length, otherwise 0.
+ */
+static int __is_variable_length_sid(const uint16_t sid);
+
+/**
+ * @brief Computes the byte length read from a Target Value when matching a
+ * Field. A Variable-Length Field is at least compared on its first byte.
+ *
+ * @param len The length of the Field, 0 if it is Variable-Length.
+ * @param mo The Matching Operator of the Field.
+ * @param msb_len The MSB length of the Field, if mo is MO_MSB.
+ * @return The byte length of a Target Value of the Field.
+ */
+static size_t __get_target_value_byte_len(const uint16_t            len,
+                                          const matching_operator_t mo,
+                                          const uint16_t            msb_len);
+
 /* ********************************************************************** */
 
 void unpack_di_mo_cda(direction_indicator_t *di, matching_operator_t *mo,
@@ -19,14 +46,57 @@ int get_rule_field_descriptor(rule_field_descriptor_t *rule_field_descriptor,
                               const uint8_t           *context,
                               const size_t             context_byte_len) {
   uint16_t rule_field_descriptor_offset;
+  size_t   position;
 
   // context[rule_descriptor_offset + 2] represents the total number of the Rule
   // Field Descriptor in the corresponding Rule Descriptor.
-  if (index >= context[rule_descriptor_offset + 2] ||
+  if ((size_t) rule_descriptor_offset + 2 >= context_byte_len ||
+      index >= context[rule_descriptor_offset + 2] ||
       rule_descriptor_offset + 3 + 2 * index + 1 >= context_byte_len) {
     return 0;
   }
 
+  // Constant-time checks of the bytes of the Rule Field Descriptor, SID, LEN,
+  // POS, DI_MO_CDA, MSB_LEN, CARD_TARGET_VALUE and the Target Value offsets,
+  // then of a single Target Value. Walking the Target Values of a mapping is
+  // left to context_validate(...).
+  rule_field_descriptor_offset =
+      merge_uint8_t(context[rule_descriptor_offset + 3 + 2 * index],
+                    context[rule_descriptor_offset + 3 + 2 * index + 1]);
+  position = (size_t) rule_field_descriptor_offset + 7;
+  if (position > context_byte_len) {
+    return 0;
+  }
+  if (((context[position - 1] >> 3) & 0x03) == MO_MSB) {
+    position += 2;
+  }
+  if (position + 1 > context_byte_len ||
+      position + 1 + 2 * (size_t) context[position] > context_byte_len) {
+    return 0;
+  }
+
+  get_rule_field_descriptor_unchecked(rule_field_descriptor, index,
+                                      rule_descriptor_offset, context);
+
+  if (rule_field_descriptor->card_target_value == 1 &&
+      rule_field_descriptor->first_target_value_offset +
+              __get_target_value_byte_len(rule_field_descriptor->len,
+                                          rule_field_descriptor->mo,
+                                          rule_field_descriptor->msb_len) >
+          context_byte_len) {
+    return 0;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void get_rule_field_descriptor_unchecked(
+    rule_field_descriptor_t *rule_field_descriptor, const unsigned int index,
+    const uint16_t rule_descriptor_offset, const uint8_t *context) {
+  uint16_t rule_field_descriptor_offset;
+
   rule_field_descriptor_offset =
       merge_uint8_t(context[rule_descriptor_offset + 3 + 2 * index],
                     context[rule_descriptor_offset + 3 + 2 * index + 1]);
@@ -72,6 +142,136 @@ int get_rule_field_descriptor(rule_field_descriptor_t *rule_field_descriptor,
   } else {
     rule_field_descriptor->first_target_value_offset = 0;
   }
+}
+
+/* ********************************************************************** */
+
+int validate_rule_field_descriptor(const uint16_t rule_field_descriptor_offset,
+                                   const uint8_t *context,
+                                   const size_t   context_byte_len) {
+  uint16_t                           sid;
+  uint16_t                           len;
+  uint16_t                           msb_len;
+  uint16_t                           target_value_offset;
+  uint8_t                            card_target_value;
+  size_t                             position;
+  size_t                             target_value_byte_len;
+  direction_indicator_t              di;
+  matching_operator_t                mo;
+  compression_decompression_action_t cda;
+
+  // SID, LEN, POS and DI_MO_CDA
+  position = rule_field_descriptor_offset;
+  if (position + 7 > context_byte_len) {
+    return 0;
+  }
+
+  sid = merge_uint8_t(context[position], context[position + 1]);
+  len = merge_uint8_t(context[position + 2], context[position + 3]);
+  unpack_di_mo_cda(&di, &mo, &cda, context[position + 6]);
+  position += 7;
+
+  if (di > DI_BI || cda > CDA_COMPUTE) {
+    return 0;
+  }
+
+  // Only CoAP Fields have their length deduced from the packet. A whole CoAP
+  // Option has no Option Length Field to deduce it from, it must be sent.
+  if (len == 0 && !__is_variable_length_sid(sid)) {
+    return 0;
+  }
+  if (len == 0 && get_coap_option_number(sid) > 0 && cda != CDA_VALUE_SENT &&
+      cda != CDA_LSB) {
+    return 0;
+  }
+
+  // MSB_LEN
+  msb_len = 0;
+  if (mo == MO_MSB) {
+    if (position + 2 > context_byte_len) {
+      return 0;
+    }
+    msb_len = merge_uint8_t(context[position], context[position + 1]);
+    position += 2;
+
+    if (msb_len == 0 || msb_len > len) {
+      return 0;
+    }
+  }
+
+  // CARD_TARGET_VALUE
+  if (position + 1 > context_byte_len) {
+    return 0;
+  }
+  card_target_value = context[position++];
+
+  // Cardinality according to the Compression Decompression Action
+  if ((cda == CDA_NOT_SENT && card_target_value != 1) ||
+      (cda == CDA_LSB && (mo != MO_MSB || card_target_value != 1)) ||
+      (cda == CDA_MAPPING_SENT &&
+       (mo != MO_MATCH_MAPPING || card_target_value == 0))) {
+    return 0;
+  }
+
+  target_value_byte_len = __get_target_value_byte_len(len, mo, msb_len);
+
+  // Target Values
+  if (card_target_value == 1) {
+    if (position + 2 > context_byte_len) {
+      return 0;
+    }
+    target_value_offset =
+        merge_uint8_t(context[position], context[position + 1]);
+
+    if (target_value_offset + target_value_byte_len > context_byte_len) {
+      return 0;
+    }
+  } else if (card_target_value > 1) {
+    if (position + 2 * (size_t) card_target_value > context_byte_len) {
+      return 0;
+    }
+
+    for (uint8_t index = 0; index < card_target_value; index++) {
+      target_value_offset =
+          merge_uint8_t(context[position + 2 * index],
+                        context[position + 2 * index + 1]);
+
+      if (target_value_offset + target_value_byte_len > context_byte_len) {
+        return 0;
+      }
+    }
+  }
 
   return 1;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __is_variable_length_sid(const uint16_t sid) {
+  return sid == SID_COAP_TOKEN || sid == SID_COAP_OPTION_DELTA_EXTENDED ||
+         sid == SID_COAP_OPTION_LENGTH_EXTENDED ||
+         sid == SID_COAP_OPTION_VALUE || get_coap_option_number(sid) > 0;
+}
+
+/* ********************************************************************** */
+
+static size_t __get_target_value_byte_len(const uint16_t            len,
+                                          const matching_operator_t mo,
+                                          const uint16_t            msb_len) {
+  size_t target_value_byte_len;
+  size_t msb_target_value_byte_len;
+
+  if (mo == MO_MSB) {
+    target_value_byte_len     = BYTE_LENGTH(msb_len);
+    msb_target_value_byte_len = BYTE_LENGTH(len) - (len - msb_len) / 8;
+    if (msb_target_value_byte_len > target_value_byte_len) {
+      target_value_byte_len = msb_target_value_byte_len;
+    }
+  } else {
+    target_value_byte_len = (len > 0) ? BYTE_LENGTH(len) : 1;
+  }
+
+  return target_value_byte_len;
 }
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include "rule_matcher.h"
+#include "protocols/headers.h"
+#include "utils/binary.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define RULE_MATCHER_X86
+#include <immintrin.h>
+#endif
+
+#define RULE_MATCHER_MAX_FIELD_LEN 128  // Longer Fields are left out
+
+/**
+ * @brief Struct that defines the Target Value a Rule compares with the bits at
+ * a given position of the packet.
+ */
+typedef struct {
+  size_t   bit_position;  // Bit position in the packet
+  size_t   bit_len;       // Bit length, from 1 to 64
+  uint64_t target_value;  // Target Value
+} rule_matcher_entry_t;
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Gets the MO_EQUAL and CDA_NOT_SENT Fields of a Compiled Rule found at
+ * a fixed bit position of the packet.
+ *
+ * @param entries Pointer to the entries to fill, NULL to only count them.
+ * @param compiled_rule Pointer to the Compiled Rule.
+ * @param context Pointer to the validated SCHC Context.
+ * @param packet_direction Packet Direction Indicator.
+ * @return The number of entries of the Rule.
+ */
+static size_t __get_rule_entries(rule_matcher_entry_t       *entries,
+                                 const compiled_rule_t      *compiled_rule,
+                                 const uint8_t              *context,
+                                 const direction_indicator_t packet_direction);
+
+/**
+ * @brief Finds the column of an entry.
+ *
+ * @param rule_matcher Pointer to the Rule Matcher.
+ * @param entry Pointer to the entry.
+ * @return The index of the column, card_columns if there is none.
+ */
+static size_t __find_column(const rule_matcher_t       *rule_matcher,
+                            const rule_matcher_entry_t *entry);
+
+/**
+ * @brief Sets the earlier Rules that may compress the packets of each Rule.
+ *
+ * @param rule_matcher Pointer to the Rule Matcher, columns filled.
+ * @param compiled_rules Pointer to the Compiled Rules.
+ */
+static void __set_shadowing_rules(rule_matcher_t         *rule_matcher,
+                                  const compiled_rules_t *compiled_rules);
+
+/**
+ * @brief Loads the bits of the packet compared with a column.
+ *
+ * @param bits Pointer to the bits to set, right-aligned.
+ * @param packet Pointer to the packet.
+ * @param packet_byte_len Byte length of the packet.
+ * @param column Pointer to the column.
+ * @return 1 if the packet holds the bits of the column, otherwise 0.
+ */
+static int __load_column_bits(uint64_t *bits, const uint8_t *packet,
+                              const size_t                 packet_byte_len,
+                              const rule_matcher_column_t *column);
+
+/**
+ * @brief Compares bits with every Target Value of a column, one at a time.
+ *
+ * @param equal_rules Bitmask of the Rules whose Target Value is equal, to set.
+ * @param target_values Pointer to the Target Values of the column.
+ * @param card_target_values Number of Target Values, a multiple of 4.
+ * @param bits The bits of the packet.
+ */
+static void __compare_column_scalar(uint64_t       *equal_rules,
+                                    const uint64_t *target_values,
+                                    const size_t    card_target_values,
+                                    const uint64_t  bits);
+
+#ifdef RULE_MATCHER_X86
+/**
+ * @brief Compares bits with every Target Value of a column, 2 at a time.
+ *
+ * @param equal_rules Bitmask of the Rules whose Target Value is equal, to set.
+ * @param target_values Pointer to the Target Values of the column.
+ * @param card_target_values Number of Target Values, a multiple of 4.
+ * @param bits The bits of the packet.
+ */
+__attribute__((target("sse4.1"))) static void __compare_column_sse4(
+    uint64_t *equal_rules, const uint64_t *target_values,
+    const size_t card_target_values, const uint64_t bits);
+
+/**
+ * @brief Compares bits with every Target Value of a column, 4 at a time.
+ *
+ * @param equal_rules Bitmask of the Rules whose Target Value is equal, to set.
+ * @param target_values Pointer to the Target Values of the column.
+ * @param card_target_values Number of Target Values, a multiple of 4.
+ * @param bits The bits of the packet.
+ */
+__attribute__((target("avx2"))) static void __compare_column_avx2(
+    uint64_t *equal_rules, const uint64_t *target_values,
+    const size_t card_target_values, const uint64_t bits);
+#endif
+
+/* ********************************************************************** */
+
+int init_rule_matcher(rule_matcher_t              *rule_matcher,
+                      const compiled_rules_t      *compiled_rules,
+                      const uint8_t               *context,
+                      const direction_indicator_t  packet_direction) {
+  size_t                 card_entries;
+  size_t                 max_card_entries;
+  size_t                 index_column;
+  rule_matcher_entry_t  *entries;
+  rule_matcher_column_t *column;
+
+  memset(rule_matcher, 0x00, sizeof(rule_matcher_t));
+  rule_matcher->card_rules = compiled_rules->card_rules;
+  rule_matcher->isa        = get_rule_matcher_isa();
+
+  // Target Values are compared 4 at a time, from a cache line
+  rule_matcher->stride = (compiled_rules->card_rules + 7) / 8 * 8;
+
+  max_card_entries = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    card_entries = __get_rule_entries(NULL, &compiled_rules->rules[index],
+                                      context, packet_direction);
+    if (card_entries > max_card_entries) {
+      max_card_entries = card_entries;
+    }
+    rule_matcher->card_columns += card_entries;
+  }
+
+  entries = (rule_matcher_entry_t *) malloc(
+      (max_card_entries + 1) * sizeof(rule_matcher_entry_t));
+  rule_matcher->columns = (rule_matcher_column_t *) malloc(
+      (rule_matcher->card_columns + 1) * sizeof(rule_matcher_column_t));
+  if (entries == NULL || rule_matcher->columns == NULL) {
+    free(entries);
+    destroy_rule_matcher(rule_matcher);
+    return 0;
+  }
+
+  // Entries of different Rules at the same position share a column
+  rule_matcher->card_columns = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    card_entries = __get_rule_entries(entries, &compiled_rules->rules[index],
+                                      context, packet_direction);
+    for (size_t index_entry = 0; index_entry < card_entries; index_entry++) {
+      if (__find_column(rule_matcher, &entries[index_entry]) ==
+          rule_matcher->card_columns) {
+        column = &rule_matcher->columns[rule_matcher->card_columns++];
+        memset(column, 0x00, sizeof(rule_matcher_column_t));
+        column->bit_position = entries[index_entry].bit_position;
+        column->bit_len      = entries[index_entry].bit_len;
+      }
+    }
+  }
+
+  rule_matcher->target_values = (uint64_t *) aligned_alloc(
+      CACHE_LINE_BYTE_LEN,
+      (rule_matcher->card_columns * rule_matcher->stride + 8) *
+          sizeof(uint64_t));
+  if (rule_matcher->target_values == NULL) {
+    free(entries);
+    destroy_rule_matcher(rule_matcher);
+    return 0;
+  }
+  memset(rule_matcher->target_values, 0x00,
+         rule_matcher->card_columns * rule_matcher->stride * sizeof(uint64_t));
+
+  for (size_t index = 0; index < rule_matcher->card_columns; index++) {
+    rule_matcher->columns[index].target_values =
+        rule_matcher->target_values + index * rule_matcher->stride;
+  }
+
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    card_entries = __get_rule_entries(entries, &compiled_rules->rules[index],
+                                      context, packet_direction);
+    for (size_t index_entry = 0; index_entry < card_entries; index_entry++) {
+      // Fields of a Rule follow each other, a Rule has one entry per column
+      index_column = __find_column(rule_matcher, &entries[index_entry]);
+      column       = &rule_matcher->columns[index_column];
+      column->target_values[index] = entries[index_entry].target_value;
+      column->rules[index / 64] |= (uint64_t) 1 << (index % 64);
+    }
+  }
+
+  free(entries);
+
+  rule_matcher->shadowing_rules = (uint64_t *) calloc(
+      compiled_rules->card_rules * RULE_MATCHER_MASK_WORDS + 1,
+      sizeof(uint64_t));
+  if (rule_matcher->shadowing_rules == NULL) {
+    destroy_rule_matcher(rule_matcher);
+    return 0;
+  }
+  __set_shadowing_rules(rule_matcher, compiled_rules);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_rule_matcher(rule_matcher_t *rule_matcher) {
+  free(rule_matcher->columns);
+  free(rule_matcher->target_values);
+  free(rule_matcher->shadowing_rules);
+  memset(rule_matcher, 0x00, sizeof(rule_matcher_t));
+}
+
+/* ********************************************************************** */
+
+rule_matcher_isa_t get_rule_matcher_isa(void) {
+#ifdef RULE_MATCHER_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return RULE_MATCHER_AVX2;
+  }
+  if (__builtin_cpu_supports("sse4.1")) {
+    return RULE_MATCHER_SSE4;
+  }
+#endif
+
+  return RULE_MATCHER_SCALAR;
+}
+
+/* ********************************************************************** */
+
+void match_rules(uint64_t              candidate_rules[RULE_MATCHER_MASK_WORDS],
+                 const rule_matcher_t *rule_matcher, const uint8_t *packet,
+                 const size_t packet_byte_len) {
+  uint64_t                     bits;
+  uint64_t                     equal_rules[RULE_MATCHER_MASK_WORDS];
+  const rule_matcher_column_t *column;
+
+  // Every Rule is a candidate to begin with
+  for (size_t index = 0; index < RULE_MATCHER_MASK_WORDS; index++) {
+    if (rule_matcher->card_rules >= 64 * (index + 1)) {
+      candidate_rules[index] = UINT64_MAX;
+    } else if (rule_matcher->card_rules > 64 * index) {
+      candidate_rules[index] =
+          ((uint64_t) 1 << (rule_matcher->card_rules % 64)) - 1;
+    } else {
+      candidate_rules[index] = 0;
+    }
+  }
+
+  for (size_t index = 0; index < rule_matcher->card_columns; index++) {
+    column = &rule_matcher->columns[index];
+    memset(equal_rules, 0x00, sizeof(equal_rules));
+
+    // Rules comparing bits beyond the end of the packet cannot match either
+    if (__load_column_bits(&bits, packet, packet_byte_len, column)) {
+      switch (rule_matcher->isa) {
+#ifdef RULE_MATCHER_X86
+        case RULE_MATCHER_AVX2:
+          __compare_column_avx2(equal_rules, column->target_values,
+                                rule_matcher->stride, bits);
+          break;
+
+        case RULE_MATCHER_SSE4:
+          __compare_column_sse4(equal_rules, column->target_values,
+                                rule_matcher->stride, bits);
+          break;
+#endif
+
+        default:  // RULE_MATCHER_SCALAR
+          __compare_column_scalar(equal_rules, column->target_values,
+                                  rule_matcher->stride, bits);
+          break;
+      }
+    }
+
+    for (size_t index_word = 0; index_word < RULE_MATCHER_MASK_WORDS;
+         index_word++) {
+      candidate_rules[index_word] &=
+          equal_rules[index_word] | ~column->rules[index_word];
+    }
+  }
+}
+
+/* ********************************************************************** */
+
+int is_rule_shadowed(const rule_matcher_t *rule_matcher,
+                     const uint64_t candidate_rules[RULE_MATCHER_MASK_WORDS],
+                     const size_t   index) {
+  const uint64_t *shadowing_rules;
+
+  shadowing_rules =
+      rule_matcher->shadowing_rules + index * RULE_MATCHER_MASK_WORDS;
+  for (size_t index_word = 0; index_word < RULE_MATCHER_MASK_WORDS;
+       index_word++) {
+    if (candidate_rules[index_word] & shadowing_rules[index_word]) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static size_t __get_rule_entries(rule_matcher_entry_t       *entries,
+                                 const compiled_rule_t      *compiled_rule,
+                                 const uint8_t              *context,
+                                 const direction_indicator_t packet_direction) {
+  size_t                  card_entries;
+  size_t                  bit_position;
+  size_t                  bit_len;
+  size_t                  byte_len;
+  size_t                  unused_len;
+  uint64_t                target_value;
+  rule_field_descriptor_t rule_field_descriptor;
+
+  card_entries = 0;
+  bit_position = 0;
+
+  if (compiled_rule->nature != NATURE_COMPRESSION) {
+    return 0;
+  }
+
+  for (unsigned int index = 0;
+       index < compiled_rule->card_rule_field_descriptor; index++) {
+    get_compiled_rule_field_descriptor(&rule_field_descriptor, index,
+                                       compiled_rule);
+
+    // Fields of the other direction are skipped without moving in the packet
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != packet_direction) {
+      continue;
+    }
+
+    // The position of the next Fields depends on the packet
+    if (rule_field_descriptor.len == 0 ||
+        get_coap_option_number(rule_field_descriptor.sid) > 0) {
+      break;
+    }
+
+    if (rule_field_descriptor.mo == MO_EQUAL &&
+        rule_field_descriptor.cda == CDA_NOT_SENT &&
+        rule_field_descriptor.card_target_value == 1 &&
+        (rule_field_descriptor.len <= 64 ||
+         (rule_field_descriptor.len <= RULE_MATCHER_MAX_FIELD_LEN &&
+          rule_field_descriptor.len % 8 == 0))) {
+      // Target Values are right-aligned on their bytes, see MO_equal(...)
+      for (size_t chunk_position = 0;
+           chunk_position < rule_field_descriptor.len; chunk_position += 64) {
+        bit_len = rule_field_descriptor.len - chunk_position;
+        if (bit_len > 64) {
+          bit_len = 64;
+        }
+
+        if (entries != NULL) {
+          target_value = 0;
+          byte_len     = BYTE_LENGTH(bit_len);
+          for (size_t index_byte = 0; index_byte < byte_len; index_byte++) {
+            target_value =
+                (target_value << 8) |
+                context[rule_field_descriptor.first_target_value_offset +
+                        chunk_position / 8 + index_byte];
+          }
+
+          entries[card_entries].bit_position = bit_position + chunk_position;
+          entries[card_entries].bit_len      = bit_len;
+          entries[card_entries].target_value = target_value;
+
+          // MO_equal(...) leaves out the first bits of a Field whose first
+          // byte holds more than 4 bits
+          unused_len = (rule_field_descriptor.len % 8 > 4)
+                           ? 2 * (rule_field_descriptor.len % 8) - 8
+                           : 0;
+          if (chunk_position == 0 && unused_len > 0) {
+            entries[card_entries].bit_position += unused_len;
+            entries[card_entries].bit_len -= unused_len;
+            entries[card_entries].target_value &=
+                ((uint64_t) 1 << (bit_len - unused_len)) - 1;
+          }
+        }
+        card_entries++;
+      }
+    }
+
+    bit_position += rule_field_descriptor.len;
+  }
+
+  return card_entries;
+}
+
+/* ********************************************************************** */
+
+static size_t __find_column(const rule_matcher_t       *rule_matcher,
+                            const rule_matcher_entry_t *entry) {
+  size_t index;
+
+  for (index = 0; index < rule_matcher->card_columns; index++) {
+    if (rule_matcher->columns[index].bit_position == entry->bit_position &&
+        rule_matcher->columns[index].bit_len == entry->bit_len) {
+      break;
+    }
+  }
+
+  return index;
+}
+
+/* ********************************************************************** */
+
+static void __set_shadowing_rules(rule_matcher_t         *rule_matcher,
+                                  const compiled_rules_t *compiled_rules) {
+  int                          disjoint;
+  uint64_t                    *shadowing_rules;
+  const rule_matcher_column_t *column;
+
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    shadowing_rules =
+        rule_matcher->shadowing_rules + index * RULE_MATCHER_MASK_WORDS;
+
+    for (size_t index_earlier = 0; index_earlier < index; index_earlier++) {
+      if (compiled_rules->rules[index_earlier].nature ==
+          NATURE_FRAGMENTATION) {
+        continue;
+      }
+
+      // Both Rules compare a column with different Target Values
+      disjoint = 0;
+      for (size_t index_column = 0;
+           index_column < rule_matcher->card_columns && !disjoint;
+           index_column++) {
+        column   = &rule_matcher->columns[index_column];
+        disjoint = ((column->rules[index / 64] >> (index % 64)) & 1) &&
+                   ((column->rules[index_earlier / 64] >>
+                     (index_earlier % 64)) &
+                    1) &&
+                   column->target_values[index] !=
+                       column->target_values[index_earlier];
+      }
+
+      if (!disjoint) {
+        shadowing_rules[index_earlier / 64] |= (uint64_t) 1
+                                               << (index_earlier % 64);
+      }
+    }
+  }
+}
+
+/* ********************************************************************** */
+
+static int __load_column_bits(uint64_t *bits, const uint8_t *packet,
+                              const size_t                 packet_byte_len,
+                              const rule_matcher_column_t *column) {
+  size_t shift;
+
+  if (column->bit_position + column->bit_len > 8 * packet_byte_len) {
+    return 0;
+  }
+
+  // load_bits(...) misses the last bits of a 64-bit column if it is unaligned
+  shift = column->bit_position % 8;
+  *bits = load_bits(packet, packet_byte_len, column->bit_position);
+  if (shift + column->bit_len > 64) {
+    *bits |= packet[column->bit_position / 8 + 8] >> (8 - shift);
+  }
+
+  if (column->bit_len < 64) {
+    *bits >>= 64 - column->bit_len;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __compare_column_scalar(uint64_t       *equal_rules,
+                                    const uint64_t *target_values,
+                                    const size_t    card_target_values,
+                                    const uint64_t  bits) {
+  for (size_t index = 0; index < card_target_values; index++) {
+    equal_rules[index / 64] |= (uint64_t) (target_values[index] == bits)
+                               << (index % 64);
+  }
+}
+
+#ifdef RULE_MATCHER_X86
+/* ********************************************************************** */
+
+__attribute__((target("sse4.1"))) static void __compare_column_sse4(
+    uint64_t *equal_rules, const uint64_t *target_values,
+    const size_t card_target_values, const uint64_t bits) {
+  __m128i bits_vector;
+  __m128i target_values_vector;
+  int     equal_mask;
+
+  bits_vector = _mm_set1_epi64x((long long) bits);
+  for (size_t index = 0; index < card_target_values; index += 2) {
+    target_values_vector =
+        _mm_load_si128((const __m128i *) (target_values + index));
+    equal_mask = _mm_movemask_pd(
+        _mm_castsi128_pd(_mm_cmpeq_epi64(target_values_vector, bits_vector)));
+    equal_rules[index / 64] |= (uint64_t) equal_mask << (index % 64);
+  }
+}
+
+/* ********************************************************************** */
+
+__attribute__((target("avx2"))) static void __compare_column_avx2(
+    uint64_t *equal_rules, const uint64_t *target_values,
+    const size_t card_target_values, const uint64_t bits) {
+  __m256i bits_vector;
+  __m256i target_values_vector;
+  int     equal_mask;
+
+  bits_vector = _mm256_set1_epi64x((long long) bits);
+  for (size_t index = 0; index < card_target_values; index += 4) {
+    target_values_vector =
+        _mm256_load_si256((const __m256i *) (target_values + index));
+    equal_mask = _mm256_movemask_pd(_mm256_castsi256_pd(
+        _mm256_cmpeq_epi64(target_values_vector, bits_vector)));
+    equal_rules[index / 64] |= (uint64_t) equal_mask << (index % 64);
+  }
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,1041 @@
+#include "rule_program.h"
+#include "protocols/headers.h"
+#include "utils/binary.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__GNUC__)
+#define RULE_PROGRAM_THREADED
+#endif
+
+// Each operation ends by jumping to the next one, either through the label of
+// its opcode or back to the switch
+#ifdef RULE_PROGRAM_THREADED
+#define __OPCODE(opcode) label_##opcode:
+#define __NEXT()                                                    \
+  __extension__({ goto *opcode_labels[(++instruction)->opcode]; })
+#else
+#define __OPCODE(opcode) case opcode:
+#define __NEXT()  \
+  instruction++;  \
+  continue
+#endif
+
+#define CHUNK_LEN 64  // Bit length of the constants
+
+/**
+ * @brief Struct that defines the Program being built.
+ */
+typedef struct {
+  rule_instruction_t *instructions;  // Instructions, NULL to only count them
+  uint64_t           *constants;     // Constants, NULL to only count them
+  uint8_t            *header_templates;  // Header templates, NULL to only
+                                         // count their bytes
+  size_t              card_instructions;       // Number of instructions
+  size_t              card_constants;          // Number of constants
+  size_t              header_templates_byte_len;  // Bytes of header templates
+} rule_program_builder_t;
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks if a Rule gets a Program in a Packet Direction.
+ *
+ * @param compiled_rule Pointer to the Compiled Rule.
+ * @param direction Packet Direction Indicator.
+ * @param decompression 1 for the decompression Program, 0 for the compression
+ * one.
+ * @return 1 if the Rule gets a Program, otherwise 0.
+ */
+static int __has_program(const compiled_rule_t      *compiled_rule,
+                         const direction_indicator_t direction,
+                         const int                   decompression);
+
+/**
+ * @brief Builds the Program of a Rule in a Packet Direction.
+ *
+ * @param rule_program Pointer to the Program to set.
+ * @param builder Pointer to the builder, which gets the instructions and
+ * constants.
+ * @param compiled_rule Pointer to the Compiled Rule, which gets a Program.
+ * @param direction Packet Direction Indicator.
+ * @param decompression 1 for the decompression Program, 0 for the compression
+ * one.
+ * @param context Pointer to the validated SCHC Context.
+ */
+static void __build_program(rule_program_t             *rule_program,
+                            rule_program_builder_t     *builder,
+                            const compiled_rule_t      *compiled_rule,
+                            const direction_indicator_t direction,
+                            const int                   decompression,
+                            const uint8_t              *context);
+
+/**
+ * @brief Adds an instruction to the Program being built.
+ *
+ * @param builder Pointer to the builder.
+ * @param opcode Operation.
+ * @param card Number of pairs or Target Values, see rule_instruction_t.
+ * @param len Bit length of the operation.
+ * @param operand Operand, see rule_instruction_t.
+ */
+static void __add_instruction(rule_program_builder_t *builder,
+                              const rule_opcode_t opcode, const uint8_t card,
+                              const uint16_t len, const uint32_t operand);
+
+/**
+ * @brief Adds the instructions skipping packet bits to the Program being
+ * built.
+ *
+ * @param builder Pointer to the builder.
+ * @param len Bit length to skip, none if 0.
+ */
+static void __add_skip(rule_program_builder_t *builder, size_t len);
+
+/**
+ * @brief Adds a constant to the Program being built.
+ *
+ * @param builder Pointer to the builder.
+ * @param constant The constant.
+ */
+static void __add_constant(rule_program_builder_t *builder,
+                           const uint64_t          constant);
+
+/**
+ * @brief Gets a bit of a Target Value.
+ *
+ * @param target_value Pointer to the Target Value, big-endian.
+ * @param byte_len Byte length of the Target Value.
+ * @param index Index of the bit, 0 for the least significant one.
+ * @return The bit, 0 beyond the Target Value.
+ */
+static uint64_t __get_target_value_bit(const uint8_t *target_value,
+                                       const size_t   byte_len,
+                                       const size_t   index);
+
+/**
+ * @brief Gets a bit of the mask a Field is compared with, see MO_equal(...)
+ * and MO_most_significant_bits(...).
+ *
+ * @param len Bit length of the Field value.
+ * @param byte_len Byte length of the Target Value.
+ * @param first_mask Mask of the first byte of the Target Value.
+ * @param index Index of the bit, 0 for the least significant one.
+ * @return The bit, 0 beyond the Field value.
+ */
+static uint64_t __get_mask_bit(const size_t len, const size_t byte_len,
+                               const uint8_t first_mask, const size_t index);
+
+/**
+ * @brief Checks if a Field value can equal a Target Value under a mask.
+ *
+ * @param len Bit length of the Field value.
+ * @param target_value Pointer to the Target Value, big-endian.
+ * @param byte_len Byte length of the Target Value.
+ * @param first_mask Mask of the first byte of the Target Value.
+ * @return 1 if the Target Value only has bits within the mask, otherwise 0.
+ */
+static int __can_match(const size_t len, const uint8_t *target_value,
+                       const size_t byte_len, const uint8_t first_mask);
+
+/**
+ * @brief Adds the instructions comparing a Field value with a Target Value
+ * under a mask, 64 bits at a time.
+ *
+ * @param builder Pointer to the builder.
+ * @param len Bit length of the Field value.
+ * @param target_value Pointer to the Target Value, big-endian.
+ * @param byte_len Byte length of the Target Value.
+ * @param first_mask Mask of the first byte of the Target Value.
+ */
+static void __add_match(rule_program_builder_t *builder, const size_t len,
+                        const uint8_t *target_value, const size_t byte_len,
+                        const uint8_t first_mask);
+
+/**
+ * @brief Adds the instruction sending the index of the Target Value of a
+ * Field, see CDA_mapping_sent(...).
+ *
+ * @param builder Pointer to the builder.
+ * @param compiled_rule Pointer to the Compiled Rule.
+ * @param index Index of the Rule Field Descriptor, of 64 bits at most.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if one of the Target Values can match, otherwise 0.
+ */
+static int __add_map(rule_program_builder_t *builder,
+                     const compiled_rule_t *compiled_rule,
+                     const unsigned int index, const uint8_t *context);
+
+/**
+ * @brief Loads up to 64 bits of a buffer.
+ *
+ * @param buffer Pointer to the buffer, which holds the bits.
+ * @param buffer_byte_len Byte length of the buffer.
+ * @param bit_position Bit position of the bits.
+ * @param bit_len Bit length, from 1 to 64.
+ * @return The bits, right-aligned.
+ */
+static inline uint64_t __load(const uint8_t *buffer,
+                              const size_t   buffer_byte_len,
+                              const size_t bit_position, const size_t bit_len);
+
+/**
+ * @brief Stores up to 64 bits into a zeroed buffer.
+ *
+ * @param buffer Pointer to the buffer, large enough.
+ * @param bit_position Bit position of the bits.
+ * @param bits The bits, right-aligned.
+ * @param bit_len Bit length, from 0 to 64.
+ */
+static inline void __store(uint8_t *buffer, size_t bit_position,
+                           const uint64_t bits, size_t bit_len);
+
+/**
+ * @brief Stores up to 64 bits into a buffer, overwriting the bits from the bit
+ * position on, see write_byte_to_buffer(...).
+ *
+ * @param buffer Pointer to the buffer, large enough.
+ * @param bit_position Bit position of the bits.
+ * @param bits The bits, right-aligned.
+ * @param bit_len Bit length, from 0 to 64.
+ */
+static inline void __write(uint8_t *buffer, size_t bit_position,
+                           const uint64_t bits, size_t bit_len);
+
+/**
+ * @brief Copies bytes from a bit position to another, into a buffer zeroed
+ * from the bit position on.
+ *
+ * @param buffer Pointer to the buffer, large enough.
+ * @param bit_position Bit position in the buffer.
+ * @param bytes Pointer to the byte of the first bit to copy.
+ * @param bit_offset Offset of the first bit to copy in its byte, the byte
+ * following the last byte copied being read when not 0.
+ * @param byte_len Number of bytes to copy.
+ */
+static void __copy_bytes(uint8_t *buffer, const size_t bit_position,
+                         const uint8_t *bytes, const size_t bit_offset,
+                         const size_t byte_len);
+
+/* ********************************************************************** */
+
+int init_rule_programs(rule_programs_t        *rule_programs,
+                       const compiled_rules_t *compiled_rules,
+                       const uint8_t          *context) {
+  rule_program_builder_t builder;
+  rule_program_t         rule_program;
+
+  memset(rule_programs, 0x00, sizeof(rule_programs_t));
+  memset(&builder, 0x00, sizeof(rule_program_builder_t));
+
+  if (compiled_rules->card_rules == 0) {
+    return 1;
+  }
+
+  // Sizes, Programs are built again below
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    for (int program = 0; program < 4; program++) {
+      __build_program(&rule_program, &builder, &compiled_rules->rules[index],
+                      program % 2 == 0 ? DI_UP : DI_DW, program / 2, context);
+    }
+  }
+
+  rule_programs->programs = (rule_program_t *) calloc(
+      4 * compiled_rules->card_rules, sizeof(rule_program_t));
+  rule_programs->instructions = (rule_instruction_t *) malloc(
+      (builder.card_instructions + 1) * sizeof(rule_instruction_t));
+  rule_programs->constants =
+      (uint64_t *) malloc((builder.card_constants + 1) * sizeof(uint64_t));
+  rule_programs->header_templates =
+      (uint8_t *) calloc(builder.header_templates_byte_len + 1, 1);
+  if (rule_programs->programs == NULL || rule_programs->instructions == NULL ||
+      rule_programs->constants == NULL ||
+      rule_programs->header_templates == NULL) {
+    destroy_rule_programs(rule_programs);
+    return 0;
+  }
+  rule_programs->card_rules = compiled_rules->card_rules;
+
+  builder.instructions              = rule_programs->instructions;
+  builder.constants                 = rule_programs->constants;
+  builder.header_templates          = rule_programs->header_templates;
+  builder.card_instructions         = 0;
+  builder.card_constants            = 0;
+  builder.header_templates_byte_len = 0;
+  for (size_t index = 0; index < compiled_rules->card_rules; index++) {
+    for (int program = 0; program < 4; program++) {
+      __build_program(
+          &rule_programs->programs[program * compiled_rules->card_rules +
+                                   index],
+          &builder, &compiled_rules->rules[index],
+          program % 2 == 0 ? DI_UP : DI_DW, program / 2, context);
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_rule_programs(rule_programs_t *rule_programs) {
+  free(rule_programs->programs);
+  free(rule_programs->instructions);
+  free(rule_programs->constants);
+  free(rule_programs->header_templates);
+  memset(rule_programs, 0x00, sizeof(rule_programs_t));
+}
+
+/* ********************************************************************** */
+
+const rule_program_t *get_rule_program(const rule_programs_t      *rule_programs,
+                                       const unsigned int          index,
+                                       const direction_indicator_t direction,
+                                       const int decompression) {
+  const rule_program_t *rule_program;
+
+  if (index >= rule_programs->card_rules ||
+      (direction != DI_UP && direction != DI_DW)) {
+    return NULL;
+  }
+
+  rule_program =
+      &rule_programs->programs[(2 * decompression + (direction == DI_DW)) *
+                                   rule_programs->card_rules +
+                               index];
+
+  return rule_program->instructions != NULL ? rule_program : NULL;
+}
+
+/* ********************************************************************** */
+
+int run_compression_program(uint8_t     *schc_packet,
+                            const size_t schc_packet_max_byte_len,
+                            size_t *bit_position, const uint8_t *packet,
+                            const size_t           packet_byte_len,
+                            const rule_program_t  *rule_program,
+                            const rule_programs_t *rule_programs) {
+  const rule_instruction_t *instruction;
+  const uint64_t           *constants;
+  size_t                    payload_byte_position;
+  size_t                    packet_bit_position;
+  size_t                    schc_packet_bit_position;
+  size_t                    chunk_len;
+  size_t                    low;
+  size_t                    high;
+  size_t                    middle;
+  uint64_t                  bits;
+
+#ifdef RULE_PROGRAM_THREADED
+  static const void *const opcode_labels[CARD_OPCODES] = {
+      [OPCODE_END]          = __extension__ &&label_OPCODE_END,
+      [OPCODE_FAIL]         = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_MATCH]        = __extension__ &&label_OPCODE_MATCH,
+      [OPCODE_SEND]         = __extension__ &&label_OPCODE_SEND,
+      [OPCODE_SKIP]         = __extension__ &&label_OPCODE_SKIP,
+      [OPCODE_MAP]          = __extension__ &&label_OPCODE_MAP,
+      [OPCODE_RECEIVE]      = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_UNMAP]        = __extension__ &&label_OPCODE_FAIL};
+#endif
+
+  // The Fields and the SCHC Packet are checked once, the instructions then
+  // stay within both
+  payload_byte_position = BYTE_LENGTH(rule_program->packet_bit_len);
+  if (packet_byte_len < payload_byte_position ||
+      BYTE_LENGTH(*bit_position + rule_program->residue_len +
+                  8 * (packet_byte_len - payload_byte_position)) >
+          schc_packet_max_byte_len) {
+    return 0;
+  }
+
+  instruction              = rule_program->instructions;
+  constants                = rule_programs->constants;
+  packet_bit_position      = 0;
+  schc_packet_bit_position = *bit_position;
+
+#ifdef RULE_PROGRAM_THREADED
+  __extension__({ goto *opcode_labels[instruction->opcode]; });
+#else
+  for (;;) {
+    switch (instruction->opcode) {
+#endif
+
+  __OPCODE(OPCODE_MATCH)
+  bits = __load(packet, packet_byte_len, packet_bit_position, instruction->len);
+  if ((bits & constants[instruction->operand]) !=
+      constants[instruction->operand + 1]) {
+    return 0;
+  }
+  packet_bit_position += instruction->len;
+  __NEXT();
+
+  __OPCODE(OPCODE_SEND)
+  for (size_t position = 0; position < instruction->len;
+       position += chunk_len) {
+    chunk_len = instruction->len - position < CHUNK_LEN
+                    ? instruction->len - position
+                    : CHUNK_LEN;
+    __write(schc_packet, schc_packet_bit_position,
+            __load(packet, packet_byte_len, packet_bit_position, chunk_len),
+            chunk_len);
+    packet_bit_position      += chunk_len;
+    schc_packet_bit_position += chunk_len;
+  }
+  __NEXT();
+
+  __OPCODE(OPCODE_SKIP)
+  packet_bit_position += instruction->len;
+  __NEXT();
+
+  __OPCODE(OPCODE_MAP)
+  // Lowest pair not lower than the Field, the lowest index among equal ones
+  bits = __load(packet, packet_byte_len, packet_bit_position, instruction->len) &
+         constants[instruction->operand];
+  low  = 0;
+  high = instruction->card;
+  while (low < high) {
+    middle = low + (high - low) / 2;
+    if (constants[instruction->operand + 2 + 2 * middle] < bits) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  if (low == instruction->card ||
+      constants[instruction->operand + 2 + 2 * low] != bits) {
+    return 0;
+  }
+  __write(schc_packet, schc_packet_bit_position,
+          constants[instruction->operand + 3 + 2 * low],
+          constants[instruction->operand + 1]);
+  packet_bit_position      += instruction->len;
+  schc_packet_bit_position += constants[instruction->operand + 1];
+  __NEXT();
+
+  __OPCODE(OPCODE_END)
+  __copy_bytes(schc_packet, schc_packet_bit_position,
+               packet + payload_byte_position, 0,
+               packet_byte_len - payload_byte_position);
+  *bit_position =
+      schc_packet_bit_position + 8 * (packet_byte_len - payload_byte_position);
+  return 1;
+
+#ifndef RULE_PROGRAM_THREADED
+  default:
+#endif
+  __OPCODE(OPCODE_FAIL)
+  return 0;
+
+#ifndef RULE_PROGRAM_THREADED
+    }
+  }
+#endif
+}
+
+/* ********************************************************************** */
+
+int run_decompression_program(uint8_t *packet, const size_t packet_max_byte_len,
+                              size_t        *packet_bit_position,
+                              const size_t   schc_packet_bit_position,
+                              const uint8_t *schc_packet,
+                              const size_t   schc_packet_byte_len,
+                              const rule_program_t *rule_program,
+                              const uint8_t        *context) {
+  const rule_instruction_t *instruction;
+  size_t                    residue_bit_position;
+  size_t                    payload_bit_position;
+  size_t                    payload_byte_len;
+  size_t                    chunk_len;
+  size_t                    index_len;
+  uint64_t                  mapping_index;
+  uint16_t                  target_value_offset;
+
+#ifdef RULE_PROGRAM_THREADED
+  static const void *const opcode_labels[CARD_OPCODES] = {
+      [OPCODE_END]          = __extension__ &&label_OPCODE_END,
+      [OPCODE_FAIL]         = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_MATCH]        = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_SEND]         = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_SKIP]         = __extension__ &&label_OPCODE_SKIP,
+      [OPCODE_MAP]          = __extension__ &&label_OPCODE_FAIL,
+      [OPCODE_RECEIVE]      = __extension__ &&label_OPCODE_RECEIVE,
+      [OPCODE_UNMAP]        = __extension__ &&label_OPCODE_UNMAP};
+#endif
+
+  // The Field Residues and the packet are checked once, the payload being
+  // shifted and its last partial byte dropped when not byte aligned
+  payload_bit_position = schc_packet_bit_position + rule_program->residue_len;
+  if (BYTE_LENGTH(payload_bit_position) > schc_packet_byte_len) {
+    return 0;
+  }
+  payload_byte_len = schc_packet_byte_len - payload_bit_position / 8 -
+                     (payload_bit_position % 8 != 0);
+  if (BYTE_LENGTH(*packet_bit_position + rule_program->packet_bit_len +
+                  8 * payload_byte_len) > packet_max_byte_len) {
+    return 0;
+  }
+
+  instruction          = rule_program->instructions;
+  residue_bit_position = schc_packet_bit_position;
+
+  // The CDA_NOT_SENT Fields are already in place in the header template
+  if (*packet_bit_position % 8 == 0) {
+    memcpy(packet + *packet_bit_position / 8, rule_program->header_template,
+           BYTE_LENGTH(rule_program->packet_bit_len));
+  } else {
+    for (size_t position = 0; position < rule_program->packet_bit_len;
+         position += chunk_len) {
+      chunk_len = rule_program->packet_bit_len - position < CHUNK_LEN
+                      ? rule_program->packet_bit_len - position
+                      : CHUNK_LEN;
+      __store(packet, *packet_bit_position + position,
+              __load(rule_program->header_template,
+                     BYTE_LENGTH(rule_program->packet_bit_len), position,
+                     chunk_len),
+              chunk_len);
+    }
+  }
+
+#ifdef RULE_PROGRAM_THREADED
+  __extension__({ goto *opcode_labels[instruction->opcode]; });
+#else
+  for (;;) {
+    switch (instruction->opcode) {
+#endif
+
+  __OPCODE(OPCODE_RECEIVE)
+  for (size_t position = 0; position < instruction->len;
+       position += chunk_len) {
+    chunk_len = instruction->len - position < CHUNK_LEN
+                    ? instruction->len - position
+                    : CHUNK_LEN;
+    __store(packet, *packet_bit_position,
+            __load(schc_packet, schc_packet_byte_len, residue_bit_position,
+                   chunk_len),
+            chunk_len);
+    residue_bit_position += chunk_len;
+    *packet_bit_position += chunk_len;
+  }
+  __NEXT();
+
+  __OPCODE(OPCODE_SKIP)
+  *packet_bit_position += instruction->len;
+  __NEXT();
+
+  __OPCODE(OPCODE_UNMAP)
+  index_len     = bits_counter(instruction->card - 1);
+  mapping_index = __load(schc_packet, schc_packet_byte_len,
+                         residue_bit_position, index_len);
+  if (mapping_index >= instruction->card) {
+    return 0;
+  }
+  residue_bit_position += index_len;
+  target_value_offset =
+      instruction->card == 1
+          ? (uint16_t) instruction->operand
+          : merge_uint8_t(context[instruction->operand + 2 * mapping_index],
+                          context[instruction->operand + 2 * mapping_index + 1]);
+  add_bits_to_buffer(packet, packet_max_byte_len, packet_bit_position,
+                     context + target_value_offset, instruction->len);
+  __NEXT();
+
+  __OPCODE(OPCODE_END)
+  __copy_bytes(packet, *packet_bit_position,
+               schc_packet + payload_bit_position / 8,
+               payload_bit_position % 8, payload_byte_len);
+  *packet_bit_position += 8 * payload_byte_len;
+  return 1;
+
+#ifndef RULE_PROGRAM_THREADED
+  default:
+#endif
+  __OPCODE(OPCODE_FAIL)
+  return 0;
+
+#ifndef RULE_PROGRAM_THREADED
+    }
+  }
+#endif
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __has_program(const compiled_rule_t      *compiled_rule,
+                         const direction_indicator_t direction,
+                         const int                   decompression) {
+  direction_indicator_t              di;
+  matching_operator_t                mo;
+  compression_decompression_action_t cda;
+
+  if (compiled_rule->nature != NATURE_COMPRESSION) {
+    return 0;
+  }
+
+  for (unsigned int index = 0; index < compiled_rule->card_rule_field_descriptor;
+       index++) {
+    unpack_di_mo_cda(&di, &mo, &cda, compiled_rule->di_mo_cdas[index]);
+    if (di != DI_BI && di != direction) {
+      continue;
+    }
+
+    // Fields whose length is read from the packet, and Mapping Sent Fields
+    // longer than the constants
+    if (compiled_rule->lens[index] == 0 ||
+        get_coap_option_number(compiled_rule->sids[index]) > 0 ||
+        (cda == CDA_LSB &&
+         compiled_rule->msb_lens[index] > compiled_rule->lens[index]) ||
+        (!decompression && cda == CDA_MAPPING_SENT &&
+         compiled_rule->lens[index] > CHUNK_LEN) ||
+        (decompression && (cda == CDA_LSB || cda == CDA_COMPUTE))) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __build_program(rule_program_t             *rule_program,
+                            rule_program_builder_t     *builder,
+                            const compiled_rule_t      *compiled_rule,
+                            const direction_indicator_t direction,
+                            const int                   decompression,
+                            const uint8_t              *context) {
+  direction_indicator_t              di;
+  matching_operator_t                mo;
+  compression_decompression_action_t cda;
+  uint16_t                           len;
+  uint16_t                           lsb_len;
+  uint16_t                           target_value_offset;
+  int                                can_match;
+  size_t                             header_template_byte_len;
+  size_t                             header_template_bit_position;
+  uint8_t                           *header_template;
+  size_t                             skip_len;
+
+  memset(rule_program, 0x00, sizeof(rule_program_t));
+  if (!__has_program(compiled_rule, direction, decompression)) {
+    return;
+  }
+
+  if (builder->instructions != NULL) {
+    rule_program->instructions =
+        builder->instructions + builder->card_instructions;
+  }
+
+  for (unsigned int index = 0;
+       index < compiled_rule->card_rule_field_descriptor; index++) {
+    unpack_di_mo_cda(&di, &mo, &cda, compiled_rule->di_mo_cdas[index]);
+    if (di == DI_BI || di == direction) {
+      rule_program->packet_bit_len += compiled_rule->lens[index];
+    }
+  }
+
+  // The header template of a decompression Program spans its Fields
+  header_template          = NULL;
+  header_template_byte_len = BYTE_LENGTH(rule_program->packet_bit_len);
+  if (decompression) {
+    if (builder->header_templates != NULL) {
+      header_template =
+          builder->header_templates + builder->header_templates_byte_len;
+      rule_program->header_template = header_template;
+    }
+    builder->header_templates_byte_len += header_template_byte_len;
+  }
+  header_template_bit_position = 0;
+  skip_len                     = 0;
+
+  can_match = 1;
+  for (unsigned int index = 0;
+       index < compiled_rule->card_rule_field_descriptor && can_match;
+       index++) {
+    unpack_di_mo_cda(&di, &mo, &cda, compiled_rule->di_mo_cdas[index]);
+    if (di != DI_BI && di != direction) {
+      continue;
+    }
+
+    len                 = compiled_rule->lens[index];
+    target_value_offset = compiled_rule->target_value_offsets[index];
+
+    if (decompression) {
+      // As add_bits_to_buffer(...) in the Rule-by-Rule decompression, which
+      // keeps the bits of the first byte beyond the Field Length
+      if (cda == CDA_NOT_SENT) {
+        if (header_template != NULL) {
+          add_bits_to_buffer(header_template, header_template_byte_len,
+                             &header_template_bit_position,
+                             context + target_value_offset, len);
+        } else {
+          header_template_bit_position += len;
+        }
+        skip_len += len;
+        continue;
+      }
+
+      // Consecutive CDA_NOT_SENT Fields are skipped at once
+      __add_skip(builder, skip_len);
+      header_template_bit_position += len;
+      skip_len                      = 0;
+
+      switch (cda) {
+        case CDA_MAPPING_SENT:
+          __add_instruction(builder, OPCODE_UNMAP,
+                            compiled_rule->card_target_values[index], len,
+                            target_value_offset);
+          rule_program->residue_len +=
+              bits_counter(compiled_rule->card_target_values[index] - 1);
+          break;
+
+        default:  // CDA_VALUE_SENT
+          __add_instruction(builder, OPCODE_RECEIVE, 0, len, 0);
+          rule_program->residue_len += len;
+          break;
+      }
+      continue;
+    }
+
+    switch (cda) {
+      case CDA_NOT_SENT:
+        // Same comparison as MO_equal(...)
+        can_match = __can_match(len, context + target_value_offset,
+                                BYTE_LENGTH(len), (1 << (8 - (len % 8))) - 1);
+        if (can_match) {
+          __add_match(builder, len, context + target_value_offset,
+                      BYTE_LENGTH(len), (1 << (8 - (len % 8))) - 1);
+        }
+        break;
+
+      case CDA_LSB:
+        // Same comparison as MO_most_significant_bits(...), which never
+        // matches without LSB
+        lsb_len   = len - compiled_rule->msb_lens[index];
+        can_match = lsb_len > 0 &&
+                    __can_match(compiled_rule->msb_lens[index],
+                                context + target_value_offset,
+                                BYTE_LENGTH(len) - lsb_len / 8,
+                                (compiled_rule->msb_lens[index] % 8 != 0)
+                                    ? (1 << (compiled_rule->msb_lens[index] %
+                                             8)) -
+                                          1
+                                    : 0xff);
+        if (can_match) {
+          __add_match(builder, compiled_rule->msb_lens[index],
+                      context + target_value_offset,
+                      BYTE_LENGTH(len) - lsb_len / 8,
+                      (compiled_rule->msb_lens[index] % 8 != 0)
+                          ? (1 << (compiled_rule->msb_lens[index] % 8)) - 1
+                          : 0xff);
+          __add_instruction(builder, OPCODE_SEND, 0, lsb_len, 0);
+          rule_program->residue_len += lsb_len;
+        }
+        break;
+
+      case CDA_MAPPING_SENT:
+        can_match = __add_map(builder, compiled_rule, index, context);
+        rule_program->residue_len +=
+            bits_counter(compiled_rule->card_target_values[index] - 1);
+        break;
+
+      case CDA_COMPUTE:
+        __add_instruction(builder, OPCODE_SKIP, 0, len, 0);
+        break;
+
+      default:  // CDA_VALUE_SENT
+        __add_instruction(builder, OPCODE_SEND, 0, len, 0);
+        rule_program->residue_len += len;
+        break;
+    }
+  }
+
+  __add_skip(builder, skip_len);
+  __add_instruction(builder, can_match ? OPCODE_END : OPCODE_FAIL, 0, 0, 0);
+}
+
+/* ********************************************************************** */
+
+static void __add_instruction(rule_program_builder_t *builder,
+                              const rule_opcode_t opcode, const uint8_t card,
+                              const uint16_t len, const uint32_t operand) {
+  rule_instruction_t *instruction;
+
+  if (builder->instructions != NULL) {
+    instruction          = &builder->instructions[builder->card_instructions];
+    instruction->opcode  = (uint8_t) opcode;
+    instruction->card    = card;
+    instruction->len     = len;
+    instruction->operand = operand;
+  }
+  builder->card_instructions++;
+}
+
+/* ********************************************************************** */
+
+static void __add_skip(rule_program_builder_t *builder, size_t len) {
+  while (len > UINT16_MAX) {
+    __add_instruction(builder, OPCODE_SKIP, 0, UINT16_MAX, 0);
+    len -= UINT16_MAX;
+  }
+  if (len > 0) {
+    __add_instruction(builder, OPCODE_SKIP, 0, (uint16_t) len, 0);
+  }
+}
+
+/* ********************************************************************** */
+
+static void __add_constant(rule_program_builder_t *builder,
+                           const uint64_t          constant) {
+  if (builder->constants != NULL) {
+    builder->constants[builder->card_constants] = constant;
+  }
+  builder->card_constants++;
+}
+
+/* ********************************************************************** */
+
+static uint64_t __get_target_value_bit(const uint8_t *target_value,
+                                       const size_t   byte_len,
+                                       const size_t   index) {
+  if (index >= 8 * byte_len) {
+    return 0;
+  }
+
+  return (target_value[byte_len - 1 - index / 8] >> (index % 8)) & 1;
+}
+
+/* ********************************************************************** */
+
+static uint64_t __get_mask_bit(const size_t len, const size_t byte_len,
+                               const uint8_t first_mask, const size_t index) {
+  if (index >= len) {
+    return 0;
+  }
+  if (index < 8 * (byte_len - 1)) {
+    return 1;
+  }
+
+  return (first_mask >> (index - 8 * (byte_len - 1))) & 1;
+}
+
+/* ********************************************************************** */
+
+static int __can_match(const size_t len, const uint8_t *target_value,
+                       const size_t byte_len, const uint8_t first_mask) {
+  for (size_t index = 0; index < 8 * byte_len; index++) {
+    if (__get_target_value_bit(target_value, byte_len, index) &&
+        !__get_mask_bit(len, byte_len, first_mask, index)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __add_match(rule_program_builder_t *builder, const size_t len,
+                        const uint8_t *target_value, const size_t byte_len,
+                        const uint8_t first_mask) {
+  size_t   chunk_position;
+  size_t   chunk_len;
+  uint64_t mask;
+  uint64_t value;
+
+  // Most significant chunk first, as the bits are read from the packet
+  for (size_t position = 0; position < len; position += chunk_len) {
+    chunk_len = (len - position) % CHUNK_LEN;
+    if (chunk_len == 0) {
+      chunk_len = CHUNK_LEN;
+    }
+    chunk_position = len - position - chunk_len;
+
+    mask  = 0;
+    value = 0;
+    for (size_t index = chunk_len; index > 0; index--) {
+      mask = (mask << 1) | __get_mask_bit(len, byte_len, first_mask,
+                                          chunk_position + index - 1);
+      value = (value << 1) | __get_target_value_bit(target_value, byte_len,
+                                                    chunk_position + index - 1);
+    }
+
+    if (mask == 0) {
+      __add_instruction(builder, OPCODE_SKIP, 0, (uint16_t) chunk_len, 0);
+    } else {
+      __add_instruction(builder, OPCODE_MATCH, 0, (uint16_t) chunk_len,
+                        (uint32_t) builder->card_constants);
+      __add_constant(builder, mask);
+      __add_constant(builder, value);
+    }
+  }
+}
+
+/* ********************************************************************** */
+
+static int __add_map(rule_program_builder_t *builder,
+                     const compiled_rule_t *compiled_rule,
+                     const unsigned int index, const uint8_t *context) {
+  size_t   len;
+  size_t   byte_len;
+  size_t   first_pair;
+  size_t   card_pairs;
+  size_t   index_pair;
+  uint8_t  first_mask;
+  uint16_t target_value_offset;
+  uint64_t mask;
+  uint64_t value;
+
+  len        = compiled_rule->lens[index];
+  byte_len   = BYTE_LENGTH(len);
+  first_mask = (1 << (8 - (len % 8))) - 1;
+
+  mask = 0;
+  for (size_t index_bit = len; index_bit > 0; index_bit--) {
+    mask = (mask << 1) |
+           __get_mask_bit(len, byte_len, first_mask, index_bit - 1);
+  }
+
+  __add_instruction(builder, OPCODE_MAP, 0, (uint16_t) len,
+                    (uint32_t) builder->card_constants);
+  __add_constant(builder, mask);
+  __add_constant(builder,
+                 bits_counter(compiled_rule->card_target_values[index] - 1));
+
+  // Insertion sort, stable so that equal Target Values keep the lowest index
+  // first. The Target Values that cannot match are left out.
+  first_pair = builder->card_constants;
+  card_pairs = 0;
+  for (uint8_t index_target_value = 0;
+       index_target_value < compiled_rule->card_target_values[index];
+       index_target_value++) {
+    target_value_offset =
+        (compiled_rule->card_target_values[index] == 1)
+            ? compiled_rule->target_value_offsets[index]
+            : merge_uint8_t(
+                  context[compiled_rule->target_value_offsets[index] +
+                          2 * index_target_value],
+                  context[compiled_rule->target_value_offsets[index] +
+                          2 * index_target_value + 1]);
+    if (!__can_match(len, context + target_value_offset, byte_len,
+                     first_mask)) {
+      continue;
+    }
+
+    __add_constant(builder, 0);
+    __add_constant(builder, 0);
+    if (builder->constants != NULL) {
+      value      = load_uint64_t(context + target_value_offset, byte_len);
+      index_pair = card_pairs;
+      while (index_pair > 0 &&
+             builder->constants[first_pair + 2 * (index_pair - 1)] > value) {
+        builder->constants[first_pair + 2 * index_pair] =
+            builder->constants[first_pair + 2 * (index_pair - 1)];
+        builder->constants[first_pair + 2 * index_pair + 1] =
+            builder->constants[first_pair + 2 * (index_pair - 1) + 1];
+        index_pair--;
+      }
+      builder->constants[first_pair + 2 * index_pair]     = value;
+      builder->constants[first_pair + 2 * index_pair + 1] = index_target_value;
+    }
+    card_pairs++;
+  }
+
+  if (builder->instructions != NULL) {
+    builder->instructions[builder->card_instructions - 1].card =
+        (uint8_t) card_pairs;
+  }
+
+  return card_pairs > 0;
+}
+
+/* ********************************************************************** */
+
+static inline uint64_t __load(const uint8_t *buffer,
+                              const size_t   buffer_byte_len,
+                              const size_t bit_position, const size_t bit_len) {
+  uint64_t bits;
+
+  // load_bits(...) gets 64 - (bit_position % 8) bits, the last ones are in
+  // the next byte
+  bits = load_bits(buffer, buffer_byte_len, bit_position);
+  if (bit_position % 8 + bit_len > 64) {
+    bits |= buffer[bit_position / 8 + 8] >> (8 - bit_position % 8);
+  }
+
+  return bits >> (64 - bit_len);
+}
+
+/* ********************************************************************** */
+
+static inline void __store(uint8_t *buffer, size_t bit_position,
+                           const uint64_t bits, size_t bit_len) {
+  size_t chunk_len;
+
+  while (bit_len > 0) {
+    chunk_len = 8 - bit_position % 8;
+    if (chunk_len > bit_len) {
+      chunk_len = bit_len;
+    }
+    buffer[bit_position / 8] |=
+        (uint8_t) (((bits >> (bit_len - chunk_len)) &
+                    ((1u << chunk_len) - 1))
+                   << (8 - bit_position % 8 - chunk_len));
+    bit_position += chunk_len;
+    bit_len      -= chunk_len;
+  }
+}
+
+/* ********************************************************************** */
+
+static inline void __write(uint8_t *buffer, size_t bit_position,
+                           const uint64_t bits, size_t bit_len) {
+  size_t chunk_len;
+  size_t offset;
+
+  while (bit_len > 0) {
+    offset    = bit_position % 8;
+    chunk_len = 8 - offset;
+    if (chunk_len > bit_len) {
+      chunk_len = bit_len;
+    }
+    buffer[bit_position / 8] =
+        (uint8_t) ((buffer[bit_position / 8] & (0xff00 >> offset)) |
+                   (((bits >> (bit_len - chunk_len)) &
+                     ((1u << chunk_len) - 1))
+                    << (8 - offset - chunk_len)));
+    bit_position += chunk_len;
+    bit_len      -= chunk_len;
+  }
+}
+
+/* ********************************************************************** */
+
+static void __copy_bytes(uint8_t *buffer, const size_t bit_position,
+                         const uint8_t *bytes, const size_t bit_offset,
+                         const size_t byte_len) {
+  size_t  byte_position;
+  size_t  offset;
+  uint8_t byte;
+
+  byte_position = bit_position / 8;
+  offset        = bit_position % 8;
+  if (offset == 0 && bit_offset == 0) {
+    memcpy(buffer + byte_position, bytes, byte_len);
+    return;
+  }
+
+  for (size_t index = 0; index < byte_len; index++) {
+    byte = bit_offset == 0 ? bytes[index]
+                           : (uint8_t) ((bytes[index] << bit_offset) |
+                                        (bytes[index + 1] >> (8 - bit_offset)));
+    if (offset == 0) {
+      buffer[byte_position + index] = byte;
+    } else {
+      buffer[byte_position + index]     |= byte >> offset;
+      buffer[byte_position + index + 1]  = (uint8_t) (byte << (8 - offset));
+    }
+  }
+}
\ No newline at end of file
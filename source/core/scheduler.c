@@ -0,0 +1,242 @@
+#include "scheduler.h"
+#include "utils/memory.h"
+
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Frees the workers of a Scheduler and the Scheduler, once their
+ * threads ended.
+ *
+ * @param scheduler Pointer to the Scheduler.
+ */
+static void __free_scheduler(scheduler_t *scheduler);
+
+/**
+ * @brief Steals a batch from the other workers, starting from one picked at
+ * random.
+ *
+ * @param worker Pointer to the worker that steals.
+ * @param item Pointer to the batch to set.
+ * @return 1 if a batch was stolen, otherwise 0.
+ */
+static int __steal_batch(scheduler_worker_t *worker, void **item);
+
+/**
+ * @brief Worker thread, processes its batches and those of the other workers
+ * until the Scheduler stops.
+ *
+ * @param arg Pointer to the worker.
+ * @return NULL.
+ */
+static void *__scheduler_worker(void *arg);
+
+/* ********************************************************************** */
+
+scheduler_t *create_scheduler(const size_t         card_workers,
+                              const size_t         inbox_capacity,
+                              scheduler_callback_t callback, void *user_data) {
+  scheduler_t        *scheduler;
+  scheduler_worker_t *worker;
+  size_t              card_started;
+
+  if (card_workers == 0 || card_workers > PIPELINE_MAX_WORKERS) {
+    return NULL;
+  }
+
+  // Both hold counters on their own cache lines
+  scheduler = (scheduler_t *) aligned_alloc(64, sizeof(scheduler_t));
+  if (scheduler == NULL) {
+    return NULL;
+  }
+  memset(scheduler, 0x00, sizeof(scheduler_t));
+  scheduler->workers = (scheduler_worker_t *) aligned_alloc(
+      64, card_workers * sizeof(scheduler_worker_t));
+  if (scheduler->workers == NULL) {
+    free(scheduler);
+    return NULL;
+  }
+  memset(scheduler->workers, 0x00, card_workers * sizeof(scheduler_worker_t));
+  scheduler->card_workers = card_workers;
+  scheduler->callback     = callback;
+  scheduler->user_data    = user_data;
+  atomic_init(&scheduler->stop, 0);
+  atomic_init(&scheduler->card_submitted, 0);
+  atomic_init(&scheduler->card_completed, 0);
+
+  for (size_t index = 0; index < card_workers; index++) {
+    worker               = &scheduler->workers[index];
+    worker->scheduler    = scheduler;
+    worker->random_state = (uint32_t) index + 1;
+    atomic_init(&worker->card_processed, 0);
+    atomic_init(&worker->card_stolen, 0);
+    if (!init_work_deque(&worker->work_deque, inbox_capacity) ||
+        !init_ring_buffer(&worker->inbox, inbox_capacity) ||
+        !init_flow_cache(&worker->flow_cache, SCHEDULER_FLOW_CACHE_ENTRIES)) {
+      __free_scheduler(scheduler);
+      return NULL;
+    }
+  }
+
+  for (card_started = 0; card_started < card_workers; card_started++) {
+    if (pthread_create(&scheduler->workers[card_started].thread, NULL,
+                       __scheduler_worker,
+                       &scheduler->workers[card_started]) != 0) {
+      atomic_store(&scheduler->stop, 1);
+      for (size_t index = 0; index < card_started; index++) {
+        pthread_join(scheduler->workers[index].thread, NULL);
+      }
+      __free_scheduler(scheduler);
+      return NULL;
+    }
+  }
+
+  return scheduler;
+}
+
+/* ********************************************************************** */
+
+void destroy_scheduler(scheduler_t *scheduler) {
+  if (scheduler == NULL) {
+    return;
+  }
+
+  atomic_store(&scheduler->stop, 1);
+  for (size_t index = 0; index < scheduler->card_workers; index++) {
+    pthread_join(scheduler->workers[index].thread, NULL);
+  }
+
+  __free_scheduler(scheduler);
+}
+
+/* ********************************************************************** */
+
+int submit_scheduler_batch(scheduler_t *scheduler, pipeline_batch_t *batch) {
+  size_t home;
+
+  // Batches of the same Rules go to the same worker, unless its inbox is full
+  home = (size_t) (((uint64_t) (uintptr_t) batch->compiled_context +
+                    (uint64_t) batch->direction) *
+                       0x9e3779b97f4a7c15ull >>
+                   32) %
+         scheduler->card_workers;
+
+  atomic_fetch_add_explicit(&scheduler->card_submitted, 1,
+                            memory_order_relaxed);
+  for (size_t index = 0; index < scheduler->card_workers; index++) {
+    if (ring_buffer_push(
+            &scheduler->workers[(home + index) % scheduler->card_workers]
+                 .inbox,
+            batch)) {
+      return 1;
+    }
+  }
+  atomic_fetch_sub_explicit(&scheduler->card_submitted, 1,
+                            memory_order_relaxed);
+
+  return 0;
+}
+
+/* ********************************************************************** */
+
+void wait_scheduler(scheduler_t *scheduler) {
+  while (atomic_load_explicit(&scheduler->card_completed,
+                              memory_order_acquire) <
+         atomic_load_explicit(&scheduler->card_submitted,
+                              memory_order_relaxed)) {
+    sched_yield();
+  }
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static void __free_scheduler(scheduler_t *scheduler) {
+  for (size_t index = 0; index < scheduler->card_workers; index++) {
+    destroy_work_deque(&scheduler->workers[index].work_deque);
+    destroy_ring_buffer(&scheduler->workers[index].inbox);
+    destroy_flow_cache(&scheduler->workers[index].flow_cache);
+  }
+
+  free(scheduler->workers);
+  free(scheduler);
+}
+
+/* ********************************************************************** */
+
+static int __steal_batch(scheduler_worker_t *worker, void **item) {
+  scheduler_t        *scheduler;
+  scheduler_worker_t *victim;
+  size_t              first;
+
+  scheduler = worker->scheduler;
+
+  // xorshift32
+  worker->random_state ^= worker->random_state << 13;
+  worker->random_state ^= worker->random_state >> 17;
+  worker->random_state ^= worker->random_state << 5;
+
+  first = worker->random_state % scheduler->card_workers;
+  for (size_t index = 0; index < scheduler->card_workers; index++) {
+    victim = &scheduler->workers[(first + index) % scheduler->card_workers];
+    if (victim == worker) {
+      continue;
+    }
+    if (work_deque_steal(&victim->work_deque, item) ||
+        ring_buffer_pop(&victim->inbox, item)) {
+      atomic_fetch_add_explicit(&worker->card_stolen, 1,
+                                memory_order_relaxed);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/* ********************************************************************** */
+
+static void *__scheduler_worker(void *arg) {
+  scheduler_worker_t *worker;
+  scheduler_t        *scheduler;
+  pipeline_batch_t   *batch;
+  void               *item;
+
+  worker    = (scheduler_worker_t *) arg;
+  scheduler = worker->scheduler;
+  init_memory_pool();
+
+  while (!atomic_load_explicit(&scheduler->stop, memory_order_relaxed)) {
+    // Only the worker pushes to its Work Deque, it never overflows
+    while (get_work_deque_size(&worker->work_deque) <
+               worker->work_deque.capacity &&
+           ring_buffer_pop(&worker->inbox, &item)) {
+      work_deque_push(&worker->work_deque, item);
+    }
+
+    if (!work_deque_pop(&worker->work_deque, &item) &&
+        !__steal_batch(worker, &item)) {
+      sched_yield();
+      continue;
+    }
+
+    batch = (pipeline_batch_t *) item;
+    process_pipeline_batch(batch, &worker->flow_cache);
+    atomic_fetch_add_explicit(&worker->card_processed, 1,
+                              memory_order_relaxed);
+    if (scheduler->callback != NULL) {
+      scheduler->callback(batch, scheduler->user_data);
+    }
+    atomic_fetch_add_explicit(&scheduler->card_completed, 1,
+                              memory_order_release);
+  }
+
+  destroy_memory_pool();
+
+  return NULL;
+}
\ No newline at end of file
@@ -118,6 +118,37 @@ void udp_checksum(uint8_t* checksum, const size_t checksum_byte_len,
 /*                         CoAP Header functions                          */
 /* ********************************************************************** */
 
+/**
+ * @brief Resolves an Option Delta or Option Length nibble with its extension.
+ *
+ * @param value Pointer to the resolved value.
+ * @param byte_position Pointer to the byte position of the extension in the
+ * packet, moved past it.
+ * @param nibble The Option Delta or Option Length nibble.
+ * @param packet Pointer to the packet.
+ * @param packet_byte_len Byte length of the packet.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __resolve_coap_option_nibble(uint16_t* value, size_t* byte_position,
+                                        const uint8_t  nibble,
+                                        const uint8_t* packet,
+                                        const size_t   packet_byte_len);
+
+/**
+ * @brief Splits an Option Delta or Option Length into its nibble and its
+ * extension.
+ *
+ * @param value The Option Delta or Option Length.
+ * @param extension Pointer to the extension value.
+ * @param extension_len Pointer to the extension bit length, 0, 8 or 16.
+ * @return The nibble.
+ */
+static uint8_t __split_coap_option_value(const uint16_t value,
+                                         uint16_t*      extension,
+                                         size_t*        extension_len);
+
+/* ********************************************************************** */
+
 void set_coap_option_variable_length(uint16_t*      variable_length,
                                      const uint8_t* field,
                                      const size_t   field_byte_len,
@@ -166,6 +197,153 @@ size_t get_coap_option_bit_length(const uint16_t option, const uint16_t sid) {
   }
 }
 
+/* ********************************************************************** */
+
+int parse_coap_options(coap_options_t* coap_options, const uint8_t* packet,
+                       const size_t packet_byte_len, const size_t byte_position,
+                       const uint16_t first_number) {
+  size_t         position;
+  uint16_t       option_delta;
+  uint16_t       option_length;
+  uint32_t       option_number;
+  coap_option_t* coap_option;
+
+  position                   = byte_position;
+  option_number              = first_number;
+  coap_options->card_options = 0;
+
+  while (position < packet_byte_len &&
+         packet[position] != COAP_PAYLOAD_MARKER_BYTE) {
+    if (coap_options->card_options == COAP_MAX_OPTIONS) {
+      return 0;
+    }
+    coap_option = &coap_options->options[coap_options->card_options];
+    coap_option->header_offset = position++;
+
+    // Option Delta extension comes first, then the Option Length one
+    if (!__resolve_coap_option_nibble(&option_delta, &position,
+                                      packet[coap_option->header_offset] >> 4,
+                                      packet, packet_byte_len) ||
+        !__resolve_coap_option_nibble(&option_length, &position,
+                                      packet[coap_option->header_offset] & 0x0f,
+                                      packet, packet_byte_len)) {
+      return 0;
+    }
+
+    option_number += option_delta;
+    if (option_number > UINT16_MAX ||
+        position + option_length > packet_byte_len) {
+      return 0;
+    }
+
+    coap_option->number       = (uint16_t) option_number;
+    coap_option->position     = 1;
+    coap_option->length       = option_length;
+    coap_option->value_offset = position;
+
+    // Options of the same number are contiguous, Option Deltas being >= 0
+    if (option_delta == 0 && coap_options->card_options > 0) {
+      coap_option->position = coap_option[-1].position + 1;
+    }
+    coap_options->card_options++;
+
+    position += option_length;
+  }
+
+  coap_options->end_offset = position;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int add_coap_option_header(uint8_t* buffer, const size_t buffer_byte_len,
+                           size_t* bit_position, const uint16_t option_delta,
+                           const uint16_t option_length) {
+  int      status;
+  uint8_t  delta_nibble;
+  uint8_t  length_nibble;
+  uint16_t delta_extension;
+  uint16_t length_extension;
+  size_t   delta_extension_len;
+  size_t   length_extension_len;
+
+  delta_nibble  = __split_coap_option_value(option_delta, &delta_extension,
+                                            &delta_extension_len);
+  length_nibble = __split_coap_option_value(option_length, &length_extension,
+                                            &length_extension_len);
+
+  if (BYTE_LENGTH(*bit_position + 8 + delta_extension_len +
+                  length_extension_len) > buffer_byte_len) {
+    return 0;
+  }
+
+  status = add_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                              (uint8_t) ((delta_nibble << 4) | length_nibble),
+                              8);
+
+  // Extensions are sent in network byte order
+  for (size_t shift = delta_extension_len; status && shift > 0; shift -= 8) {
+    status = add_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                                (uint8_t) (delta_extension >> (shift - 8)), 8);
+  }
+  for (size_t shift = length_extension_len; status && shift > 0; shift -= 8) {
+    status = add_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                                (uint8_t) (length_extension >> (shift - 8)), 8);
+  }
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+uint16_t get_coap_option_number(const uint16_t sid) {
+  switch (sid) {
+    case SID_COAP_OPTION_IF_MATCH:
+      return COAP_OPTION_NUMBER_IF_MATCH;
+    case SID_COAP_OPTION_URI_HOST:
+      return COAP_OPTION_NUMBER_URI_HOST;
+    case SID_COAP_OPTION_ETAG:
+      return COAP_OPTION_NUMBER_ETAG;
+    case SID_COAP_OPTION_IF_NONE_MATCH:
+      return COAP_OPTION_NUMBER_IF_NONE_MATCH;
+    case SID_COAP_OPTION_OBSERVE:
+      return COAP_OPTION_NUMBER_OBSERVE;
+    case SID_COAP_OPTION_URI_PORT:
+      return COAP_OPTION_NUMBER_URI_PORT;
+    case SID_COAP_OPTION_LOCATION_PATH:
+      return COAP_OPTION_NUMBER_LOCATION_PATH;
+    case SID_COAP_OPTION_URI_PATH:
+      return COAP_OPTION_NUMBER_URI_PATH;
+    case SID_COAP_OPTION_CONTENT_FORMAT:
+      return COAP_OPTION_NUMBER_CONTENT_FORMAT;
+    case SID_COAP_OPTION_MAX_AGE:
+      return COAP_OPTION_NUMBER_MAX_AGE;
+    case SID_COAP_OPTION_URI_QUERY:
+      return COAP_OPTION_NUMBER_URI_QUERY;
+    case SID_COAP_OPTION_ACCEPT:
+      return COAP_OPTION_NUMBER_ACCEPT;
+    case SID_COAP_OPTION_LOCATION_QUERY:
+      return COAP_OPTION_NUMBER_LOCATION_QUERY;
+    case SID_COAP_OPTION_BLOCK2:
+      return COAP_OPTION_NUMBER_BLOCK2;
+    case SID_COAP_OPTION_BLOCK1:
+      return COAP_OPTION_NUMBER_BLOCK1;
+    case SID_COAP_OPTION_SIZE2:
+      return COAP_OPTION_NUMBER_SIZE2;
+    case SID_COAP_OPTION_PROXY_URI:
+      return COAP_OPTION_NUMBER_PROXY_URI;
+    case SID_COAP_OPTION_PROXY_SCHEME:
+      return COAP_OPTION_NUMBER_PROXY_SCHEME;
+    case SID_COAP_OPTION_SIZE1:
+      return COAP_OPTION_NUMBER_SIZE1;
+    case SID_COAP_OPTION_NO_RESPONSE:
+      return COAP_OPTION_NUMBER_NO_RESPONSE;
+    default:
+      return 0;
+  }
+}
+
 /* ********************************************************************** */
 /*                             Static function                            */
 /* ********************************************************************** */
@@ -179,4 +357,64 @@ static void __calculate_checksum(uint32_t* checksum, const uint8_t* data,
     carry     = *checksum >> 16;
     *checksum = (*checksum + carry) & 0xffff;
   }
+}
+
+/* ********************************************************************** */
+
+static int __resolve_coap_option_nibble(uint16_t* value, size_t* byte_position,
+                                        const uint8_t  nibble,
+                                        const uint8_t* packet,
+                                        const size_t   packet_byte_len) {
+  uint32_t extended_value;
+
+  switch (nibble) {
+    case 13:
+      if (*byte_position + 1 > packet_byte_len) {
+        return 0;
+      }
+      *value = (uint16_t) packet[*byte_position] + 13;
+      *byte_position += 1;
+      return 1;
+
+    case 14:
+      if (*byte_position + 2 > packet_byte_len) {
+        return 0;
+      }
+      extended_value = (uint32_t) merge_uint8_t(packet[*byte_position],
+                                                packet[*byte_position + 1]) +
+                       269;
+      if (extended_value > UINT16_MAX) {
+        return 0;
+      }
+      *value = (uint16_t) extended_value;
+      *byte_position += 2;
+      return 1;
+
+    case 15:  // Reserved, only allowed in the Payload Marker
+      return 0;
+
+    default:
+      *value = nibble;
+      return 1;
+  }
+}
+
+/* ********************************************************************** */
+
+static uint8_t __split_coap_option_value(const uint16_t value,
+                                         uint16_t*      extension,
+                                         size_t*        extension_len) {
+  if (value < 13) {
+    *extension     = 0;
+    *extension_len = 0;
+    return (uint8_t) value;
+  } else if (value < 269) {
+    *extension     = value - 13;
+    *extension_len = 8;
+    return 13;
+  }
+
+  *extension     = value - 269;
+  *extension_len = 16;
+  return 14;
 }
\ No newline at end of file
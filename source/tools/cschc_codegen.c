@@ -0,0 +1,1469 @@
+/**
+ * @file cschc_codegen.c
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Generates the compression and decompression functions of a SCHC
+ * Context.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Usage: cschc-codegen <context file> <prefix> <output directory>
+ *
+ * The Context file is the raw CSCHC Context byte array, see context_loader.h.
+ * The tool writes <prefix>_rules.h and <prefix>_rules.c, declaring:
+ * - <prefix>_validated_context, the Context embedded in the source,
+ * - <prefix>_compress(...), same as compress_validated(...),
+ * - <prefix>_decompress(...), same as decompress_validated(...).
+ *
+ * Each Rule gets its own straight-line functions, per Direction Indicator
+ * when some of its Rule Field Descriptors are not bidirectional. Field
+ * positions, lengths, masks, Target Values and Residue lengths are constants,
+ * therefore no DI_MO_CDA is interpreted at runtime. The SCHC Packets are the
+ * ones of the interpreter, bit for bit, quirks included, e.g. the mask of the
+ * first byte of __MO_equal_from_offset(...).
+ *
+ * The Rules that depend on the packet layout are left to the interpreter:
+ * - compression stops at the first Rule with a Variable-Length Field or a
+ * whole CoAP Option, compress_validated(...) then tries all Rules again, the
+ * previous ones failing the same way,
+ * - decompression of a Rule with such a Field, or with CDA_LSB or CDA_COMPUTE,
+ * is performed by decompress_validated(...).
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#include "core/context.h"
+#include "core/context_loader.h"
+#include "core/rule_descriptor.h"
+#include "core/rule_field_descriptor.h"
+#include "protocols/coap.h"
+#include "utils/binary.h"
+
+#include <ctype.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_PREFIX_LEN 64
+#define MAX_PATH_LEN   4096
+#define CHUNK_LEN      64  // Bit length of the generated integer comparisons
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Checks if a Rule can be compressed or decompressed by generated
+ * functions in a direction.
+ *
+ * @param rule_descriptor Pointer to the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param decompression 1 for the decompression, 0 for the compression.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if the Rule gets generated functions, otherwise 0.
+ */
+static int __is_generated(const rule_descriptor_t    *rule_descriptor,
+                          const direction_indicator_t direction,
+                          const int decompression, const uint8_t *context);
+
+/**
+ * @brief Checks if a Rule has Rule Field Descriptors that are not
+ * bidirectional.
+ *
+ * @param rule_descriptor Pointer to the Rule Descriptor.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if the Rule depends on the Direction Indicator, otherwise 0.
+ */
+static int __depends_on_direction(const rule_descriptor_t *rule_descriptor,
+                                  const uint8_t           *context);
+
+/**
+ * @brief Checks if a Field value can satisfy (value & mask) == target_value,
+ * the mask being the one of the first byte followed by 0xff bytes.
+ *
+ * @param bit_len Bit length of the Field value.
+ * @param target_value Pointer to the Target Value.
+ * @param byte_len Byte length of the Target Value and mask.
+ * @param first_mask Mask of the first byte.
+ * @return 1 if some Field value satisfies the comparison, otherwise 0.
+ */
+static int __can_match(const size_t bit_len, const uint8_t *target_value,
+                       const size_t byte_len, const uint8_t first_mask);
+
+/**
+ * @brief Checks if a compression Rule can match a packet in a direction.
+ *
+ * @param rule_descriptor Pointer to the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if some packet may be compressed by the Rule, otherwise 0.
+ */
+static int __can_match_rule(const rule_descriptor_t    *rule_descriptor,
+                            const direction_indicator_t direction,
+                            const uint8_t              *context);
+
+/**
+ * @brief Gets the index of the first Rule left to the interpreter by the
+ * generated compression in a direction.
+ *
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ * @return The index of the Rule, or the number of Rules if there is none.
+ */
+static unsigned int __get_interpreted_rule(const direction_indicator_t direction,
+                                           const uint8_t *context);
+
+/**
+ * @brief Checks if the generated compression tries a Rule in a direction.
+ *
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if the Rule has a generated compression function, otherwise 0.
+ */
+static int __is_compressed(const unsigned int          index_rule_descriptor,
+                           const direction_indicator_t direction,
+                           const uint8_t              *context);
+
+/**
+ * @brief Checks if the generated decompression handles a Rule in a direction.
+ *
+ * @details Only the first Rule with a Rule ID is used, see
+ * decompress_validated(...).
+ *
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ * @return 1 if the Rule has a generated decompression function, otherwise 0.
+ */
+static int __is_decompressed(const unsigned int          index_rule_descriptor,
+                             const direction_indicator_t direction,
+                             const uint8_t              *context);
+
+/**
+ * @brief Gets 64 bits of a byte array, from its end.
+ *
+ * @param bytes Pointer to the byte array, a big-endian integer.
+ * @param byte_len Byte length of the byte array.
+ * @param index Index of the 64-bit chunk, 0 for the least significant one.
+ * @return The chunk.
+ */
+static uint64_t __get_chunk(const uint8_t *bytes, const size_t byte_len,
+                            const size_t index);
+
+/**
+ * @brief Writes the loads of a Field into the field variables of a generated
+ * compression function, one per 64-bit chunk.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param bit_position Bit position of the Field in the packet.
+ * @param bit_len Bit length of the Field.
+ */
+static void __write_loads(FILE *source, const char *prefix,
+                          const size_t bit_position, const size_t bit_len);
+
+/**
+ * @brief Writes the expression comparing the loaded field variables with a
+ * Target Value, see __can_match(...).
+ *
+ * @param source The generated source.
+ * @param bit_len Bit length of the Field value.
+ * @param target_value Pointer to the Target Value.
+ * @param byte_len Byte length of the Target Value and mask.
+ * @param first_mask Mask of the first byte.
+ */
+static void __write_comparison(FILE *source, const size_t bit_len,
+                               const uint8_t *target_value,
+                               const size_t byte_len, const uint8_t first_mask);
+
+/**
+ * @brief Writes the stores of packet bits into the SCHC Packet, one per
+ * 64-bit chunk.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param schc_packet_bit_position Bit position in the SCHC Packet.
+ * @param packet_bit_position Bit position in the packet.
+ * @param bit_len Number of bits to store.
+ */
+static void __write_stores(FILE *source, const char *prefix,
+                           const size_t schc_packet_bit_position,
+                           const size_t packet_bit_position,
+                           const size_t bit_len);
+
+/**
+ * @brief Writes the name of the generated function of a Rule.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param operation "compress" or "decompress".
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Direction Indicator of the function, DI_BI if the Rule
+ * does not depend on it.
+ */
+static void __write_rule_function_name(FILE *source, const char *prefix,
+                                       const char        *operation,
+                                       const unsigned int index_rule_descriptor,
+                                       const direction_indicator_t direction);
+
+/**
+ * @brief Writes the compression function of a Rule in a direction.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ */
+static void __write_compress_rule(FILE *source, const char *prefix,
+                                  const unsigned int          index_rule_descriptor,
+                                  const direction_indicator_t direction,
+                                  const uint8_t              *context);
+
+/**
+ * @brief Writes the Target Value offsets of the Mapping Sent Fields of a Rule
+ * in a direction, unless already written.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param has_target_values Bitmap of the lists of Target Values already
+ * written, by list offset.
+ * @param context Pointer to the validated SCHC Context.
+ */
+static void __write_target_value_offsets(
+    FILE *source, const char *prefix, const unsigned int index_rule_descriptor,
+    const direction_indicator_t direction, uint8_t *has_target_values,
+    const uint8_t *context);
+
+/**
+ * @brief Writes the decompression function of a Rule in a direction.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param index_rule_descriptor Index of the Rule Descriptor.
+ * @param direction Packet Direction Indicator.
+ * @param context Pointer to the validated SCHC Context.
+ */
+static void __write_decompress_rule(FILE *source, const char *prefix,
+                                    const unsigned int index_rule_descriptor,
+                                    const direction_indicator_t direction,
+                                    const uint8_t              *context);
+
+/**
+ * @brief Writes the generated header.
+ *
+ * @param header The generated header.
+ * @param prefix Prefix of the generated functions.
+ * @param context_path Path of the Context file.
+ */
+static void __write_header(FILE *header, const char *prefix,
+                           const char *context_path);
+
+/**
+ * @brief Writes the generated source.
+ *
+ * @param source The generated source.
+ * @param prefix Prefix of the generated functions.
+ * @param context_path Path of the Context file.
+ * @param validated_context Pointer to the Validated Context.
+ */
+static void __write_source(FILE *source, const char *prefix,
+                           const char                *context_path,
+                           const validated_context_t *validated_context);
+
+/* ********************************************************************** */
+
+int main(int argc, char **argv) {
+  validated_context_t validated_context;
+  char                path[MAX_PATH_LEN];
+  FILE               *header;
+  FILE               *source;
+  const char         *prefix;
+
+  if (argc != 4) {
+    fprintf(stderr, "Usage: %s <context file> <prefix> <output directory>\n",
+            argv[0]);
+    return 1;
+  }
+  prefix = argv[2];
+
+  // The prefix starts the generated identifiers
+  if (strlen(prefix) == 0 || strlen(prefix) > MAX_PREFIX_LEN ||
+      isdigit((unsigned char) prefix[0])) {
+    fprintf(stderr, "Invalid prefix: %s\n", prefix);
+    return 1;
+  }
+  for (size_t index = 0; index < strlen(prefix); index++) {
+    if (!isalnum((unsigned char) prefix[index]) && prefix[index] != '_') {
+      fprintf(stderr, "Invalid prefix: %s\n", prefix);
+      return 1;
+    }
+  }
+
+  if (!load_context_file(&validated_context, argv[1])) {
+    fprintf(stderr, "Invalid Context file: %s\n", argv[1]);
+    return 1;
+  }
+
+  snprintf(path, sizeof(path), "%s/%s_rules.h", argv[3], prefix);
+  header = fopen(path, "w");
+  snprintf(path, sizeof(path), "%s/%s_rules.c", argv[3], prefix);
+  source = fopen(path, "w");
+  if (header == NULL || source == NULL) {
+    fprintf(stderr, "Cannot write to %s\n", argv[3]);
+    if (header != NULL) {
+      fclose(header);
+    }
+    if (source != NULL) {
+      fclose(source);
+    }
+    unload_context_file(&validated_context);
+    return 1;
+  }
+
+  __write_header(header, prefix, argv[1]);
+  __write_source(source, prefix, argv[1], &validated_context);
+
+  fclose(header);
+  fclose(source);
+  unload_context_file(&validated_context);
+
+  return 0;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __is_generated(const rule_descriptor_t    *rule_descriptor,
+                          const direction_indicator_t direction,
+                          const int decompression, const uint8_t *context) {
+  rule_field_descriptor_t rule_field_descriptor;
+
+  if (rule_descriptor->nature == NATURE_NO_COMPRESSION) {
+    return !decompression;
+  }
+  if (rule_descriptor->nature != NATURE_COMPRESSION) {
+    return 0;
+  }
+
+  for (unsigned int index = 0;
+       index < rule_descriptor->card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor->offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+
+    // Their bit length and position depend on the packet
+    if (rule_field_descriptor.len == 0 ||
+        get_coap_option_number(rule_field_descriptor.sid) > 0) {
+      return 0;
+    }
+
+    if (decompression && (rule_field_descriptor.cda == CDA_LSB ||
+                          rule_field_descriptor.cda == CDA_COMPUTE)) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static int __depends_on_direction(const rule_descriptor_t *rule_descriptor,
+                                  const uint8_t           *context) {
+  rule_field_descriptor_t rule_field_descriptor;
+
+  if (rule_descriptor->nature != NATURE_COMPRESSION) {
+    return 0;
+  }
+
+  for (unsigned int index = 0;
+       index < rule_descriptor->card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor->offset, context);
+    if (rule_field_descriptor.di != DI_BI) {
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+/* ********************************************************************** */
+
+static int __can_match(const size_t bit_len, const uint8_t *target_value,
+                       const size_t byte_len, const uint8_t first_mask) {
+  uint8_t mask;
+  size_t  unused_bit_len;
+
+  // The bits of the Target Value must be in the mask and in the Field value
+  unused_bit_len = 8 * byte_len - bit_len;
+  for (size_t index = 0; index < byte_len; index++) {
+    mask = (index == 0) ? first_mask : 0xff;
+    if (8 * (index + 1) <= unused_bit_len) {
+      mask = 0x00;
+    } else if (8 * index < unused_bit_len) {
+      mask &= 0xff >> (unused_bit_len - 8 * index);
+    }
+
+    if (target_value[index] & ~mask) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static int __can_match_rule(const rule_descriptor_t    *rule_descriptor,
+                            const direction_indicator_t direction,
+                            const uint8_t              *context) {
+  rule_field_descriptor_t rule_field_descriptor;
+  size_t                  byte_len;
+  size_t                  msb_byte_len;
+  uint16_t                target_value_offset;
+  int                     can_match;
+
+  if (rule_descriptor->nature != NATURE_COMPRESSION) {
+    return rule_descriptor->nature == NATURE_NO_COMPRESSION;
+  }
+
+  for (unsigned int index = 0;
+       index < rule_descriptor->card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor->offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+
+    byte_len = BYTE_LENGTH(rule_field_descriptor.len);
+    switch (rule_field_descriptor.cda) {
+      case CDA_NOT_SENT:
+        can_match = __can_match(
+            rule_field_descriptor.len,
+            context + rule_field_descriptor.first_target_value_offset,
+            byte_len, (1 << (8 - (rule_field_descriptor.len % 8))) - 1);
+        break;
+
+      case CDA_LSB:
+        // Same comparison as MO_most_significant_bits(...)
+        msb_byte_len =
+            byte_len -
+            (rule_field_descriptor.len - rule_field_descriptor.msb_len) / 8;
+        can_match =
+            rule_field_descriptor.len > rule_field_descriptor.msb_len &&
+            __can_match(
+                rule_field_descriptor.msb_len,
+                context + rule_field_descriptor.first_target_value_offset,
+                msb_byte_len,
+                (rule_field_descriptor.msb_len % 8 != 0)
+                    ? (1 << (rule_field_descriptor.msb_len % 8)) - 1
+                    : 0xff);
+        break;
+
+      case CDA_MAPPING_SENT:
+        can_match = 0;
+        for (uint8_t index_target_value = 0;
+             index_target_value < rule_field_descriptor.card_target_value &&
+             !can_match;
+             index_target_value++) {
+          target_value_offset =
+              (rule_field_descriptor.card_target_value == 1)
+                  ? rule_field_descriptor.first_target_value_offset
+                  : merge_uint8_t(
+                        context[rule_field_descriptor
+                                    .first_target_value_offset +
+                                2 * index_target_value],
+                        context[rule_field_descriptor
+                                    .first_target_value_offset +
+                                2 * index_target_value + 1]);
+          can_match = __can_match(
+              rule_field_descriptor.len, context + target_value_offset,
+              byte_len, (1 << (8 - (rule_field_descriptor.len % 8))) - 1);
+        }
+        break;
+
+      default:  // CDA_VALUE_SENT and CDA_COMPUTE
+        can_match = 1;
+        break;
+    }
+
+    if (!can_match) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static unsigned int __get_interpreted_rule(const direction_indicator_t direction,
+                                           const uint8_t *context) {
+  rule_descriptor_t rule_descriptor;
+  unsigned int      index_rule_descriptor;
+
+  // Fragmentation Rules fail in both
+  for (index_rule_descriptor = 0;
+       index_rule_descriptor < context[CARD_RULE_DESCRIPTOR_OFFSET];
+       index_rule_descriptor++) {
+    get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                  context);
+    if (rule_descriptor.nature != NATURE_FRAGMENTATION &&
+        !__is_generated(&rule_descriptor, direction, 0, context)) {
+      break;
+    }
+  }
+
+  return index_rule_descriptor;
+}
+
+/* ********************************************************************** */
+
+static int __is_compressed(const unsigned int          index_rule_descriptor,
+                           const direction_indicator_t direction,
+                           const uint8_t              *context) {
+  rule_descriptor_t rule_descriptor;
+
+  get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                context);
+
+  return index_rule_descriptor < __get_interpreted_rule(direction, context) &&
+         __is_generated(&rule_descriptor, direction, 0, context) &&
+         __can_match_rule(&rule_descriptor, direction, context);
+}
+
+/* ********************************************************************** */
+
+static int __is_decompressed(const unsigned int          index_rule_descriptor,
+                             const direction_indicator_t direction,
+                             const uint8_t              *context) {
+  rule_descriptor_t rule_descriptor;
+  rule_descriptor_t previous_rule_descriptor;
+  size_t            rule_len;
+
+  get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                context);
+  rule_len = bits_counter(context[CARD_RULE_DESCRIPTOR_OFFSET] - 1);
+
+  // The Rule ID is read on rule_len bits
+  if (rule_descriptor.id >= (1u << rule_len)) {
+    return 0;
+  }
+
+  for (unsigned int index = 0; index < index_rule_descriptor; index++) {
+    get_rule_descriptor_unchecked(&previous_rule_descriptor, index, context);
+    if (previous_rule_descriptor.id == rule_descriptor.id) {
+      return 0;
+    }
+  }
+
+  return __is_generated(&rule_descriptor, direction, 1, context);
+}
+
+/* ********************************************************************** */
+
+static uint64_t __get_chunk(const uint8_t *bytes, const size_t byte_len,
+                            const size_t index) {
+  uint64_t chunk;
+
+  chunk = 0;
+  for (size_t index_byte = 0; index_byte < 8; index_byte++) {
+    if (8 * index + index_byte < byte_len) {
+      chunk |= (uint64_t) bytes[byte_len - 1 - 8 * index - index_byte]
+               << (8 * index_byte);
+    }
+  }
+
+  return chunk;
+}
+
+/* ********************************************************************** */
+
+static void __write_loads(FILE *source, const char *prefix,
+                          const size_t bit_position, const size_t bit_len) {
+  size_t chunk_len;
+
+  for (size_t index = 0; CHUNK_LEN * index < bit_len; index++) {
+    chunk_len = bit_len - CHUNK_LEN * index;
+    if (chunk_len > CHUNK_LEN) {
+      chunk_len = CHUNK_LEN;
+    }
+    fprintf(source, "  field[%zu] = __%s_load(packet, %zu, %zu);\n", index,
+            prefix, bit_position + bit_len - CHUNK_LEN * index - chunk_len,
+            chunk_len);
+  }
+}
+
+/* ********************************************************************** */
+
+static void __write_comparison(FILE *source, const size_t bit_len,
+                               const uint8_t *target_value,
+                               const size_t byte_len, const uint8_t first_mask) {
+  uint64_t chunk_mask;
+  uint64_t chunk_target_value;
+  uint64_t field_mask;
+  size_t   chunk_len;
+  int      card_comparisons;
+
+  // The chunks beyond the Field value hold no bit of the Target Value, see
+  // __can_match(...)
+  card_comparisons = 0;
+  for (size_t index = 0; CHUNK_LEN * index < bit_len; index++) {
+    chunk_len = bit_len - CHUNK_LEN * index;
+    if (chunk_len > CHUNK_LEN) {
+      chunk_len = CHUNK_LEN;
+    }
+    field_mask = (chunk_len < CHUNK_LEN) ? ((uint64_t) 1 << chunk_len) - 1
+                                         : UINT64_MAX;
+
+    // The mask is first_mask followed by 0xff bytes
+    chunk_mask = field_mask;
+    if (8 * (index + 1) >= byte_len) {
+      chunk_mask &= ~((uint64_t) (0xff & ~first_mask)
+                      << (8 * (byte_len - 1 - 8 * index)));
+    }
+    chunk_target_value = __get_chunk(target_value, byte_len, index);
+    if (chunk_mask == 0) {
+      continue;
+    }
+
+    fprintf(source, "%s", card_comparisons > 0 ? " && " : "");
+    if (chunk_mask == field_mask) {
+      fprintf(source, "field[%zu] == 0x%" PRIx64 "u", index,
+              chunk_target_value);
+    } else {
+      fprintf(source, "(field[%zu] & 0x%" PRIx64 "u) == 0x%" PRIx64 "u", index,
+              chunk_mask, chunk_target_value);
+    }
+    card_comparisons++;
+  }
+
+  if (card_comparisons == 0) {
+    fprintf(source, "1");
+  }
+}
+
+/* ********************************************************************** */
+
+static void __write_stores(FILE *source, const char *prefix,
+                           const size_t schc_packet_bit_position,
+                           const size_t packet_bit_position,
+                           const size_t bit_len) {
+  size_t chunk_len;
+
+  // Most significant chunk first
+  for (size_t position = 0; position < bit_len; position += chunk_len) {
+    chunk_len = (bit_len - position) % CHUNK_LEN;
+    if (chunk_len == 0) {
+      chunk_len = CHUNK_LEN;
+    }
+    fprintf(source,
+            "  __%s_store(schc_packet, %zu,\n"
+            "      __%s_load(packet, %zu, %zu), %zu);\n",
+            prefix, schc_packet_bit_position + position, prefix,
+            packet_bit_position + position, chunk_len, chunk_len);
+  }
+}
+
+/* ********************************************************************** */
+
+static void __write_rule_function_name(FILE *source, const char *prefix,
+                                       const char        *operation,
+                                       const unsigned int index_rule_descriptor,
+                                       const direction_indicator_t direction) {
+  fprintf(source, "__%s_%s_rule_%u%s", prefix, operation,
+          index_rule_descriptor,
+          direction == DI_UP   ? "_up"
+          : direction == DI_DW ? "_dw"
+                               : "");
+}
+
+/* ********************************************************************** */
+
+static void __write_compress_rule(FILE *source, const char *prefix,
+                                  const unsigned int          index_rule_descriptor,
+                                  const direction_indicator_t direction,
+                                  const uint8_t              *context) {
+  rule_descriptor_t       rule_descriptor;
+  rule_field_descriptor_t rule_field_descriptor;
+  size_t                  rule_len;
+  size_t                  packet_bit_position;
+  size_t                  schc_packet_bit_position;
+  size_t                  byte_len;
+  size_t                  lsb_len;
+  size_t                  mapping_len;
+  size_t                  card_chunks;
+  size_t                  field_len;
+  uint16_t                target_value_offset;
+  int                     has_mapping;
+  int                     card_matches;
+
+  get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                context);
+  rule_len = bits_counter(context[CARD_RULE_DESCRIPTOR_OFFSET] - 1);
+
+  // Bit lengths of the packet fields, and of the field variables
+  packet_bit_position = 0;
+  card_chunks         = 0;
+  has_mapping         = 0;
+  for (unsigned int index = 0;
+       rule_descriptor.nature == NATURE_COMPRESSION &&
+       index < rule_descriptor.card_rule_field_descriptor;
+       index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+
+    field_len = 0;
+    if (rule_field_descriptor.cda == CDA_NOT_SENT ||
+        rule_field_descriptor.cda == CDA_MAPPING_SENT) {
+      field_len = rule_field_descriptor.len;
+    } else if (rule_field_descriptor.cda == CDA_LSB) {
+      field_len = rule_field_descriptor.msb_len;
+    }
+    if ((field_len + CHUNK_LEN - 1) / CHUNK_LEN > card_chunks) {
+      card_chunks = (field_len + CHUNK_LEN - 1) / CHUNK_LEN;
+    }
+    has_mapping |= rule_field_descriptor.cda == CDA_MAPPING_SENT &&
+                   rule_field_descriptor.card_target_value > 1;
+    packet_bit_position += rule_field_descriptor.len;
+  }
+  byte_len = BYTE_LENGTH(packet_bit_position);
+
+  fprintf(source, "static size_t ");
+  __write_rule_function_name(source, prefix, "compress", index_rule_descriptor,
+                             __depends_on_direction(&rule_descriptor, context)
+                                 ? direction
+                                 : DI_BI);
+  fprintf(source,
+          "(\n"
+          "    uint8_t *schc_packet, const size_t schc_packet_max_byte_len,\n"
+          "    const uint8_t *packet, const size_t packet_byte_len) {\n");
+  if (card_chunks > 0) {
+    fprintf(source, "  uint64_t field[%zu];\n", card_chunks);
+  }
+  if (has_mapping) {
+    fprintf(source, "  uint8_t  mapping_index;\n");
+  }
+  if (card_chunks > 0 || has_mapping) {
+    fprintf(source, "\n");
+  }
+
+  // Residue bit length, the payload follows
+  schc_packet_bit_position = rule_len;
+  for (unsigned int index = 0;
+       rule_descriptor.nature == NATURE_COMPRESSION &&
+       index < rule_descriptor.card_rule_field_descriptor;
+       index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+    if (rule_field_descriptor.cda == CDA_VALUE_SENT) {
+      schc_packet_bit_position += rule_field_descriptor.len;
+    } else if (rule_field_descriptor.cda == CDA_LSB) {
+      schc_packet_bit_position +=
+          rule_field_descriptor.len - rule_field_descriptor.msb_len;
+    } else if (rule_field_descriptor.cda == CDA_MAPPING_SENT) {
+      schc_packet_bit_position +=
+          bits_counter(rule_field_descriptor.card_target_value - 1);
+    }
+  }
+
+  // Every Field is in the packet and the SCHC Packet fits, checked once
+  fprintf(source, "  if (");
+  if (byte_len > 0) {
+    fprintf(source, "packet_byte_len < %zu ||\n      ", byte_len);
+  }
+  fprintf(source,
+          "BYTE_LENGTH(%zu + 8 * (packet_byte_len - %zu)) >\n"
+          "          schc_packet_max_byte_len) {\n"
+          "    return 0;\n"
+          "  }\n\n",
+          schc_packet_bit_position, byte_len);
+
+  fprintf(source, "  // Rule ID %u\n", rule_descriptor.id);
+  fprintf(source, "  __%s_store(schc_packet, 0, 0x%xu, %zu);\n", prefix,
+          rule_descriptor.id & ((1u << rule_len) - 1), rule_len);
+
+  packet_bit_position      = 0;
+  schc_packet_bit_position = rule_len;
+  for (unsigned int index = 0;
+       rule_descriptor.nature == NATURE_COMPRESSION &&
+       index < rule_descriptor.card_rule_field_descriptor;
+       index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+
+    byte_len = BYTE_LENGTH(rule_field_descriptor.len);
+    fprintf(source, "\n  // SID %u, %u bits at bit %zu\n",
+            rule_field_descriptor.sid, rule_field_descriptor.len,
+            packet_bit_position);
+
+    switch (rule_field_descriptor.cda) {
+      case CDA_NOT_SENT:
+        __write_loads(source, prefix, packet_bit_position,
+                      rule_field_descriptor.len);
+        fprintf(source, "  if (!(");
+        __write_comparison(
+            source, rule_field_descriptor.len,
+            context + rule_field_descriptor.first_target_value_offset,
+            byte_len, (1 << (8 - (rule_field_descriptor.len % 8))) - 1);
+        fprintf(source, ")) {\n    return 0;\n  }\n");
+        break;
+
+      case CDA_LSB:
+        lsb_len = rule_field_descriptor.len - rule_field_descriptor.msb_len;
+        __write_loads(source, prefix, packet_bit_position,
+                      rule_field_descriptor.msb_len);
+        fprintf(source, "  if (!(");
+        __write_comparison(
+            source, rule_field_descriptor.msb_len,
+            context + rule_field_descriptor.first_target_value_offset,
+            byte_len - lsb_len / 8,
+            (rule_field_descriptor.msb_len % 8 != 0)
+                ? (1 << (rule_field_descriptor.msb_len % 8)) - 1
+                : 0xff);
+        fprintf(source, ")) {\n    return 0;\n  }\n");
+        __write_stores(source, prefix, schc_packet_bit_position,
+                       packet_bit_position + rule_field_descriptor.msb_len,
+                       lsb_len);
+        schc_packet_bit_position += lsb_len;
+        break;
+
+      case CDA_MAPPING_SENT:
+        mapping_len = bits_counter(rule_field_descriptor.card_target_value - 1);
+        __write_loads(source, prefix, packet_bit_position,
+                      rule_field_descriptor.len);
+
+        if (rule_field_descriptor.card_target_value == 1) {
+          fprintf(source, "  if (!(");
+          __write_comparison(
+              source, rule_field_descriptor.len,
+              context + rule_field_descriptor.first_target_value_offset,
+              byte_len, (1 << (8 - (rule_field_descriptor.len % 8))) - 1);
+          fprintf(source, ")) {\n    return 0;\n  }\n");
+          fprintf(source, "  __%s_store(schc_packet, %zu, 0x0u, %zu);\n",
+                  prefix, schc_packet_bit_position, mapping_len);
+          schc_packet_bit_position += mapping_len;
+          break;
+        }
+
+        // The first Target Value that matches gives the index
+        card_matches = 0;
+        for (uint8_t index_target_value = 0;
+             index_target_value < rule_field_descriptor.card_target_value;
+             index_target_value++) {
+          target_value_offset = merge_uint8_t(
+              context[rule_field_descriptor.first_target_value_offset +
+                      2 * index_target_value],
+              context[rule_field_descriptor.first_target_value_offset +
+                      2 * index_target_value + 1]);
+          if (!__can_match(rule_field_descriptor.len,
+                           context + target_value_offset, byte_len,
+                           (1 << (8 - (rule_field_descriptor.len % 8))) -
+                               1)) {
+            continue;
+          }
+
+          fprintf(source, "%s", card_matches == 0 ? "  if (" : " else if (");
+          __write_comparison(
+              source, rule_field_descriptor.len, context + target_value_offset,
+              byte_len, (1 << (8 - (rule_field_descriptor.len % 8))) - 1);
+          fprintf(source, ") {\n    mapping_index = %u;\n  }",
+                  index_target_value);
+          card_matches++;
+        }
+        fprintf(source, " else {\n    return 0;\n  }\n");
+        fprintf(source,
+                "  __%s_store(schc_packet, %zu, mapping_index, %zu);\n",
+                prefix, schc_packet_bit_position, mapping_len);
+        schc_packet_bit_position += mapping_len;
+        break;
+
+      case CDA_COMPUTE:
+        fprintf(source, "  // Computed by the decompressor\n");
+        break;
+
+      default:  // CDA_VALUE_SENT
+        __write_stores(source, prefix, schc_packet_bit_position,
+                       packet_bit_position, rule_field_descriptor.len);
+        schc_packet_bit_position += rule_field_descriptor.len;
+        break;
+    }
+
+    packet_bit_position += rule_field_descriptor.len;
+  }
+
+  byte_len = BYTE_LENGTH(packet_bit_position);
+  fprintf(source,
+          "\n  // Payload\n"
+          "  __%s_store_bytes(schc_packet, %zu, packet + %zu,\n"
+          "      packet_byte_len - %zu);\n\n"
+          "  return BYTE_LENGTH(%zu + 8 * (packet_byte_len - %zu));\n"
+          "}\n\n",
+          prefix, schc_packet_bit_position, byte_len, byte_len,
+          schc_packet_bit_position, byte_len);
+}
+
+/* ********************************************************************** */
+
+static void __write_target_value_offsets(
+    FILE *source, const char *prefix, const unsigned int index_rule_descriptor,
+    const direction_indicator_t direction, uint8_t *has_target_values,
+    const uint8_t *context) {
+  rule_descriptor_t       rule_descriptor;
+  rule_field_descriptor_t rule_field_descriptor;
+  uint16_t                target_value_offset;
+
+  get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                context);
+  for (unsigned int index = 0;
+       index < rule_descriptor.card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    target_value_offset = rule_field_descriptor.first_target_value_offset;
+    if ((rule_field_descriptor.di != DI_BI &&
+         rule_field_descriptor.di != direction) ||
+        rule_field_descriptor.cda != CDA_MAPPING_SENT ||
+        rule_field_descriptor.card_target_value < 2 ||
+        (has_target_values[target_value_offset / 8] >>
+         (target_value_offset % 8)) &
+            1) {
+      continue;
+    }
+    has_target_values[target_value_offset / 8] |= 1 << (target_value_offset % 8);
+
+    fprintf(source, "static const uint16_t __%s_target_values_%u[] = {",
+            prefix, target_value_offset);
+    for (uint8_t index_target_value = 0;
+         index_target_value < rule_field_descriptor.card_target_value;
+         index_target_value++) {
+      fprintf(source, "%s%u%s", index_target_value % 12 == 0 ? "\n    " : "",
+              merge_uint8_t(context[target_value_offset +
+                                    2 * index_target_value],
+                            context[target_value_offset +
+                                    2 * index_target_value + 1]),
+              index_target_value + 1 < rule_field_descriptor.card_target_value
+                  ? ", "
+                  : "");
+    }
+    fprintf(source, "};\n\n");
+  }
+}
+
+/* ********************************************************************** */
+
+static void __write_decompress_rule(FILE *source, const char *prefix,
+                                    const unsigned int index_rule_descriptor,
+                                    const direction_indicator_t direction,
+                                    const uint8_t              *context) {
+  rule_descriptor_t       rule_descriptor;
+  rule_field_descriptor_t rule_field_descriptor;
+  size_t                  schc_packet_bit_position;
+  size_t                  field_byte_len;
+  size_t                  mapping_len;
+
+  get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                context);
+
+  // Field buffer, one more byte for extract_bits(...) when unaligned
+  field_byte_len = 0;
+  for (unsigned int index = 0;
+       index < rule_descriptor.card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    if ((rule_field_descriptor.di == DI_BI ||
+         rule_field_descriptor.di == direction) &&
+        (rule_field_descriptor.cda == CDA_VALUE_SENT ||
+         rule_field_descriptor.cda == CDA_MAPPING_SENT)) {
+      if ((size_t) BYTE_LENGTH(rule_field_descriptor.len) + 1 >
+          field_byte_len) {
+        field_byte_len = (size_t) BYTE_LENGTH(rule_field_descriptor.len) + 1;
+      }
+    }
+  }
+
+  fprintf(source, "static size_t ");
+  __write_rule_function_name(source, prefix, "decompress",
+                             index_rule_descriptor,
+                             __depends_on_direction(&rule_descriptor, context)
+                                 ? direction
+                                 : DI_BI);
+  fprintf(source,
+          "(\n"
+          "    uint8_t *packet, const size_t packet_max_byte_len,\n"
+          "    const uint8_t *schc_packet, const size_t schc_packet_byte_len) "
+          "{\n");
+  schc_packet_bit_position =
+      bits_counter(context[CARD_RULE_DESCRIPTOR_OFFSET] - 1);
+  if (field_byte_len > 0) {
+    fprintf(source,
+            "  uint8_t field[%zu];\n"
+            "  size_t  packet_bit_position;\n"
+            "  size_t  schc_packet_bit_position;\n\n"
+            "  packet_bit_position      = 0;\n"
+            "  schc_packet_bit_position = %zu;\n\n",
+            field_byte_len, schc_packet_bit_position);
+  } else {
+    // Nothing is read from the SCHC Packet before the payload
+    fprintf(source,
+            "  size_t packet_bit_position;\n\n"
+            "  packet_bit_position = 0;\n\n");
+  }
+  fprintf(source, "  memset(packet, 0x00, packet_max_byte_len);\n");
+
+  for (unsigned int index = 0;
+       index < rule_descriptor.card_rule_field_descriptor; index++) {
+    get_rule_field_descriptor_unchecked(&rule_field_descriptor, index,
+                                        rule_descriptor.offset, context);
+    if (rule_field_descriptor.di != DI_BI &&
+        rule_field_descriptor.di != direction) {
+      continue;
+    }
+
+    fprintf(source, "\n  // SID %u, %u bits\n", rule_field_descriptor.sid,
+            rule_field_descriptor.len);
+    switch (rule_field_descriptor.cda) {
+      case CDA_NOT_SENT:
+        fprintf(source,
+                "  if (!add_bits_to_buffer(packet, packet_max_byte_len,\n"
+                "                          &packet_bit_position,\n"
+                "                          __%s_context + %u, %u)) {\n"
+                "    return 0;\n"
+                "  }\n",
+                prefix, rule_field_descriptor.first_target_value_offset,
+                rule_field_descriptor.len);
+        break;
+
+      case CDA_MAPPING_SENT:
+        mapping_len = bits_counter(rule_field_descriptor.card_target_value - 1);
+        fprintf(source,
+                "  if (!extract_bits(field, 1, %zu, &schc_packet_bit_position,\n"
+                "                    schc_packet, schc_packet_byte_len) ||\n"
+                "      field[0] >= %u ||\n"
+                "      !add_bits_to_buffer(packet, packet_max_byte_len,\n"
+                "                          &packet_bit_position,\n",
+                mapping_len, rule_field_descriptor.card_target_value);
+        if (rule_field_descriptor.card_target_value == 1) {
+          fprintf(source, "                          __%s_context + %u, %u)) {\n",
+                  prefix, rule_field_descriptor.first_target_value_offset,
+                  rule_field_descriptor.len);
+        } else {
+          fprintf(source,
+                  "                          __%s_context +\n"
+                  "                              __%s_target_values_%u[field[0]],\n"
+                  "                          %u)) {\n",
+                  prefix, prefix,
+                  rule_field_descriptor.first_target_value_offset,
+                  rule_field_descriptor.len);
+        }
+        fprintf(source, "    return 0;\n  }\n");
+        schc_packet_bit_position += mapping_len;
+        break;
+
+      default:  // CDA_VALUE_SENT
+        fprintf(source,
+                "  if (!extract_bits(field, %u, %u, &schc_packet_bit_position,\n"
+                "                    schc_packet, schc_packet_byte_len) ||\n"
+                "      !add_bits_to_buffer(packet, packet_max_byte_len,\n"
+                "                          &packet_bit_position, field, %u)) {\n"
+                "    return 0;\n"
+                "  }\n",
+                BYTE_LENGTH(rule_field_descriptor.len),
+                rule_field_descriptor.len, rule_field_descriptor.len);
+        schc_packet_bit_position += rule_field_descriptor.len;
+        break;
+    }
+  }
+
+  fprintf(source,
+          "\n  // Payload\n"
+          "  if (!__%s_add_payload(packet, packet_max_byte_len,\n"
+          "          &packet_bit_position, schc_packet,\n"
+          "          schc_packet_byte_len, %zu)) {\n"
+          "    return 0;\n"
+          "  }\n\n"
+          "  return BYTE_LENGTH(packet_bit_position);\n"
+          "}\n\n",
+          prefix, schc_packet_bit_position);
+}
+
+/* ********************************************************************** */
+
+static void __write_header(FILE *header, const char *prefix,
+                           const char *context_path) {
+  char guard[MAX_PREFIX_LEN + 1];
+
+  for (size_t index = 0; index <= strlen(prefix); index++) {
+    guard[index] = (char) toupper((unsigned char) prefix[index]);
+  }
+
+  fprintf(header,
+          "/**\n"
+          " * @file %s_rules.h\n"
+          " * @brief Compression and decompression of the Rules of %s.\n"
+          " *\n"
+          " * @details Generated by cschc-codegen, do not edit.\n"
+          " */\n\n"
+          "#ifndef _%s_RULES_H_\n"
+          "#define _%s_RULES_H_\n\n"
+          "#include \"core/context.h\"\n\n"
+          "#include <stddef.h>\n"
+          "#include <stdint.h>\n\n"
+          "/**\n"
+          " * @brief The Context the functions are generated from.\n"
+          " */\n"
+          "extern const validated_context_t %s_validated_context;\n\n"
+          "/**\n"
+          " * @brief Same as compress_validated(...) with "
+          "%s_validated_context.\n"
+          " */\n"
+          "size_t %s_compress(\n"
+          "    uint8_t *schc_packet, const size_t schc_packet_max_byte_len,\n"
+          "    const direction_indicator_t packet_direction,\n"
+          "    const uint8_t *packet, const size_t packet_byte_len);\n\n"
+          "/**\n"
+          " * @brief Same as decompress_validated(...) with "
+          "%s_validated_context.\n"
+          " */\n"
+          "size_t %s_decompress(\n"
+          "    uint8_t *packet, const size_t packet_max_byte_len,\n"
+          "    const direction_indicator_t packet_direction,\n"
+          "    const uint8_t *schc_packet, const size_t schc_packet_byte_len);\n\n"
+          "#endif  // _%s_RULES_H_\n",
+          prefix, context_path, guard, guard, prefix, prefix, prefix, prefix,
+          prefix, guard);
+}
+
+/* ********************************************************************** */
+
+static void __write_source(FILE *source, const char *prefix,
+                           const char                *context_path,
+                           const validated_context_t *validated_context) {
+  const uint8_t    *context;
+  uint8_t           card_rule_descriptor;
+  size_t            rule_len;
+  rule_descriptor_t rule_descriptor;
+  uint8_t           has_target_values[UINT16_MAX / 8 + 1];
+  int               depends_on_direction;
+  int               card_calls;
+
+  context              = validated_context->context;
+  card_rule_descriptor = context[CARD_RULE_DESCRIPTOR_OFFSET];
+  rule_len             = bits_counter(card_rule_descriptor - 1);
+
+  fprintf(source,
+          "/**\n"
+          " * @file %s_rules.c\n"
+          " * @brief Compression and decompression of the Rules of %s.\n"
+          " *\n"
+          " * @details Generated by cschc-codegen, do not edit.\n"
+          " */\n\n"
+          "#include \"%s_rules.h\"\n"
+          "#include \"core/compression.h\"\n"
+          "#include \"core/decompression.h\"\n"
+          "#include \"utils/binary.h\"\n\n"
+          "#include <string.h>\n\n",
+          prefix, context_path, prefix);
+
+  // Context
+  fprintf(source, "static const uint8_t __%s_context[] = {", prefix);
+  for (size_t index = 0; index < validated_context->context_byte_len;
+       index++) {
+    fprintf(source, "%s0x%02x%s", index % 12 == 0 ? "\n    " : "",
+            context[index],
+            index + 1 < validated_context->context_byte_len ? ", " : "");
+  }
+  fprintf(source,
+          "};\n\n"
+          "const validated_context_t %s_validated_context = {\n"
+          "    __%s_context, sizeof(__%s_context)};\n\n",
+          prefix, prefix, prefix);
+
+  // Bit helpers, inlined with constant bit positions and lengths
+  fprintf(
+      source,
+      "/**\n"
+      " * @brief Loads up to 64 bits of a buffer, right-aligned.\n"
+      " */\n"
+      "static inline uint64_t __%s_load(const uint8_t *buffer,\n"
+      "                                 const size_t   bit_position,\n"
+      "                                 const size_t   bit_len) {\n"
+      "  size_t   byte_position;\n"
+      "  size_t   first_len;\n"
+      "  size_t   remaining_len;\n"
+      "  uint64_t bits;\n\n"
+      "  byte_position = bit_position / 8;\n"
+      "  first_len     = 8 - bit_position %% 8;\n"
+      "  bits          = buffer[byte_position] & (0xff >> (bit_position %% 8));\n"
+      "  if (bit_len <= first_len) {\n"
+      "    return bits >> (first_len - bit_len);\n"
+      "  }\n\n"
+      "  for (remaining_len = bit_len - first_len; remaining_len >= 8;\n"
+      "       remaining_len -= 8) {\n"
+      "    bits = (bits << 8) | buffer[++byte_position];\n"
+      "  }\n"
+      "  if (remaining_len > 0) {\n"
+      "    bits = (bits << remaining_len) |\n"
+      "           (buffer[++byte_position] >> (8 - remaining_len));\n"
+      "  }\n\n"
+      "  return bits;\n"
+      "}\n\n"
+      "/**\n"
+      " * @brief Stores up to 64 bits in a buffer, the bytes after the bit\n"
+      " * position being overwritten.\n"
+      " */\n"
+      "static inline void __%s_store(uint8_t *buffer, const size_t "
+      "bit_position,\n"
+      "                              const uint64_t bits, const size_t "
+      "bit_len) {\n"
+      "  size_t  byte_position;\n"
+      "  size_t  offset;\n"
+      "  size_t  remaining_len;\n"
+      "  size_t  chunk_len;\n"
+      "  uint8_t chunk;\n\n"
+      "  byte_position = bit_position / 8;\n"
+      "  offset        = bit_position %% 8;\n"
+      "  remaining_len = bit_len;\n"
+      "  while (remaining_len > 0) {\n"
+      "    chunk_len = (8 - offset < remaining_len) ? 8 - offset : "
+      "remaining_len;\n"
+      "    remaining_len -= chunk_len;\n"
+      "    chunk = (uint8_t) (((bits >> remaining_len) & ((1u << chunk_len) - "
+      "1))\n"
+      "                       << (8 - offset - chunk_len));\n"
+      "    buffer[byte_position] =\n"
+      "        (offset == 0) ? chunk : buffer[byte_position] | chunk;\n"
+      "    byte_position++;\n"
+      "    offset = 0;\n"
+      "  }\n"
+      "}\n\n"
+      "/**\n"
+      " * @brief Stores bytes in a buffer, the bytes after the bit position "
+      "being\n"
+      " * overwritten.\n"
+      " */\n"
+      "static inline void __%s_store_bytes(uint8_t *buffer,\n"
+      "                                    const size_t   bit_position,\n"
+      "                                    const uint8_t *bytes,\n"
+      "                                    const size_t   byte_len) {\n"
+      "  size_t byte_position;\n"
+      "  size_t offset;\n\n"
+      "  byte_position = bit_position / 8;\n"
+      "  offset        = bit_position %% 8;\n"
+      "  if (offset == 0) {\n"
+      "    memcpy(buffer + byte_position, bytes, byte_len);\n"
+      "    return;\n"
+      "  }\n\n"
+      "  for (size_t index = 0; index < byte_len; index++) {\n"
+      "    buffer[byte_position + index] |= bytes[index] >> offset;\n"
+      "    buffer[byte_position + index + 1] = bytes[index] << (8 - offset);\n"
+      "  }\n"
+      "}\n\n"
+      "/**\n"
+      " * @brief Adds the payload of a SCHC Packet to the packet, as\n"
+      " * decompress_validated(...) does.\n"
+      " */\n"
+      "static inline int __%s_add_payload(uint8_t     *packet,\n"
+      "                                   const size_t packet_max_byte_len,\n"
+      "                                   size_t      *packet_bit_position,\n"
+      "                                   const uint8_t *schc_packet,\n"
+      "                                   const size_t   schc_packet_byte_len,\n"
+      "                                   const size_t "
+      "schc_packet_bit_position) {\n"
+      "  size_t payload_byte_position;\n"
+      "  size_t offset;\n\n"
+      "  payload_byte_position = schc_packet_bit_position / 8;\n"
+      "  offset                = schc_packet_bit_position %% 8;\n"
+      "  if (offset == 0) {\n"
+      "    return add_bits_to_buffer(\n"
+      "        packet, packet_max_byte_len, packet_bit_position,\n"
+      "        schc_packet + payload_byte_position,\n"
+      "        8 * (schc_packet_byte_len - payload_byte_position));\n"
+      "  }\n\n"
+      "  // The last bits of the SCHC Packet are padding\n"
+      "  if (BYTE_LENGTH(*packet_bit_position +\n"
+      "                  8 * (schc_packet_byte_len - payload_byte_position - "
+      "1)) >\n"
+      "      packet_max_byte_len) {\n"
+      "    return 0;\n"
+      "  }\n"
+      "  for (size_t index = payload_byte_position; index + 1 < "
+      "schc_packet_byte_len;\n"
+      "       index++) {\n"
+      "    add_byte_to_buffer(packet, packet_max_byte_len, "
+      "packet_bit_position,\n"
+      "                       (uint8_t) ((schc_packet[index] << offset) |\n"
+      "                                  (schc_packet[index + 1] >> (8 - "
+      "offset))),\n"
+      "                       8);\n"
+      "  }\n\n"
+      "  return 1;\n"
+      "}\n\n",
+      prefix, prefix, prefix, prefix);
+
+  // Rule functions, a Rule that does not depend on the direction gets one
+  memset(has_target_values, 0x00, sizeof(has_target_values));
+  for (unsigned int index_rule_descriptor = 0;
+       index_rule_descriptor < card_rule_descriptor; index_rule_descriptor++) {
+    get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                  context);
+    depends_on_direction = __depends_on_direction(&rule_descriptor, context);
+    for (int direction = DI_UP; direction <= DI_DW; direction++) {
+      if (__is_compressed(index_rule_descriptor,
+                          (direction_indicator_t) direction, context) &&
+          (depends_on_direction ||
+           direction == DI_UP ||
+           !__is_compressed(index_rule_descriptor, DI_UP, context))) {
+        __write_compress_rule(source, prefix, index_rule_descriptor,
+                              (direction_indicator_t) direction, context);
+      }
+      if (__is_decompressed(index_rule_descriptor,
+                            (direction_indicator_t) direction, context) &&
+          (depends_on_direction || direction == DI_UP)) {
+        __write_target_value_offsets(source, prefix, index_rule_descriptor,
+                                     (direction_indicator_t) direction,
+                                     has_target_values, context);
+        __write_decompress_rule(source, prefix, index_rule_descriptor,
+                                (direction_indicator_t) direction, context);
+      }
+    }
+  }
+
+  // Compression, Rules tried in order until one is left to the interpreter
+  card_calls = 0;
+  for (unsigned int index_rule_descriptor = 0;
+       index_rule_descriptor < card_rule_descriptor; index_rule_descriptor++) {
+    card_calls += __is_compressed(index_rule_descriptor, DI_UP, context) ||
+                  __is_compressed(index_rule_descriptor, DI_DW, context);
+  }
+  fprintf(source,
+          "size_t %s_compress(\n"
+          "    uint8_t *schc_packet, const size_t schc_packet_max_byte_len,\n"
+          "    const direction_indicator_t packet_direction,\n"
+          "    const uint8_t *packet, const size_t packet_byte_len) {\n",
+          prefix);
+  if (card_calls > 0) {
+    fprintf(source, "  size_t schc_packet_byte_len;\n\n");
+  }
+  for (int direction = DI_UP; direction <= DI_DW; direction++) {
+    fprintf(source, "  if (packet_direction == %s) {\n",
+            direction == DI_UP ? "DI_UP" : "DI_DW");
+    for (unsigned int index_rule_descriptor = 0;
+         index_rule_descriptor < card_rule_descriptor;
+         index_rule_descriptor++) {
+      if (!__is_compressed(index_rule_descriptor,
+                           (direction_indicator_t) direction, context)) {
+        continue;
+      }
+      get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                    context);
+
+      fprintf(source, "    schc_packet_byte_len = ");
+      __write_rule_function_name(
+          source, prefix, "compress", index_rule_descriptor,
+          __depends_on_direction(&rule_descriptor, context)
+              ? (direction_indicator_t) direction
+              : DI_BI);
+      fprintf(source,
+              "(\n"
+              "        schc_packet, schc_packet_max_byte_len, packet, "
+              "packet_byte_len);\n"
+              "    if (schc_packet_byte_len > 0) {\n"
+              "      return schc_packet_byte_len;\n"
+              "    }\n");
+    }
+
+    if (__get_interpreted_rule((direction_indicator_t) direction, context) ==
+        card_rule_descriptor) {
+      fprintf(source, "    return 0;\n  }\n\n");
+    } else {
+      fprintf(source,
+              "    // The next Rule depends on the packet layout\n"
+              "    return compress_validated(\n"
+              "        schc_packet, schc_packet_max_byte_len, "
+              "packet_direction, packet,\n"
+              "        packet_byte_len, &%s_validated_context);\n"
+              "  }\n\n",
+              prefix);
+    }
+  }
+  fprintf(source,
+          "  return compress_validated(schc_packet, "
+          "schc_packet_max_byte_len,\n"
+          "                            packet_direction, packet, "
+          "packet_byte_len,\n"
+          "                            &%s_validated_context);\n"
+          "}\n\n",
+          prefix);
+
+  // Decompression, the Rule is given by the Rule ID
+  fprintf(source,
+          "size_t %s_decompress(\n"
+          "    uint8_t *packet, const size_t packet_max_byte_len,\n"
+          "    const direction_indicator_t packet_direction,\n"
+          "    const uint8_t *schc_packet, const size_t schc_packet_byte_len) {\n",
+          prefix);
+  for (int direction = DI_UP; direction <= DI_DW; direction++) {
+    card_calls = 0;
+    for (unsigned int index_rule_descriptor = 0;
+         index_rule_descriptor < card_rule_descriptor;
+         index_rule_descriptor++) {
+      if (!__is_decompressed(index_rule_descriptor,
+                             (direction_indicator_t) direction, context)) {
+        continue;
+      }
+      get_rule_descriptor_unchecked(&rule_descriptor, index_rule_descriptor,
+                                    context);
+
+      if (card_calls == 0) {
+        fprintf(source,
+                "  if (packet_direction == %s && schc_packet_byte_len > 0) {\n"
+                "    switch (schc_packet[0] >> %zu) {\n",
+                direction == DI_UP ? "DI_UP" : "DI_DW", 8 - rule_len);
+      }
+      fprintf(source, "      case %u:\n        return ", rule_descriptor.id);
+      __write_rule_function_name(
+          source, prefix, "decompress", index_rule_descriptor,
+          __depends_on_direction(&rule_descriptor, context)
+              ? (direction_indicator_t) direction
+              : DI_BI);
+      fprintf(source,
+              "(\n"
+              "            packet, packet_max_byte_len, schc_packet, "
+              "schc_packet_byte_len);\n");
+      card_calls++;
+    }
+    if (card_calls > 0) {
+      fprintf(source, "      default:\n        break;\n    }\n  }\n\n");
+    }
+  }
+  fprintf(source,
+          "  return decompress_validated(packet, packet_max_byte_len,\n"
+          "                              packet_direction, schc_packet,\n"
+          "                              schc_packet_byte_len, "
+          "&%s_validated_context);\n"
+          "}\n",
+          prefix);
+}
\ No newline at end of file
@@ -0,0 +1,1660 @@
+/**
+ * @file cschc_gateway.c
+ * @author Corentin Banier and Quentin Lampin
+ * @brief SCHC gateway forwarding UDP datagrams on the loopback interface.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Usage: cschc-gateway <context file> [options]
+ *   -p <port>     Port receiving the IPv6/UDP packets, default 47000.
+ *   -P <port>     Port the decompressed packets are sent to, default 47001.
+ *   -s <port>     Port receiving the SCHC frames, default 47002.
+ *   -S <port>     Port the SCHC frames are sent to, default 47003.
+ *   -t <threads>  Worker threads, default 1.
+ *   -r            SO_REUSEPORT sharding, required by more than one thread.
+ *   -b <packets>  Datagrams per recvmmsg/sendmmsg batch, default 64.
+ *   -u            Device side: compresses in DI_UP and decompresses in DI_DW,
+ *                 instead of the opposite.
+ *   -l <packets>  Load mode, see below.
+ *   -w <packets>  Datagrams in flight in load mode, default 256.
+ *   -g <packets>  Malformed datagrams sent before the load, default 0.
+ *   -i            io_uring backend, instead of recvmmsg and sendmmsg.
+ *
+ * Each UDP datagram received on [::1]:<-p> holds an IPv6 packet, which is
+ * compressed with the Context and sent as a SCHC frame to [::1]:<-S>. Each
+ * datagram received on [::1]:<-s> holds a SCHC frame, which is decompressed
+ * and sent to [::1]:<-P>. The gateway runs until SIGINT or SIGTERM, then
+ * prints its counters. It fails if a worker leaves bytes allocated in its
+ * memory pool, which lives as long as the worker.
+ *
+ * Datagrams are received and sent by batches with recvmmsg and sendmmsg. With
+ * -r, every worker binds its own sockets to the same ports and the kernel
+ * shards the flows between them. Each worker owns its memory pool and Flow
+ * Cache.
+ *
+ * With -i, each worker owns an io_uring instead. One multishot receive per
+ * socket fills the buffers of a provided buffer ring, the results are written
+ * straight into registered send buffers and leave with zero-copy sends, and a
+ * single io_uring_enter submits the sends of a pass and waits for the next
+ * completions. The rings are set up with raw syscalls, liburing is not
+ * required. The worker falls back to recvmmsg and sendmmsg when the kernel
+ * refuses them.
+ *
+ * In load mode, the tool also plays the application and the devices. It sends
+ * synthetic packets to the gateway, the decompression of random SCHC Packets
+ * whose last 4 bytes survive the round trip, tagged there with a sequence
+ * number. It mirrors the SCHC frames back to the gateway, which decompresses
+ * them in the direction they were compressed in, and receives the packets. It
+ * then prints the round trip throughput and latency percentiles, and fails if
+ * any packet is lost. With -g, truncated packets and random SCHC frames are
+ * sent to the gateway first, so the load checks that they left it working.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/decompression.h"
+#include "core/flow_cache.h"
+#include "utils/memory.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_DATAGRAM_BYTE_LEN 2048
+#define MAX_WORKERS           64
+#define POLL_TIMEOUT_MS       100
+#define LOAD_TIMEOUT_NS       1000000000ull  // Without progress, in load mode
+#define RETRANSMIT_TIMEOUT_NS 200000000ull   // At least, before resending
+#define FLOW_CACHE_ENTRIES    1024
+#define SOCKET_BUFFER_LEN     (4 * 1024 * 1024)
+#define MIN_LOAD_PACKET_BYTE_LEN 52  // IPv6 and UDP headers, then the tag
+#define URING_BUFFERS         512    // Receive and send buffers, a power of 2
+#define URING_BUFFER_GROUP    0
+#define URING_RECEIVE_PACKET  (1ull << 32)  // Kinds of the user data
+#define URING_RECEIVE_SCHC    (2ull << 32)
+#define URING_SEND            (3ull << 32)
+
+/**
+ * @brief Struct that defines the configuration of the gateway.
+ */
+typedef struct {
+  const compiled_context_t *compiled_context;
+  direction_indicator_t     compression_direction;
+  direction_indicator_t     decompression_direction;
+  uint16_t                  packet_port;       // Receives the packets
+  uint16_t                  packet_peer_port;  // Gets the packets
+  uint16_t                  schc_port;         // Receives the SCHC frames
+  uint16_t                  schc_peer_port;    // Gets the SCHC frames
+  size_t                    batch_len;         // Datagrams per syscall
+  int                       reuse_port;        // 1 for SO_REUSEPORT
+  int                       io_uring;          // 1 for the io_uring backend
+} gateway_config_t;
+
+/**
+ * @brief Struct that defines a batch of datagrams of a recvmmsg or sendmmsg.
+ */
+typedef struct {
+  uint8_t        *buffers;   // MAX_DATAGRAM_BYTE_LEN bytes per datagram
+  struct iovec   *iovecs;    // One per datagram
+  struct mmsghdr *messages;  // One per datagram
+} datagram_batch_t;
+
+/**
+ * @brief Struct that defines a datagram received by an io_uring, waiting for a
+ * free send buffer.
+ */
+typedef struct {
+  uint16_t buffer_id;      // Receive buffer
+  uint16_t decompression;  // 1 for a SCHC frame
+  uint32_t byte_len;       // Byte length of the datagram
+} uring_datagram_t;
+
+/**
+ * @brief Struct that defines the io_uring of a worker, with its provided
+ * receive buffers and registered send buffers.
+ */
+typedef struct {
+  int                       ring_fd;
+  uint8_t                  *rings;          // Submission and completion rings
+  size_t                    rings_byte_len;
+  struct io_uring_sqe      *sqes;
+  size_t                    sqes_byte_len;
+  _Atomic uint32_t         *sq_head;
+  _Atomic uint32_t         *sq_tail;
+  uint32_t                  sq_mask;
+  uint32_t                  sq_local_tail;  // Next entry to fill
+  _Atomic uint32_t         *cq_head;
+  _Atomic uint32_t         *cq_tail;
+  uint32_t                  cq_mask;
+  struct io_uring_cqe      *cqes;
+  struct io_uring_buf_ring *buffer_ring;       // Provided receive buffers
+  uint16_t                  buffer_ring_tail;  // Next buffer to provide
+  uint8_t                  *receive_buffers;
+  uint8_t                  *send_buffers;  // Registered, buffer index 0
+  int                       fixed_sends;   // 1 for zero-copy sends
+  int                       is_armed[2];   // Multishot receives, per socket
+  uint16_t                  free_sends[URING_BUFFERS];
+  size_t                    card_free_sends;
+  uring_datagram_t          sends[URING_BUFFERS];    // In flight, per buffer
+  uring_datagram_t          pending[URING_BUFFERS];  // Received, FIFO
+  size_t                    pending_first;
+  size_t                    card_pending;
+} uring_t;
+
+/**
+ * @brief Struct that defines a worker of the gateway.
+ */
+typedef struct {
+  pthread_t               thread;
+  const gateway_config_t *config;
+  int                     packet_socket;  // Bound to packet_port
+  int                     schc_socket;    // Bound to schc_port
+  flow_cache_t            flow_cache;
+  datagram_batch_t        received;
+  datagram_batch_t        sent;
+  uring_t                 uring;
+  struct sockaddr_in6     packet_peer;
+  struct sockaddr_in6     schc_peer;
+  _Atomic uint64_t        card_compressed;
+  _Atomic uint64_t        card_decompressed;
+  _Atomic uint64_t        card_dropped;
+  _Atomic uint64_t        card_syscalls;
+  size_t                  pool_leak_byte_len;  // Left in the pool, stopped
+} gateway_worker_t;
+
+/**
+ * @brief Struct that defines the mirror of the load mode, which plays the
+ * devices.
+ */
+typedef struct {
+  const gateway_config_t *config;
+  int                     socket_fd;     // Bound to schc_peer_port
+  const int              *senders;       // Source sockets of the frames
+  size_t                  card_senders;  // Number of source sockets
+} mirror_t;
+
+/* ********************************************************************** */
+
+static volatile sig_atomic_t stop        = 0;  // Stops the workers
+static volatile sig_atomic_t mirror_stop = 0;  // Stops the mirror
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Sets the stop flag on SIGINT and SIGTERM.
+ */
+static void __handle_signal(int signal_number);
+
+/**
+ * @brief Returns the time of a monotonic clock in nanoseconds.
+ */
+static uint64_t __now(void);
+
+/**
+ * @brief Fills the address of a port of the loopback interface.
+ *
+ * @param address Pointer to the address to fill.
+ * @param port The port.
+ */
+static void __set_loopback_address(struct sockaddr_in6 *address,
+                                   const uint16_t       port);
+
+/**
+ * @brief Opens a UDP socket on the loopback interface.
+ *
+ * @param port Port to bind to, 0 for an ephemeral one.
+ * @param reuse_port 1 to set SO_REUSEPORT.
+ * @return The socket, -1 on failure.
+ */
+static int __open_socket(const uint16_t port, const int reuse_port);
+
+/**
+ * @brief Allocates a batch of datagrams sent to, or received from, an
+ * address.
+ *
+ * @param batch Pointer to the batch to initialize.
+ * @param batch_len Number of datagrams.
+ * @param address Pointer to the destination of the datagrams, or NULL.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __init_datagram_batch(datagram_batch_t *batch,
+                                 const size_t      batch_len,
+                                 struct sockaddr_in6 *address);
+
+/**
+ * @brief Frees a batch of datagrams.
+ *
+ * @param batch Pointer to the batch to destroy.
+ */
+static void __destroy_datagram_batch(datagram_batch_t *batch);
+
+/**
+ * @brief Sends the first card_datagrams datagrams of a batch, retrying on
+ * partial sends.
+ *
+ * @param socket_fd The socket.
+ * @param batch Pointer to the batch, whose iovec lengths are set.
+ * @param card_datagrams Number of datagrams.
+ * @param card_syscalls Pointer to the syscall counter to increment.
+ * @return The number of datagrams sent.
+ */
+static size_t __send_batch(const int socket_fd, datagram_batch_t *batch,
+                           const size_t      card_datagrams,
+                           _Atomic uint64_t *card_syscalls);
+
+/**
+ * @brief Receives a batch of datagrams, compresses or decompresses them and
+ * sends the results.
+ *
+ * @param worker Pointer to the worker.
+ * @param decompression 1 to decompress SCHC frames, 0 to compress packets.
+ * @return The number of datagrams received.
+ */
+static size_t __forward_batch(gateway_worker_t *worker,
+                              const int         decompression);
+
+/**
+ * @brief Forwards datagrams with recvmmsg and sendmmsg until the stop flag is
+ * set.
+ *
+ * @param worker Pointer to the worker.
+ */
+static void __run_mmsg(gateway_worker_t *worker);
+
+/**
+ * @brief Sets up the io_uring of a worker, registers its send buffers and
+ * provides its receive buffers.
+ *
+ * @param uring Pointer to the io_uring to initialize.
+ * @return The status code, 1 for success, otherwise 0 with errno set.
+ */
+static int __init_uring(uring_t *uring);
+
+/**
+ * @brief Closes the io_uring of a worker and frees its buffers.
+ *
+ * @param uring Pointer to the io_uring to destroy.
+ */
+static void __destroy_uring(uring_t *uring);
+
+/**
+ * @brief Returns the next free submission queue entry of an io_uring, zeroed.
+ *
+ * @param uring Pointer to the io_uring.
+ * @return Pointer to the entry.
+ */
+static struct io_uring_sqe *__get_uring_sqe(uring_t *uring);
+
+/**
+ * @brief Queues the send of a send buffer, a zero-copy send from the
+ * registered buffers when the kernel supports it.
+ *
+ * @param worker Pointer to the worker.
+ * @param send_id The send buffer, whose datagram is set.
+ */
+static void __send_uring_buffer(gateway_worker_t *worker,
+                                const uint16_t    send_id);
+
+/**
+ * @brief Gives a receive buffer back to the kernel, once the tail of the
+ * buffer ring is published.
+ *
+ * @param uring Pointer to the io_uring.
+ * @param buffer_id The receive buffer.
+ */
+static void __provide_uring_buffer(uring_t *uring, const uint16_t buffer_id);
+
+/**
+ * @brief Forwards datagrams with an io_uring until the stop flag is set.
+ *
+ * @param worker Pointer to the worker, whose io_uring is initialized.
+ */
+static void __run_uring(gateway_worker_t *worker);
+
+/**
+ * @brief Worker thread, forwards datagrams until the stop flag is set.
+ *
+ * @param arg Pointer to the worker.
+ * @return NULL.
+ */
+static void *__gateway_worker(void *arg);
+
+/**
+ * @brief Load mode: sends tagged packets to the gateway, mirrors the SCHC
+ * frames and receives the packets.
+ *
+ * @param config Pointer to the configuration of the gateway.
+ * @param card_packets Number of packets to send.
+ * @param window Maximum number of packets in flight.
+ * @param card_senders Number of source sockets, so that flows are sharded.
+ * @param card_malformed Number of malformed datagrams sent before the load.
+ * @return The status code, 1 if every packet came back, otherwise 0.
+ */
+static int __run_load(const gateway_config_t *config,
+                      const size_t card_packets, const size_t window,
+                      const size_t card_senders, const size_t card_malformed);
+
+/**
+ * @brief Checks that the last 4 bytes of a packet, its tag, come back from
+ * its compression and decompression, whatever their value.
+ *
+ * @param packet Pointer to the packet, MAX_DATAGRAM_BYTE_LEN bytes long.
+ * @param packet_byte_len Byte length of the packet.
+ * @param config Pointer to the configuration of the gateway.
+ * @return 1 if the tag comes back, otherwise 0.
+ */
+static int __keeps_tag(uint8_t *packet, const size_t packet_byte_len,
+                       const gateway_config_t *config);
+
+/**
+ * @brief Writes a packet of the load traffic tagged with its sequence number.
+ *
+ * @param datagram Pointer to the datagram, MAX_DATAGRAM_BYTE_LEN bytes long.
+ * @param traffic Pointer to the packets of the traffic.
+ * @param traffic_byte_lens Pointer to the byte lengths of the packets.
+ * @param card_traffic Number of packets of the traffic.
+ * @param sequence Sequence number of the packet.
+ * @return The byte length of the datagram.
+ */
+static size_t __write_load_packet(uint8_t *datagram, const uint8_t *traffic,
+                                  const size_t *traffic_byte_lens,
+                                  const size_t  card_traffic,
+                                  const size_t  sequence);
+
+/**
+ * @brief Sends the first card_datagrams datagrams of a batch with one
+ * sendmmsg.
+ *
+ * @param socket_fd The socket.
+ * @param batch Pointer to the batch, whose iovec lengths are set.
+ * @param card_datagrams Number of datagrams.
+ * @return The number of datagrams accepted by the kernel, the first ones of
+ * the batch.
+ */
+static size_t __send_load_batch(const int socket_fd, datagram_batch_t *batch,
+                                const size_t card_datagrams);
+
+/**
+ * @brief Sends malformed datagrams to the gateway, truncations of the load
+ * packets and random SCHC frames, then receives what comes out of them until
+ * the application socket is quiet.
+ *
+ * @param config Pointer to the configuration of the gateway.
+ * @param senders Pointer to the source sockets.
+ * @param card_senders Number of source sockets.
+ * @param packet_socket Socket of the application.
+ * @param sent Pointer to a batch, whose destinations are overwritten.
+ * @param received Pointer to a batch to receive into.
+ * @param traffic Pointer to the packets of the traffic.
+ * @param traffic_byte_lens Pointer to the byte lengths of the packets.
+ * @param card_traffic Number of packets of the traffic.
+ * @param card_malformed Number of malformed datagrams to send.
+ */
+static void __send_malformed(const gateway_config_t *config,
+                             const int *senders, const size_t card_senders,
+                             const int packet_socket, datagram_batch_t *sent,
+                             datagram_batch_t *received,
+                             const uint8_t    *traffic,
+                             const size_t     *traffic_byte_lens,
+                             const size_t      card_traffic,
+                             const size_t      card_malformed);
+
+/**
+ * @brief Mirror thread of the load mode, sends the SCHC frames back to the
+ * gateway.
+ *
+ * @param arg Pointer to the mirror.
+ * @return NULL.
+ */
+static void *__mirror(void *arg);
+
+/**
+ * @brief Compares two latencies, for qsort.
+ */
+static int __compare_latencies(const void *first, const void *second);
+
+/* ********************************************************************** */
+
+int main(int argc, char *argv[]) {
+  compiled_context_t *compiled_context;
+  gateway_config_t    config;
+  gateway_worker_t    workers[MAX_WORKERS];
+  struct sigaction    action;
+  size_t              card_workers;
+  size_t              card_load_packets;
+  size_t              card_malformed;
+  size_t              window;
+  uint64_t            start;
+  uint64_t            card_compressed;
+  uint64_t            card_decompressed;
+  uint64_t            card_dropped;
+  uint64_t            card_syscalls;
+  double              elapsed;
+  int                 status;
+  int                 option;
+
+  memset(&config, 0x00, sizeof(config));
+  config.compression_direction   = DI_DW;
+  config.decompression_direction = DI_UP;
+  config.packet_port             = 47000;
+  config.packet_peer_port        = 47001;
+  config.schc_port               = 47002;
+  config.schc_peer_port          = 47003;
+  config.batch_len               = 64;
+  card_workers                   = 1;
+  card_load_packets              = 0;
+  card_malformed                 = 0;
+  window                         = 256;
+  while ((option = getopt(argc, argv, "p:P:s:S:t:rb:ul:w:g:i")) != -1) {
+    switch (option) {
+      case 'p':
+        config.packet_port = (uint16_t) strtoul(optarg, NULL, 10);
+        break;
+      case 'P':
+        config.packet_peer_port = (uint16_t) strtoul(optarg, NULL, 10);
+        break;
+      case 's':
+        config.schc_port = (uint16_t) strtoul(optarg, NULL, 10);
+        break;
+      case 'S':
+        config.schc_peer_port = (uint16_t) strtoul(optarg, NULL, 10);
+        break;
+      case 't':
+        card_workers = strtoul(optarg, NULL, 10);
+        break;
+      case 'r':
+        config.reuse_port = 1;
+        break;
+      case 'b':
+        config.batch_len = strtoul(optarg, NULL, 10);
+        break;
+      case 'u':
+        config.compression_direction   = DI_UP;
+        config.decompression_direction = DI_DW;
+        break;
+      case 'l':
+        card_load_packets = strtoul(optarg, NULL, 10);
+        break;
+      case 'w':
+        window = strtoul(optarg, NULL, 10);
+        break;
+      case 'g':
+        card_malformed = strtoul(optarg, NULL, 10);
+        break;
+      case 'i':
+        config.io_uring = 1;
+        break;
+      default:
+        optind = argc;
+        break;
+    }
+  }
+  if (optind != argc - 1 || card_workers == 0 || card_workers > MAX_WORKERS ||
+      (card_workers > 1 && !config.reuse_port) || config.batch_len == 0 ||
+      window == 0) {
+    fprintf(stderr,
+            "Usage: %s <context file> [-p port] [-P port] [-s port] "
+            "[-S port] [-t threads] [-r] [-b batch] [-u] [-l packets] "
+            "[-w window] [-g packets] [-i]\n",
+            argv[0]);
+    return 1;
+  }
+
+  // In load mode, the SCHC frames come back to the gateway
+  if (card_load_packets > 0) {
+    config.decompression_direction = config.compression_direction;
+  }
+
+  init_memory_pool();
+
+  compiled_context = compile_context_file(argv[optind]);
+  if (compiled_context == NULL) {
+    fprintf(stderr, "Cannot load the Context %s\n", argv[optind]);
+    return 1;
+  }
+  config.compiled_context = compiled_context;
+
+  memset(&action, 0x00, sizeof(action));
+  action.sa_handler = __handle_signal;
+  sigaction(SIGINT, &action, NULL);
+  sigaction(SIGTERM, &action, NULL);
+
+  // The sockets are bound before the first datagram is sent
+  memset(workers, 0x00, sizeof(workers));
+  for (size_t index = 0; index < card_workers; index++) {
+    workers[index].config        = &config;
+    workers[index].packet_socket = __open_socket(config.packet_port,
+                                                 config.reuse_port);
+    workers[index].schc_socket   = __open_socket(config.schc_port,
+                                                 config.reuse_port);
+    if (workers[index].packet_socket < 0 || workers[index].schc_socket < 0) {
+      fprintf(stderr, "Cannot bind the ports %u and %u: %s\n",
+              config.packet_port, config.schc_port, strerror(errno));
+      return 1;
+    }
+  }
+
+  start = __now();
+  for (size_t index = 0; index < card_workers; index++) {
+    if (pthread_create(&workers[index].thread, NULL, __gateway_worker,
+                       &workers[index]) != 0) {
+      fprintf(stderr, "Cannot start the worker %zu\n", index);
+      return 1;
+    }
+  }
+
+  status = 1;
+  if (card_load_packets > 0) {
+    status = __run_load(&config, card_load_packets, window, card_workers,
+                        card_malformed);
+    stop   = 1;
+  } else {
+    while (!stop) {
+      pause();
+    }
+  }
+
+  card_compressed   = 0;
+  card_decompressed = 0;
+  card_dropped      = 0;
+  card_syscalls     = 0;
+  for (size_t index = 0; index < card_workers; index++) {
+    pthread_join(workers[index].thread, NULL);
+    card_compressed += atomic_load(&workers[index].card_compressed);
+    card_decompressed += atomic_load(&workers[index].card_decompressed);
+    card_dropped += atomic_load(&workers[index].card_dropped);
+    card_syscalls += atomic_load(&workers[index].card_syscalls);
+    if (workers[index].pool_leak_byte_len > 0) {
+      fprintf(stderr, "Worker %zu left %zu bytes allocated in its pool\n",
+              index, workers[index].pool_leak_byte_len);
+      status = 0;
+    }
+    close(workers[index].packet_socket);
+    close(workers[index].schc_socket);
+  }
+  elapsed = (double) (__now() - start) / 1e9;
+
+  printf("gateway: %" PRIu64 " compressed, %" PRIu64 " decompressed, %" PRIu64
+         " dropped in %.3f s, %.2f syscalls per datagram\n",
+         card_compressed, card_decompressed, card_dropped, elapsed,
+         (card_compressed + card_decompressed + card_dropped) > 0
+             ? (double) card_syscalls /
+                   (double) (card_compressed + card_decompressed +
+                             card_dropped)
+             : 0.0);
+
+  free_compiled_context(compiled_context);
+  destroy_memory_pool();
+
+  return status ? 0 : 1;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static void __handle_signal(int signal_number) {
+  (void) signal_number;
+  stop = 1;
+}
+
+/* ********************************************************************** */
+
+static uint64_t __now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (uint64_t) now.tv_sec * 1000000000ull + (uint64_t) now.tv_nsec;
+}
+
+/* ********************************************************************** */
+
+static void __set_loopback_address(struct sockaddr_in6 *address,
+                                   const uint16_t       port) {
+  memset(address, 0x00, sizeof(struct sockaddr_in6));
+  address->sin6_family = AF_INET6;
+  address->sin6_addr   = in6addr_loopback;
+  address->sin6_port   = htons(port);
+}
+
+/* ********************************************************************** */
+
+static int __open_socket(const uint16_t port, const int reuse_port) {
+  struct sockaddr_in6 address;
+  int                 socket_fd;
+  int                 value;
+
+  socket_fd = socket(AF_INET6, SOCK_DGRAM, 0);
+  if (socket_fd < 0) {
+    return -1;
+  }
+
+  value = 1;
+  if (reuse_port && setsockopt(socket_fd, SOL_SOCKET, SO_REUSEPORT, &value,
+                               sizeof(value)) != 0) {
+    close(socket_fd);
+    return -1;
+  }
+
+  // Best effort, the kernel caps them
+  value = SOCKET_BUFFER_LEN;
+  setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUF, &value, sizeof(value));
+  setsockopt(socket_fd, SOL_SOCKET, SO_SNDBUF, &value, sizeof(value));
+
+  __set_loopback_address(&address, port);
+  if (bind(socket_fd, (struct sockaddr *) &address, sizeof(address)) != 0) {
+    close(socket_fd);
+    return -1;
+  }
+
+  return socket_fd;
+}
+
+/* ********************************************************************** */
+
+static int __init_datagram_batch(datagram_batch_t *batch,
+                                 const size_t      batch_len,
+                                 struct sockaddr_in6 *address) {
+  batch->buffers  = (uint8_t *) malloc(batch_len * MAX_DATAGRAM_BYTE_LEN);
+  batch->iovecs   = (struct iovec *) calloc(batch_len, sizeof(struct iovec));
+  batch->messages = (struct mmsghdr *) calloc(batch_len,
+                                              sizeof(struct mmsghdr));
+  if (batch->buffers == NULL || batch->iovecs == NULL ||
+      batch->messages == NULL) {
+    __destroy_datagram_batch(batch);
+    return 0;
+  }
+
+  for (size_t index = 0; index < batch_len; index++) {
+    batch->iovecs[index].iov_base = &batch->buffers[index *
+                                                    MAX_DATAGRAM_BYTE_LEN];
+    batch->iovecs[index].iov_len  = MAX_DATAGRAM_BYTE_LEN;
+    batch->messages[index].msg_hdr.msg_iov    = &batch->iovecs[index];
+    batch->messages[index].msg_hdr.msg_iovlen = 1;
+    if (address != NULL) {
+      batch->messages[index].msg_hdr.msg_name    = address;
+      batch->messages[index].msg_hdr.msg_namelen = sizeof(*address);
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __destroy_datagram_batch(datagram_batch_t *batch) {
+  free(batch->buffers);
+  free(batch->iovecs);
+  free(batch->messages);
+  memset(batch, 0x00, sizeof(datagram_batch_t));
+}
+
+/* ********************************************************************** */
+
+static size_t __send_batch(const int socket_fd, datagram_batch_t *batch,
+                           const size_t      card_datagrams,
+                           _Atomic uint64_t *card_syscalls) {
+  size_t card_sent;
+  int    result;
+
+  card_sent = 0;
+  while (card_sent < card_datagrams) {
+    result = sendmmsg(socket_fd, &batch->messages[card_sent],
+                      (unsigned int) (card_datagrams - card_sent), 0);
+    atomic_fetch_add_explicit(card_syscalls, 1, memory_order_relaxed);
+    if (result < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The first datagram failed, e.g. no socket on the destination port
+      card_sent++;
+      continue;
+    }
+    card_sent += (size_t) result;
+  }
+
+  return card_sent;
+}
+
+/* ********************************************************************** */
+
+static size_t __forward_batch(gateway_worker_t *worker,
+                              const int         decompression) {
+  const gateway_config_t *config;
+  uint8_t                *input;
+  uint8_t                *output;
+  size_t                  output_byte_len;
+  size_t                  card_outputs;
+  int                     card_received;
+
+  config        = worker->config;
+  card_received = recvmmsg(
+      decompression ? worker->schc_socket : worker->packet_socket,
+      worker->received.messages, (unsigned int) config->batch_len,
+      MSG_DONTWAIT, NULL);
+  atomic_fetch_add_explicit(&worker->card_syscalls, 1, memory_order_relaxed);
+  if (card_received <= 0) {
+    return 0;
+  }
+
+  // The results are written straight into the buffers of the sendmmsg
+  card_outputs = 0;
+  for (int index = 0; index < card_received; index++) {
+    input  = worker->received.iovecs[index].iov_base;
+    output = worker->sent.iovecs[card_outputs].iov_base;
+    if (decompression) {
+      output_byte_len = decompress_compiled(
+          output, MAX_DATAGRAM_BYTE_LEN, config->decompression_direction,
+          input, worker->received.messages[index].msg_len,
+          config->compiled_context);
+    } else {
+      output_byte_len = compress_compiled_cached(
+          output, MAX_DATAGRAM_BYTE_LEN, config->compression_direction, input,
+          worker->received.messages[index].msg_len, config->compiled_context,
+          &worker->flow_cache);
+    }
+    if (output_byte_len == 0) {
+      atomic_fetch_add_explicit(&worker->card_dropped, 1,
+                                memory_order_relaxed);
+      continue;
+    }
+
+    worker->sent.iovecs[card_outputs].iov_len = output_byte_len;
+    worker->sent.messages[card_outputs].msg_hdr.msg_name =
+        decompression ? &worker->packet_peer : &worker->schc_peer;
+    card_outputs++;
+  }
+
+  __send_batch(decompression ? worker->packet_socket : worker->schc_socket,
+               &worker->sent, card_outputs, &worker->card_syscalls);
+  atomic_fetch_add_explicit(decompression ? &worker->card_decompressed
+                                          : &worker->card_compressed,
+                            card_outputs, memory_order_relaxed);
+
+  return (size_t) card_received;
+}
+
+/* ********************************************************************** */
+
+static void __run_mmsg(gateway_worker_t *worker) {
+  struct pollfd poll_fds[2];
+
+  if (!__init_datagram_batch(&worker->received, worker->config->batch_len,
+                             NULL) ||
+      !__init_datagram_batch(&worker->sent, worker->config->batch_len,
+                             &worker->schc_peer)) {
+    fprintf(stderr, "Memory exhausted\n");
+    stop = 1;
+  }
+
+  poll_fds[0].fd     = worker->packet_socket;
+  poll_fds[0].events = POLLIN;
+  poll_fds[1].fd     = worker->schc_socket;
+  poll_fds[1].events = POLLIN;
+  while (!stop) {
+    atomic_fetch_add_explicit(&worker->card_syscalls, 1, memory_order_relaxed);
+    if (poll(poll_fds, 2, POLL_TIMEOUT_MS) <= 0) {
+      continue;
+    }
+
+    // Full batches mean that more datagrams are waiting
+    if (poll_fds[0].revents & POLLIN) {
+      while (!stop && __forward_batch(worker, 0) == worker->config->batch_len) {
+      }
+    }
+    if (poll_fds[1].revents & POLLIN) {
+      while (!stop && __forward_batch(worker, 1) == worker->config->batch_len) {
+      }
+    }
+  }
+
+  __destroy_datagram_batch(&worker->sent);
+  __destroy_datagram_batch(&worker->received);
+}
+
+/* ********************************************************************** */
+
+static int __init_uring(uring_t *uring) {
+  struct io_uring_params  params;
+  struct io_uring_buf_reg buffer_reg;
+  struct iovec            send_region;
+
+  memset(uring, 0x00, sizeof(uring_t));
+  uring->ring_fd = -1;
+
+  // Completions are only posted when the worker waits for them, by batches
+  memset(&params, 0x00, sizeof(params));
+  params.flags      = IORING_SETUP_CQSIZE | IORING_SETUP_SINGLE_ISSUER |
+                      IORING_SETUP_DEFER_TASKRUN;
+  params.cq_entries = 4 * URING_BUFFERS;
+  uring->ring_fd    = (int) syscall(__NR_io_uring_setup, 2 * URING_BUFFERS,
+                                    &params);
+  if (uring->ring_fd < 0 && errno == EINVAL) {
+    // Before Linux 6.1
+    memset(&params, 0x00, sizeof(params));
+    params.flags      = IORING_SETUP_CQSIZE;
+    params.cq_entries = 4 * URING_BUFFERS;
+    uring->ring_fd    = (int) syscall(__NR_io_uring_setup, 2 * URING_BUFFERS,
+                                      &params);
+  }
+  if (uring->ring_fd < 0) {
+    return 0;
+  }
+  if (!(params.features & IORING_FEAT_SINGLE_MMAP) ||
+      !(params.features & IORING_FEAT_EXT_ARG)) {
+    __destroy_uring(uring);
+    errno = ENOSYS;
+    return 0;
+  }
+
+  // Both rings share one mapping
+  uring->rings_byte_len = params.sq_off.array +
+                          params.sq_entries * sizeof(uint32_t);
+  if (uring->rings_byte_len <
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe)) {
+    uring->rings_byte_len = params.cq_off.cqes +
+                            params.cq_entries * sizeof(struct io_uring_cqe);
+  }
+  uring->sqes_byte_len = params.sq_entries * sizeof(struct io_uring_sqe);
+  uring->rings = (uint8_t *) mmap(NULL, uring->rings_byte_len,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_SHARED | MAP_POPULATE, uring->ring_fd,
+                                  IORING_OFF_SQ_RING);
+  uring->sqes  = (struct io_uring_sqe *) mmap(
+      NULL, uring->sqes_byte_len, PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE, uring->ring_fd, IORING_OFF_SQES);
+  if (uring->rings == MAP_FAILED || uring->sqes == MAP_FAILED) {
+    __destroy_uring(uring);
+    return 0;
+  }
+  uring->sq_head = (_Atomic uint32_t *) (uring->rings + params.sq_off.head);
+  uring->sq_tail = (_Atomic uint32_t *) (uring->rings + params.sq_off.tail);
+  uring->sq_mask = *(uint32_t *) (uring->rings + params.sq_off.ring_mask);
+  uring->cq_head = (_Atomic uint32_t *) (uring->rings + params.cq_off.head);
+  uring->cq_tail = (_Atomic uint32_t *) (uring->rings + params.cq_off.tail);
+  uring->cq_mask = *(uint32_t *) (uring->rings + params.cq_off.ring_mask);
+  uring->cqes    = (struct io_uring_cqe *) (uring->rings +
+                                         params.cq_off.cqes);
+  uring->sq_local_tail = atomic_load_explicit(uring->sq_tail,
+                                              memory_order_relaxed);
+  for (uint32_t index = 0; index < params.sq_entries; index++) {
+    ((uint32_t *) (uring->rings + params.sq_off.array))[index] = index;
+  }
+
+  uring->receive_buffers = (uint8_t *) malloc(URING_BUFFERS *
+                                              MAX_DATAGRAM_BYTE_LEN);
+  uring->send_buffers    = (uint8_t *) malloc(URING_BUFFERS *
+                                              MAX_DATAGRAM_BYTE_LEN);
+  uring->buffer_ring     = (struct io_uring_buf_ring *) aligned_alloc(
+      4096, URING_BUFFERS * sizeof(struct io_uring_buf));
+  if (uring->receive_buffers == NULL || uring->send_buffers == NULL ||
+      uring->buffer_ring == NULL) {
+    __destroy_uring(uring);
+    errno = ENOMEM;
+    return 0;
+  }
+  memset(uring->buffer_ring, 0x00, URING_BUFFERS * sizeof(struct io_uring_buf));
+
+  send_region.iov_base = uring->send_buffers;
+  send_region.iov_len  = URING_BUFFERS * MAX_DATAGRAM_BYTE_LEN;
+  memset(&buffer_reg, 0x00, sizeof(buffer_reg));
+  buffer_reg.ring_addr    = (uint64_t) (uintptr_t) uring->buffer_ring;
+  buffer_reg.ring_entries = URING_BUFFERS;
+  buffer_reg.bgid         = URING_BUFFER_GROUP;
+  if (syscall(__NR_io_uring_register, uring->ring_fd, IORING_REGISTER_BUFFERS,
+              &send_region, 1) != 0 ||
+      syscall(__NR_io_uring_register, uring->ring_fd,
+              IORING_REGISTER_PBUF_RING, &buffer_reg, 1) != 0) {
+    __destroy_uring(uring);
+    return 0;
+  }
+  uring->fixed_sends = 1;
+
+  for (uint16_t index = 0; index < URING_BUFFERS; index++) {
+    __provide_uring_buffer(uring, index);
+    uring->free_sends[index] = index;
+  }
+  uring->card_free_sends = URING_BUFFERS;
+  atomic_store_explicit((_Atomic uint16_t *) &uring->buffer_ring->tail,
+                        uring->buffer_ring_tail, memory_order_release);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __destroy_uring(uring_t *uring) {
+  // Closing the ring cancels its requests and unregisters its buffers
+  if (uring->sqes != NULL && uring->sqes != MAP_FAILED) {
+    munmap(uring->sqes, uring->sqes_byte_len);
+  }
+  if (uring->rings != NULL && uring->rings != MAP_FAILED) {
+    munmap(uring->rings, uring->rings_byte_len);
+  }
+  if (uring->ring_fd >= 0) {
+    close(uring->ring_fd);
+  }
+  free(uring->buffer_ring);
+  free(uring->send_buffers);
+  free(uring->receive_buffers);
+  memset(uring, 0x00, sizeof(uring_t));
+  uring->ring_fd = -1;
+}
+
+/* ********************************************************************** */
+
+static struct io_uring_sqe *__get_uring_sqe(uring_t *uring) {
+  struct io_uring_sqe *sqe;
+
+  // The submission queue holds twice the buffers, one pass never fills it
+  sqe = &uring->sqes[uring->sq_local_tail & uring->sq_mask];
+  uring->sq_local_tail++;
+  memset(sqe, 0x00, sizeof(struct io_uring_sqe));
+
+  return sqe;
+}
+
+/* ********************************************************************** */
+
+static void __send_uring_buffer(gateway_worker_t *worker,
+                                const uint16_t    send_id) {
+  uring_t             *uring;
+  struct io_uring_sqe *sqe;
+
+  uring         = &worker->uring;
+  sqe           = __get_uring_sqe(uring);
+  sqe->opcode   = uring->fixed_sends ? IORING_OP_SEND_ZC : IORING_OP_SEND;
+  sqe->fd       = uring->sends[send_id].decompression ? worker->packet_socket
+                                                      : worker->schc_socket;
+  sqe->addr     = (uint64_t) (uintptr_t) &uring->send_buffers
+                      [(size_t) send_id * MAX_DATAGRAM_BYTE_LEN];
+  sqe->len      = uring->sends[send_id].byte_len;
+  sqe->addr2    = (uint64_t) (uintptr_t) (uring->sends[send_id].decompression
+                                              ? &worker->packet_peer
+                                              : &worker->schc_peer);
+  sqe->addr_len = sizeof(struct sockaddr_in6);
+  if (uring->fixed_sends) {
+    sqe->ioprio    = IORING_RECVSEND_FIXED_BUF;
+    sqe->buf_index = 0;
+  }
+  sqe->user_data = URING_SEND | send_id;
+}
+
+/* ********************************************************************** */
+
+static void __provide_uring_buffer(uring_t *uring, const uint16_t buffer_id) {
+  struct io_uring_buf *buffer;
+
+  // Leaves resv alone, the first one overlays the tail
+  buffer = &uring->buffer_ring
+                ->bufs[uring->buffer_ring_tail & (URING_BUFFERS - 1)];
+  buffer->addr = (uint64_t) (uintptr_t) &uring->receive_buffers
+                     [(size_t) buffer_id * MAX_DATAGRAM_BYTE_LEN];
+  buffer->len  = MAX_DATAGRAM_BYTE_LEN;
+  buffer->bid  = buffer_id;
+  uring->buffer_ring_tail++;
+}
+
+/* ********************************************************************** */
+
+static void __run_uring(gateway_worker_t *worker) {
+  const gateway_config_t       *config;
+  uring_t                      *uring;
+  struct io_uring_sqe          *sqe;
+  struct io_uring_cqe          *cqe;
+  struct io_uring_getevents_arg wait_arg;
+  struct __kernel_timespec      wait_timeout;
+  uring_datagram_t             *datagram;
+  uint8_t                      *input;
+  uint8_t                      *output;
+  size_t                        output_byte_len;
+  uint32_t                      cq_head;
+  uint32_t                      cq_tail;
+  uint32_t                      to_submit;
+  uint64_t                      kind;
+  uint16_t                      send_id;
+  int                           decompression;
+
+  config = worker->config;
+  uring  = &worker->uring;
+
+  memset(&wait_timeout, 0x00, sizeof(wait_timeout));
+  wait_timeout.tv_nsec = POLL_TIMEOUT_MS * 1000000ll;
+  memset(&wait_arg, 0x00, sizeof(wait_arg));
+  wait_arg.ts = (uint64_t) (uintptr_t) &wait_timeout;
+
+  while (!stop) {
+    // Completions: sends free their buffer, receives wait for one
+    cq_head = atomic_load_explicit(uring->cq_head, memory_order_relaxed);
+    cq_tail = atomic_load_explicit(uring->cq_tail, memory_order_acquire);
+    for (; cq_head != cq_tail; cq_head++) {
+      cqe  = &uring->cqes[cq_head & uring->cq_mask];
+      kind = cqe->user_data & ~0xffffffffull;
+      if (kind == URING_SEND) {
+        send_id = (uint16_t) cqe->user_data;
+        if (cqe->res == -EINVAL && uring->fixed_sends) {
+          // No zero-copy sends before Linux 6.0, the same buffer is sent
+          // again by address
+          uring->fixed_sends = 0;
+          __send_uring_buffer(worker, send_id);
+          continue;
+        }
+        if (cqe->flags & IORING_CQE_F_MORE) {
+          // The buffer is in use until the notification of a zero-copy send
+          continue;
+        }
+        uring->free_sends[uring->card_free_sends++] = send_id;
+        continue;
+      }
+
+      decompression = kind == URING_RECEIVE_SCHC;
+      if (!(cqe->flags & IORING_CQE_F_MORE)) {
+        // e.g. out of receive buffers, it is armed again below
+        uring->is_armed[decompression] = 0;
+      }
+      if (!(cqe->flags & IORING_CQE_F_BUFFER)) {
+        continue;
+      }
+      datagram = &uring->pending[(uring->pending_first + uring->card_pending) &
+                                 (URING_BUFFERS - 1)];
+      datagram->buffer_id     = (uint16_t) (cqe->flags >>
+                                            IORING_CQE_BUFFER_SHIFT);
+      datagram->decompression = (uint16_t) decompression;
+      datagram->byte_len      = cqe->res > 0 ? (uint32_t) cqe->res : 0;
+      uring->card_pending++;
+    }
+    atomic_store_explicit(uring->cq_head, cq_head, memory_order_release);
+
+    // The results are written straight into the registered send buffers
+    while (uring->card_pending > 0 && uring->card_free_sends > 0) {
+      datagram = &uring->pending[uring->pending_first];
+      send_id  = uring->free_sends[uring->card_free_sends - 1];
+      input    = &uring->receive_buffers[(size_t) datagram->buffer_id *
+                                         MAX_DATAGRAM_BYTE_LEN];
+      output   = &uring->send_buffers[(size_t) send_id *
+                                      MAX_DATAGRAM_BYTE_LEN];
+      if (datagram->byte_len == 0) {
+        output_byte_len = 0;
+      } else if (datagram->decompression) {
+        output_byte_len = decompress_compiled(
+            output, MAX_DATAGRAM_BYTE_LEN, config->decompression_direction,
+            input, datagram->byte_len, config->compiled_context);
+      } else {
+        output_byte_len = compress_compiled_cached(
+            output, MAX_DATAGRAM_BYTE_LEN, config->compression_direction,
+            input, datagram->byte_len, config->compiled_context,
+            &worker->flow_cache);
+      }
+      __provide_uring_buffer(uring, datagram->buffer_id);
+      uring->pending_first = (uring->pending_first + 1) & (URING_BUFFERS - 1);
+      uring->card_pending--;
+
+      if (output_byte_len == 0) {
+        atomic_fetch_add_explicit(&worker->card_dropped, 1,
+                                  memory_order_relaxed);
+        continue;
+      }
+      uring->card_free_sends--;
+      uring->sends[send_id].buffer_id     = send_id;
+      uring->sends[send_id].decompression = datagram->decompression;
+      uring->sends[send_id].byte_len      = (uint32_t) output_byte_len;
+      __send_uring_buffer(worker, send_id);
+      atomic_fetch_add_explicit(datagram->decompression
+                                    ? &worker->card_decompressed
+                                    : &worker->card_compressed,
+                                1, memory_order_relaxed);
+    }
+    atomic_store_explicit((_Atomic uint16_t *) &uring->buffer_ring->tail,
+                          uring->buffer_ring_tail, memory_order_release);
+
+    // Receives are armed again once they have buffers to fill
+    for (decompression = 0; decompression < 2; decompression++) {
+      if (uring->is_armed[decompression] ||
+          uring->card_pending == URING_BUFFERS) {
+        continue;
+      }
+      sqe         = __get_uring_sqe(uring);
+      sqe->opcode = IORING_OP_RECV;
+      sqe->fd     = decompression ? worker->schc_socket : worker->packet_socket;
+      sqe->ioprio = IORING_RECV_MULTISHOT;
+      sqe->flags  = IOSQE_BUFFER_SELECT;
+      sqe->buf_group = URING_BUFFER_GROUP;
+      sqe->user_data = decompression ? URING_RECEIVE_SCHC
+                                     : URING_RECEIVE_PACKET;
+      uring->is_armed[decompression] = 1;
+    }
+
+    // One syscall submits the pass and waits for the next completions
+    atomic_store_explicit(uring->sq_tail, uring->sq_local_tail,
+                          memory_order_release);
+    to_submit = uring->sq_local_tail -
+                atomic_load_explicit(uring->sq_head, memory_order_acquire);
+    atomic_fetch_add_explicit(&worker->card_syscalls, 1, memory_order_relaxed);
+    if (syscall(__NR_io_uring_enter, uring->ring_fd, to_submit, 1,
+                IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &wait_arg,
+                sizeof(wait_arg)) < 0 &&
+        errno != EINTR && errno != ETIME && errno != EBUSY &&
+        errno != EAGAIN) {
+      fprintf(stderr, "io_uring_enter: %s\n", strerror(errno));
+      stop = 1;
+    }
+  }
+}
+
+/* ********************************************************************** */
+
+static void *__gateway_worker(void *arg) {
+  gateway_worker_t *worker;
+
+  worker = (gateway_worker_t *) arg;
+  init_memory_pool();
+
+  __set_loopback_address(&worker->packet_peer,
+                         worker->config->packet_peer_port);
+  __set_loopback_address(&worker->schc_peer, worker->config->schc_peer_port);
+  if (!init_flow_cache(&worker->flow_cache, FLOW_CACHE_ENTRIES)) {
+    fprintf(stderr, "Memory exhausted\n");
+    stop = 1;
+  }
+
+  if (!worker->config->io_uring) {
+    __run_mmsg(worker);
+  } else if (__init_uring(&worker->uring)) {
+    __run_uring(worker);
+    __destroy_uring(&worker->uring);
+  } else {
+    fprintf(stderr,
+            "io_uring is unavailable (%s), falling back to recvmmsg and "
+            "sendmmsg\n",
+            strerror(errno));
+    __run_mmsg(worker);
+  }
+
+  // Every (de)compression, failed or not, gives its allocations back
+  worker->pool_leak_byte_len = (pool != NULL) ? pool->used : 0;
+
+  destroy_flow_cache(&worker->flow_cache);
+  destroy_memory_pool();
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+static int __run_load(const gateway_config_t *config,
+                      const size_t card_packets, const size_t window,
+                      const size_t card_senders, const size_t card_malformed) {
+  pthread_t           mirror_thread;
+  mirror_t            mirror;
+  datagram_batch_t    sent;
+  datagram_batch_t    received;
+  struct sockaddr_in6 gateway_address;
+  struct pollfd       poll_fd;
+  uint8_t            *traffic;
+  size_t             *traffic_byte_lens;
+  uint64_t           *send_times;
+  uint64_t           *latencies;
+  uint8_t            *is_received;
+  uint8_t            *is_retransmitted;
+  uint8_t             schc_packet[64];
+  size_t              schc_packet_byte_len;
+  size_t              card_traffic;
+  size_t              card_sent;
+  size_t              card_received;
+  size_t              card_retransmitted;
+  size_t              card_latencies;
+  size_t              card_batch;
+  size_t              first_missing;
+  uint32_t            random_state;
+  uint32_t            sequence;
+  uint64_t            start;
+  uint64_t            last_progress;
+  uint64_t            retransmit_timeout;
+  uint64_t            now;
+  int                 packet_socket;
+  int                 senders[MAX_WORKERS];
+  int                 card_datagrams;
+  int                 is_mirror_started;
+  int                 is_idle;
+  int                 status;
+  double              elapsed;
+
+  // Every resource is released under cleanup, whatever was acquired
+  status            = 0;
+  is_mirror_started = 0;
+  packet_socket     = -1;
+  mirror.socket_fd  = -1;
+  for (size_t index = 0; index < card_senders; index++) {
+    senders[index] = -1;
+  }
+  memset(&sent, 0x00, sizeof(sent));
+  memset(&received, 0x00, sizeof(received));
+
+  // Synthetic packets with their tag after the IPv6 and UDP headers
+  card_traffic      = 1024;
+  traffic           = (uint8_t *) malloc(card_traffic * MAX_DATAGRAM_BYTE_LEN);
+  traffic_byte_lens = (size_t *) calloc(card_traffic, sizeof(size_t));
+  send_times        = (uint64_t *) calloc(card_packets, sizeof(uint64_t));
+  latencies         = (uint64_t *) calloc(card_packets, sizeof(uint64_t));
+  is_received       = (uint8_t *) calloc(card_packets, sizeof(uint8_t));
+  is_retransmitted  = (uint8_t *) calloc(card_packets, sizeof(uint8_t));
+  if (traffic == NULL || traffic_byte_lens == NULL || send_times == NULL ||
+      latencies == NULL || is_received == NULL || is_retransmitted == NULL) {
+    fprintf(stderr, "Memory exhausted\n");
+    goto cleanup;
+  }
+  random_state = 1;
+  for (size_t index = 0, card_attempts = 0; index < card_traffic;) {
+    if (++card_attempts > 1000 * card_traffic) {
+      fprintf(stderr, "The Context decompresses no random SCHC Packet\n");
+      goto cleanup;
+    }
+    schc_packet_byte_len = 1 + (random_state >> 16) % sizeof(schc_packet);
+    for (size_t index_byte = 0; index_byte < schc_packet_byte_len;
+         index_byte++) {
+      random_state            = random_state * 1103515245u + 12345u;
+      schc_packet[index_byte] = (uint8_t) (random_state >> 16);
+    }
+    traffic_byte_lens[index] = decompress_compiled(
+        &traffic[index * MAX_DATAGRAM_BYTE_LEN], MAX_DATAGRAM_BYTE_LEN,
+        config->compression_direction, schc_packet, schc_packet_byte_len,
+        config->compiled_context);
+    if (traffic_byte_lens[index] >= MIN_LOAD_PACKET_BYTE_LEN &&
+        __keeps_tag(&traffic[index * MAX_DATAGRAM_BYTE_LEN],
+                    traffic_byte_lens[index], config)) {
+      index++;
+    }
+  }
+
+  // The application receives the packets on packet_peer_port, the devices
+  // the SCHC frames on schc_peer_port, before the first datagram is sent
+  packet_socket       = __open_socket(config->packet_peer_port, 0);
+  mirror.config       = config;
+  mirror.socket_fd    = __open_socket(config->schc_peer_port, 0);
+  mirror.senders      = senders;
+  mirror.card_senders = card_senders;
+  for (size_t index = 0; index < card_senders; index++) {
+    senders[index] = __open_socket(0, 0);
+    if (senders[index] < 0) {
+      fprintf(stderr, "Cannot open a socket: %s\n", strerror(errno));
+      goto cleanup;
+    }
+  }
+  __set_loopback_address(&gateway_address, config->packet_port);
+  if (packet_socket < 0 || mirror.socket_fd < 0 ||
+      !__init_datagram_batch(&sent, config->batch_len, &gateway_address) ||
+      !__init_datagram_batch(&received, config->batch_len, NULL) ||
+      pthread_create(&mirror_thread, NULL, __mirror, &mirror) != 0) {
+    fprintf(stderr, "Cannot start the load: %s\n", strerror(errno));
+    goto cleanup;
+  }
+  is_mirror_started = 1;
+
+  // What comes out of the malformed datagrams is received before the load,
+  // its last bytes could pass for tags
+  if (card_malformed > 0) {
+    __send_malformed(config, senders, card_senders, packet_socket, &sent,
+                     &received, traffic, traffic_byte_lens, card_traffic,
+                     card_malformed);
+    for (size_t index = 0; index < config->batch_len; index++) {
+      sent.messages[index].msg_hdr.msg_name = &gateway_address;
+    }
+  }
+
+  poll_fd.fd         = packet_socket;
+  poll_fd.events     = POLLIN;
+  card_sent          = 0;
+  card_received      = 0;
+  card_retransmitted = 0;
+  card_latencies     = 0;
+  first_missing      = 0;
+  retransmit_timeout = RETRANSMIT_TIMEOUT_NS;
+  start              = __now();
+  last_progress      = start;
+  while (card_received < card_packets && !stop) {
+    // Tagged packets, while the window has room. Those that sendmmsg does not
+    // accept are written again on the next pass.
+    card_batch = 0;
+    while (card_batch < config->batch_len &&
+           card_sent + card_batch < card_packets &&
+           card_sent + card_batch - card_received < window) {
+      sent.iovecs[card_batch].iov_len = __write_load_packet(
+          sent.iovecs[card_batch].iov_base, traffic, traffic_byte_lens,
+          card_traffic, card_sent + card_batch);
+      send_times[card_sent + card_batch] = __now();
+      card_batch++;
+    }
+    if (card_batch > 0) {
+      card_sent += __send_load_batch(
+          senders[(card_sent / config->batch_len) % card_senders], &sent,
+          card_batch);
+    }
+
+    // Loopback UDP drops datagrams when a socket buffer is full. Once nothing
+    // has come back for twice the longest round trip, the packets still
+    // missing are sent again, each at most once per timeout.
+    is_idle = poll(&poll_fd, 1, 10) <= 0;
+    now     = __now();
+    if (is_idle && now - last_progress > LOAD_TIMEOUT_NS) {
+      break;
+    }
+    if (is_idle && now - last_progress > retransmit_timeout) {
+      while (first_missing < card_sent && is_received[first_missing]) {
+        first_missing++;
+      }
+      card_batch = 0;
+      for (size_t index = first_missing; index < card_sent; index++) {
+        if (is_received[index] ||
+            now - send_times[index] <= retransmit_timeout) {
+          continue;
+        }
+        sent.iovecs[card_batch].iov_len = __write_load_packet(
+            sent.iovecs[card_batch].iov_base, traffic, traffic_byte_lens,
+            card_traffic, index);
+        send_times[index]       = now;
+        is_retransmitted[index] = 1;
+        card_batch++;
+        if (card_batch == config->batch_len) {
+          card_retransmitted += __send_load_batch(
+              senders[card_retransmitted % card_senders], &sent, card_batch);
+          card_batch = 0;
+        }
+      }
+      if (card_batch > 0) {
+        card_retransmitted += __send_load_batch(
+            senders[card_retransmitted % card_senders], &sent, card_batch);
+      }
+    }
+
+    if (is_idle) {
+      continue;
+    }
+    card_datagrams = recvmmsg(packet_socket, received.messages,
+                              (unsigned int) config->batch_len, MSG_DONTWAIT,
+                              NULL);
+    now = __now();
+    for (int index = 0; index < card_datagrams; index++) {
+      if (received.messages[index].msg_len < sizeof(sequence)) {
+        continue;
+      }
+      memcpy(&sequence,
+             (uint8_t *) received.iovecs[index].iov_base +
+                 received.messages[index].msg_len - sizeof(sequence),
+             sizeof(sequence));
+      if (sequence >= card_sent || is_received[sequence]) {
+        continue;
+      }
+      // The round trip of a retransmitted packet is ambiguous, it is left out
+      is_received[sequence] = 1;
+      if (!is_retransmitted[sequence]) {
+        latencies[card_latencies] = now - send_times[sequence];
+        if (2 * latencies[card_latencies] > retransmit_timeout) {
+          retransmit_timeout = 2 * latencies[card_latencies];
+        }
+        card_latencies++;
+      }
+      card_received++;
+      last_progress = now;
+    }
+  }
+  elapsed = (double) (__now() - start) / 1e9;
+
+  qsort(latencies, card_latencies, sizeof(uint64_t), __compare_latencies);
+  printf("load: %zu sent, %zu retransmitted, %zu received in %.3f s, "
+         "%.0f packets/s\n",
+         card_sent, card_retransmitted, card_received, elapsed,
+         (double) card_received / elapsed);
+  if (card_latencies > 0) {
+    printf("load: round trip latency p50 %.1f us, p99 %.1f us, max %.1f us\n",
+           (double) latencies[card_latencies / 2] / 1e3,
+           (double) latencies[card_latencies * 99 / 100] / 1e3,
+           (double) latencies[card_latencies - 1] / 1e3);
+  }
+  status = card_received == card_packets;
+
+cleanup:
+  if (is_mirror_started) {
+    mirror_stop = 1;
+    pthread_join(mirror_thread, NULL);
+  }
+  __destroy_datagram_batch(&received);
+  __destroy_datagram_batch(&sent);
+  if (packet_socket >= 0) {
+    close(packet_socket);
+  }
+  if (mirror.socket_fd >= 0) {
+    close(mirror.socket_fd);
+  }
+  for (size_t index = 0; index < card_senders; index++) {
+    if (senders[index] >= 0) {
+      close(senders[index]);
+    }
+  }
+  free(is_retransmitted);
+  free(is_received);
+  free(latencies);
+  free(send_times);
+  free(traffic_byte_lens);
+  free(traffic);
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+static int __keeps_tag(uint8_t *packet, const size_t packet_byte_len,
+                       const gateway_config_t *config) {
+  uint8_t schc_packet[MAX_DATAGRAM_BYTE_LEN];
+  uint8_t decompressed_packet[MAX_DATAGRAM_BYTE_LEN];
+  size_t  schc_packet_byte_len;
+
+  const uint32_t tags[] = {0x00000000, 0xa5a5a5a5, 0x5a5a5a5a, 0xffffffff};
+
+  // e.g. a Field ending the packet may be ignored, or computed
+  for (size_t index = 0; index < sizeof(tags) / sizeof(tags[0]); index++) {
+    memcpy(packet + packet_byte_len - sizeof(tags[0]), &tags[index],
+           sizeof(tags[0]));
+    schc_packet_byte_len = compress_compiled(
+        schc_packet, sizeof(schc_packet), config->compression_direction,
+        packet, packet_byte_len, config->compiled_context);
+    if (schc_packet_byte_len == 0 ||
+        decompress_compiled(decompressed_packet, sizeof(decompressed_packet),
+                            config->decompression_direction, schc_packet,
+                            schc_packet_byte_len, config->compiled_context) !=
+            packet_byte_len ||
+        memcmp(decompressed_packet + packet_byte_len - sizeof(tags[0]),
+               &tags[index], sizeof(tags[0])) != 0) {
+      return 0;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static size_t __write_load_packet(uint8_t *datagram, const uint8_t *traffic,
+                                  const size_t *traffic_byte_lens,
+                                  const size_t  card_traffic,
+                                  const size_t  sequence) {
+  size_t   packet_byte_len;
+  uint32_t tag;
+
+  packet_byte_len = traffic_byte_lens[sequence % card_traffic];
+  memcpy(datagram, &traffic[(sequence % card_traffic) * MAX_DATAGRAM_BYTE_LEN],
+         packet_byte_len);
+  tag = (uint32_t) sequence;
+  memcpy(datagram + packet_byte_len - sizeof(tag), &tag, sizeof(tag));
+
+  return packet_byte_len;
+}
+
+/* ********************************************************************** */
+
+static size_t __send_load_batch(const int socket_fd, datagram_batch_t *batch,
+                                const size_t card_datagrams) {
+  int result;
+
+  do {
+    result = sendmmsg(socket_fd, batch->messages,
+                      (unsigned int) card_datagrams, 0);
+  } while (result < 0 && errno == EINTR);
+
+  // e.g. ENOBUFS, or the error of an earlier datagram
+  return result < 0 ? 0 : (size_t) result;
+}
+
+/* ********************************************************************** */
+
+static void __send_malformed(const gateway_config_t *config,
+                             const int *senders, const size_t card_senders,
+                             const int packet_socket, datagram_batch_t *sent,
+                             datagram_batch_t *received,
+                             const uint8_t    *traffic,
+                             const size_t     *traffic_byte_lens,
+                             const size_t      card_traffic,
+                             const size_t      card_malformed) {
+  struct sockaddr_in6 packet_address;
+  struct sockaddr_in6 schc_address;
+  struct pollfd       poll_fd;
+  uint8_t            *datagram;
+  size_t              datagram_byte_len;
+  size_t              card_batch;
+  size_t              card_returned;
+  size_t              index_traffic;
+  uint32_t            random_state;
+  int                 card_datagrams;
+
+  __set_loopback_address(&packet_address, config->packet_port);
+  __set_loopback_address(&schc_address, config->schc_port);
+
+  // Every other datagram is a packet cut short, or a random SCHC frame. Those
+  // that sendmmsg does not accept are not sent again.
+  random_state = 2;
+  for (size_t index = 0; index < card_malformed;) {
+    card_batch = 0;
+    while (card_batch < config->batch_len && index < card_malformed) {
+      random_state = random_state * 1103515245u + 12345u;
+      datagram     = sent->iovecs[card_batch].iov_base;
+      if (index % 2 == 0) {
+        index_traffic     = (index / 2) % card_traffic;
+        datagram_byte_len = (random_state >> 16) %
+                            traffic_byte_lens[index_traffic];
+        memcpy(datagram, &traffic[index_traffic * MAX_DATAGRAM_BYTE_LEN],
+               datagram_byte_len);
+        sent->messages[card_batch].msg_hdr.msg_name = &packet_address;
+      } else {
+        datagram_byte_len = (random_state >> 16) % 64;
+        for (size_t index_byte = 0; index_byte < datagram_byte_len;
+             index_byte++) {
+          random_state         = random_state * 1103515245u + 12345u;
+          datagram[index_byte] = (uint8_t) (random_state >> 16);
+        }
+        sent->messages[card_batch].msg_hdr.msg_name = &schc_address;
+      }
+      sent->iovecs[card_batch].iov_len = datagram_byte_len;
+      card_batch++;
+      index++;
+    }
+    __send_load_batch(senders[(index / config->batch_len) % card_senders],
+                      sent, card_batch);
+  }
+
+  poll_fd.fd     = packet_socket;
+  poll_fd.events = POLLIN;
+  card_returned  = 0;
+  while (!stop && poll(&poll_fd, 1, POLL_TIMEOUT_MS) > 0) {
+    card_datagrams = recvmmsg(packet_socket, received->messages,
+                              (unsigned int) config->batch_len, MSG_DONTWAIT,
+                              NULL);
+    if (card_datagrams > 0) {
+      card_returned += (size_t) card_datagrams;
+    }
+  }
+  printf("load: %zu malformed datagrams sent, %zu packets came out of them\n",
+         card_malformed, card_returned);
+}
+
+/* ********************************************************************** */
+
+static void *__mirror(void *arg) {
+  const mirror_t      *mirror;
+  datagram_batch_t     batch;
+  struct sockaddr_in6  gateway_address;
+  struct pollfd        poll_fd;
+  _Atomic uint64_t     card_syscalls;
+  int                  card_datagrams;
+  size_t               card_batches;
+
+  mirror = (const mirror_t *) arg;
+  __set_loopback_address(&gateway_address, mirror->config->schc_port);
+  poll_fd.fd     = mirror->socket_fd;
+  poll_fd.events = POLLIN;
+  if (!__init_datagram_batch(&batch, mirror->config->batch_len,
+                             &gateway_address)) {
+    fprintf(stderr, "Cannot start the mirror: %s\n", strerror(errno));
+    return NULL;
+  }
+  atomic_init(&card_syscalls, 0);
+
+  // Received SCHC frames are sent back as they are
+  card_batches = 0;
+  while (!mirror_stop) {
+    if (poll(&poll_fd, 1, POLL_TIMEOUT_MS) <= 0) {
+      continue;
+    }
+    card_datagrams = recvmmsg(poll_fd.fd, batch.messages,
+                              (unsigned int) mirror->config->batch_len,
+                              MSG_DONTWAIT, NULL);
+    if (card_datagrams <= 0) {
+      continue;
+    }
+    for (int index = 0; index < card_datagrams; index++) {
+      batch.iovecs[index].iov_len = batch.messages[index].msg_len;
+      batch.messages[index].msg_hdr.msg_name    = &gateway_address;
+      batch.messages[index].msg_hdr.msg_namelen = sizeof(gateway_address);
+    }
+    __send_batch(mirror->senders[card_batches++ % mirror->card_senders],
+                 &batch, (size_t) card_datagrams, &card_syscalls);
+    for (int index = 0; index < card_datagrams; index++) {
+      batch.iovecs[index].iov_len = MAX_DATAGRAM_BYTE_LEN;
+    }
+  }
+
+  __destroy_datagram_batch(&batch);
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+static int __compare_latencies(const void *first, const void *second) {
+  const uint64_t a = *(const uint64_t *) first;
+  const uint64_t b = *(const uint64_t *) second;
+
+  return (a > b) - (a < b);
+}
\ No newline at end of file
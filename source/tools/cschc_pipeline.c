@@ -0,0 +1,605 @@
+/**
+ * @file cschc_pipeline.c
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Measures the throughput of the SCHC Pipeline, or of the Scheduler,
+ * over a number of worker threads.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details Usage: cschc-pipeline <context file> [options]
+ *   -w <workers>   Largest number of workers, default 4.
+ *   -b <packets>   Packets per batch, default 64.
+ *   -n <packets>   Synthetic packets, default 65536.
+ *   -r <rounds>    Times the packets are processed, default 16.
+ *   -p <pcap file> Compresses the IPv6 packets of a pcap file instead.
+ *   -d             Direction DI_DW instead of DI_UP.
+ *   -s             Work-stealing Scheduler instead of the Pipeline.
+ *
+ * The Context file is the raw CSCHC Context byte array, see context_loader.h.
+ * Synthetic packets are the decompression of random SCHC Packets, so that
+ * most of them match a Rule. The pcap file may hold raw IP, IPv6 or Ethernet
+ * frames.
+ *
+ * The packets are compressed, then their SCHC Packets decompressed, with 1, 2,
+ * 4... workers up to the largest number, and the tool prints the packets per
+ * second of each run and its speedup against one worker. The results are
+ * checked against the ones of compress_compiled(...) in the main thread.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/decompression.h"
+#include "core/pipeline.h"
+#include "core/scheduler.h"
+#include "utils/memory.h"
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_PACKET_BYTE_LEN       1500
+#define GENERATED_PACKET_BYTE_LEN 256
+#define RULE_ID_BYTE_LEN          1
+#define MAX_BATCHES_IN_FLIGHT     64
+
+#define PCAP_MAGIC         0xa1b2c3d4
+#define PCAP_MAGIC_NANO    0xa1b23c4d
+#define LINKTYPE_ETHERNET  1
+#define LINKTYPE_RAW       101
+#define LINKTYPE_IPV6      229
+#define ETHERTYPE_IPV6     0x86dd
+#define ETHERNET_BYTE_LEN  14
+#define PCAP_HEADER_LEN    24
+#define PCAP_RECORD_LEN    16
+
+/**
+ * @brief Struct that defines the packets processed by the runs.
+ */
+typedef struct {
+  uint8_t *packets;              // packet_max_byte_len bytes per packet
+  size_t  *packet_byte_lens;     // Byte length of each packet
+  size_t   packet_max_byte_len;  // Bytes reserved for each packet
+  size_t   card_packets;         // Number of packets
+} traffic_t;
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Allocates the buffers of a traffic.
+ *
+ * @param traffic Pointer to the traffic.
+ * @param card_packets Number of packets.
+ * @param packet_max_byte_len Bytes reserved for each packet.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __init_traffic(traffic_t *traffic, const size_t card_packets,
+                          const size_t packet_max_byte_len);
+
+/**
+ * @brief Frees the buffers of a traffic.
+ *
+ * @param traffic Pointer to the traffic.
+ */
+static void __destroy_traffic(traffic_t *traffic);
+
+/**
+ * @brief Decompresses random SCHC Packets until card_packets packets are
+ * obtained.
+ *
+ * @param traffic Pointer to the traffic to fill.
+ * @param card_packets Number of packets.
+ * @param direction Packet Direction Indicator.
+ * @param compiled_context Pointer to the Compiled Context.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __generate_traffic(traffic_t *traffic, const size_t card_packets,
+                              const direction_indicator_t direction,
+                              const compiled_context_t   *compiled_context);
+
+/**
+ * @brief Reads the IPv6 packets of a pcap file. Packets larger than
+ * MAX_PACKET_BYTE_LEN are skipped and counted.
+ *
+ * @param traffic Pointer to the traffic to fill.
+ * @param path Path of the pcap file.
+ * @return The status code, 1 for success, otherwise 0.
+ */
+static int __read_pcap(traffic_t *traffic, const char *path);
+
+/**
+ * @brief Compresses or decompresses a traffic with a Pipeline or a Scheduler.
+ *
+ * @param output Pointer to the traffic to fill with the results.
+ * @param input Pointer to the traffic to process.
+ * @param card_workers Number of workers.
+ * @param batch_len Packets per batch.
+ * @param card_rounds Times the traffic is processed.
+ * @param decompression 1 to decompress the traffic.
+ * @param direction Packet Direction Indicator.
+ * @param compiled_context Pointer to the Compiled Context.
+ * @param work_stealing 1 to run a Scheduler rather than a Pipeline.
+ * @return The elapsed time in seconds, a negative value on failure.
+ */
+static double __run(traffic_t *output, const traffic_t *input,
+                    const size_t card_workers, const size_t batch_len,
+                    const size_t card_rounds, const int decompression,
+                    const direction_indicator_t direction,
+                    const compiled_context_t   *compiled_context,
+                    const int                   work_stealing);
+
+/**
+ * @brief Returns the time of a monotonic clock in seconds.
+ */
+static double __now(void);
+
+/**
+ * @brief Reads a 32-bit integer of a pcap file.
+ *
+ * @param bytes Pointer to the integer.
+ * @param swapped 1 if the file is not in the host byte order.
+ * @return The integer.
+ */
+static uint32_t __pcap_u32(const uint8_t *bytes, const int swapped);
+
+/* ********************************************************************** */
+
+int main(int argc, char *argv[]) {
+  compiled_context_t   *compiled_context;
+  traffic_t             packets;
+  traffic_t             schc_packets;
+  traffic_t             decompressed_packets;
+  direction_indicator_t direction;
+  const char           *pcap_path;
+  size_t                max_workers;
+  size_t                batch_len;
+  size_t                card_packets;
+  size_t                card_rounds;
+  size_t                card_compressed;
+  double                reference_rates[2];
+  double                elapsed;
+  uint8_t               schc_packet[MAX_PACKET_BYTE_LEN + RULE_ID_BYTE_LEN];
+  size_t                schc_packet_byte_len;
+  int                   work_stealing;
+  int                   option;
+
+  max_workers  = 4;
+  batch_len    = 64;
+  card_packets = 65536;
+  card_rounds  = 16;
+  pcap_path    = NULL;
+  direction     = DI_UP;
+  work_stealing = 0;
+  while ((option = getopt(argc, argv, "w:b:n:r:p:ds")) != -1) {
+    switch (option) {
+      case 'w':
+        max_workers = strtoul(optarg, NULL, 10);
+        break;
+      case 'b':
+        batch_len = strtoul(optarg, NULL, 10);
+        break;
+      case 'n':
+        card_packets = strtoul(optarg, NULL, 10);
+        break;
+      case 'r':
+        card_rounds = strtoul(optarg, NULL, 10);
+        break;
+      case 'p':
+        pcap_path = optarg;
+        break;
+      case 'd':
+        direction = DI_DW;
+        break;
+      case 's':
+        work_stealing = 1;
+        break;
+      default:
+        fprintf(stderr, "Usage: %s <context file> [-w workers] [-b batch] "
+                        "[-n packets] [-r rounds] [-p pcap file] [-d] [-s]\n",
+                argv[0]);
+        return 1;
+    }
+  }
+  if (optind != argc - 1 || max_workers == 0 ||
+      max_workers > PIPELINE_MAX_WORKERS || batch_len == 0 ||
+      card_packets == 0 || card_rounds == 0) {
+    fprintf(stderr, "Usage: %s <context file> [-w workers] [-b batch] "
+                    "[-n packets] [-r rounds] [-p pcap file] [-d] [-s]\n",
+            argv[0]);
+    return 1;
+  }
+
+  init_memory_pool();
+
+  compiled_context = compile_context_file(argv[optind]);
+  if (compiled_context == NULL) {
+    fprintf(stderr, "Cannot load the Context %s\n", argv[optind]);
+    return 1;
+  }
+
+  if (pcap_path != NULL ? !__read_pcap(&packets, pcap_path)
+                        : !__generate_traffic(&packets, card_packets,
+                                              direction, compiled_context)) {
+    fprintf(stderr, "Cannot build the traffic\n");
+    return 1;
+  }
+  // The no-compression Rule adds a Rule ID to the packets
+  if (!__init_traffic(&schc_packets, packets.card_packets,
+                      packets.packet_max_byte_len + RULE_ID_BYTE_LEN) ||
+      !__init_traffic(&decompressed_packets, packets.card_packets,
+                      schc_packets.packet_max_byte_len)) {
+    fprintf(stderr, "Memory exhausted\n");
+    return 1;
+  }
+
+  printf("%zu packets, %zu per batch, %zu rounds\n", packets.card_packets,
+         batch_len, card_rounds);
+  printf("%8s %16s %8s %16s %8s\n", "workers", "compression/s", "speedup",
+         "decompression/s", "speedup");
+
+  for (size_t card_workers = 1; card_workers <= max_workers;
+       card_workers = (card_workers * 2 > max_workers && card_workers <
+                       max_workers) ? max_workers : card_workers * 2) {
+    elapsed = __run(&schc_packets, &packets, card_workers, batch_len,
+                    card_rounds, 0, direction, compiled_context,
+                    work_stealing);
+    if (elapsed < 0) {
+      fprintf(stderr, "Cannot start %zu workers\n", card_workers);
+      return 1;
+    }
+    if (card_workers == 1) {
+      reference_rates[0] = packets.card_packets * card_rounds / elapsed;
+    }
+    printf("%8zu %16.0f %8.2f", card_workers,
+           packets.card_packets * card_rounds / elapsed,
+           packets.card_packets * card_rounds / elapsed / reference_rates[0]);
+
+    elapsed = __run(&decompressed_packets, &schc_packets, card_workers,
+                    batch_len, card_rounds, 1, direction, compiled_context,
+                    work_stealing);
+    if (elapsed < 0) {
+      fprintf(stderr, "Cannot start %zu workers\n", card_workers);
+      return 1;
+    }
+    if (card_workers == 1) {
+      reference_rates[1] = packets.card_packets * card_rounds / elapsed;
+    }
+    printf(" %16.0f %8.2f\n", packets.card_packets * card_rounds / elapsed,
+           packets.card_packets * card_rounds / elapsed / reference_rates[1]);
+  }
+
+  // The workers give the SCHC Packets of the single-threaded compression
+  card_compressed = 0;
+  for (size_t index = 0; index < packets.card_packets; index++) {
+    schc_packet_byte_len = compress_compiled(
+        schc_packet, schc_packets.packet_max_byte_len, direction,
+        &packets.packets[index * packets.packet_max_byte_len],
+        packets.packet_byte_lens[index], compiled_context);
+    if (schc_packet_byte_len != schc_packets.packet_byte_lens[index] ||
+        memcmp(schc_packet,
+               &schc_packets.packets[index * schc_packets.packet_max_byte_len],
+               schc_packet_byte_len) != 0) {
+      fprintf(stderr, "Packet %zu compressed differently\n", index);
+      return 1;
+    }
+    card_compressed += schc_packet_byte_len > 0;
+  }
+  printf("%zu packets compressed\n", card_compressed);
+
+  __destroy_traffic(&decompressed_packets);
+  __destroy_traffic(&schc_packets);
+  __destroy_traffic(&packets);
+  free_compiled_context(compiled_context);
+  destroy_memory_pool();
+
+  return 0;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static int __init_traffic(traffic_t *traffic, const size_t card_packets,
+                          const size_t packet_max_byte_len) {
+  traffic->card_packets        = card_packets;
+  traffic->packet_max_byte_len = packet_max_byte_len;
+  traffic->packets             = (uint8_t *) calloc(card_packets,
+                                                    packet_max_byte_len);
+  traffic->packet_byte_lens = (size_t *) calloc(card_packets, sizeof(size_t));
+  if (traffic->packets == NULL || traffic->packet_byte_lens == NULL) {
+    __destroy_traffic(traffic);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __destroy_traffic(traffic_t *traffic) {
+  free(traffic->packets);
+  free(traffic->packet_byte_lens);
+  traffic->packets            = NULL;
+  traffic->packet_byte_lens    = NULL;
+  traffic->packet_max_byte_len = 0;
+  traffic->card_packets        = 0;
+}
+
+/* ********************************************************************** */
+
+static int __generate_traffic(traffic_t *traffic, const size_t card_packets,
+                              const direction_indicator_t direction,
+                              const compiled_context_t   *compiled_context) {
+  uint8_t  schc_packet[64];
+  size_t   schc_packet_byte_len;
+  size_t   card_attempts;
+  size_t   index;
+  uint32_t random_state;
+
+  if (!__init_traffic(traffic, card_packets, GENERATED_PACKET_BYTE_LEN)) {
+    return 0;
+  }
+
+  random_state  = 1;
+  card_attempts = 0;
+  index         = 0;
+  while (index < card_packets) {
+    if (++card_attempts > 1000 * card_packets) {
+      __destroy_traffic(traffic);
+      return 0;
+    }
+
+    schc_packet_byte_len = 1 + (random_state >> 16) % sizeof(schc_packet);
+    for (size_t index_byte = 0; index_byte < schc_packet_byte_len;
+         index_byte++) {
+      random_state            = random_state * 1103515245u + 12345u;
+      schc_packet[index_byte] = (uint8_t) (random_state >> 16);
+    }
+
+    traffic->packet_byte_lens[index] = decompress_compiled(
+        &traffic->packets[index * GENERATED_PACKET_BYTE_LEN],
+        GENERATED_PACKET_BYTE_LEN, direction, schc_packet, schc_packet_byte_len,
+        compiled_context);
+    if (traffic->packet_byte_lens[index] > 0) {
+      index++;
+    }
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static int __read_pcap(traffic_t *traffic, const char *path) {
+  FILE    *file;
+  uint8_t  header[PCAP_HEADER_LEN];
+  uint8_t  record[PCAP_RECORD_LEN];
+  uint8_t  frame[65536];
+  uint32_t link_type;
+  uint32_t frame_byte_len;
+  size_t   offset;
+  size_t   capacity;
+  size_t   card_skipped;
+  int      swapped;
+  void    *resized;
+
+  file = fopen(path, "rb");
+  if (file == NULL) {
+    return 0;
+  }
+  if (fread(header, 1, sizeof(header), file) != sizeof(header)) {
+    fclose(file);
+    return 0;
+  }
+
+  swapped = __pcap_u32(header, 0) != PCAP_MAGIC &&
+            __pcap_u32(header, 0) != PCAP_MAGIC_NANO;
+  if (swapped && __pcap_u32(header, 1) != PCAP_MAGIC &&
+      __pcap_u32(header, 1) != PCAP_MAGIC_NANO) {
+    fclose(file);
+    return 0;
+  }
+  link_type = __pcap_u32(header + 20, swapped) & 0x0fffffff;
+  if (link_type != LINKTYPE_ETHERNET && link_type != LINKTYPE_RAW &&
+      link_type != LINKTYPE_IPV6) {
+    fclose(file);
+    return 0;
+  }
+
+  capacity = 1024;
+  if (!__init_traffic(traffic, capacity, MAX_PACKET_BYTE_LEN)) {
+    fclose(file);
+    return 0;
+  }
+  traffic->card_packets = 0;
+  card_skipped          = 0;
+
+  while (fread(record, 1, sizeof(record), file) == sizeof(record)) {
+    frame_byte_len = __pcap_u32(record + 8, swapped);
+    if (frame_byte_len > sizeof(frame) ||
+        fread(frame, 1, frame_byte_len, file) != frame_byte_len) {
+      break;
+    }
+
+    offset = 0;
+    if (link_type == LINKTYPE_ETHERNET) {
+      if (frame_byte_len < ETHERNET_BYTE_LEN ||
+          ((frame[12] << 8) | frame[13]) != ETHERTYPE_IPV6) {
+        continue;
+      }
+      offset = ETHERNET_BYTE_LEN;
+    }
+    if (frame_byte_len - offset == 0 || frame[offset] >> 4 != 6) {
+      continue;
+    }
+    if (frame_byte_len - offset > MAX_PACKET_BYTE_LEN) {
+      card_skipped++;
+      continue;
+    }
+
+    if (traffic->card_packets == capacity) {
+      capacity *= 2;
+      resized = realloc(traffic->packets, capacity * MAX_PACKET_BYTE_LEN);
+      if (resized == NULL) {
+        break;
+      }
+      traffic->packets = (uint8_t *) resized;
+      resized = realloc(traffic->packet_byte_lens, capacity * sizeof(size_t));
+      if (resized == NULL) {
+        break;
+      }
+      traffic->packet_byte_lens = (size_t *) resized;
+    }
+    memcpy(&traffic->packets[traffic->card_packets * MAX_PACKET_BYTE_LEN],
+           frame + offset, frame_byte_len - offset);
+    traffic->packet_byte_lens[traffic->card_packets++] =
+        frame_byte_len - offset;
+  }
+  fclose(file);
+
+  if (card_skipped > 0) {
+    fprintf(stderr, "%zu IPv6 packets over %d bytes skipped\n", card_skipped,
+            MAX_PACKET_BYTE_LEN);
+  }
+  if (traffic->card_packets == 0) {
+    __destroy_traffic(traffic);
+    return 0;
+  }
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static double __run(traffic_t *output, const traffic_t *input,
+                    const size_t card_workers, const size_t batch_len,
+                    const size_t card_rounds, const int decompression,
+                    const direction_indicator_t direction,
+                    const compiled_context_t   *compiled_context,
+                    const int                   work_stealing) {
+  pipeline_t        *pipeline;
+  scheduler_t       *scheduler;
+  pipeline_batch_t  *batches;
+  pipeline_batch_t  *batch;
+  pipeline_packet_t *batch_packets;
+  size_t             card_batches;
+  size_t             card_submitted;
+  size_t             card_received;
+  size_t             index;
+  size_t             first;
+  double             start;
+
+  card_batches  = (input->card_packets + batch_len - 1) / batch_len;
+  batches       = (pipeline_batch_t *) calloc(card_batches,
+                                              sizeof(pipeline_batch_t));
+  batch_packets = (pipeline_packet_t *) calloc(input->card_packets,
+                                               sizeof(pipeline_packet_t));
+  pipeline      = NULL;
+  scheduler     = NULL;
+  if (work_stealing) {
+    scheduler = create_scheduler(card_workers, MAX_BATCHES_IN_FLIGHT, NULL,
+                                 NULL);
+  } else {
+    pipeline = create_pipeline(card_workers, MAX_BATCHES_IN_FLIGHT);
+  }
+  if (batches == NULL || batch_packets == NULL ||
+      (pipeline == NULL && scheduler == NULL)) {
+    free(batches);
+    free(batch_packets);
+    destroy_pipeline(pipeline);
+    destroy_scheduler(scheduler);
+    return -1;
+  }
+
+  for (index = 0; index < input->card_packets; index++) {
+    batch_packets[index].packet =
+        &input->packets[index * input->packet_max_byte_len];
+    batch_packets[index].packet_byte_len = input->packet_byte_lens[index];
+    batch_packets[index].output =
+        &output->packets[index * output->packet_max_byte_len];
+    batch_packets[index].output_max_byte_len = output->packet_max_byte_len;
+  }
+  for (index = 0; index < card_batches; index++) {
+    first                            = index * batch_len;
+    batches[index].compiled_context  = compiled_context;
+    batches[index].direction         = direction;
+    batches[index].decompression     = decompression;
+    batches[index].packets           = &batch_packets[first];
+    batches[index].card_packets      = input->card_packets - first < batch_len
+                                           ? input->card_packets - first
+                                           : batch_len;
+  }
+
+  // A batch is submitted again once processed, round after round
+  start          = __now();
+  card_submitted = 0;
+  card_received  = 0;
+  while (scheduler != NULL && card_received < card_rounds) {
+    for (index = 0; index < card_batches; index++) {
+      while (!submit_scheduler_batch(scheduler, &batches[index])) {
+        sched_yield();
+      }
+    }
+    wait_scheduler(scheduler);
+    card_received++;
+  }
+  while (pipeline != NULL && card_received < card_batches * card_rounds) {
+    while (card_submitted < card_batches * card_rounds &&
+           card_submitted - card_received < card_batches &&
+           submit_pipeline_batch(pipeline,
+                                 &batches[card_submitted % card_batches])) {
+      card_submitted++;
+    }
+
+    batch = receive_pipeline_batch(pipeline);
+    if (batch == NULL) {
+      sched_yield();
+      continue;
+    }
+    card_received++;
+  }
+  start = __now() - start;
+
+  for (index = 0; index < input->card_packets; index++) {
+    output->packet_byte_lens[index] = batch_packets[index].output_byte_len;
+  }
+
+  destroy_pipeline(pipeline);
+  destroy_scheduler(scheduler);
+  free(batch_packets);
+  free(batches);
+
+  return start;
+}
+
+/* ********************************************************************** */
+
+static double __now(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+
+  return (double) now.tv_sec + (double) now.tv_nsec / 1e9;
+}
+
+/* ********************************************************************** */
+
+static uint32_t __pcap_u32(const uint8_t *bytes, const int swapped) {
+  uint32_t value;
+
+  memcpy(&value, bytes, sizeof(value));
+  if (swapped) {
+    value = ((value & 0xff) << 24) | ((value & 0xff00) << 8) |
+            ((value >> 8) & 0xff00) | (value >> 24);
+  }
+
+  return value;
+}
\ No newline at end of file
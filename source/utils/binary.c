@@ -158,6 +158,119 @@ int add_bits_to_buffer(uint8_t* buffer, const size_t buffer_byte_len,
   return status;
 }
 
+/* ********************************************************************** */
+
+int write_byte_to_buffer(uint8_t* buffer, const size_t buffer_byte_len,
+                         size_t* bit_position, const uint8_t content,
+                         const size_t content_len) {
+  size_t byte_pos;
+  size_t bit_offset;
+  size_t remaining_bits;
+
+  if (content_len > 8 ||
+      BYTE_LENGTH(*bit_position + content_len) > buffer_byte_len) {
+    return 0;
+  }
+  if (content_len == 0) {
+    return 1;
+  }
+
+  byte_pos   = *bit_position / 8;
+  bit_offset = *bit_position % 8;
+
+  // The bits before bit_offset are kept, those after it are written
+  if (bit_offset + content_len <= 8) {
+    buffer[byte_pos] =
+        (uint8_t) ((buffer[byte_pos] & (0xff00 >> bit_offset)) |
+                   (content << (8 - bit_offset - content_len)));
+  } else {
+    remaining_bits   = content_len - (8 - bit_offset);
+    buffer[byte_pos] = (uint8_t) ((buffer[byte_pos] & (0xff00 >> bit_offset)) |
+                                  (content >> remaining_bits));
+    buffer[++byte_pos] = (uint8_t) (content << (8 - remaining_bits));
+  }
+
+  *bit_position += content_len;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int write_bits_to_buffer(uint8_t* buffer, const size_t buffer_byte_len,
+                         size_t* bit_position, const uint8_t* content,
+                         const size_t content_len) {
+  int    status;
+  size_t content_ind;
+  size_t len_remainder;
+  size_t content_byte_len;
+
+  if (BYTE_LENGTH(*bit_position + content_len) > buffer_byte_len) {
+    return 0;
+  }
+
+  status           = 1;
+  content_ind      = 0;
+  len_remainder    = content_len % 8;
+  content_byte_len = content_len / 8;
+
+  // Left-padded as in add_bits_to_buffer(...)
+  if (len_remainder > 0) {
+    status = write_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                                  content[content_ind++], len_remainder);
+  }
+
+  // Byte-aligned bytes are copied at once
+  if (*bit_position % 8 == 0) {
+    memcpy(buffer + *bit_position / 8, content + content_ind,
+           content_byte_len);
+    *bit_position += 8 * content_byte_len;
+    return status;
+  }
+
+  while (status && content_ind < content_byte_len + (len_remainder > 0)) {
+    status = write_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                                  content[content_ind++], 8);
+  }
+
+  return status;
+}
+
+/* ********************************************************************** */
+
+int write_variable_length(uint8_t* buffer, const size_t buffer_byte_len,
+                          size_t* bit_position, const size_t variable_len) {
+  uint32_t is_12_bits;
+  uint32_t is_28_bits;
+  uint32_t prefix;
+  size_t   prefix_len;
+  size_t   value_len;
+
+  is_12_bits = variable_len >= 15;
+  is_28_bits = variable_len >= 255;
+  prefix_len = 4 + 8 * is_12_bits + 16 * is_28_bits;
+  value_len  = 4 + 4 * is_12_bits + 8 * is_28_bits;
+
+  if (variable_len > 0xffff ||
+      BYTE_LENGTH(*bit_position + prefix_len) > buffer_byte_len) {
+    return 0;
+  }
+
+  // The 0, 4 or 12 bits set to 1 announce the value length
+  prefix = (((1u << (prefix_len - value_len)) - 1) << value_len) |
+           (uint32_t) variable_len;
+
+  // The first 4 bits, then the remaining bytes
+  write_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                       (uint8_t) (prefix >> (prefix_len - 4)) & 0x0f, 4);
+  for (size_t shift = prefix_len - 4; shift > 0; shift -= 8) {
+    write_byte_to_buffer(buffer, buffer_byte_len, bit_position,
+                         (uint8_t) (prefix >> (shift - 8)), 8);
+  }
+
+  return 1;
+}
+
 /* ********************************************************************** */
 /*                               Extraction                               */
 /* ********************************************************************** */
@@ -217,6 +330,74 @@ int extract_bits(uint8_t* content, const size_t content_max_byte_len,
   return 1;
 }
 
+/* ********************************************************************** */
+
+uint64_t load_bits(const uint8_t* buffer, const size_t buffer_byte_len,
+                   const size_t bit_position) {
+  uint64_t bits;
+  size_t   byte_pos;
+
+  byte_pos = bit_position / 8;
+  bits     = 0;
+
+  if (byte_pos + sizeof(uint64_t) <= buffer_byte_len) {
+    // One unaligned load, turned big-endian
+    memcpy(&bits, buffer + byte_pos, sizeof(uint64_t));
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    bits = __builtin_bswap64(bits);
+#elif !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+    bits = 0;
+    for (size_t i = 0; i < sizeof(uint64_t); i++) {
+      bits = (bits << 8) | buffer[byte_pos + i];
+    }
+#endif
+  } else {
+    // Near the end of the buffer, the missing bytes read as 0
+    for (size_t i = 0; i < sizeof(uint64_t); i++) {
+      bits <<= 8;
+      if (byte_pos + i < buffer_byte_len) {
+        bits |= buffer[byte_pos + i];
+      }
+    }
+  }
+
+  return bits << (bit_position % 8);
+}
+
+/* ********************************************************************** */
+
+int read_variable_length(size_t* variable_len, size_t* bit_position,
+                         const uint8_t* buffer, const size_t buffer_byte_len) {
+  uint64_t bits;
+  uint64_t is_12_bits;
+  uint64_t is_28_bits;
+  size_t   prefix_len;
+  size_t   value_len;
+
+  if (*bit_position >= 8 * buffer_byte_len) {
+    return 0;
+  }
+
+  bits = load_bits(buffer, buffer_byte_len, *bit_position);
+
+  // 0xf announces 8 more bits, then 0xff announces 16 more bits
+  is_12_bits = (bits >> 60) == 0x0f;
+  is_28_bits = is_12_bits & (((bits >> 52) & 0xff) == 0xff);
+  prefix_len = 4 + 8 * is_12_bits + 16 * is_28_bits;
+  value_len  = 4 + 4 * is_12_bits + 8 * is_28_bits;
+
+  if (*bit_position + prefix_len > 8 * buffer_byte_len) {
+    return 0;
+  }
+
+  *variable_len =
+      (size_t) ((bits >> (64 - prefix_len)) & ((1u << value_len) - 1));
+  *bit_position += prefix_len;
+
+  return 1;
+}
+
 /* ********************************************************************** */
 /*                                Other(s)                                */
 /* ********************************************************************** */
@@ -249,4 +430,54 @@ void split_uint16_t(uint8_t* left_byte, uint8_t* right_byte,
 
 uint16_t merge_uint8_t(const uint8_t left_byte, const uint8_t right_byte) {
   return ((uint16_t) (left_byte << 8)) | right_byte;
-}
\ No newline at end of file
+}
+
+/* ********************************************************************** */
+
+uint64_t load_uint64_t(const uint8_t* buffer, const size_t buffer_byte_len) {
+  uint64_t value;
+
+  value = 0;
+  for (size_t i = 0; i < buffer_byte_len; i++) {
+    value = (value << 8) | buffer[i];
+  }
+
+  return value;
+}
+
+/* ********************************************************************** */
+
+void store_uint64_t(uint8_t* buffer, const size_t buffer_byte_len,
+                    uint64_t value) {
+  for (size_t i = buffer_byte_len; i > 0; i--) {
+    buffer[i - 1] = (uint8_t) (value & 0xff);
+    value >>= 8;
+  }
+}
+
+#ifdef __SIZEOF_INT128__
+/* ********************************************************************** */
+
+uint128_t load_uint128_t(const uint8_t* buffer, const size_t buffer_byte_len) {
+  // Two 64-bit loads, the first one holding the bytes beyond the 8 last ones
+  if (buffer_byte_len <= 8) {
+    return load_uint64_t(buffer, buffer_byte_len);
+  }
+
+  return ((uint128_t) load_uint64_t(buffer, buffer_byte_len - 8) << 64) |
+         load_uint64_t(buffer + buffer_byte_len - 8, 8);
+}
+
+/* ********************************************************************** */
+
+void store_uint128_t(uint8_t* buffer, const size_t buffer_byte_len,
+                     const uint128_t value) {
+  if (buffer_byte_len <= 8) {
+    store_uint64_t(buffer, buffer_byte_len, (uint64_t) value);
+    return;
+  }
+
+  store_uint64_t(buffer, buffer_byte_len - 8, (uint64_t) (value >> 64));
+  store_uint64_t(buffer + buffer_byte_len - 8, 8, (uint64_t) value);
+}
+#endif
\ No newline at end of file
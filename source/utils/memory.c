@@ -5,7 +5,7 @@
 
 /* ********************************************************************** */
 
-memory_pool_t *pool = NULL;
+POOL_THREAD_LOCAL memory_pool_t *pool = NULL;
 
 /* ********************************************************************** */
 
@@ -35,6 +35,7 @@ void destroy_memory_pool(void) {
   if (pool) {
     free(pool->memory);
     free(pool);
+    pool = NULL;
   }
 }
 
@@ -0,0 +1,118 @@
+#include "utils/ring_buffer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+
+int init_ring_buffer(ring_buffer_t *ring_buffer, const size_t capacity) {
+  memset(ring_buffer, 0x00, sizeof(ring_buffer_t));
+
+  ring_buffer->capacity = 2;
+  while (ring_buffer->capacity < capacity) {
+    ring_buffer->capacity <<= 1;
+  }
+
+  ring_buffer->slots = (ring_buffer_slot_t *) malloc(
+      ring_buffer->capacity * sizeof(ring_buffer_slot_t));
+  if (ring_buffer->slots == NULL) {
+    ring_buffer->capacity = 0;
+    return 0;
+  }
+
+  // The slot at position i is ready to be pushed to at position i
+  for (size_t index = 0; index < ring_buffer->capacity; index++) {
+    atomic_init(&ring_buffer->slots[index].sequence, index);
+    ring_buffer->slots[index].item = NULL;
+  }
+  atomic_init(&ring_buffer->push_position, 0);
+  atomic_init(&ring_buffer->pop_position, 0);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_ring_buffer(ring_buffer_t *ring_buffer) {
+  free(ring_buffer->slots);
+  ring_buffer->slots    = NULL;
+  ring_buffer->capacity = 0;
+}
+
+/* ********************************************************************** */
+
+int ring_buffer_push(ring_buffer_t *ring_buffer, void *item) {
+  ring_buffer_slot_t *slot;
+  size_t              position;
+  ptrdiff_t           difference;
+
+  position = atomic_load_explicit(&ring_buffer->push_position,
+                                  memory_order_relaxed);
+  for (;;) {
+    slot     = &ring_buffer->slots[position & (ring_buffer->capacity - 1)];
+    difference =
+        (ptrdiff_t) (atomic_load_explicit(&slot->sequence,
+                                          memory_order_acquire) -
+                     position);
+
+    if (difference == 0) {
+      // The slot is free, it is ours once the position is claimed
+      if (atomic_compare_exchange_weak_explicit(
+              &ring_buffer->push_position, &position, position + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // The slot still holds the item pushed one lap before
+      return 0;
+    } else {
+      position = atomic_load_explicit(&ring_buffer->push_position,
+                                      memory_order_relaxed);
+    }
+  }
+
+  slot->item = item;
+  atomic_store_explicit(&slot->sequence, position + 1, memory_order_release);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int ring_buffer_pop(ring_buffer_t *ring_buffer, void **item) {
+  ring_buffer_slot_t *slot;
+  size_t              position;
+  ptrdiff_t           difference;
+
+  position =
+      atomic_load_explicit(&ring_buffer->pop_position, memory_order_relaxed);
+  for (;;) {
+    slot     = &ring_buffer->slots[position & (ring_buffer->capacity - 1)];
+    difference =
+        (ptrdiff_t) (atomic_load_explicit(&slot->sequence,
+                                          memory_order_acquire) -
+                     (position + 1));
+
+    if (difference == 0) {
+      if (atomic_compare_exchange_weak_explicit(
+              &ring_buffer->pop_position, &position, position + 1,
+              memory_order_relaxed, memory_order_relaxed)) {
+        break;
+      }
+    } else if (difference < 0) {
+      // No item pushed at this position yet
+      return 0;
+    } else {
+      position = atomic_load_explicit(&ring_buffer->pop_position,
+                                      memory_order_relaxed);
+    }
+  }
+
+  *item = slot->item;
+
+  // The slot is ready for the push one lap later
+  atomic_store_explicit(&slot->sequence, position + ring_buffer->capacity,
+                        memory_order_release);
+
+  return 1;
+}
\ No newline at end of file
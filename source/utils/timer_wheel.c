@@ -0,0 +1,267 @@
+#include "utils/timer_wheel.h"
+#include "utils/memory.h"
+
+#include <string.h>
+
+/* ********************************************************************** */
+/*                           Static definitions                           */
+/* ********************************************************************** */
+
+/**
+ * @brief Appends a timer to a list of timers.
+ *
+ * @param sentinel Pointer to the sentinel of the list.
+ * @param timer Pointer to the timer to append.
+ */
+static void __link_timer(wheel_timer_t *sentinel, wheel_timer_t *timer);
+
+/**
+ * @brief Removes a timer from its list of timers.
+ *
+ * @param timer Pointer to the timer to remove.
+ */
+static void __unlink_timer(wheel_timer_t *timer);
+
+/**
+ * @brief Moves the timers of a slot to a list of timers.
+ *
+ * @param sentinel Pointer to the sentinel of the list, uninitialized.
+ * @param slot Pointer to the sentinel of the slot, left empty.
+ * @return 1 if the slot had timers, otherwise 0.
+ */
+static int __take_slot(wheel_timer_t *sentinel, wheel_timer_t *slot);
+
+/**
+ * @brief Adds a timer to the slot of the lowest level holding its expiry tick.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param timer Pointer to the timer, not expiring before the current tick.
+ */
+static void __insert_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer);
+
+/**
+ * @brief Moves the timers of the slot of a level reached at the current tick
+ * down to the lower levels.
+ *
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param level Level of the slot, at least 1.
+ */
+static void __cascade_timers(timer_wheel_t *timer_wheel, const size_t level);
+
+/* ********************************************************************** */
+
+int init_timer_wheel(timer_wheel_t *timer_wheel, const size_t card_slots,
+                     const uint64_t current_tick) {
+  size_t slot_bits;
+
+  if (card_slots < 2 || (card_slots & (card_slots - 1)) != 0 ||
+      card_slots > ((size_t) 1 << TIMER_WHEEL_MAX_SLOT_BITS)) {
+    return 0;
+  }
+
+  for (slot_bits = 0; ((size_t) 1 << slot_bits) < card_slots; slot_bits++) {
+  }
+
+  // Allocate slots from the pool
+  timer_wheel->slots = (wheel_timer_t *) pool_alloc(
+      TIMER_WHEEL_LEVELS * card_slots * sizeof(wheel_timer_t));
+  if (timer_wheel->slots == NULL) {
+    return 0;
+  }
+
+  for (size_t index = 0; index < TIMER_WHEEL_LEVELS * card_slots; index++) {
+    timer_wheel->slots[index].previous = &timer_wheel->slots[index];
+    timer_wheel->slots[index].next     = &timer_wheel->slots[index];
+  }
+
+  timer_wheel->card_slots   = card_slots;
+  timer_wheel->slot_bits    = slot_bits;
+  timer_wheel->card_timers  = 0;
+  timer_wheel->current_tick = current_tick;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_timer_wheel(timer_wheel_t *timer_wheel) {
+  // Deallocate slots from the pool
+  pool_dealloc(timer_wheel->slots, TIMER_WHEEL_LEVELS *
+                                       timer_wheel->card_slots *
+                                       sizeof(wheel_timer_t));
+
+  memset(timer_wheel, 0x00, sizeof(timer_wheel_t));
+}
+
+/* ********************************************************************** */
+
+void init_wheel_timer(wheel_timer_t *timer, void (*expire)(wheel_timer_t *),
+                      void *owner) {
+  timer->previous    = NULL;
+  timer->next        = NULL;
+  timer->expiry_tick = 0;
+  timer->owner       = owner;
+  timer->expire      = expire;
+}
+
+/* ********************************************************************** */
+
+void start_wheel_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer,
+                       const uint64_t delay_ticks) {
+  stop_wheel_timer(timer_wheel, timer);
+
+  timer->expiry_tick =
+      timer_wheel->current_tick + (delay_ticks > 0 ? delay_ticks : 1);
+  __insert_timer(timer_wheel, timer);
+  timer_wheel->card_timers++;
+}
+
+/* ********************************************************************** */
+
+void stop_wheel_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer) {
+  if (!is_wheel_timer_running(timer)) {
+    return;
+  }
+
+  __unlink_timer(timer);
+  timer_wheel->card_timers--;
+}
+
+/* ********************************************************************** */
+
+int is_wheel_timer_running(const wheel_timer_t *timer) {
+  return timer->next != NULL;
+}
+
+/* ********************************************************************** */
+
+size_t advance_timer_wheel(timer_wheel_t *timer_wheel,
+                           const uint64_t current_tick) {
+  wheel_timer_t  due;
+  wheel_timer_t *slot;
+  wheel_timer_t *timer;
+  size_t         card_expired;
+
+  card_expired = 0;
+
+  while (timer_wheel->current_tick < current_tick) {
+    // Nothing can expire, jump to the current tick
+    if (timer_wheel->card_timers == 0) {
+      timer_wheel->current_tick = current_tick;
+      break;
+    }
+
+    timer_wheel->current_tick++;
+
+    // Slots of upper levels starting at this tick, the highest level first as
+    // its timers may move to a slot of a lower level starting at this tick too
+    for (size_t level = TIMER_WHEEL_LEVELS - 1; level > 0; level--) {
+      if ((timer_wheel->current_tick &
+           (((uint64_t) 1 << (level * timer_wheel->slot_bits)) - 1)) == 0) {
+        __cascade_timers(timer_wheel, level);
+      }
+    }
+
+    // Move the slot aside, expiry functions may start timers in it
+    slot = &timer_wheel->slots[timer_wheel->current_tick &
+                               (timer_wheel->card_slots - 1)];
+    if (!__take_slot(&due, slot)) {
+      continue;
+    }
+
+    while (due.next != &due) {
+      timer = due.next;
+      __unlink_timer(timer);
+
+      timer_wheel->card_timers--;
+      card_expired++;
+      timer->expire(timer);
+    }
+  }
+
+  return card_expired;
+}
+
+/* ********************************************************************** */
+/*                            Static functions                            */
+/* ********************************************************************** */
+
+static void __link_timer(wheel_timer_t *sentinel, wheel_timer_t *timer) {
+  timer->previous          = sentinel->previous;
+  timer->next              = sentinel;
+  sentinel->previous->next = timer;
+  sentinel->previous       = timer;
+}
+
+/* ********************************************************************** */
+
+static void __unlink_timer(wheel_timer_t *timer) {
+  timer->previous->next = timer->next;
+  timer->next->previous = timer->previous;
+  timer->previous       = NULL;
+  timer->next           = NULL;
+}
+
+/* ********************************************************************** */
+
+static int __take_slot(wheel_timer_t *sentinel, wheel_timer_t *slot) {
+  if (slot->next == slot) {
+    return 0;
+  }
+
+  sentinel->next           = slot->next;
+  sentinel->previous       = slot->previous;
+  sentinel->next->previous = sentinel;
+  sentinel->previous->next = sentinel;
+  slot->next               = slot;
+  slot->previous           = slot;
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+static void __insert_timer(timer_wheel_t *timer_wheel, wheel_timer_t *timer) {
+  size_t level;
+  size_t shift;
+  size_t index;
+
+  // The expiry tick and the current tick share the span of a slot of the next
+  // level up, so that the slot of this level is reached before expiry
+  level = 0;
+  shift = 0;
+  while (level < TIMER_WHEEL_LEVELS - 1 &&
+         (timer->expiry_tick >> (shift + timer_wheel->slot_bits)) !=
+             (timer_wheel->current_tick >> (shift + timer_wheel->slot_bits))) {
+    level++;
+    shift += timer_wheel->slot_bits;
+  }
+
+  index = (size_t) (timer->expiry_tick >> shift) &
+          (timer_wheel->card_slots - 1);
+  __link_timer(&timer_wheel->slots[level * timer_wheel->card_slots + index],
+               timer);
+}
+
+/* ********************************************************************** */
+
+static void __cascade_timers(timer_wheel_t *timer_wheel, const size_t level) {
+  wheel_timer_t  cascaded;
+  wheel_timer_t *timer;
+  size_t         index;
+
+  index = (size_t) (timer_wheel->current_tick >>
+                    (level * timer_wheel->slot_bits)) &
+          (timer_wheel->card_slots - 1);
+  if (!__take_slot(&cascaded,
+                   &timer_wheel->slots[level * timer_wheel->card_slots +
+                                       index])) {
+    return;
+  }
+
+  while (cascaded.next != &cascaded) {
+    timer = cascaded.next;
+    __unlink_timer(timer);
+    __insert_timer(timer_wheel, timer);
+  }
+}
\ No newline at end of file
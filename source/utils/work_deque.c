@@ -0,0 +1,128 @@
+#include "utils/work_deque.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+/* ********************************************************************** */
+
+int init_work_deque(work_deque_t *work_deque, const size_t capacity) {
+  memset(work_deque, 0x00, sizeof(work_deque_t));
+
+  work_deque->capacity = 2;
+  while (work_deque->capacity < capacity) {
+    work_deque->capacity <<= 1;
+  }
+
+  work_deque->items = (_Atomic(void *) *) malloc(work_deque->capacity *
+                                                 sizeof(_Atomic(void *)));
+  if (work_deque->items == NULL) {
+    work_deque->capacity = 0;
+    return 0;
+  }
+
+  for (size_t index = 0; index < work_deque->capacity; index++) {
+    atomic_init(&work_deque->items[index], NULL);
+  }
+  atomic_init(&work_deque->top, 0);
+  atomic_init(&work_deque->bottom, 0);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+void destroy_work_deque(work_deque_t *work_deque) {
+  free(work_deque->items);
+  work_deque->items    = NULL;
+  work_deque->capacity = 0;
+}
+
+/* ********************************************************************** */
+
+size_t get_work_deque_size(work_deque_t *work_deque) {
+  ptrdiff_t size;
+
+  size = atomic_load_explicit(&work_deque->bottom, memory_order_relaxed) -
+         atomic_load_explicit(&work_deque->top, memory_order_relaxed);
+
+  return size > 0 ? (size_t) size : 0;
+}
+
+/* ********************************************************************** */
+
+int work_deque_push(work_deque_t *work_deque, void *item) {
+  ptrdiff_t bottom;
+  ptrdiff_t top;
+
+  bottom = atomic_load_explicit(&work_deque->bottom, memory_order_relaxed);
+  top    = atomic_load_explicit(&work_deque->top, memory_order_acquire);
+  if ((size_t) (bottom - top) >= work_deque->capacity) {
+    return 0;
+  }
+
+  atomic_store_explicit(
+      &work_deque->items[(size_t) bottom & (work_deque->capacity - 1)], item,
+      memory_order_relaxed);
+  atomic_thread_fence(memory_order_release);
+  atomic_store_explicit(&work_deque->bottom, bottom + 1, memory_order_relaxed);
+
+  return 1;
+}
+
+/* ********************************************************************** */
+
+int work_deque_pop(work_deque_t *work_deque, void **item) {
+  ptrdiff_t bottom;
+  ptrdiff_t top;
+  int       popped;
+
+  // Claims the bottom item before looking at the top, a thief then sees it
+  // gone or the owner sees the thief
+  bottom = atomic_load_explicit(&work_deque->bottom, memory_order_relaxed) - 1;
+  atomic_store_explicit(&work_deque->bottom, bottom, memory_order_relaxed);
+  atomic_thread_fence(memory_order_seq_cst);
+  top = atomic_load_explicit(&work_deque->top, memory_order_relaxed);
+
+  if (top > bottom) {
+    atomic_store_explicit(&work_deque->bottom, bottom + 1,
+                          memory_order_relaxed);
+    return 0;
+  }
+
+  *item  = atomic_load_explicit(
+      &work_deque->items[(size_t) bottom & (work_deque->capacity - 1)],
+      memory_order_relaxed);
+  popped = 1;
+  if (top == bottom) {
+    // The last item, the owner and the thieves race for the top
+    popped = atomic_compare_exchange_strong_explicit(
+        &work_deque->top, &top, top + 1, memory_order_seq_cst,
+        memory_order_relaxed);
+    atomic_store_explicit(&work_deque->bottom, bottom + 1,
+                          memory_order_relaxed);
+  }
+
+  return popped;
+}
+
+/* ********************************************************************** */
+
+int work_deque_steal(work_deque_t *work_deque, void **item) {
+  ptrdiff_t top;
+  ptrdiff_t bottom;
+
+  top = atomic_load_explicit(&work_deque->top, memory_order_acquire);
+  atomic_thread_fence(memory_order_seq_cst);
+  bottom = atomic_load_explicit(&work_deque->bottom, memory_order_acquire);
+  if (top >= bottom) {
+    return 0;
+  }
+
+  *item = atomic_load_explicit(
+      &work_deque->items[(size_t) top & (work_deque->capacity - 1)],
+      memory_order_relaxed);
+
+  return atomic_compare_exchange_strong_explicit(
+      &work_deque->top, &top, top + 1, memory_order_seq_cst,
+      memory_order_relaxed);
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include <stdint.h>
+#include <stdio.h>
+
+/* ********************************************************************** */
+
+/**
+ * @brief Context of the code generator tests, written to the Context file given
+ * as argument at build time. The Rule 0 covers the Matching Operators
+ * MO_EQUAL, MO_IGNORE and MO_MATCH_MAPPING, the Rule 1 MO_MSB with CDA_LSB,
+ * the Rule 2 CDA_COMPUTE, the Rules 3 and 4 the Packet Directions and the CoAP
+ * Fields. The Rule 5 is the no-compression Rule.
+ */
+const uint8_t context[] = {
+    // Context
+    0, 6, 0, 14, 0, 39, 0, 54, 0, 65, 0, 72, 0, 81,
+
+    // Rule Descriptors
+    0, 0, 11, 0, 84, 0, 94, 0, 102, 0, 112, 0, 126, 0,
+    136, 0, 144, 0, 154, 0, 162, 0, 172, 0, 186,  // Rule Descriptor n° 0
+    1, 0, 6, 0, 196, 0, 206, 0, 218, 0, 230, 0, 242, 0,
+    254,                                          // Rule Descriptor n° 1
+    2, 0, 4, 1, 10, 1, 20, 1, 28, 1, 36,          // Rule Descriptor n° 2
+    3, 0, 2, 1, 44, 1, 54,                        // Rule Descriptor n° 3
+    4, 0, 3, 1, 64, 1, 72, 1, 80,                 // Rule Descriptor n° 4
+    5, 1, 0,                                      // Rule Descriptor n° 5
+
+    // Rule Field Descriptors
+    0x13, 0xcc, 0, 4, 0, 0, 64, 1, 1, 90,            // sid-ipv6-version
+                                                     // bi/eq/ns
+    0x13, 0xc9, 0, 8, 0, 0, 75, 0,                   // sid-ipv6-traffic-class
+                                                     // bi/ig/vs
+    0x13, 0xc5, 0, 13, 0, 0, 64, 1, 1, 91,           // sid-ipv6-flow-label
+                                                     // bi/eq/ns
+    0x13, 0xc7, 0, 8, 0, 0, 90, 3, 1, 93, 1, 94, 1,
+    95,                                              // sid-ipv6-next-header
+                                                     // bi/mm/ms
+    0x13, 0xc6, 0, 8, 0, 0, 0, 1, 1, 96,             // sid-ipv6-hop-limit
+                                                     // up/eq/ns
+    0x13, 0xc6, 0, 8, 0, 0, 43, 0,                   // sid-ipv6-hop-limit
+                                                     // dw/ig/vs
+    0x13, 0xc1, 0, 128, 0, 0, 64, 1, 1, 97,          // sid-ipv6-app-prefix
+                                                     // bi/eq/ns
+    0x13, 0xc4, 0, 64, 0, 0, 75, 0,                  // sid-ipv6-dev-prefix
+                                                     // bi/ig/vs
+    0x13, 0xce, 0, 3, 0, 0, 90, 1, 1, 113,           // sid-udp-app-port
+                                                     // bi/mm/ms
+    0x13, 0xd1, 0, 72, 0, 0, 90, 3, 1, 114, 1, 123,
+    1, 132,                                          // sid-udp-dev-port
+                                                     // bi/mm/ms
+    0x13, 0xd2, 0, 7, 0, 0, 64, 1, 1, 141,           // sid-udp-length
+                                                     // bi/eq/ns
+    0x13, 0xcc, 0, 4, 0, 0, 64, 1, 1, 142,           // sid-ipv6-version
+                                                     // bi/eq/ns
+    0x13, 0xc5, 0, 20, 0, 0, 81, 0, 12, 1, 1, 143,   // sid-ipv6-flow-label
+                                                     // bi/msb(12)/lsb
+    0x13, 0xce, 0, 16, 0, 0, 81, 0, 12, 1, 1, 145,   // sid-udp-app-port
+                                                     // bi/msb(12)/lsb
+    0x13, 0xc1, 0, 100, 0, 0, 81, 0, 90, 1, 1, 147,  // sid-ipv6-app-prefix
+                                                     // bi/msb(90)/lsb
+    0x13, 0xc6, 0, 5, 0, 0, 17, 0, 1, 1, 1, 159,     // sid-ipv6-hop-limit
+                                                     // up/msb(1)/lsb
+    0x13, 0xc9, 0, 8, 0, 0, 49, 0, 8, 1, 1, 160,     // sid-ipv6-traffic-class
+                                                     // dw/msb(8)/lsb
+    0x13, 0xcc, 0, 4, 0, 0, 64, 1, 1, 161,           // sid-ipv6-version
+                                                     // bi/eq/ns
+    0x13, 0xc9, 0, 8, 0, 0, 75, 0,                   // sid-ipv6-traffic-class
+                                                     // bi/ig/vs
+    0x13, 0xc8, 0, 16, 0, 0, 76, 0,                  // sid-ipv6-payload-length
+                                                     // bi/ig/cp
+    0x13, 0xc5, 0, 20, 0, 0, 75, 0,                  // sid-ipv6-flow-label
+                                                     // bi/ig/vs
+    0x13, 0xcc, 0, 4, 0, 0, 32, 1, 1, 162,           // sid-ipv6-version
+                                                     // dw/eq/ns
+    0x13, 0xc9, 0, 8, 0, 0, 64, 1, 1, 163,           // sid-ipv6-traffic-class
+                                                     // bi/eq/ns
+    0x13, 0xbc, 0, 4, 0, 0, 11, 0,                   // sid-coap-tkl
+                                                     // up/ig/vs
+    0x13, 0xbd, 0, 0, 0, 0, 11, 0,                   // sid-coap-token
+                                                     // up/ig/vs
+    0x13, 0xcc, 0, 4, 0, 0, 64, 1, 1, 164,           // sid-ipv6-version
+                                                     // bi/eq/ns
+
+    // Target Values
+    0x06,                                // Version of the Rule 0
+    0x05, 0x45,                          // Flow Label of the Rule 0
+    0x11,                                // Next Header of the Rule 0
+    0x06,                                // Next Header of the Rule 0
+    0x11,                                // Next Header of the Rule 0
+    0xff,                                // Hop Limit of the Rule 0
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x20,              // Application Prefix of the Rule 0
+    0x05,                                // Application Port of the Rule 0
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0xf0,                    // Device Port of the Rule 0
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+    0x07, 0x08, 0xf1,                    // Device Port of the Rule 0
+    0xff, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0xa5,                    // Device Port of the Rule 0
+    0x01,                                // UDP Length of the Rule 0
+    0x06,                                // Version of the Rule 1
+    0x0a, 0xbc,                          // Flow Label of the Rule 1
+    0x01, 0x63,                          // Application Port of the Rule 1
+    0x02, 0x11, 0x22, 0x33, 0x44, 0x55,
+    0x66, 0x77, 0x88, 0x99, 0x00, 0xaa,  // Application Prefix of the Rule 1
+    0x01,                                // Hop Limit of the Rule 1
+    0x00,                                // Traffic Class of the Rule 1
+    0x06,                                // Version of the Rule 2
+    0x06,                                // Version of the Rule 3
+    0x00,                                // Traffic Class of the Rule 3
+    0x07                                 // Version of the Rule 4
+};
+
+/* ********************************************************************** */
+
+int main(int argc, char *argv[]) {
+  FILE *file;
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s <context file>\n", argv[0]);
+    return 1;
+  }
+
+  file = fopen(argv[1], "wb");
+  if (file == NULL) {
+    perror(argv[1]);
+    return 1;
+  }
+
+  if (fwrite(context, 1, sizeof(context), file) != sizeof(context)) {
+    perror(argv[1]);
+    fclose(file);
+    return 1;
+  }
+
+  return fclose(file) == 0 ? 0 : 1;
+}
\ No newline at end of file
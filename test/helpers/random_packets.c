@@ -0,0 +1,36 @@
+#include "random_packets.h"
+
+#define CARD_CODEGEN_RULES 6
+
+/* ********************************************************************** */
+
+static uint32_t random_state = 4242;
+
+/* ********************************************************************** */
+
+uint8_t random_byte(void) {
+  random_state = random_state * 1103515245u + 12345u;
+  return (uint8_t) (random_state >> 16);
+}
+
+/* ********************************************************************** */
+
+size_t random_schc_packet(uint8_t *schc_packet, const size_t min_byte_len,
+                          const size_t max_byte_len) {
+  size_t  schc_packet_byte_len;
+  uint8_t rule_id;
+
+  schc_packet_byte_len =
+      min_byte_len + random_byte() % (max_byte_len - min_byte_len + 1);
+  for (size_t index_byte = 0; index_byte < schc_packet_byte_len; index_byte++) {
+    schc_packet[index_byte] = random_byte();
+  }
+
+  // The Rule ID takes the 3 first bits
+  rule_id = random_byte() % CARD_CODEGEN_RULES;
+  if (schc_packet_byte_len > 0) {
+    schc_packet[0] = (uint8_t) ((rule_id << 5) | (schc_packet[0] & 0x1f));
+  }
+
+  return schc_packet_byte_len;
+}
\ No newline at end of file
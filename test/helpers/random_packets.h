@@ -0,0 +1,42 @@
+/**
+ * @file random_packets.h
+ * @author Corentin Banier and Quentin Lampin
+ * @brief Reproducible random bytes and SCHC Packets for the CSCHC tests.
+ * @version 1.0
+ * @date 2024-08-26
+ *
+ * @details The SCHC Packets carry the Rule ID of one of the 6 Rules of the
+ * code generator test Context, test/contexts/codegen_context.c, on their 3
+ * first bits, the rest of their bits being random.
+ *
+ * @copyright Copyright (c) Orange 2024. This project is released under the MIT
+ * License.
+ *
+ */
+
+#ifndef _RANDOM_PACKETS_H_
+#define _RANDOM_PACKETS_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Returns a byte from a linear congruential generator, so that runs are
+ * reproducible.
+ *
+ * @return The random byte.
+ */
+uint8_t random_byte(void);
+
+/**
+ * @brief Writes a random SCHC Packet of the code generator test Context.
+ *
+ * @param schc_packet Pointer to the SCHC Packet to write.
+ * @param min_byte_len The minimal byte length of the SCHC Packet.
+ * @param max_byte_len The maximal byte length of the SCHC Packet.
+ * @return The byte length of the SCHC Packet.
+ */
+size_t random_schc_packet(uint8_t *schc_packet, const size_t min_byte_len,
+                          const size_t max_byte_len);
+
+#endif  // _RANDOM_PACKETS_H_
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "core/actions.h"
+#include "utils/binary.h"
 #include "utils/memory.h"
 
 #include <assert.h>
@@ -292,6 +293,65 @@ void test_CDA_least_significant_bits(void) {
 
 /* ********************************************************************** */
 
+void test_CDA_least_significant_bits_lengths(void) {
+  /**
+   * @brief Test CDA_least_significant_bits on Fields of 2 to 136 bits, through
+   * its 64-bit, 128-bit and byte paths, against the last bytes of the Field
+   * masked on the LSB length.
+   */
+  rule_field_descriptor_t rule_field_descriptor;
+  uint8_t                 field[17];
+  uint8_t                 target_value[17];
+  uint8_t                 field_residue[17];
+  uint8_t                 expected_field_residue[17];
+  size_t                  field_byte_len;
+  size_t                  residue_byte_len;
+  size_t                  msb_field_byte_len;
+  size_t                  lsb_len;
+  uint32_t                seed;
+
+  memset(&rule_field_descriptor, 0x00, sizeof(rule_field_descriptor_t));
+  rule_field_descriptor.first_target_value_offset = 0;
+
+  seed = 1;
+  for (uint16_t len = 2; len <= 136; len++) {
+    for (uint16_t msb_len = 1; msb_len < len; msb_len++) {
+      rule_field_descriptor.len     = len;
+      rule_field_descriptor.msb_len = msb_len;
+      field_byte_len                = BYTE_LENGTH(len);
+      lsb_len                       = len - msb_len;
+      residue_byte_len              = BYTE_LENGTH(lsb_len);
+
+      for (size_t index = 0; index < field_byte_len; index++) {
+        seed         = seed * 1103515245 + 12345;
+        field[index] = seed >> 16;
+      }
+
+      // The MSB of the Field as Target Value
+      memcpy(target_value, field, field_byte_len);
+      msb_field_byte_len = right_shift(target_value, field_byte_len, lsb_len);
+      if (msb_len % 8 != 0) {
+        target_value[0] &= (1 << (msb_len % 8)) - 1;
+      }
+      assert(msb_field_byte_len > 0);
+
+      memcpy(expected_field_residue,
+             field + field_byte_len - residue_byte_len, residue_byte_len);
+      if (lsb_len % 8 != 0) {
+        expected_field_residue[0] &= (1 << (lsb_len % 8)) - 1;
+      }
+
+      assert(CDA_least_significant_bits(field_residue, field,
+                                        &rule_field_descriptor, target_value,
+                                        sizeof(target_value)));
+      assert(memcmp(field_residue, expected_field_residue,
+                    residue_byte_len) == 0);
+    }
+  }
+}
+
+/* ********************************************************************** */
+
 void test_CDA_mapping_sent(void) {
   const uint8_t short_context[] = {
       // ...
@@ -432,6 +492,7 @@ int main(void) {
 
   init_memory_pool();
   test_CDA_least_significant_bits();  // Needs the pool to be allocated
+  test_CDA_least_significant_bits_lengths();
   destroy_memory_pool();
 
   test_CDA_mapping_sent();
@@ -0,0 +1,286 @@
+#include "core/async_compressor.h"
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/context_loader.h"
+#include "core/decompression.h"
+#include "helpers/random_packets.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_WORKERS        2
+#define MAX_IN_FLIGHT       16
+#define CARD_PACKETS        4096
+#define MAX_PACKET_BYTE_LEN 128
+
+/* ********************************************************************** */
+
+validated_context_t validated_context;
+compiled_context_t *compiled_context;
+pthread_t           loop_thread;
+
+async_compressor_t *async_compressor;
+_Atomic size_t      card_callbacks;
+
+uint8_t         packets[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+size_t          packet_byte_lens[CARD_PACKETS];
+uint8_t         outputs[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+async_request_t requests[CARD_PACKETS];
+
+/* ********************************************************************** */
+
+/**
+ * @brief Counts the requests completed by callback, from a worker thread.
+ */
+void count_completion(async_request_t *request, void *user_data) {
+  assert(user_data == &card_callbacks);
+  assert(request->callback == count_completion);
+  assert(!pthread_equal(pthread_self(), loop_thread));
+  assert(atomic_load(&async_compressor->card_in_flight) <= MAX_IN_FLIGHT);
+  atomic_fetch_add(&card_callbacks, 1);
+}
+
+/**
+ * @brief Counts the requests completed by callback, and checks that the pool
+ * of the worker, which lives as long as its thread, holds nothing.
+ */
+void check_worker_pool(async_request_t *request, void *user_data) {
+  assert(user_data == &card_callbacks);
+  assert(request->callback == check_worker_pool);
+  assert(pool != NULL && pool->used == 0);
+  atomic_fetch_add(&card_callbacks, 1);
+}
+
+/* ********************************************************************** */
+
+void test_async_compressor(void) {
+  /**
+   * @brief Test that an event loop submitting downlink compressions and uplink
+   * decompressions, half with a callback and half polled, gets them all
+   * completed with the results of the single-threaded calls, and that the
+   * descriptor signals completions and the end of the backpressure.
+   */
+
+  struct pollfd    poll_fd;
+  async_request_t *request;
+  uint8_t          schc_packet[MAX_PACKET_BYTE_LEN];
+  uint8_t          output[MAX_PACKET_BYTE_LEN];
+  size_t           schc_packet_byte_len;
+  size_t           output_byte_len;
+  size_t           card_submitted;
+  size_t           card_polled;
+  size_t           card_refused;
+  size_t           card_compressed;
+  size_t           index;
+
+  // The first half are the decompression of random SCHC Packets, in DI_DW, the
+  // second half SCHC Packets.
+  index = 0;
+  while (index < CARD_PACKETS) {
+    schc_packet_byte_len = random_schc_packet(schc_packet, 1, 63);
+
+    if (index < CARD_PACKETS / 2) {
+      packet_byte_lens[index] = decompress_compiled(
+          packets[index], MAX_PACKET_BYTE_LEN, DI_DW, schc_packet,
+          schc_packet_byte_len, compiled_context);
+      if (packet_byte_lens[index] == 0) {
+        continue;
+      }
+    } else {
+      memcpy(packets[index], schc_packet, schc_packet_byte_len);
+      packet_byte_lens[index] = schc_packet_byte_len;
+    }
+    index++;
+  }
+
+  // Compressions and decompressions alternate, callbacks every other pair
+  for (index = 0; index < CARD_PACKETS; index++) {
+    request                      = &requests[index];
+    request->compiled_context    = compiled_context;
+    request->decompression       = index % 2;
+    request->direction           = request->decompression ? DI_UP : DI_DW;
+    request->packet              = packets[index / 2 + (index % 2) *
+                                                          (CARD_PACKETS / 2)];
+    request->packet_byte_len     = packet_byte_lens[index / 2 + (index % 2) *
+                                                          (CARD_PACKETS / 2)];
+    request->output              = outputs[index];
+    request->output_max_byte_len = MAX_PACKET_BYTE_LEN;
+    request->callback            = (index / 2) % 2 ? count_completion : NULL;
+    request->user_data           = &card_callbacks;
+  }
+
+  loop_thread = pthread_self();
+  atomic_init(&card_callbacks, 0);
+  async_compressor = create_async_compressor(CARD_WORKERS, MAX_IN_FLIGHT);
+  assert(async_compressor != NULL);
+  poll_fd.fd     = get_async_compressor_fd(async_compressor);
+  poll_fd.events = POLLIN;
+
+  // The event loop submits until refused, then waits for the descriptor
+  card_submitted = 0;
+  card_polled    = 0;
+  card_refused   = 0;
+  while (card_polled + atomic_load(&card_callbacks) < CARD_PACKETS) {
+    while (card_submitted < CARD_PACKETS) {
+      if (!submit_async_request(async_compressor,
+                                &requests[card_submitted])) {
+        card_refused++;
+        break;
+      }
+      card_submitted++;
+    }
+
+    // Without refusal, the last requests may all complete by callback
+    if (card_submitted < CARD_PACKETS) {
+      assert(poll(&poll_fd, 1, 1000) == 1);
+    } else {
+      poll(&poll_fd, 1, 10);
+    }
+    while ((request = poll_async_completion(async_compressor)) != NULL) {
+      assert(request->callback == NULL);
+      card_polled++;
+    }
+  }
+
+  assert(card_refused > 0);
+  assert(card_polled == CARD_PACKETS / 2);
+  assert(atomic_load(&card_callbacks) == CARD_PACKETS / 2);
+  assert(atomic_load(&async_compressor->card_in_flight) == 0);
+  assert(poll_async_completion(async_compressor) == NULL);
+  assert(poll(&poll_fd, 1, 0) == 0);
+  destroy_async_compressor(async_compressor);
+
+  card_compressed = 0;
+  for (index = 0; index < CARD_PACKETS; index++) {
+    request = &requests[index];
+    if (request->decompression) {
+      output_byte_len = decompress_compiled(
+          output, sizeof(output), DI_UP, request->packet,
+          request->packet_byte_len, compiled_context);
+    } else {
+      output_byte_len = compress_compiled(output, sizeof(output), DI_DW,
+                                          request->packet,
+                                          request->packet_byte_len,
+                                          compiled_context);
+      card_compressed += output_byte_len > 0;
+    }
+    assert(request->output_byte_len == output_byte_len);
+    assert(memcmp(request->output, output, output_byte_len) == 0);
+  }
+  assert(card_compressed > 0);
+
+  assert(create_async_compressor(0, MAX_IN_FLIGHT) == NULL);
+  assert(create_async_compressor(ASYNC_MAX_WORKERS + 1, MAX_IN_FLIGHT) ==
+         NULL);
+  assert(create_async_compressor(CARD_WORKERS, 0) == NULL);
+}
+
+/* ********************************************************************** */
+
+void test_malformed_requests(void) {
+  /**
+   * @brief Test that truncated packets and SCHC Packets, among valid ones,
+   * leave nothing in the pools of the workers, and that every request still
+   * gets the result of the single-threaded calls.
+   *
+   * @details Uses the packets of test_async_compressor().
+   */
+
+  struct pollfd    poll_fd;
+  async_request_t *request;
+  uint8_t          output[MAX_PACKET_BYTE_LEN];
+  size_t           output_byte_len;
+  size_t           card_submitted;
+  size_t           card_truncated;
+  size_t           card_compressed;
+  size_t           index;
+  size_t           index_packet;
+  uint32_t         random_state;
+
+  // Every fourth pair of requests is valid, the others cut their packet short
+  random_state   = 1;
+  card_truncated = 0;
+  for (index = 0; index < CARD_PACKETS; index++) {
+    request                      = &requests[index];
+    index_packet                 = index / 2 + (index % 2) * (CARD_PACKETS / 2);
+    request->compiled_context    = compiled_context;
+    request->decompression       = index % 2;
+    request->direction           = request->decompression ? DI_UP : DI_DW;
+    request->packet              = packets[index_packet];
+    request->packet_byte_len     = packet_byte_lens[index_packet];
+    request->output              = outputs[index];
+    request->output_max_byte_len = MAX_PACKET_BYTE_LEN;
+    request->callback            = check_worker_pool;
+    request->user_data           = &card_callbacks;
+    if ((index / 2) % 4 != 3) {
+      random_state             = random_state * 1103515245u + 12345u;
+      request->packet_byte_len = (random_state >> 16) %
+                                 packet_byte_lens[index_packet];
+      card_truncated++;
+    }
+  }
+
+  atomic_init(&card_callbacks, 0);
+  async_compressor = create_async_compressor(CARD_WORKERS, MAX_IN_FLIGHT);
+  assert(async_compressor != NULL);
+  poll_fd.fd     = get_async_compressor_fd(async_compressor);
+  poll_fd.events = POLLIN;
+
+  card_submitted = 0;
+  while (atomic_load(&card_callbacks) < CARD_PACKETS) {
+    while (card_submitted < CARD_PACKETS &&
+           submit_async_request(async_compressor,
+                                &requests[card_submitted])) {
+      card_submitted++;
+    }
+    poll(&poll_fd, 1, 10);
+    assert(poll_async_completion(async_compressor) == NULL);
+  }
+  destroy_async_compressor(async_compressor);
+
+  card_compressed = 0;
+  for (index = 0; index < CARD_PACKETS; index++) {
+    request = &requests[index];
+    if (request->decompression) {
+      output_byte_len = decompress_compiled(
+          output, sizeof(output), DI_UP, request->packet,
+          request->packet_byte_len, compiled_context);
+    } else {
+      output_byte_len = compress_compiled(output, sizeof(output), DI_DW,
+                                          request->packet,
+                                          request->packet_byte_len,
+                                          compiled_context);
+      card_compressed += (index / 2) % 4 == 3 && output_byte_len > 0;
+    }
+    assert(request->output_byte_len == output_byte_len);
+    assert(memcmp(request->output, output, output_byte_len) == 0);
+  }
+  assert(card_truncated == 3 * CARD_PACKETS / 4);
+  assert(card_compressed > 0);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  assert(load_context_file(&validated_context, CODEGEN_CONTEXT_FILE));
+  compiled_context = compile_context(validated_context.context,
+                                     validated_context.context_byte_len);
+  assert(compiled_context != NULL);
+
+  test_async_compressor();
+  test_malformed_requests();
+
+  free_compiled_context(compiled_context);
+  unload_context_file(&validated_context);
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
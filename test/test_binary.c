@@ -163,6 +163,116 @@ void test_add_bits_to_buffer(void) {
   assert(!add_bits_to_buffer(buffer, buffer_byte_len, &bit_pos, content1, 4));
 }
 
+/* ********************************************************************** */
+
+void test_write_bits_to_buffer(void) {
+  uint8_t  added[16];
+  uint8_t  written[16];
+  uint8_t  content[3];
+  size_t   added_bit_pos;
+  size_t   written_bit_pos;
+  size_t   content_len;
+  uint32_t random_state;
+
+  const uint8_t expected_buffer[] = {0x6d, 0xc5, 0x4e, 0x1f, 0xf8};
+
+  // The example of add_bits_to_buffer, over bits that are all set
+  memset(written, 0xff, sizeof(written));
+  written_bit_pos = 0;
+  assert(write_byte_to_buffer(written, 5, &written_bit_pos, 0x06, 4));
+  assert(written[0] == 0x60);
+  content[0] = 0x1b;
+  assert(write_bits_to_buffer(written, 5, &written_bit_pos, content, 5));
+  content[0] = 0x08;
+  content[1] = 0xa9;
+  content[2] = 0xc3;
+  assert(write_bits_to_buffer(written, 5, &written_bit_pos, content, 20));
+  content[0] = 0xff;
+  assert(write_bits_to_buffer(written, 5, &written_bit_pos, content, 8));
+  assert(written_bit_pos == 37);
+  assert(memcmp(expected_buffer, written, 5) == 0);
+  assert(!write_bits_to_buffer(written, 5, &written_bit_pos, content, 4));
+  assert(!write_byte_to_buffer(written, 5, &written_bit_pos, 0x00, 9));
+  assert(written_bit_pos == 37);
+
+  // Random writes, the bits of the contents beyond their length included, over
+  // what a first round left give the same bytes as adding them to zeroes
+  random_state = 42;
+  for (int round = 0; round < 1000; round++) {
+    memset(added, 0x00, sizeof(added));
+    added_bit_pos = 0;
+    for (int pass = 0; pass < 2; pass++) {
+      written_bit_pos = 0;
+      random_state    = random_state * 1103515245u + 12345u;
+      while (written_bit_pos < 8 * sizeof(written) - 24) {
+        random_state = random_state * 1103515245u + 12345u;
+        content_len  = (random_state >> 16) % 25;
+        content[0]   = (uint8_t) (random_state >> 8);
+        content[1]   = (uint8_t) (random_state >> 24);
+        content[2]   = (uint8_t) random_state;
+        if (pass == 1) {
+          assert(add_bits_to_buffer(added, sizeof(added), &added_bit_pos,
+                                    content, content_len));
+        }
+        assert(write_bits_to_buffer(written, sizeof(written),
+                                    &written_bit_pos, content, content_len));
+      }
+    }
+    assert(added_bit_pos == written_bit_pos);
+    assert(memcmp(added, written, BYTE_LENGTH(written_bit_pos)) == 0);
+  }
+}
+
+/* ********************************************************************** */
+
+void test_write_variable_length(void) {
+  uint8_t buffer[5];
+  size_t  bit_position;
+
+  /**
+   * @brief Writes 14, 15 and 254 from bit_pos = 2.
+   *
+   * @details The lengths take 4, 12 and 12 bits:
+   * - buffer = 0b00111011 0b11000011 0b11111111 0b11111000
+   * - bit_position = 2 + 4 + 12 + 12 = 30
+   */
+  const uint8_t expected_buffer1[] = {0x3b, 0xc3, 0xff, 0xf8};
+  memset(buffer, 0x00, sizeof(buffer));
+  bit_position = 2;
+  assert(write_variable_length(buffer, sizeof(buffer), &bit_position, 14));
+  assert(bit_position == 6);
+  assert(write_variable_length(buffer, sizeof(buffer), &bit_position, 15));
+  assert(bit_position == 18);
+  assert(write_variable_length(buffer, sizeof(buffer), &bit_position, 254));
+  assert(bit_position == 30);
+  assert(memcmp(buffer, expected_buffer1, sizeof(expected_buffer1)) == 0);
+
+  /**
+   * @brief Writes 255 from bit_pos = 0.
+   *
+   * @details The length takes 28 bits: buffer = 0xff 0xf0 0x0f 0xf0.
+   */
+  const uint8_t expected_buffer2[] = {0xff, 0xf0, 0x0f, 0xf0};
+  memset(buffer, 0x00, sizeof(buffer));
+  bit_position = 0;
+  assert(write_variable_length(buffer, sizeof(buffer), &bit_position, 255));
+  assert(bit_position == 28);
+  assert(memcmp(buffer, expected_buffer2, sizeof(expected_buffer2)) == 0);
+
+  /**
+   * @brief Writes 255 from bit_pos = 28, and 0x10000 from bit_pos = 0.
+   *
+   * @details The buffer is too short for the first, the second does not fit in
+   * 16 bits: both fail and leave bit_position untouched.
+   */
+  assert(!write_variable_length(buffer, sizeof(buffer), &bit_position, 255));
+  assert(bit_position == 28);
+  bit_position = 0;
+  assert(!write_variable_length(buffer, sizeof(buffer), &bit_position,
+                                0x10000));
+  assert(bit_position == 0);
+}
+
 /* ********************************************************************** */
 /*                               Extraction                               */
 /* ********************************************************************** */
@@ -269,6 +379,117 @@ void test_extract_bits(void) {
   assert(bit_position == 40);
 }
 
+/* ********************************************************************** */
+
+void test_load_bits(void) {
+  const uint8_t buffer[]        = {0x6d, 0xc5, 0x4e, 0x1f, 0xf8,
+                                   0x01, 0x23, 0x45, 0x67, 0x89};
+  const size_t  buffer_byte_len = sizeof(buffer);
+
+  /**
+   * @brief Loads on buffer = 0x6dc54e1ff80123456789.
+   *
+   * @details From bit_pos = 0 and 8, a single 8-byte load is performed.
+   */
+  assert(load_bits(buffer, buffer_byte_len, 0) == 0x6dc54e1ff8012345);
+  assert(load_bits(buffer, buffer_byte_len, 8) == 0xc54e1ff801234567);
+
+  /**
+   * @brief Loads on buffer = 0x6dc54e1ff80123456789.
+   *
+   * @details From bit_pos = 4, the last 4 bits are not loaded and read as 0.
+   */
+  assert(load_bits(buffer, buffer_byte_len, 4) == 0xdc54e1ff80123450);
+
+  /**
+   * @brief Loads on buffer = 0x6dc54e1ff80123456789.
+   *
+   * @details From bit_pos = 60, the bits beyond the buffer read as 0.
+   */
+  assert(load_bits(buffer, buffer_byte_len, 60) == 0x5678900000000000);
+}
+
+/* ********************************************************************** */
+
+void test_read_variable_length(void) {
+  size_t variable_len;
+  size_t bit_position;
+
+  /**
+   * @brief Reads 0b1110, 0b1111 0x0f and 0b1111 0xff 0x0100 from bit_pos = 2.
+   *
+   * @details The lengths are 14 on 4 bits, 15 on 12 bits and 256 on 28 bits.
+   */
+  const uint8_t buffer[] = {0x3b, 0xc3, 0xff, 0xfc, 0x04, 0x00};
+  const size_t  buffer_byte_len = sizeof(buffer);
+
+  bit_position = 2;
+  assert(read_variable_length(&variable_len, &bit_position, buffer,
+                              buffer_byte_len));
+  assert(variable_len == 14);
+  assert(bit_position == 6);
+
+  assert(read_variable_length(&variable_len, &bit_position, buffer,
+                              buffer_byte_len));
+  assert(variable_len == 15);
+  assert(bit_position == 18);
+
+  assert(read_variable_length(&variable_len, &bit_position, buffer,
+                              buffer_byte_len));
+  assert(variable_len == 256);
+  assert(bit_position == 46);
+
+  /**
+   * @brief Reads a 28-bit prefix from a 24-bit buffer.
+   *
+   * @details The prefix is truncated, bit_position is left untouched.
+   */
+  const uint8_t truncated_buffer[] = {0xff, 0xf0, 0x10};
+  bit_position                     = 0;
+  assert(!read_variable_length(&variable_len, &bit_position, truncated_buffer,
+                               sizeof(truncated_buffer)));
+  assert(bit_position == 0);
+}
+
+/* ********************************************************************** */
+
+void test_variable_length_round_trip(void) {
+  uint8_t buffer[8];
+  size_t  write_bit_position;
+  size_t  read_bit_position;
+  size_t  variable_len;
+  size_t  expected_prefix_len;
+
+  /**
+   * @brief Writes then reads every length from 0 to 0xffff, from every bit
+   * offset of a byte, followed by a byte of 1s.
+   *
+   * @details The length is read back on the same number of bits, 4 below 15,
+   * 12 below 255 and 28 otherwise, and the following bits are left untouched.
+   */
+  for (size_t len = 0; len <= 0xffff; len++) {
+    expected_prefix_len = (len < 15) ? 4 : (len < 255) ? 12 : 28;
+
+    for (size_t offset = 0; offset < 8; offset++) {
+      memset(buffer, 0x00, sizeof(buffer));
+      write_bit_position = offset;
+      assert(write_variable_length(buffer, sizeof(buffer), &write_bit_position,
+                                   len));
+      assert(write_bit_position == offset + expected_prefix_len);
+      assert(add_byte_to_buffer(buffer, sizeof(buffer), &write_bit_position,
+                                0xff, 8));
+
+      read_bit_position = offset;
+      assert(read_variable_length(&variable_len, &read_bit_position, buffer,
+                                  sizeof(buffer)));
+      assert(variable_len == len);
+      assert(read_bit_position == offset + expected_prefix_len);
+      assert(load_bits(buffer, sizeof(buffer), read_bit_position) >> 56 ==
+             0xff);
+    }
+  }
+}
+
 /* ********************************************************************** */
 /*                                Other(s)                                */
 /* ********************************************************************** */
@@ -368,15 +589,71 @@ void test_merge_uint8_t(void) {
 
 /* ********************************************************************** */
 
+void test_load_store_uint64_t(void) {
+  const uint8_t buffer[] = {0x6d, 0xc5, 0x4e, 0x1f, 0xf8, 0x01, 0x23, 0x45};
+  uint8_t       stored[8];
+
+  /**
+   * @brief Loads on buffer = 0x6dc54e1ff8012345.
+   *
+   * @details The value is read big-endian on the given byte length.
+   */
+  assert(load_uint64_t(buffer, 0) == 0);
+  assert(load_uint64_t(buffer, 3) == 0x6dc54e);
+  assert(load_uint64_t(buffer, 8) == 0x6dc54e1ff8012345);
+
+  /**
+   * @brief Stores 0x6dc54e1ff8012345 on 2 and 8 bytes.
+   *
+   * @details Only the least significant bytes are stored.
+   */
+  memset(stored, 0x00, sizeof(stored));
+  store_uint64_t(stored, 2, 0x6dc54e1ff8012345);
+  assert(stored[0] == 0x23 && stored[1] == 0x45 && stored[2] == 0x00);
+  store_uint64_t(stored, 8, 0x6dc54e1ff8012345);
+  assert(memcmp(stored, buffer, sizeof(buffer)) == 0);
+
+#ifdef __SIZEOF_INT128__
+  const uint8_t long_buffer[] = {0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a,
+                                 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0x00, 0x00, 0x00, 0x20};
+  uint8_t       long_stored[16];
+  uint128_t     value;
+
+  /**
+   * @brief Loads and stores on long_buffer = 2001:db8:a::20.
+   *
+   * @details Values beyond 8 bytes are split on two 64-bit loads.
+   */
+  value = load_uint128_t(long_buffer, 16);
+  assert((uint64_t) (value >> 64) == 0x20010db8000a0000);
+  assert((uint64_t) value == 0x20);
+  assert(load_uint128_t(long_buffer, 10) >> 64 == 0x2001);
+
+  store_uint128_t(long_stored, 16, value);
+  assert(memcmp(long_stored, long_buffer, sizeof(long_buffer)) == 0);
+  store_uint128_t(long_stored, 5, value << 8);
+  assert(long_stored[3] == 0x20 && long_stored[4] == 0x00);
+#endif
+}
+
+/* ********************************************************************** */
+
 int main(void) {
   test_right_shift();
   test_left_shift();
   test_add_byte_to_buffer();
   test_add_bits_to_buffer();
+  test_write_bits_to_buffer();
+  test_write_variable_length();
   test_extract_bits();
+  test_load_bits();
+  test_read_variable_length();
+  test_variable_length_round_trip();
   test_bits_counter();
   test_split_uint16_t();
   test_merge_uint8_t();
+  test_load_store_uint64_t();
 
   printf("All tests passed!\n");
 
@@ -0,0 +1,183 @@
+#include "codegen_rules.h"
+#include "core/compression.h"
+#include "core/decompression.h"
+#include "helpers/random_packets.h"
+#include "utils/binary.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_PACKETS        2000
+#define MAX_PACKET_BYTE_LEN 128
+
+/* ********************************************************************** */
+
+/**
+ * @brief Writes the bit_len low bits of a value into a buffer.
+ */
+void write_bits(uint8_t *buffer, size_t *bit_position, const uint64_t value,
+                const size_t bit_len) {
+  for (size_t index = bit_len; index > 0; index--) {
+    assert(add_byte_to_buffer(buffer, MAX_PACKET_BYTE_LEN, bit_position,
+                              (value >> (index - 1)) & 0x01, 1));
+  }
+}
+
+/**
+ * @brief Compresses a packet with the generated functions and with the
+ * interpreter, for several SCHC Packet capacities, and checks that both give
+ * the same SCHC Packet.
+ *
+ * @return 1 if the packet was compressed with a Rule other than the
+ * no-compression one, otherwise 0.
+ */
+int compare_compression(const direction_indicator_t direction,
+                        const uint8_t *packet, const size_t packet_byte_len) {
+  uint8_t schc_packet[MAX_PACKET_BYTE_LEN + 8];
+  uint8_t generated_schc_packet[MAX_PACKET_BYTE_LEN + 8];
+  size_t  schc_packet_max_byte_lens[3];
+  size_t  schc_packet_byte_len;
+  int     compressed;
+
+  schc_packet_max_byte_lens[0] = sizeof(schc_packet);
+  schc_packet_max_byte_lens[1] = packet_byte_len;
+  schc_packet_max_byte_lens[2] = random_byte() % (packet_byte_len + 1);
+
+  compressed = 0;
+  for (int index = 0; index < 3; index++) {
+    memset(generated_schc_packet, 0xa5, sizeof(generated_schc_packet));
+    schc_packet_byte_len = compress_validated(
+        schc_packet, schc_packet_max_byte_lens[index], direction, packet,
+        packet_byte_len, &codegen_validated_context);
+    assert(codegen_compress(generated_schc_packet,
+                            schc_packet_max_byte_lens[index], direction,
+                            packet, packet_byte_len) == schc_packet_byte_len);
+    assert(memcmp(generated_schc_packet, schc_packet, schc_packet_byte_len) ==
+           0);
+    if (index == 0 && schc_packet_byte_len > 0) {
+      compressed = (schc_packet[0] >> 5) != 5;
+    }
+  }
+
+  return compressed;
+}
+
+/* ********************************************************************** */
+
+void test_codegen_decompression(void) {
+  /**
+   * @brief Test that the generated decompression gives the same packets as the
+   * interpreter for random SCHC Packets, and that the generated compression
+   * gives back the same SCHC Packets from these packets and from their
+   * mutations.
+   */
+
+  uint8_t schc_packet[MAX_PACKET_BYTE_LEN];
+  uint8_t packet[MAX_PACKET_BYTE_LEN];
+  uint8_t generated_packet[MAX_PACKET_BYTE_LEN];
+  size_t  schc_packet_byte_len;
+  size_t  packet_byte_len;
+  int     card_decompressed;
+  int     card_compressed;
+
+  const direction_indicator_t directions[] = {DI_UP, DI_DW};
+
+  card_decompressed = 0;
+  card_compressed   = 0;
+  for (int index = 0; index < CARD_PACKETS; index++) {
+    schc_packet_byte_len = random_schc_packet(schc_packet, 0, 63);
+
+    for (int index_direction = 0; index_direction < 2; index_direction++) {
+      memset(generated_packet, 0xa5, sizeof(generated_packet));
+      packet_byte_len = decompress_validated(
+          packet, sizeof(packet), directions[index_direction], schc_packet,
+          schc_packet_byte_len, &codegen_validated_context);
+      assert(codegen_decompress(generated_packet, sizeof(generated_packet),
+                                directions[index_direction], schc_packet,
+                                schc_packet_byte_len) == packet_byte_len);
+      assert(memcmp(generated_packet, packet, packet_byte_len) == 0);
+      if (packet_byte_len == 0) {
+        continue;
+      }
+      card_decompressed++;
+
+      card_compressed += compare_compression(directions[index_direction],
+                                             packet, packet_byte_len);
+
+      // A flipped bit, then a truncated packet
+      packet[random_byte() % packet_byte_len] ^= 1 << (random_byte() % 8);
+      compare_compression(directions[index_direction], packet,
+                          packet_byte_len);
+      compare_compression(directions[index_direction], packet,
+                          random_byte() % packet_byte_len);
+    }
+  }
+
+  assert(card_decompressed > CARD_PACKETS / 2);
+  assert(card_compressed > CARD_PACKETS / 4);
+}
+
+/* ********************************************************************** */
+
+void test_codegen_compression_lsb(void) {
+  /**
+   * @brief Test that the generated compression gives the same SCHC Packets as
+   * the interpreter for packets matching the Rule 1 with CDA_LSB, and for their
+   * mutations.
+   */
+
+  uint8_t packet[MAX_PACKET_BYTE_LEN];
+  size_t  packet_byte_len;
+  size_t  bit_position;
+  int     card_compressed;
+
+  const uint8_t target_value[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66,
+                                  0x77, 0x88, 0x99, 0x00, 0xaa};
+
+  card_compressed = 0;
+  for (int index = 0; index < CARD_PACKETS; index++) {
+    memset(packet, 0x00, sizeof(packet));
+    bit_position = 0;
+    write_bits(packet, &bit_position, 0x6, 4);
+    write_bits(packet, &bit_position, 0xabc00 | random_byte(), 20);
+    write_bits(packet, &bit_position, 0x1630 | (random_byte() & 0x0f), 16);
+    write_bits(packet, &bit_position, 0x2, 2);
+    assert(add_bits_to_buffer(packet, sizeof(packet), &bit_position,
+                              target_value, 8 * sizeof(target_value)));
+    write_bits(packet, &bit_position,
+               ((random_byte() & 0x03) << 8) | random_byte(), 10);
+    write_bits(packet, &bit_position, 0x10 | (random_byte() & 0x0f), 5);
+
+    packet_byte_len = BYTE_LENGTH(bit_position) + random_byte() % 32;
+    for (size_t index_byte = BYTE_LENGTH(bit_position);
+         index_byte < packet_byte_len; index_byte++) {
+      packet[index_byte] = random_byte();
+    }
+
+    card_compressed += compare_compression(DI_UP, packet, packet_byte_len);
+    compare_compression(DI_DW, packet, packet_byte_len);
+
+    packet[random_byte() % packet_byte_len] ^= 1 << (random_byte() % 8);
+    compare_compression(DI_UP, packet, packet_byte_len);
+    compare_compression(DI_UP, packet, random_byte() % packet_byte_len);
+  }
+
+  assert(card_compressed == CARD_PACKETS);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_codegen_decompression();
+  test_codegen_compression_lsb();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
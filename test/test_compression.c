@@ -1,4 +1,5 @@
 #include "core/compression.h"
+#include "core/decompression.h"
 #include "utils/memory.h"
 
 #include <assert.h>
@@ -164,11 +165,11 @@ void test_coap_option_extended(void) {
   const size_t packet1_byte_len = sizeof(packet1);
 
   const uint8_t expected_schc_packet1[] = {
-      0x00, 0x0e, 0x80, 0x0e, 0x89, 0xf6, 0xb3, 0xe8, 0x0e, 0x99, 0xbd, 0x19,
-      0x69, 0xd1, 0x81, 0xb6, 0xfe, 0x20, 0xe4, 0xc8, 0x4f, 0xa4, 0x36, 0x3b,
-      0xb6, 0x99, 0x36, 0x9e, 0x98, 0x97, 0x18, 0xfb, 0xc3, 0x2b, 0x81, 0xe9,
-      0xc1, 0xab, 0x13, 0x09, 0xcb, 0x13, 0x23, 0x0b, 0x19, 0x83, 0x13, 0x2f,
-      0x88, 0x03, 0x95, 0xb4, 0x19, 0xb6, 0x36, 0x18, 0x05, 0x00};
+      0x00, 0x0e, 0x80, 0x0e, 0x89, 0xf6, 0xb3, 0x0e, 0x99, 0xbd, 0x19, 0x69,
+      0xd1, 0x81, 0xb6, 0xe4, 0xe4, 0xc8, 0x4c, 0xb6, 0x3b, 0xb6, 0x99, 0x36,
+      0x9e, 0x98, 0x97, 0x18, 0xf8, 0x7b, 0x2b, 0x81, 0xe9, 0xc1, 0xab, 0x13,
+      0x09, 0xcb, 0x13, 0x23, 0x0b, 0x19, 0x83, 0x13, 0x29, 0x03, 0x95, 0xb4,
+      0x19, 0xb6, 0x36, 0x18, 0x05, 0x00};
   const size_t expected_schc_packet1_byte_len = sizeof(expected_schc_packet1);
 
   schc_packet_byte_len =
@@ -192,11 +193,11 @@ void test_coap_option_extended(void) {
   const size_t packet2_byte_len = sizeof(packet2);
 
   const uint8_t expected_schc_packet2[] = {
-      0x00, 0x0e, 0x80, 0x0e, 0x89, 0xf6, 0xbf, 0xe8, 0x0e, 0x99, 0xbd, 0x19,
-      0x69, 0xd1, 0x81, 0xb6, 0xfe, 0x20, 0xe4, 0xc9, 0x4f, 0xa4, 0x36, 0x3b,
-      0xb6, 0x99, 0x36, 0x9e, 0x98, 0x97, 0x18, 0xfb, 0xc3, 0x2b, 0xbd, 0x5e,
-      0x6f, 0x78, 0x09, 0x1a, 0x2b, 0x13, 0x23, 0x0b, 0x19, 0x83, 0x13, 0x2f,
-      0x88, 0x03, 0x95, 0xb7, 0xb9, 0x30, 0xb7, 0x33, 0xb2, 0x9e, 0x19, 0x80};
+      0x00, 0x0e, 0x80, 0x0e, 0x89, 0xf6, 0xbf, 0x0e, 0x99, 0xbd, 0x19, 0x69,
+      0xd1, 0x81, 0xb6, 0xe4, 0xe4, 0xc9, 0x4c, 0xb6, 0x3b, 0xb6, 0x99, 0x36,
+      0x9e, 0x98, 0x97, 0x18, 0xf8, 0x7b, 0x2b, 0xbd, 0x5e, 0x6f, 0x78, 0x09,
+      0x1a, 0x2b, 0x13, 0x23, 0x0b, 0x19, 0x83, 0x13, 0x29, 0x03, 0x95, 0xb7,
+      0xb9, 0x30, 0xb7, 0x33, 0xb2, 0x9e, 0x19, 0x80};
   const size_t expected_schc_packet2_byte_len = sizeof(expected_schc_packet2);
 
   schc_packet_byte_len =
@@ -209,6 +210,203 @@ void test_coap_option_extended(void) {
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
+/* ********************************************************************** */
+
+void test_coap_option_chain(void) {
+  uint8_t      schc_packet[64];
+  const size_t schc_packet_max_byte_len = sizeof(schc_packet);
+  size_t       schc_packet_byte_len;
+
+  /**
+   * @brief Perform SCHC compression on packet (DI = UP) using short_context.
+   *
+   * @details The Rule Descriptor which matchs the packet is the 0, its Rule
+   * Field Descriptors stand for whole CoAP Options: Observe, two Uri-Path,
+   * Block2 and No-Response, whose Option Delta and Option Length are not sent.
+   * The second Uri-Path has an Option Length Extended, and No-Response an
+   * Option Delta Extended.
+   */
+  const uint8_t short_context[] = {
+      // Context
+      0, 2, 0, 6, 0, 31,
+      // Rule Descriptor
+      0x00, 0, 11, 0, 34, 0, 44, 0, 54, 0, 64, 0, 74, 0, 82, 0, 90, 0, 100, 0,
+      108, 0, 116, 0, 126,  // Rule for compression
+      0x01, 1, 0,           // Rule for no-compression
+      // Rule Field Descriptor
+      0x13, 0xbf, 0, 2, 0, 1, 64, 1, 0x00, 0x88,   // sid-coap-version
+                                                   // bi/eq/ns
+      0x13, 0xbe, 0, 2, 0, 1, 64, 1, 0x00, 0x89,   // sid-coap-type
+                                                   // bi/eq/ns
+      0x13, 0xbc, 0, 4, 0, 1, 64, 1, 0x00, 0x8a,   // sid-coap-tkl
+                                                   // bi/eq/ns
+      0x13, 0x9f, 0, 8, 0, 1, 64, 1, 0x00, 0x8b,   // sid-coap-code
+                                                   // bi/eq/ns
+      0x13, 0xa2, 0, 16, 0, 1, 75, 0,              // sid-coap-mid
+                                                   // bi/ig/vs
+      0x14, 0x1a, 0, 0, 0, 1, 75, 0,               // sid-option-observe
+                                                   // bi/ig/vs
+      0x14, 0x1d, 0, 56, 0, 1, 64, 1, 0x00, 0x8c,  // sid-option-uri-path
+                                                   // bi/eq/ns
+      0x14, 0x1d, 0, 0, 0, 2, 75, 0,               // sid-option-uri-path
+                                                   // bi/ig/vs
+      0x14, 0x23, 0, 8, 0, 1, 75, 0,               // sid-option-block2
+                                                   // bi/ig/vs
+      0x14, 0x29, 0, 8, 0, 1, 64, 1, 0x00, 0x93,   // sid-option-no-response
+                                                   // bi/eq/ns
+      0x14, 0x15, 0, 8, 0, 1, 64, 1, 0x00, 0x94,   // sid-payload-marker
+                                                   // bi/eq/ns
+      // Target Value
+      0x01,                                      // CoAP Version
+      0x01,                                      // CoAP Type
+      0x00,                                      // CoAP TKL
+      0x45,                                      // CoAP Code
+      0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x73,  // CoAP Uri-Path "sensors"
+      0x1a,                                      // CoAP No-Response
+      0xff                                       // CoAP Payload Marker
+  };
+  const size_t short_context_byte_len = sizeof(short_context);
+
+  const uint8_t packet[] = {
+      0x50, 0x45, 0x12, 0x34,                          // CoAP Header
+      0x61, 0x05,                                      // Observe
+      0x57, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x73,  // Uri-Path "sensors"
+      0x0d, 0x0a, 0x74, 0x65, 0x6d, 0x70, 0x65, 0x72, 0x61, 0x74, 0x75, 0x72,
+      0x65, 0x2d, 0x6c, 0x69, 0x76, 0x69, 0x6e, 0x67, 0x2d, 0x72, 0x6f, 0x6f,
+      0x6d,                    // Uri-Path "temperature-living-room"
+      0xc1, 0x02,              // Block2
+      0xd1, 0xde, 0x1a,        // No-Response
+      0xff,                    // CoAP Payload Marker
+      0x32, 0x31, 0x2e, 0x35   // Payload
+  };
+  const size_t packet_byte_len = sizeof(packet);
+
+  const uint8_t expected_schc_packet[] = {
+      0x09, 0x1a, 0x08, 0x2f, 0x8b, 0xba, 0x32, 0xb6, 0xb8, 0x32, 0xb9, 0x30,
+      0xba, 0x3a, 0xb9, 0x32, 0x96, 0xb6, 0x34, 0xbb, 0x34, 0xb7, 0x33, 0x96,
+      0xb9, 0x37, 0xb7, 0xb6, 0x81, 0x19, 0x18, 0x97, 0x1a, 0x80};
+  const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
+
+  schc_packet_byte_len =
+      compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+               packet_byte_len, short_context, short_context_byte_len);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
+  /**
+   * @brief Perform SCHC compression on packet without its Observe Option.
+   *
+   * @details The CoAP Options no longer follow the Rule Descriptor 0, the
+   * no-compression Rule Descriptor 1 is used.
+   */
+  uint8_t unobserved_packet[sizeof(packet) - 2];
+  memcpy(unobserved_packet, packet, 4);
+  memcpy(unobserved_packet + 4, packet + 6, sizeof(packet) - 6);
+  unobserved_packet[4] = 0xb7;  // Uri-Path Option Delta is now 11
+
+  schc_packet_byte_len = compress(
+      schc_packet, schc_packet_max_byte_len, DI_UP, unobserved_packet,
+      sizeof(unobserved_packet), short_context, short_context_byte_len);
+
+  assert(schc_packet_byte_len == sizeof(unobserved_packet) + 1);
+  assert(schc_packet[0] >> 7 == 0x01);
+}
+
+/* ********************************************************************** */
+
+void test_coap_option_position(void) {
+  uint8_t      schc_packet[64];
+  const size_t schc_packet_max_byte_len = sizeof(schc_packet);
+  size_t       schc_packet_byte_len;
+
+  /**
+   * @brief Perform SCHC compression on packet (DI = UP) using short_context.
+   *
+   * @details The Rule Descriptor which matchs the packet is the 0, its Rule
+   * Field Descriptors stand for the four Uri-Path segments of the packet, told
+   * apart by their Field Position: /api/v1/sensors are elided, the last
+   * segment is sent.
+   */
+  uint8_t short_context[] = {
+      // Context
+      0, 2, 0, 6, 0, 29,
+      // Rule Descriptor
+      0x00, 0, 10, 0, 32, 0, 42, 0, 52, 0, 62, 0, 72, 0, 80, 0, 90, 0, 100, 0,
+      110, 0, 118,  // Rule for compression
+      0x01, 1, 0,   // Rule for no-compression
+      // Rule Field Descriptor
+      0x13, 0xbf, 0, 2, 0, 1, 64, 1, 0x00, 0x80,   // sid-coap-version
+                                                   // bi/eq/ns
+      0x13, 0xbe, 0, 2, 0, 1, 64, 1, 0x00, 0x81,   // sid-coap-type
+                                                   // bi/eq/ns
+      0x13, 0xbc, 0, 4, 0, 1, 64, 1, 0x00, 0x82,   // sid-coap-tkl
+                                                   // bi/eq/ns
+      0x13, 0x9f, 0, 8, 0, 1, 64, 1, 0x00, 0x83,   // sid-coap-code
+                                                   // bi/eq/ns
+      0x13, 0xa2, 0, 16, 0, 1, 75, 0,              // sid-coap-mid
+                                                   // bi/ig/vs
+      0x14, 0x1d, 0, 24, 0, 1, 64, 1, 0x00, 0x84,  // sid-option-uri-path
+                                                   // pos 1, bi/eq/ns
+      0x14, 0x1d, 0, 16, 0, 2, 64, 1, 0x00, 0x87,  // sid-option-uri-path
+                                                   // pos 2, bi/eq/ns
+      0x14, 0x1d, 0, 56, 0, 3, 64, 1, 0x00, 0x89,  // sid-option-uri-path
+                                                   // pos 3, bi/eq/ns
+      0x14, 0x1d, 0, 0, 0, 4, 75, 0,               // sid-option-uri-path
+                                                   // pos 4, bi/ig/vs
+      0x14, 0x15, 0, 8, 0, 1, 64, 1, 0x00, 0x90,   // sid-payload-marker
+                                                   // bi/eq/ns
+      // Target Value
+      0x01,                                      // CoAP Version
+      0x01,                                      // CoAP Type
+      0x00,                                      // CoAP TKL
+      0x45,                                      // CoAP Code
+      0x61, 0x70, 0x69,                          // CoAP Uri-Path "api"
+      0x76, 0x31,                                // CoAP Uri-Path "v1"
+      0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x73,  // CoAP Uri-Path "sensors"
+      0xff                                       // CoAP Payload Marker
+  };
+  const size_t short_context_byte_len = sizeof(short_context);
+
+  const uint8_t packet[] = {
+      0x50, 0x45, 0x12, 0x34,                          // CoAP Header
+      0xb3, 0x61, 0x70, 0x69,                          // Uri-Path "api"
+      0x02, 0x76, 0x31,                                // Uri-Path "v1"
+      0x07, 0x73, 0x65, 0x6e, 0x73, 0x6f, 0x72, 0x73,  // Uri-Path "sensors"
+      0x02, 0x34, 0x32,                                // Uri-Path "42"
+      0xff,                                            // CoAP Payload Marker
+      0x32, 0x31, 0x2e, 0x35                           // Payload
+  };
+  const size_t packet_byte_len = sizeof(packet);
+
+  const uint8_t expected_schc_packet[] = {
+      0x09, 0x1a, 0x11, 0xa1, 0x91, 0x91, 0x89, 0x71, 0xa8};
+  const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
+
+  schc_packet_byte_len =
+      compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+               packet_byte_len, short_context, short_context_byte_len);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
+  /**
+   * @brief Perform SCHC compression on packet with the Field Position of the
+   * second Uri-Path set to 1.
+   *
+   * @details "v1" is the second occurrence of Uri-Path, the Rule Descriptor 0
+   * no longer matches and the no-compression Rule Descriptor 1 is used.
+   */
+  short_context[95] = 1;
+
+  schc_packet_byte_len =
+      compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+               packet_byte_len, short_context, short_context_byte_len);
+
+  assert(schc_packet_byte_len == packet_byte_len + 1);
+  assert(schc_packet[0] >> 7 == 0x01);
+}
+
 /* ********************************************************************** */
 /*                         TESTS WITH CDA_COMPUTE                         */
 /* ********************************************************************** */
@@ -359,9 +557,11 @@ void test_with_compute(void) {
 
 void test_rule_descriptor_0(const uint8_t* context,
                             const size_t   context_byte_len) {
-  uint8_t*     schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
-  const size_t schc_packet_max_byte_len = sizeof(uint8_t) * 100;
-  size_t       schc_packet_byte_len;
+  uint8_t*            schc_packet =
+      (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 100;
+  size_t              schc_packet_byte_len;
+  validated_context_t validated_context;
 
   /**
    * @brief Perform SCHC compression on packet (DI = UP) using context.
@@ -380,10 +580,10 @@ void test_rule_descriptor_0(const uint8_t* context,
   const size_t packet_byte_len = sizeof(packet);
 
   const uint8_t expected_schc_packet[] = {
-      0x06, 0x7d, 0x00, 0x04, 0x08, 0x0c, 0x10, 0x14, 0x18, 0x1c, 0x23,
-      0xc4, 0x15, 0x8d, 0x0f, 0x78, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
-      0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0xf1, 0x0a,
-      0xbe, 0xf7, 0x06, 0x17, 0x96, 0xc6, 0xf6, 0x16, 0x40};
+      0x06, 0x60, 0x04, 0x08, 0x0c, 0x10, 0x14, 0x18, 0x1c, 0x20, 0x95, 0x8d,
+      0x0f, 0x0f, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13,
+      0x14, 0x15, 0x16, 0x17, 0x18, 0x2a, 0xbe, 0xf7, 0x06, 0x17, 0x96, 0xc6,
+      0xf6, 0x16, 0x40};
   const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
 
   schc_packet_byte_len =
@@ -393,6 +593,15 @@ void test_rule_descriptor_0(const uint8_t* context,
   assert(schc_packet_byte_len == expected_schc_packet_byte_len);
   assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
 
+  // Same result with the Validated Context
+  assert(context_validate(&validated_context, context, context_byte_len));
+  schc_packet_byte_len =
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+                         packet_byte_len, &validated_context);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
@@ -400,9 +609,11 @@ void test_rule_descriptor_0(const uint8_t* context,
 
 void test_rule_descriptor_1(const uint8_t* context,
                             const size_t   context_byte_len) {
-  uint8_t*     schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
-  const size_t schc_packet_max_byte_len = sizeof(uint8_t) * 100;
-  size_t       schc_packet_byte_len;
+  uint8_t*            schc_packet =
+      (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 100;
+  size_t              schc_packet_byte_len;
+  validated_context_t validated_context;
 
   /**
    * @brief Perform SCHC compression on packet (DI = UP) using context.
@@ -421,10 +632,10 @@ void test_rule_descriptor_1(const uint8_t* context,
   const size_t packet_byte_len = sizeof(packet);
 
   const uint8_t expected_schc_packet[] = {
-      0x29, 0xe7, 0xe8, 0x00, 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe1,
-      0x1e, 0x20, 0xac, 0x68, 0x7b, 0xc0, 0x50, 0x58, 0x60, 0x68, 0x70,
-      0x78, 0x80, 0x88, 0x90, 0x98, 0xa0, 0xa8, 0xb0, 0xb8, 0xc7, 0x88,
-      0x55, 0xf7, 0xb8, 0x30, 0xbc, 0xb6, 0x37, 0xb0, 0xb2, 0x00};
+      0x29, 0xe7, 0x00, 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe1, 0x04, 0xac,
+      0x68, 0x78, 0x78, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78, 0x80, 0x88, 0x90,
+      0x98, 0xa0, 0xa8, 0xb0, 0xb8, 0xc1, 0x55, 0xf7, 0xb8, 0x30, 0xbc, 0xb6,
+      0x37, 0xb0, 0xb2, 0x00};
   const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
 
   schc_packet_byte_len =
@@ -434,6 +645,15 @@ void test_rule_descriptor_1(const uint8_t* context,
   assert(schc_packet_byte_len == expected_schc_packet_byte_len);
   assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
 
+  // Same result with the Validated Context
+  assert(context_validate(&validated_context, context, context_byte_len));
+  schc_packet_byte_len =
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+                         packet_byte_len, &validated_context);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
@@ -441,9 +661,11 @@ void test_rule_descriptor_1(const uint8_t* context,
 
 void test_rule_descriptor_2(const uint8_t* context,
                             const size_t   context_byte_len) {
-  uint8_t*     schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
-  const size_t schc_packet_max_byte_len = sizeof(uint8_t) * 100;
-  size_t       schc_packet_byte_len;
+  uint8_t*            schc_packet =
+      (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 100;
+  size_t              schc_packet_byte_len;
+  validated_context_t validated_context;
 
   /**
    * @brief Perform SCHC compression on packet (DI = UP) using context.
@@ -462,10 +684,10 @@ void test_rule_descriptor_2(const uint8_t* context,
   const size_t packet_byte_len = sizeof(packet);
 
   const uint8_t expected_schc_packet[] = {
-      0x40, 0x98, 0x00, 0x3f, 0xa0, 0x00, 0x81, 0x01, 0x82, 0x02, 0x83,
-      0x03, 0x84, 0x78, 0x82, 0xb1, 0xa1, 0xef, 0x01, 0x41, 0x61, 0x81,
-      0xa1, 0xc1, 0xe2, 0x02, 0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3,
-      0x1e, 0x21, 0x57, 0xde, 0xe0, 0xc2, 0xf2, 0xd8, 0xde, 0xc2, 0xc8};
+      0x40, 0x98, 0x00, 0x3c, 0x00, 0x81, 0x01, 0x82, 0x02, 0x83, 0x03, 0x84,
+      0x12, 0xb1, 0xa1, 0xe1, 0xe1, 0x41, 0x61, 0x81, 0xa1, 0xc1, 0xe2, 0x02,
+      0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3, 0x05, 0x57, 0xde, 0xe0, 0xc2,
+      0xf2, 0xd8, 0xde, 0xc2, 0xc8};
   const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
 
   schc_packet_byte_len =
@@ -475,6 +697,15 @@ void test_rule_descriptor_2(const uint8_t* context,
   assert(schc_packet_byte_len == expected_schc_packet_byte_len);
   assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
 
+  // Same result with the Validated Context
+  assert(context_validate(&validated_context, context, context_byte_len));
+  schc_packet_byte_len =
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+                         packet_byte_len, &validated_context);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
@@ -482,9 +713,11 @@ void test_rule_descriptor_2(const uint8_t* context,
 
 void test_rule_descriptor_3(const uint8_t* context,
                             const size_t   context_byte_len) {
-  uint8_t*     schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
-  const size_t schc_packet_max_byte_len = sizeof(uint8_t) * 100;
-  size_t       schc_packet_byte_len;
+  uint8_t*            schc_packet =
+      (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 100;
+  size_t              schc_packet_byte_len;
+  validated_context_t validated_context;
 
   /**
    * @brief Perform SCHC compression on packet (DI = UP) using context.
@@ -503,11 +736,11 @@ void test_rule_descriptor_3(const uint8_t* context,
   const size_t packet_byte_len = sizeof(packet);
 
   const uint8_t expected_schc_packet[] = {
-      0x77, 0x9f, 0xdb, 0x96, 0x90, 0x05, 0xff, 0xfd, 0xe8, 0x00, 0x20, 0x40,
-      0x60, 0x80, 0xa0, 0xc0, 0xe1, 0x16, 0x5e, 0x20, 0xac, 0x68, 0x67, 0xe3,
-      0x0c, 0x47, 0xaa, 0xa1, 0xb0, 0x05, 0xef, 0x01, 0x41, 0x61, 0x81, 0xa1,
-      0xc1, 0xe2, 0x02, 0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3, 0x1a, 0x50,
-      0x29, 0xe2, 0x15, 0x7d, 0xee, 0x0c, 0x2f, 0x2d, 0x8d, 0xec, 0x2c, 0x80};
+      0x77, 0x9f, 0xdb, 0x96, 0x90, 0x05, 0xff, 0xfd, 0x00, 0x20, 0x40, 0x60,
+      0x80, 0xa0, 0xc0, 0xe1, 0x16, 0x44, 0xac, 0x68, 0x66, 0x6c, 0x47, 0xaa,
+      0xa1, 0xa2, 0x05, 0xe1, 0xe1, 0x41, 0x61, 0x81, 0xa1, 0xc1, 0xe2, 0x02,
+      0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3, 0x1a, 0x42, 0x28, 0x55, 0x7d,
+      0xee, 0x0c, 0x2f, 0x2d, 0x8d, 0xec, 0x2c, 0x80};
   const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
 
   schc_packet_byte_len =
@@ -517,6 +750,15 @@ void test_rule_descriptor_3(const uint8_t* context,
   assert(schc_packet_byte_len == expected_schc_packet_byte_len);
   assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
 
+  // Same result with the Validated Context
+  assert(context_validate(&validated_context, context, context_byte_len));
+  schc_packet_byte_len =
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+                         packet_byte_len, &validated_context);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
@@ -524,9 +766,11 @@ void test_rule_descriptor_3(const uint8_t* context,
 
 void test_rule_descriptor_4(const uint8_t* context,
                             const size_t   context_byte_len) {
-  uint8_t*     schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
-  const size_t schc_packet_max_byte_len = sizeof(uint8_t) * 100;
-  size_t       schc_packet_byte_len;
+  uint8_t*            schc_packet =
+      (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 100;
+  size_t              schc_packet_byte_len;
+  validated_context_t validated_context;
 
   /**
    * @brief Perform SCHC compression on packet (DI = DW) using context.
@@ -545,15 +789,15 @@ void test_rule_descriptor_4(const uint8_t* context,
   const size_t packet_byte_len = sizeof(packet);
 
   const uint8_t expected_schc_packet[] = {
-      0x8d, 0x79, 0xfd, 0xb9, 0x60, 0x07, 0x02, 0x28, 0x04, 0x00, 0x21,
-      0xb7, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-      0x00, 0x00, 0x64, 0x00, 0x21, 0xb7, 0x00, 0x01, 0x40, 0x00, 0x00,
-      0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x1a, 0x20, 0x02, 0xc6,
-      0x60, 0x07, 0x14, 0x0d, 0x89, 0x00, 0x5f, 0xff, 0xc0, 0x20, 0x40,
-      0x60, 0x80, 0xa0, 0xc0, 0xe1, 0x16, 0x4a, 0xc6, 0x86, 0x6c, 0x47,
-      0xaa, 0xa1, 0xa0, 0x41, 0x41, 0x61, 0x81, 0xa1, 0xc1, 0xe2, 0x02,
-      0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3, 0x1a, 0x42, 0x95, 0x7d,
-      0xff, 0xee, 0x0c, 0x2f, 0x2d, 0x8d, 0xec, 0x2c, 0x80};
+      0x8d, 0x79, 0xfd, 0xb9, 0x60, 0x07, 0x02, 0x28, 0x04, 0x00, 0x21, 0xb7,
+      0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x64, 0x00, 0x21, 0xb7, 0x00, 0x01, 0x40, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x04, 0x1a, 0x20, 0x02, 0xc6, 0x60, 0x07, 0x14, 0x0d,
+      0x89, 0x00, 0x5f, 0xff, 0xc0, 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe1,
+      0x16, 0x4a, 0xc6, 0x86, 0x6c, 0x47, 0xaa, 0xa1, 0xa0, 0x41, 0x41, 0x61,
+      0x81, 0xa1, 0xc1, 0xe2, 0x02, 0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe3,
+      0x1a, 0x42, 0x95, 0x7d, 0xff, 0xee, 0x0c, 0x2f, 0x2d, 0x8d, 0xec, 0x2c,
+      0x80};
   const size_t expected_schc_packet_byte_len = sizeof(expected_schc_packet);
 
   schc_packet_byte_len =
@@ -563,6 +807,137 @@ void test_rule_descriptor_4(const uint8_t* context,
   assert(schc_packet_byte_len == expected_schc_packet_byte_len);
   assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
 
+  // Same result with the Validated Context
+  assert(context_validate(&validated_context, context, context_byte_len));
+  schc_packet_byte_len =
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_DW, packet,
+                         packet_byte_len, &validated_context);
+
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
+  pool_dealloc(schc_packet, schc_packet_max_byte_len);
+}
+
+/* ********************************************************************** */
+/*                           TRUNCATED PACKETS                            */
+/* ********************************************************************** */
+
+void test_truncated_packets(void) {
+  uint8_t*            schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 50);
+  const size_t        schc_packet_max_byte_len = sizeof(uint8_t) * 50;
+  uint8_t*            packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 50);
+  const size_t        packet_max_byte_len      = sizeof(uint8_t) * 50;
+  size_t              schc_packet_byte_len;
+  size_t              pool_used;
+  size_t              truncated_byte_len;
+  int                 round;
+  validated_context_t validated_context;
+  compiled_context_t* compiled_context;
+  flow_cache_t        flow_cache;
+
+  /**
+   * @brief Perform SCHC compression and decompression on every truncation of
+   * packet (DI = UP), many times, and check that nothing is left allocated in
+   * the pool, as the pool of a worker lives as long as its thread.
+   *
+   * @details The Rule Descriptor 0 needs the 7 first bytes of the packet,
+   * shorter packets fail in the middle of its Rule Field Descriptors and are
+   * sent with the no-compression Rule Descriptor 1.
+   */
+  const uint8_t context[] = {
+      // Context
+      0, 2, 0, 6, 0, 19,
+      // Rule Descriptor
+      0x00, 0, 5, 0, 22, 0, 32, 0, 40, 0, 48, 0, 60,  // Rule for compression
+      0x01, 1, 0,  // Rule for no-compression
+      // Rule Field Descriptor
+      0x13, 0xcc, 0, 4, 0, 1, 64, 1, 0, 72,  // sid-ipv6-version
+                                             // bi/eq/ns
+      0x13, 0xc9, 0, 8, 0, 1, 75, 0,         // sid-ipv6-trafficclass
+                                             // bi/ig/vs
+      0x13, 0xc5, 0, 20, 0, 1, 75, 0,        // sid-ipv6-flow-label
+                                             // bi/ig/vs
+      0x13, 0xc8, 0, 16, 0, 1, 81, 0, 12, 1, 0, 73,  // sid-ipv6-payload-length
+                                                     // bi/msb(12)/lsb
+      0x13, 0xc7, 0, 8, 0, 1, 90, 2, 0, 75, 0, 76,   // sid-ipv6-nextheader
+                                                     // bi/mm/ms
+      // Target Values
+      0x06,        // ipv6-version
+      0x00, 0x00,  // ipv6-payload-length MSB
+      0x06, 0x11   // ipv6-nextheader
+  };
+  const size_t context_byte_len = sizeof(context) / sizeof(uint8_t);
+
+  const uint8_t packet1[] = {0x60, 0x0a, 0xbc, 0x12, 0x00, 0x04,
+                             0x11, 0xde, 0xad, 0xbe, 0xef};
+  const size_t  packet1_byte_len = sizeof(packet1) / sizeof(uint8_t);
+
+  assert(context_validate(&validated_context, context, context_byte_len));
+  compiled_context = compile_context(context, context_byte_len);
+  assert(compiled_context != NULL);
+  assert(init_flow_cache(&flow_cache, 16));
+
+  // The whole packet is compressed with the Rule Descriptor 0
+  schc_packet_byte_len =
+      compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet1,
+               packet1_byte_len, context, context_byte_len);
+  assert(schc_packet_byte_len > 0 && schc_packet_byte_len < packet1_byte_len);
+
+  pool_used = pool->used;
+
+  for (round = 0; round < 100; round++) {
+    for (truncated_byte_len = 0; truncated_byte_len < packet1_byte_len;
+         truncated_byte_len++) {
+      compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet1,
+               truncated_byte_len, context, context_byte_len);
+      assert(pool->used == pool_used);
+
+      compress_validated(schc_packet, schc_packet_max_byte_len, DI_UP, packet1,
+                         truncated_byte_len, &validated_context);
+      assert(pool->used == pool_used);
+
+      compress_compiled(schc_packet, schc_packet_max_byte_len, DI_UP, packet1,
+                        truncated_byte_len, compiled_context);
+      assert(pool->used == pool_used);
+
+      compress_compiled_cached(schc_packet, schc_packet_max_byte_len, DI_UP,
+                               packet1, truncated_byte_len, compiled_context,
+                               &flow_cache);
+      assert(pool->used == pool_used);
+    }
+
+    // Truncated SCHC Packets of the Rule Descriptor 0 fail in the middle of
+    // the decompression
+    schc_packet_byte_len =
+        compress(schc_packet, schc_packet_max_byte_len, DI_UP, packet1,
+                 packet1_byte_len, context, context_byte_len);
+    for (truncated_byte_len = 0; truncated_byte_len <= schc_packet_byte_len;
+         truncated_byte_len++) {
+      decompress(packet, packet_max_byte_len, DI_UP, schc_packet,
+                 truncated_byte_len, context, context_byte_len);
+      assert(pool->used == pool_used);
+
+      decompress_compiled(packet, packet_max_byte_len, DI_UP, schc_packet,
+                          truncated_byte_len, compiled_context);
+      assert(pool->used == pool_used);
+    }
+  }
+
+  // The packets that follow are still compressed
+  schc_packet_byte_len = compress_compiled_cached(
+      schc_packet, schc_packet_max_byte_len, DI_UP, packet1, packet1_byte_len,
+      compiled_context, &flow_cache);
+  assert(schc_packet_byte_len > 0 && schc_packet_byte_len < packet1_byte_len);
+  assert(decompress_compiled(packet, packet_max_byte_len, DI_UP, schc_packet,
+                             schc_packet_byte_len,
+                             compiled_context) == packet1_byte_len);
+  assert(memcmp(packet, packet1, packet1_byte_len) == 0);
+
+  destroy_flow_cache(&flow_cache);
+  free_compiled_context(compiled_context);
+
+  pool_dealloc(packet, packet_max_byte_len);
   pool_dealloc(schc_packet, schc_packet_max_byte_len);
 }
 
@@ -572,7 +947,10 @@ int main(void) {
   init_memory_pool();
 
   test_coap_option_extended();
+  test_coap_option_chain();
+  test_coap_option_position();
   test_with_compute();
+  test_truncated_packets();
 
   destroy_memory_pool();
 
@@ -0,0 +1,292 @@
+#include "core/compression.h"
+#include "core/context.h"
+#include "core/context_loader.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ********************************************************************** */
+
+const uint8_t context[] = {
+    // Context
+    0, 5, 0, 12, 0, 89, 0, 166, 0, 243, 1, 64,
+
+    // Rule Descriptors
+    0, 0, 37, 1, 67, 1, 77, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 17, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 0
+    1, 0, 37, 1, 67, 2, 167, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 179, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 1
+    2, 0, 37, 1, 67, 2, 191, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 199, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 2
+    3, 0, 37, 1, 67, 2, 191, 2, 207, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 2, 215, 2, 223,
+    2, 231, 2, 239, 2, 199, 2, 37, 2, 247, 2, 255, 2, 65, 2, 247, 2, 255, 2, 65,
+    2, 247, 2, 255, 3, 7, 2, 65, 2, 247, 2, 255, 3, 15, 2, 65, 2,
+    157,      // Rule Descriptor n° 3
+    4, 1, 0,  // Rule Descriptor n° 4
+
+    // Rule Field Descriptors
+    0x13, 0xcc, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x17,  // Rule Field Descriptor n° 0
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x5a, 0x4, 0x3, 0x18, 0x3, 0x19, 0x3, 0x1a,
+    0x3, 0x1b,  // Rule Field Descriptor n° 1
+    0x13, 0xc5, 0x0, 0x14, 0x0, 0x1, 0x5a, 0x4, 0x3, 0x1c, 0x3, 0x1f, 0x3, 0x22,
+    0x3, 0x25,                                   // Rule Field Descriptor n° 2
+    0x13, 0xc8, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 3
+    0x13, 0xc7, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x28,  // Rule Field Descriptor n° 4
+    0x13, 0xc6, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x29,  // Rule Field Descriptor n° 5
+    0x13, 0xc1, 0x0, 0x80, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x2a,  // Rule Field Descriptor n° 6
+    0x13, 0xc1, 0x0, 0x80, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x3a,  // Rule Field Descriptor n° 7
+    0x13, 0xc4, 0x0, 0x80, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x3a,  // Rule Field Descriptor n° 8
+    0x13, 0xc4, 0x0, 0x80, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x2a,  // Rule Field Descriptor n° 9
+    0x13, 0xce, 0x0, 0x10, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x4a,  // Rule Field Descriptor n° 10
+    0x13, 0xce, 0x0, 0x10, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x4c,  // Rule Field Descriptor n° 11
+    0x13, 0xd1, 0x0, 0x10, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x4c,  // Rule Field Descriptor n° 12
+    0x13, 0xd1, 0x0, 0x10, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x4a,                                        // Rule Field Descriptor n° 13
+    0x13, 0xd2, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 14
+    0x13, 0xd0, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 15
+    0x13, 0xbf, 0x0, 0x2, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x4e,  // Rule Field Descriptor n° 16
+    0x13, 0xbe, 0x0, 0x2, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x4f,  // Rule Field Descriptor n° 17
+    0x13, 0xbc, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x50,  // Rule Field Descriptor n° 18
+    0x13, 0x9f, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x51,  // Rule Field Descriptor n° 19
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x5a, 0x6, 0x3, 0x52, 0x3, 0x54, 0x3, 0x56,
+    0x3, 0x58, 0x3, 0x5a, 0x3, 0x5c,             // Rule Field Descriptor n° 20
+    0x13, 0xbd, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 21
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x5e,  // Rule Field Descriptor n° 22
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x5f,                                        // Rule Field Descriptor n° 23
+    0x14, 0x14, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 24
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x60,  // Rule Field Descriptor n° 25
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x60,  // Rule Field Descriptor n° 26
+    0x14, 0x14, 0x0, 0x0, 0x0, 0x1, 0x5a, 0x3, 0x3, 0x61, 0x3, 0x64, 0x3,
+    0x67,  // Rule Field Descriptor n° 27
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6a,  // Rule Field Descriptor n° 28
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6b,  // Rule Field Descriptor n° 29
+    0x14, 0x13, 0x0, 0x0, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x51,  // Rule Field Descriptor n° 30
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6b,  // Rule Field Descriptor n° 31
+    0x14, 0x11, 0x0, 0x0, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6c,  // Rule Field Descriptor n° 32
+    0x14, 0x15, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x18,  // Rule Field Descriptor n° 33
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x51, 0x0, 0x4, 0x1, 0x3,
+    0x6d,  // Rule Field Descriptor n° 34
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x51, 0x0, 0xa, 0x1, 0x3,
+    0x6e,                                        // Rule Field Descriptor n° 35
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 36
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 37
+    0x13, 0xc5, 0x0, 0x14, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 38
+    0x13, 0xbf, 0x0, 0x2, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 39
+    0x13, 0xbe, 0x0, 0x2, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 40
+    0x13, 0xbc, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 41
+    0x13, 0x9f, 0x0, 0x8, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 42
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 43
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 44
+    0x14, 0x13, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 45
+    0x14, 0x11, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 46
+
+    // Target Values
+    0x6, 0xff, 0xfe, 0xf1, 0xf7, 0x0, 0xef, 0x2d, 0xf, 0xfe, 0x2d, 0x7, 0x77,
+    0x77, 0xf, 0xf8, 0x5f, 0x11, 0x40, 0x20, 0x1, 0xd, 0xb8, 0x0, 0xa, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x3, 0x20, 0x1, 0xd, 0xb8, 0x0, 0xa, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x20, 0xd1, 0x0, 0x16, 0x33, 0x1,
+    0x0, 0x8, 0x2, 0x84, 0x81, 0x84, 0x82, 0x84, 0x83, 0x84, 0x84, 0x84, 0x85,
+    0x84, 0x86, 0xb, 0x2, 0x3, 0x62, 0x3d, 0x55, 0xab, 0xcd, 0xef, 0x77, 0x0,
+    0xff, 0x0, 0xd, 0x14, 0xf, 0x2, 0x12};
+const size_t context_byte_len = sizeof(context);
+
+/* ********************************************************************** */
+
+/**
+ * @brief Writes buffer into a new temporary file.
+ *
+ * @param path Pointer to the mkstemp(...) template, filled with the file path.
+ * @param buffer Pointer to the content of the file.
+ * @param buffer_byte_len Byte length of the buffer.
+ */
+void write_temporary_file(char* path, const uint8_t* buffer,
+                          const size_t buffer_byte_len) {
+  int     fd;
+  ssize_t written_byte_len;
+
+  fd = mkstemp(path);
+  assert(fd >= 0);
+
+  written_byte_len = write(fd, buffer, buffer_byte_len);
+  assert(written_byte_len == (ssize_t) buffer_byte_len);
+
+  close(fd);
+}
+
+/* ********************************************************************** */
+
+void test_context_validate(void) {
+  uint8_t             corrupted_context[sizeof(context)];
+  validated_context_t validated_context;
+
+  /**
+   * @brief A well-formed Context is valid.
+   */
+  assert(context_validate(&validated_context, context, context_byte_len));
+  assert(validated_context.context == context);
+  assert(validated_context.context_byte_len == context_byte_len);
+
+  /**
+   * @brief A truncated Context is rejected: the Target Values of the last Rule
+   * Field Descriptors are out of range.
+   */
+  assert(
+      !context_validate(&validated_context, context, context_byte_len - 1));
+  assert(!context_validate(&validated_context, context, 1));
+
+  /**
+   * @brief The offset of the Rule Descriptor 4 points outside the Context.
+   */
+  memcpy(corrupted_context, context, context_byte_len);
+  corrupted_context[10] = 0xff;
+  assert(!context_validate(&validated_context, corrupted_context,
+                           context_byte_len));
+
+  /**
+   * @brief Two Rule Descriptors share the same Rule ID.
+   */
+  memcpy(corrupted_context, context, context_byte_len);
+  corrupted_context[89] = 0;
+  assert(!context_validate(&validated_context, corrupted_context,
+                           context_byte_len));
+
+  /**
+   * @brief The Rule ID 4 cannot be sent on 2 bits when only 4 Rule Descriptors
+   * are announced.
+   */
+  memcpy(corrupted_context, context, context_byte_len);
+  corrupted_context[1] = 4;
+  corrupted_context[8] = 1;
+  corrupted_context[9] = 64;
+  assert(!context_validate(&validated_context, corrupted_context,
+                           context_byte_len));
+
+  /**
+   * @brief The Rule Field Descriptor n° 0 (not-sent) announces no Target
+   * Value.
+   */
+  memcpy(corrupted_context, context, context_byte_len);
+  corrupted_context[323 + 7] = 0;
+  assert(!context_validate(&validated_context, corrupted_context,
+                           context_byte_len));
+  assert(validated_context.context == NULL);
+}
+
+/* ********************************************************************** */
+
+void test_load_context_file(void) {
+  char                path[] = "/tmp/cschc-context-XXXXXX";
+  validated_context_t validated_context;
+  uint8_t*            schc_packet;
+  uint8_t*            expected_schc_packet;
+  size_t              schc_packet_byte_len;
+  size_t              expected_schc_packet_byte_len;
+
+  const uint8_t packet[] = {
+      0x6f, 0xff, 0xf8, 0x5f, 0x00, 0x38, 0x11, 0x40, 0x20, 0x01, 0x0d, 0xb8,
+      0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+      0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x00, 0x00, 0x00, 0x20, 0xd1, 0x00, 0x16, 0x33, 0x00, 0x38, 0x1b, 0xe9,
+      0x48, 0x02, 0x84, 0x82, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+      0xb2, 0x56, 0x34, 0x33, 0x62, 0x3d, 0x55, 0x0d, 0x02, 0x0a, 0x0b, 0x0c,
+      0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+      0xd2, 0x14, 0xab, 0xef, 0xff, 0x70, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64};
+  const size_t packet_byte_len = sizeof(packet);
+
+  /**
+   * @brief Load a Context file and compress a packet with it. The SCHC Packet
+   * must be the same as the one obtained with the Context byte array.
+   */
+  write_temporary_file(path, context, context_byte_len);
+  assert(load_context_file(&validated_context, path));
+  assert(validated_context.context_byte_len == context_byte_len);
+  assert(memcmp(validated_context.context, context, context_byte_len) == 0);
+
+  expected_schc_packet = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+  schc_packet          = (uint8_t*) pool_alloc(sizeof(uint8_t) * 100);
+
+  expected_schc_packet_byte_len = compress(expected_schc_packet, 100, DI_UP,
+                                           packet, packet_byte_len, context,
+                                           context_byte_len);
+  schc_packet_byte_len =
+      compress_validated(schc_packet, 100, DI_UP, packet, packet_byte_len,
+                         &validated_context);
+
+  assert(expected_schc_packet_byte_len > 0);
+  assert(schc_packet_byte_len == expected_schc_packet_byte_len);
+  assert(memcmp(schc_packet, expected_schc_packet, schc_packet_byte_len) == 0);
+
+  pool_dealloc(schc_packet, sizeof(uint8_t) * 100);
+  pool_dealloc(expected_schc_packet, sizeof(uint8_t) * 100);
+
+  unload_context_file(&validated_context);
+  assert(validated_context.context == NULL);
+  unlink(path);
+
+  /**
+   * @brief A truncated Context file is rejected.
+   */
+  strcpy(path, "/tmp/cschc-context-XXXXXX");
+  write_temporary_file(path, context, context_byte_len / 2);
+  assert(!load_context_file(&validated_context, path));
+  assert(validated_context.context == NULL);
+  unlink(path);
+
+  /**
+   * @brief A missing Context file is rejected.
+   */
+  assert(!load_context_file(&validated_context, path));
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_context_validate();
+  test_load_context_file();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
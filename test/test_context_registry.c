@@ -0,0 +1,607 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/context_registry.h"
+#include "core/decompression.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+/* ********************************************************************** */
+
+const uint8_t context[] = {
+    // Context
+    0, 5, 0, 12, 0, 89, 0, 166, 0, 243, 1, 64,
+
+    // Rule Descriptors
+    0, 0, 37, 1, 67, 1, 77, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 17, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 0
+    1, 0, 37, 1, 67, 2, 167, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 179, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 1
+    2, 0, 37, 1, 67, 2, 191, 1, 93, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 1, 233, 1, 243,
+    1, 253, 2, 7, 2, 199, 2, 37, 2, 45, 2, 55, 2, 65, 2, 73, 2, 83, 2, 93, 2,
+    107, 2, 117, 2, 127, 2, 65, 2, 137, 2, 55, 2, 147, 2, 65, 2,
+    157,  // Rule Descriptor n° 2
+    3, 0, 37, 1, 67, 2, 191, 2, 207, 1, 109, 1, 117, 1, 127, 1, 137, 1, 147, 1,
+    157, 1, 167, 1, 177, 1, 187, 1, 197, 1, 207, 1, 217, 1, 225, 2, 215, 2, 223,
+    2, 231, 2, 239, 2, 199, 2, 37, 2, 247, 2, 255, 2, 65, 2, 247, 2, 255, 2, 65,
+    2, 247, 2, 255, 3, 7, 2, 65, 2, 247, 2, 255, 3, 15, 2, 65, 2,
+    157,      // Rule Descriptor n° 3
+    4, 1, 0,  // Rule Descriptor n° 4
+
+    // Rule Field Descriptors
+    0x13, 0xcc, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x17,  // Rule Field Descriptor n° 0
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x5a, 0x4, 0x3, 0x18, 0x3, 0x19, 0x3, 0x1a,
+    0x3, 0x1b,  // Rule Field Descriptor n° 1
+    0x13, 0xc5, 0x0, 0x14, 0x0, 0x1, 0x5a, 0x4, 0x3, 0x1c, 0x3, 0x1f, 0x3, 0x22,
+    0x3, 0x25,                                   // Rule Field Descriptor n° 2
+    0x13, 0xc8, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 3
+    0x13, 0xc7, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x28,  // Rule Field Descriptor n° 4
+    0x13, 0xc6, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x29,  // Rule Field Descriptor n° 5
+    0x13, 0xc1, 0x0, 0x80, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x2a,  // Rule Field Descriptor n° 6
+    0x13, 0xc1, 0x0, 0x80, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x3a,  // Rule Field Descriptor n° 7
+    0x13, 0xc4, 0x0, 0x80, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x3a,  // Rule Field Descriptor n° 8
+    0x13, 0xc4, 0x0, 0x80, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x2a,  // Rule Field Descriptor n° 9
+    0x13, 0xce, 0x0, 0x10, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x4a,  // Rule Field Descriptor n° 10
+    0x13, 0xce, 0x0, 0x10, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x4c,  // Rule Field Descriptor n° 11
+    0x13, 0xd1, 0x0, 0x10, 0x0, 0x1, 0x0, 0x1, 0x3,
+    0x4c,  // Rule Field Descriptor n° 12
+    0x13, 0xd1, 0x0, 0x10, 0x0, 0x1, 0x20, 0x1, 0x3,
+    0x4a,                                        // Rule Field Descriptor n° 13
+    0x13, 0xd2, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 14
+    0x13, 0xd0, 0x0, 0x10, 0x0, 0x1, 0x4c, 0x0,  // Rule Field Descriptor n° 15
+    0x13, 0xbf, 0x0, 0x2, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x4e,  // Rule Field Descriptor n° 16
+    0x13, 0xbe, 0x0, 0x2, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x4f,  // Rule Field Descriptor n° 17
+    0x13, 0xbc, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x50,  // Rule Field Descriptor n° 18
+    0x13, 0x9f, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x51,  // Rule Field Descriptor n° 19
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x5a, 0x6, 0x3, 0x52, 0x3, 0x54, 0x3, 0x56,
+    0x3, 0x58, 0x3, 0x5a, 0x3, 0x5c,             // Rule Field Descriptor n° 20
+    0x13, 0xbd, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 21
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x5e,  // Rule Field Descriptor n° 22
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x5f,                                        // Rule Field Descriptor n° 23
+    0x14, 0x14, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 24
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x60,  // Rule Field Descriptor n° 25
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x60,  // Rule Field Descriptor n° 26
+    0x14, 0x14, 0x0, 0x0, 0x0, 0x1, 0x5a, 0x3, 0x3, 0x61, 0x3, 0x64, 0x3,
+    0x67,  // Rule Field Descriptor n° 27
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6a,  // Rule Field Descriptor n° 28
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6b,  // Rule Field Descriptor n° 29
+    0x14, 0x13, 0x0, 0x0, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x51,  // Rule Field Descriptor n° 30
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6b,  // Rule Field Descriptor n° 31
+    0x14, 0x11, 0x0, 0x0, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x6c,  // Rule Field Descriptor n° 32
+    0x14, 0x15, 0x0, 0x8, 0x0, 0x1, 0x40, 0x1, 0x3,
+    0x18,  // Rule Field Descriptor n° 33
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x51, 0x0, 0x4, 0x1, 0x3,
+    0x6d,  // Rule Field Descriptor n° 34
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x51, 0x0, 0xa, 0x1, 0x3,
+    0x6e,                                        // Rule Field Descriptor n° 35
+    0x13, 0xc9, 0x0, 0x8, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 36
+    0x13, 0xa2, 0x0, 0x10, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 37
+    0x13, 0xc5, 0x0, 0x14, 0x0, 0x1, 0x4b, 0x0,  // Rule Field Descriptor n° 38
+    0x13, 0xbf, 0x0, 0x2, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 39
+    0x13, 0xbe, 0x0, 0x2, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 40
+    0x13, 0xbc, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 41
+    0x13, 0x9f, 0x0, 0x8, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 42
+    0x14, 0x10, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 43
+    0x14, 0x12, 0x0, 0x4, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 44
+    0x14, 0x13, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 45
+    0x14, 0x11, 0x0, 0x0, 0x0, 0x1, 0x4b, 0x0,   // Rule Field Descriptor n° 46
+
+    // Target Values
+    0x6, 0xff, 0xfe, 0xf1, 0xf7, 0x0, 0xef, 0x2d, 0xf, 0xfe, 0x2d, 0x7, 0x77,
+    0x77, 0xf, 0xf8, 0x5f, 0x11, 0x40, 0x20, 0x1, 0xd, 0xb8, 0x0, 0xa, 0x0, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x3, 0x20, 0x1, 0xd, 0xb8, 0x0, 0xa, 0x0,
+    0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x0, 0x20, 0xd1, 0x0, 0x16, 0x33, 0x1,
+    0x0, 0x8, 0x2, 0x84, 0x81, 0x84, 0x82, 0x84, 0x83, 0x84, 0x84, 0x84, 0x85,
+    0x84, 0x86, 0xb, 0x2, 0x3, 0x62, 0x3d, 0x55, 0xab, 0xcd, 0xef, 0x77, 0x0,
+    0xff, 0x0, 0xd, 0x14, 0xf, 0x2, 0x12};
+const size_t context_byte_len = sizeof(context);
+
+/**
+ * @brief This Packet matches the Rule Descriptor 0.
+ */
+const uint8_t packet[] = {
+    0x6f, 0xff, 0xf8, 0x5f, 0x00, 0x38, 0x11, 0x40, 0x20, 0x01, 0x0d, 0xb8,
+    0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03,
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x20, 0xd1, 0x00, 0x16, 0x33, 0x00, 0x38, 0x1b, 0xe9,
+    0x48, 0x02, 0x84, 0x82, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0xb2, 0x56, 0x34, 0x33, 0x62, 0x3d, 0x55, 0x0d, 0x02, 0x0a, 0x0b, 0x0c,
+    0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+    0xd2, 0x14, 0xab, 0xef, 0xff, 0x70, 0x61, 0x79, 0x6c, 0x6f, 0x61, 0x64};
+const size_t packet_byte_len = sizeof(packet);
+
+#define EXPECTED_SCHC_PACKET_BYTE_LEN 39
+#define DEVICES                       100000
+#define READER_ITERATIONS             2000
+#define WRITER_ITERATIONS             200
+
+/* ********************************************************************** */
+
+/**
+ * @brief Compiles a new version of the Context, which only differs by the
+ * last Target Value, not used by the Rule Descriptor 0.
+ *
+ * @param context_id The Context ID of the new version.
+ * @param version Value of the last Target Value.
+ * @return A pointer to the Compiled Context.
+ */
+compiled_context_t *compile_context_version(const uint8_t context_id,
+                                            const uint8_t version) {
+  uint8_t context_version[sizeof(context)];
+
+  memcpy(context_version, context, context_byte_len);
+  context_version[0]                    = context_id;
+  context_version[context_byte_len - 1] = version;
+
+  return compile_context(context_version, context_byte_len);
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Compresses packet with a Compiled Context.
+ *
+ * @param compiled_context Pointer to the Compiled Context.
+ * @return The byte length of the SCHC Packet.
+ */
+size_t compress_with_context(const compiled_context_t *compiled_context) {
+  uint8_t schc_packet[100];
+
+  return compress_validated(schc_packet, sizeof(schc_packet), DI_UP, packet,
+                            packet_byte_len,
+                            &compiled_context->validated_context);
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Compresses packet with the Compiled Context published for the
+ * Context ID 0.
+ *
+ * @param registry Pointer to the Context Registry.
+ * @return The byte length of the SCHC Packet, 0 if no Context is published.
+ */
+size_t compress_with_published_context(context_registry_t *registry) {
+  const compiled_context_t *compiled_context;
+
+  compiled_context = get_published_context(registry, 0);
+  if (compiled_context == NULL) {
+    return 0;
+  }
+
+  return compress_with_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_compile_context(void) {
+  compiled_context_t *compiled_context;
+  uint8_t             corrupted_context[sizeof(context)];
+  char                path[] = "/tmp/cschc-context-XXXXXX";
+  int                 fd;
+
+  /**
+   * @brief The Compiled Context owns a validated copy of the Context.
+   */
+  compiled_context = compile_context(context, context_byte_len);
+  assert(compiled_context != NULL);
+  assert(compiled_context->context != context);
+  assert(compiled_context->validated_context.context ==
+         compiled_context->context);
+  assert(compiled_context->validated_context.context_byte_len ==
+         context_byte_len);
+  assert(memcmp(compiled_context->context, context, context_byte_len) == 0);
+  assert(!compiled_context->is_mapped);
+  free_compiled_context(compiled_context);
+
+  /**
+   * @brief A Compiled Context of a Context file reads the mapping of the file
+   * instead of a copy, and compresses the same way.
+   */
+  fd = mkstemp(path);
+  assert(fd >= 0);
+  assert(write(fd, context, context_byte_len) == (ssize_t) context_byte_len);
+  close(fd);
+  compiled_context = compile_context_file(path);
+  assert(compiled_context != NULL);
+  assert(compiled_context->is_mapped);
+  assert(compiled_context->validated_context.context ==
+         compiled_context->context);
+  assert(memcmp(compiled_context->context, context, context_byte_len) == 0);
+  assert(compress_with_context(compiled_context) ==
+         EXPECTED_SCHC_PACKET_BYTE_LEN);
+  free_compiled_context(compiled_context);
+  unlink(path);
+  assert(compile_context_file(path) == NULL);
+
+  /**
+   * @brief An invalid Context cannot be compiled.
+   */
+  memcpy(corrupted_context, context, context_byte_len);
+  corrupted_context[10] = 0xff;
+  assert(compile_context(corrupted_context, context_byte_len) == NULL);
+  assert(compile_context(NULL, 0) == NULL);
+}
+
+/* ********************************************************************** */
+
+void test_compiled_rules(void) {
+  compiled_context_t     *compiled_context;
+  const compiled_rule_t  *compiled_rule;
+  rule_descriptor_t       rule_descriptor;
+  rule_field_descriptor_t rule_field_descriptor;
+  rule_field_descriptor_t compiled_rule_field_descriptor;
+  uint8_t                 schc_packet[100];
+  uint8_t                 compiled_schc_packet[100];
+  uint8_t                 decompressed_packet[100];
+  uint8_t                 compiled_decompressed_packet[100];
+  size_t                  schc_packet_byte_len;
+  size_t                  decompressed_packet_byte_len;
+
+  /**
+   * @brief The Compiled Rules hold the Rule Field Descriptors of the Context,
+   * one cache line aligned block of arrays per Rule.
+   */
+  compiled_context = compile_context(context, context_byte_len);
+  assert(compiled_context != NULL);
+  assert(compiled_context->compiled_rules.card_rules == context[1]);
+  assert((uintptr_t) compiled_context->compiled_rules.rules %
+             CACHE_LINE_BYTE_LEN ==
+         0);
+
+  for (unsigned int index = 0; index < context[1]; index++) {
+    get_rule_descriptor_unchecked(&rule_descriptor, index, context);
+    compiled_rule = &compiled_context->compiled_rules.rules[index];
+    assert(compiled_rule->id == rule_descriptor.id);
+    assert(compiled_rule->nature == rule_descriptor.nature);
+    assert(compiled_rule->card_rule_field_descriptor ==
+           rule_descriptor.card_rule_field_descriptor);
+    assert((uintptr_t) compiled_rule->sids % CACHE_LINE_BYTE_LEN == 0);
+
+    for (unsigned int index_rule_field_descriptor = 0;
+         index_rule_field_descriptor <
+         rule_descriptor.card_rule_field_descriptor;
+         index_rule_field_descriptor++) {
+      get_rule_field_descriptor_unchecked(&rule_field_descriptor,
+                                          index_rule_field_descriptor,
+                                          rule_descriptor.offset, context);
+      get_compiled_rule_field_descriptor(&compiled_rule_field_descriptor,
+                                         index_rule_field_descriptor,
+                                         compiled_rule);
+      assert(compiled_rule_field_descriptor.sid == rule_field_descriptor.sid);
+      assert(compiled_rule_field_descriptor.len == rule_field_descriptor.len);
+      assert(compiled_rule_field_descriptor.pos == rule_field_descriptor.pos);
+      assert(compiled_rule_field_descriptor.di == rule_field_descriptor.di);
+      assert(compiled_rule_field_descriptor.mo == rule_field_descriptor.mo);
+      assert(compiled_rule_field_descriptor.cda == rule_field_descriptor.cda);
+      assert(compiled_rule_field_descriptor.msb_len ==
+             rule_field_descriptor.msb_len);
+      assert(compiled_rule_field_descriptor.card_target_value ==
+             rule_field_descriptor.card_target_value);
+      assert(compiled_rule_field_descriptor.first_target_value_offset ==
+             rule_field_descriptor.first_target_value_offset);
+    }
+  }
+
+  /**
+   * @brief Compression and decompression give the same results with the
+   * Compiled Rules and with the Validated Context.
+   */
+  schc_packet_byte_len = compress_compiled(compiled_schc_packet,
+                                           sizeof(compiled_schc_packet), DI_UP,
+                                           packet, packet_byte_len,
+                                           compiled_context);
+  assert(schc_packet_byte_len == EXPECTED_SCHC_PACKET_BYTE_LEN);
+  assert(compress_validated(schc_packet, sizeof(schc_packet), DI_UP, packet,
+                            packet_byte_len,
+                            &compiled_context->validated_context) ==
+         schc_packet_byte_len);
+  assert(memcmp(compiled_schc_packet, schc_packet, schc_packet_byte_len) == 0);
+
+  decompressed_packet_byte_len = decompress_compiled(
+      compiled_decompressed_packet, sizeof(compiled_decompressed_packet), DI_UP,
+      schc_packet, schc_packet_byte_len, compiled_context);
+  assert(decompressed_packet_byte_len == packet_byte_len);
+  assert(decompress_validated(decompressed_packet, sizeof(decompressed_packet),
+                              DI_UP, schc_packet, schc_packet_byte_len,
+                              &compiled_context->validated_context) ==
+         decompressed_packet_byte_len);
+  assert(memcmp(compiled_decompressed_packet, decompressed_packet,
+                decompressed_packet_byte_len) == 0);
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_hot_swap(void) {
+  context_registry_t       *registry;
+  context_reader_t         *reader;
+  compiled_context_t       *first_context;
+  compiled_context_t       *second_context;
+  const compiled_context_t *published_context;
+  uint8_t                   schc_packet[100];
+  size_t                    schc_packet_byte_len;
+
+  registry = create_context_registry();
+  assert(registry != NULL);
+  reader = register_context_reader(registry);
+  assert(reader != NULL);
+
+  /**
+   * @brief Nothing is published yet.
+   */
+  context_reader_lock(registry, reader);
+  assert(get_published_context(registry, 0) == NULL);
+  context_reader_unlock(reader);
+
+  first_context  = compile_context(context, context_byte_len);
+  second_context = compile_context_version(0, 0x13);
+  assert(first_context != NULL && second_context != NULL);
+  assert(publish_context(registry, first_context));
+
+  /**
+   * @brief A reader keeps using the first Compiled Context while the second
+   * one is published. The first one is only freed once the reader unlocks.
+   */
+  context_reader_lock(registry, reader);
+  published_context = get_published_context(registry, 0);
+  assert(published_context == first_context);
+
+  assert(publish_context(registry, second_context));
+  assert(reclaim_contexts(registry) == 1);
+
+  schc_packet_byte_len = compress_validated(
+      schc_packet, sizeof(schc_packet), DI_UP, packet, packet_byte_len,
+      &published_context->validated_context);
+  assert(schc_packet_byte_len == EXPECTED_SCHC_PACKET_BYTE_LEN);
+  assert(get_published_context(registry, 0) == second_context);
+  context_reader_unlock(reader);
+
+  assert(reclaim_contexts(registry) == 0);
+
+  /**
+   * @brief A reader that locks after the publication only sees the second
+   * Compiled Context and does not delay its withdrawal.
+   */
+  context_reader_lock(registry, reader);
+  assert(get_published_context(registry, 0) == second_context);
+  context_reader_unlock(reader);
+
+  assert(withdraw_context(registry, 0));
+  assert(!withdraw_context(registry, 0));
+  assert(reclaim_contexts(registry) == 0);
+
+  context_reader_lock(registry, reader);
+  assert(get_published_context(registry, 0) == NULL);
+  context_reader_unlock(reader);
+
+  unregister_context_reader(registry, reader);
+  destroy_context_registry(registry);
+}
+
+/* ********************************************************************** */
+
+void test_shared_contexts(void) {
+  context_registry_t       *registry;
+  const compiled_context_t *shared_context;
+
+  registry = create_context_registry();
+  assert(registry != NULL);
+
+  /**
+   * @brief The Context IDs 0 and 1 publish the same Rules, they share one
+   * Compiled Context. The Context ID 2 publishes other Rules.
+   */
+  assert(publish_context(registry, compile_context_version(0, 0x12)));
+  assert(publish_context(registry, compile_context_version(1, 0x12)));
+  assert(publish_context(registry, compile_context_version(2, 0x13)));
+
+  shared_context = get_published_context(registry, 0);
+  assert(shared_context != NULL);
+  assert(get_published_context(registry, 1) == shared_context);
+  assert(get_published_context(registry, 2) != shared_context);
+  assert(shared_context->card_references == 2);
+
+  /**
+   * @brief Withdrawing the Context ID 0 keeps the shared Compiled Context
+   * alive for the Context ID 1.
+   */
+  assert(withdraw_context(registry, 0));
+  assert(reclaim_contexts(registry) == 0);
+  assert(get_published_context(registry, 1) == shared_context);
+  assert(shared_context->card_references == 1);
+
+  /**
+   * @brief Publishing the Rules of the Context ID 2 under the Context ID 1
+   * releases its last reference on the shared Compiled Context.
+   */
+  assert(publish_context(registry, compile_context_version(1, 0x13)));
+  assert(get_published_context(registry, 1) ==
+         get_published_context(registry, 2));
+  assert(reclaim_contexts(registry) == 0);
+
+  destroy_context_registry(registry);
+}
+
+/* ********************************************************************** */
+
+void test_devices(void) {
+  context_registry_t       *registry;
+  context_reader_t         *reader;
+  const compiled_context_t *compiled_contexts[3];
+  int                       status;
+
+  registry = create_context_registry();
+  assert(registry != NULL);
+  reader = register_context_reader(registry);
+  assert(reader != NULL);
+
+  for (uint8_t context_id = 0; context_id < 3; context_id++) {
+    status = publish_context(registry,
+                             compile_context_version(context_id, context_id));
+    assert(status);
+    compiled_contexts[context_id] = get_published_context(registry, context_id);
+  }
+
+  /**
+   * @brief Bind many devices to 3 Contexts. The Device Table grows several
+   * times while a reader is locked, the previous tables are freed once it
+   * unlocks.
+   */
+  context_reader_lock(registry, reader);
+  for (uint64_t device_id = 0; device_id < DEVICES; device_id++) {
+    status = bind_device(registry, device_id, (uint8_t) (device_id % 3));
+    assert(status);
+  }
+  assert(reclaim_contexts(registry) > 0);
+  context_reader_unlock(reader);
+  assert(reclaim_contexts(registry) == 0);
+
+  context_reader_lock(registry, reader);
+  for (uint64_t device_id = 0; device_id < DEVICES; device_id++) {
+    assert(get_device_context(registry, device_id) ==
+           compiled_contexts[device_id % 3]);
+  }
+  assert(get_device_context(registry, DEVICES) == NULL);
+  context_reader_unlock(reader);
+
+  /**
+   * @brief A device can move to another Context ID, or be unbound.
+   */
+  assert(bind_device(registry, 42, 1));
+  assert(get_device_context(registry, 42) == compiled_contexts[1]);
+  assert(unbind_device(registry, 42));
+  assert(!unbind_device(registry, 42));
+  assert(get_device_context(registry, 42) == NULL);
+  assert(!bind_device(registry, DEVICE_ID_EMPTY, 0));
+
+  /**
+   * @brief A device bound to a withdrawn Context ID has no Context.
+   */
+  assert(withdraw_context(registry, 2));
+  assert(get_device_context(registry, 2) == NULL);
+
+  unregister_context_reader(registry, reader);
+  destroy_context_registry(registry);
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Reader thread, compresses packet in batches of 10 while Compiled
+ * Contexts are being replaced.
+ *
+ * @param arg Pointer to the Context Registry.
+ * @return NULL.
+ */
+void *reader_thread(void *arg) {
+  context_registry_t *registry;
+  context_reader_t   *reader;
+  size_t              schc_packet_byte_len;
+
+  // Each thread compresses from its own memory pool
+  init_memory_pool();
+
+  registry = (context_registry_t *) arg;
+  reader   = register_context_reader(registry);
+  assert(reader != NULL);
+
+  for (int iteration = 0; iteration < READER_ITERATIONS; iteration++) {
+    context_reader_lock(registry, reader);
+    for (int index = 0; index < 10; index++) {
+      schc_packet_byte_len = compress_with_published_context(registry);
+      assert(schc_packet_byte_len == EXPECTED_SCHC_PACKET_BYTE_LEN);
+    }
+    context_reader_unlock(reader);
+  }
+
+  unregister_context_reader(registry, reader);
+  destroy_memory_pool();
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+void test_concurrent_hot_swap(void) {
+  context_registry_t *registry;
+  pthread_t           thread;
+  int                 status;
+
+  registry = create_context_registry();
+  assert(registry != NULL);
+  status =
+      publish_context(registry, compile_context(context, context_byte_len));
+  assert(status);
+
+  status = pthread_create(&thread, NULL, reader_thread, registry);
+  assert(status == 0);
+
+  for (int iteration = 0; iteration < WRITER_ITERATIONS; iteration++) {
+    status = publish_context(registry,
+                             compile_context_version(0, (uint8_t) iteration));
+    assert(status);
+    sched_yield();
+  }
+
+  status = pthread_join(thread, NULL);
+  assert(status == 0);
+  assert(reclaim_contexts(registry) == 0);
+
+  destroy_context_registry(registry);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_compile_context();
+  test_compiled_rules();
+  test_hot_swap();
+  test_shared_contexts();
+  test_devices();
+  test_concurrent_hot_swap();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
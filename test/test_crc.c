@@ -0,0 +1,57 @@
+#include "utils/crc.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+/* ********************************************************************** */
+
+void test_crc32(void) {
+  /**
+   * @brief Test the CRC32 check value and an empty buffer.
+   */
+
+  const uint8_t check[] = "123456789";
+
+  assert(crc32(check, strlen((const char *) check)) == 0xcbf43926u);
+  assert(crc32(check, 0) == 0x00000000u);
+}
+
+/* ********************************************************************** */
+
+void test_crc32_update(void) {
+  /**
+   * @brief Test that a CRC32 computed in several parts matches the CRC32
+   * computed at once.
+   */
+
+  uint8_t  buffer[300];
+  uint32_t crc;
+
+  for (size_t index = 0; index < sizeof(buffer); index++) {
+    buffer[index] = (uint8_t) (index * 7 + 3);
+  }
+
+  crc = CRC32_INIT;
+  crc = crc32_update(crc, buffer, 1);
+  crc = crc32_update(crc, buffer + 1, 150);
+  crc = crc32_update(crc, buffer + 151, sizeof(buffer) - 151);
+
+  assert(crc32_final(crc) == crc32(buffer, sizeof(buffer)));
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_crc32();
+  test_crc32_update();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/flow_cache.h"
+#include "core/rule_matcher.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_PACKETS       4000
+#define PACKET_BYTE_LEN    48
+#define FLOW_CACHE_ENTRIES 64
+
+/* ********************************************************************** */
+
+/**
+ * @brief The Rules 0 and 1 compress the UDP Device Port 0x1633, the Rule 0 only
+ * with a Hop Limit of 64, the Rule 2 the UDP Device Port 0x1634.
+ */
+const uint8_t context[] = {
+    // Context
+    0, 4, 0, 10, 0, 33, 0, 56, 0, 79,
+
+    // Rule Descriptors
+    0, 0, 10, 0, 82, 0, 92, 0, 100, 0, 108, 0, 116, 0, 126, 0, 144, 0, 154, 0,
+    162, 0, 182,  // Rule Descriptor n° 0
+    1, 0, 10, 0, 82, 0, 92, 0, 100, 0, 108, 0, 116, 0, 136, 0, 144, 0, 154, 0,
+    162, 0, 182,  // Rule Descriptor n° 1
+    2, 0, 10, 0, 82, 0, 92, 0, 100, 0, 108, 0, 116, 0, 136, 0, 144, 0, 154, 0,
+    172, 0, 182,  // Rule Descriptor n° 2
+    3, 1, 0,      // Rule Descriptor n° 3
+
+    // Rule Field Descriptors
+    0x13, 0xcc, 0, 4, 0, 1, 64, 1, 0, 190,    // sid-ipv6-version
+                                              // bi/eq/ns
+    0x13, 0xc9, 0, 8, 0, 1, 75, 0,            // sid-ipv6-traffic-class
+                                              // bi/ig/vs
+    0x13, 0xc5, 0, 20, 0, 1, 75, 0,           // sid-ipv6-flow-label
+                                              // bi/ig/vs
+    0x13, 0xc8, 0, 16, 0, 1, 75, 0,           // sid-ipv6-payload-length
+                                              // bi/ig/vs
+    0x13, 0xc7, 0, 8, 0, 1, 64, 1, 0, 191,    // sid-ipv6-next-header
+                                              // bi/eq/ns
+    0x13, 0xc6, 0, 8, 0, 1, 64, 1, 0, 192,    // sid-ipv6-hop-limit
+                                              // bi/eq/ns
+    0x13, 0xc6, 0, 8, 0, 1, 75, 0,            // sid-ipv6-hop-limit
+                                              // bi/ig/vs
+    0x13, 0xc1, 0, 128, 0, 1, 64, 1, 0, 193,  // sid-ipv6-src-address
+                                              // bi/eq/ns
+    0x13, 0xc4, 0, 128, 0, 1, 75, 0,          // sid-ipv6-dst-address
+                                              // bi/ig/vs
+    0x13, 0xd1, 0, 16, 0, 1, 64, 1, 0, 209,   // sid-udp-dev-port
+                                              // bi/eq/ns
+    0x13, 0xd1, 0, 16, 0, 1, 64, 1, 0, 211,   // sid-udp-dev-port
+                                              // bi/eq/ns
+    0x13, 0xce, 0, 16, 0, 1, 75, 0,           // sid-udp-app-port
+                                              // bi/ig/vs
+
+    // Target Values
+    0x06,                    // Version
+    0x11,                    // Next Header
+    0x40,                    // Hop Limit of the Rule 0
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x20,  // Source Address
+    0x16, 0x33,              // Device Port of the Rules 0 and 1
+    0x16, 0x34               // Device Port of the Rule 2
+};
+
+/* ********************************************************************** */
+
+/**
+ * @brief Builds an IPv6/UDP packet for the Rules of context.
+ *
+ * @param packet Pointer to the packet to fill, PACKET_BYTE_LEN bytes long.
+ * @param flow The last byte of the Destination Address.
+ * @param hop_limit The Hop Limit.
+ * @param dev_port The UDP Device Port.
+ */
+void build_packet(uint8_t packet[PACKET_BYTE_LEN], const uint8_t flow,
+                  const uint8_t hop_limit, const uint16_t dev_port) {
+  memset(packet, 0x00, PACKET_BYTE_LEN);
+  packet[0] = 0x60;
+  packet[5] = 8;
+  packet[6] = 0x11;
+  packet[7] = hop_limit;
+  memcpy(packet + 8, context + 193, 16);
+  packet[24] = 0xfe;
+  packet[25] = 0x80;
+  packet[39] = flow;
+  packet[40] = dev_port >> 8;
+  packet[41] = dev_port & 0xff;
+  packet[42] = 0x16;
+  packet[43] = 0x33;
+  memcpy(packet + 44, "schc", 4);
+}
+
+/**
+ * @brief Compresses a packet with and without a Flow Cache and checks that
+ * both give the same SCHC Packet.
+ *
+ * @return The Rule ID of the SCHC Packet.
+ */
+uint8_t compare_compression(const compiled_context_t *compiled_context,
+                            flow_cache_t *flow_cache, const uint8_t *packet,
+                            const size_t packet_byte_len,
+                            const size_t schc_packet_max_byte_len) {
+  uint8_t schc_packet[PACKET_BYTE_LEN + 1];
+  uint8_t cached_schc_packet[PACKET_BYTE_LEN + 1];
+  size_t  schc_packet_byte_len;
+
+  schc_packet_byte_len =
+      compress_compiled(schc_packet, schc_packet_max_byte_len, DI_UP, packet,
+                        packet_byte_len, compiled_context);
+  assert(compress_compiled_cached(cached_schc_packet, schc_packet_max_byte_len,
+                                  DI_UP, packet, packet_byte_len,
+                                  compiled_context,
+                                  flow_cache) == schc_packet_byte_len);
+  assert(memcmp(cached_schc_packet, schc_packet, schc_packet_byte_len) == 0);
+
+  return schc_packet[0] >> 6;
+}
+
+/* ********************************************************************** */
+
+void test_flow_cache_shadowing(void) {
+  /**
+   * @brief Test that only the earlier Rules with the same Target Values in the
+   * columns they share shadow a Rule.
+   */
+
+  compiled_context_t   *compiled_context;
+  const rule_matcher_t *rule_matcher;
+  uint64_t              candidate_rules[RULE_MATCHER_MASK_WORDS];
+
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+  rule_matcher = &compiled_context->rule_matchers[DI_UP];
+
+  memset(candidate_rules, 0x00, sizeof(candidate_rules));
+  candidate_rules[0] = 0x0f;
+  assert(!is_rule_shadowed(rule_matcher, candidate_rules, 0));
+  assert(is_rule_shadowed(rule_matcher, candidate_rules, 1));
+  assert(!is_rule_shadowed(rule_matcher, candidate_rules, 2));
+  assert(is_rule_shadowed(rule_matcher, candidate_rules, 3));
+
+  // Without the Rule 0 in the candidates
+  candidate_rules[0] = 0x0e;
+  assert(!is_rule_shadowed(rule_matcher, candidate_rules, 1));
+  assert(is_rule_shadowed(rule_matcher, candidate_rules, 3));
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_flow_cache_hits(void) {
+  /**
+   * @brief Test that the Rule of a flow is tried first when nothing shadows it,
+   * and that a shadowed Rule does not hide an earlier one.
+   */
+
+  compiled_context_t *compiled_context;
+  flow_cache_t        flow_cache;
+  uint8_t             packet[PACKET_BYTE_LEN];
+  uint32_t            flow_hash;
+
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+  assert(init_flow_cache(&flow_cache, 50));
+  assert(flow_cache.capacity == 64);
+
+  // The Rule 2 is never shadowed by the Rules 0 and 1
+  build_packet(packet, 1, 64, 0x1634);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 2);
+  assert(get_flow_hash(&flow_hash, packet, sizeof(packet)));
+  assert(get_flow_rule(&flow_cache, flow_hash) == 2);
+  assert(flow_cache.card_hits == 0 && flow_cache.card_misses == 1);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 2);
+  assert(flow_cache.card_hits == 1 && flow_cache.card_misses == 1);
+
+  // The Rule 1 is shadowed by the Rule 0 once the Hop Limit is 64
+  build_packet(packet, 2, 63, 0x1633);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 1);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 1);
+  assert(flow_cache.card_hits == 2 && flow_cache.card_misses == 2);
+  build_packet(packet, 2, 64, 0x1633);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 0);
+  assert(flow_cache.card_hits == 2 && flow_cache.card_misses == 3);
+  build_packet(packet, 2, 63, 0x1633);
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 1);
+  assert(flow_cache.card_hits == 2 && flow_cache.card_misses == 4);
+
+  // Other packets are not cached
+  packet[0] = 0x40;
+  assert(!get_flow_hash(&flow_hash, packet, sizeof(packet)));
+  assert(compare_compression(compiled_context, &flow_cache, packet,
+                             sizeof(packet), sizeof(packet) + 1) == 3);
+  assert(flow_cache.card_hits == 2 && flow_cache.card_misses == 4);
+
+  clear_flow_cache(&flow_cache);
+  build_packet(packet, 1, 64, 0x1634);
+  assert(get_flow_hash(&flow_hash, packet, sizeof(packet)));
+  assert(get_flow_rule(&flow_cache, flow_hash) == FLOW_CACHE_RULE_NONE);
+
+  destroy_flow_cache(&flow_cache);
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_flow_cache_random(void) {
+  /**
+   * @brief Test that random packets of a few flows, with random SCHC Packet
+   * capacities, are compressed as without Flow Cache, most of them with the
+   * cached Rule.
+   */
+
+  compiled_context_t *compiled_context;
+  flow_cache_t        flow_cache;
+  uint8_t             packet[PACKET_BYTE_LEN];
+  uint32_t            random_state;
+
+  const uint16_t dev_ports[] = {0x1633, 0x1634, 0x1635};
+
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+  assert(init_flow_cache(&flow_cache, FLOW_CACHE_ENTRIES));
+
+  random_state = 1;
+  for (int index = 0; index < CARD_PACKETS; index++) {
+    random_state = random_state * 1103515245u + 12345u;
+    build_packet(packet, (random_state >> 8) % 16,
+                 ((random_state >> 16) % 8 == 0) ? 64 : 63,
+                 dev_ports[(random_state >> 20) % 3]);
+    compare_compression(
+        compiled_context, &flow_cache, packet,
+        ((random_state >> 24) % 16 == 0) ? (random_state >> 12) % 48
+                                         : sizeof(packet),
+        ((random_state >> 28) % 4 == 0) ? 40 : sizeof(packet) + 1);
+  }
+
+  assert(flow_cache.card_hits > CARD_PACKETS / 2);
+
+  destroy_flow_cache(&flow_cache);
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_flow_cache_shadowing();
+  test_flow_cache_hits();
+  test_flow_cache_random();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
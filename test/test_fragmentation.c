@@ -0,0 +1,752 @@
+#include "core/compression.h"
+#include "core/context.h"
+#include "core/decompression.h"
+#include "core/fragmentation.h"
+#include "utils/binary.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define PACKET_BYTE_LEN      200
+#define LORAWAN_MTU          51  // LoRaWAN DR0 payload
+#define MAX_FRAGMENTS        16
+#define DEVICE_ID            0x0123456789abcdefull
+#define REASSEMBLY_BUFFERS   4
+#define TIMER_WHEEL_SLOTS    64
+#define RETRANSMISSION_TICKS 4
+#define INACTIVITY_TICKS     100
+#define LOSS_PERCENT         20
+#define SIMULATED_PACKETS    32
+#define MAX_SIMULATED_TICKS  1000
+
+/* ********************************************************************** */
+
+const uint8_t context[] = {
+    // Context
+    0, 3, 0, 8, 0, 11, 0, 23,
+
+    // Rule Descriptors
+    0, 1, 0,                              // No-compression Rule
+    1, 2, 0, 0, 0, 2, 0, 1, 1, 0, 0, 10,  // No-ACK, DTag 2 bits, 10-byte tiles
+    2, 2, 0, 2, 0, 2, 3, 3, 7, 8, 0, 10   // ACK-on-Error, W 3 bits, FCN 3 bits,
+                                          // windows of 7 tiles
+};
+
+/* ********************************************************************** */
+
+/**
+ * @brief Compresses a Packet with the No-compression Rule and fragments it.
+ *
+ * @param fragments Fragments to fill.
+ * @param fragment_byte_lens Byte lengths of the fragments.
+ * @param dtag Datagram Tag.
+ * @param packet Packet to send.
+ * @return The number of fragments.
+ */
+size_t fragment_packet(uint8_t fragments[MAX_FRAGMENTS][LORAWAN_MTU],
+                       size_t fragment_byte_lens[MAX_FRAGMENTS],
+                       const uint8_t dtag, const uint8_t *packet) {
+  fragmentation_descriptor_t descriptor;
+  fragmentation_sender_t     sender;
+  rule_descriptor_t          rule_descriptor;
+  uint8_t                    schc_packet[PACKET_BYTE_LEN + 1];
+  size_t                     schc_packet_byte_len;
+  size_t                     card_fragments;
+  int                        status;
+
+  schc_packet_byte_len =
+      compress(schc_packet, sizeof(schc_packet), DI_UP, packet,
+               PACKET_BYTE_LEN, context, sizeof(context));
+  assert(schc_packet_byte_len == PACKET_BYTE_LEN + 1);
+
+  status = get_rule_descriptor(&rule_descriptor, 1, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(&descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(status);
+  status = init_fragmentation_sender(&sender, &descriptor, dtag, schc_packet,
+                                     schc_packet_byte_len, NULL, 0);
+  assert(status);
+
+  card_fragments = 0;
+  while (!sender.is_complete) {
+    assert(card_fragments < MAX_FRAGMENTS);
+    fragment_byte_lens[card_fragments] =
+        get_next_fragment(&sender, fragments[card_fragments], LORAWAN_MTU);
+    assert(fragment_byte_lens[card_fragments] > 0);
+    assert(fragment_byte_lens[card_fragments] <= LORAWAN_MTU);
+    card_fragments++;
+  }
+  assert(get_next_fragment(&sender, fragments[0], LORAWAN_MTU) == 0);
+
+  return card_fragments;
+}
+
+/* ********************************************************************** */
+
+void test_fragmentation_descriptor(void) {
+  /**
+   * @brief Test that Fragmentation Rules are validated with the Context and
+   * that their parameters are read back.
+   */
+
+  validated_context_t        validated_context;
+  fragmentation_descriptor_t descriptor;
+  rule_descriptor_t          rule_descriptor;
+  uint8_t                    invalid_context[sizeof(context)];
+  int                        status;
+
+  status = context_validate(&validated_context, context, sizeof(context));
+  assert(status);
+
+  status = get_rule_descriptor(&rule_descriptor, 1, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(&descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(status);
+  assert(descriptor.rule_id == 1);
+  assert(descriptor.rule_id_len == 2);
+  assert(descriptor.mode == FRAGMENTATION_NO_ACK);
+  assert(descriptor.di == DI_UP);
+  assert(descriptor.dtag_len == 2);
+  assert(descriptor.w_len == 0);
+  assert(descriptor.fcn_len == 1);
+  assert(descriptor.tile_byte_len == 10);
+
+  status = get_rule_descriptor(&rule_descriptor, 2, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(&descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(status);
+  assert(descriptor.mode == FRAGMENTATION_ACK_ON_ERROR);
+  assert(descriptor.w_len == 3);
+  assert(descriptor.fcn_len == 3);
+  assert(descriptor.window_size == 7);
+  assert(descriptor.max_ack_requests == 8);
+
+  // The No-compression Rule is not a Fragmentation Rule
+  status = get_rule_descriptor(&rule_descriptor, 0, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(&descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(!status);
+
+  // Truncated parameters
+  status = context_validate(&validated_context, context, sizeof(context) - 1);
+  assert(!status);
+
+  // No-ACK has no window
+  memcpy(invalid_context, context, sizeof(context));
+  invalid_context[17] = 1;
+  status = context_validate(&validated_context, invalid_context,
+                            sizeof(invalid_context));
+  assert(!status);
+
+  // Empty tiles
+  memcpy(invalid_context, context, sizeof(context));
+  invalid_context[22] = 0;
+  status = context_validate(&validated_context, invalid_context,
+                            sizeof(invalid_context));
+  assert(!status);
+
+  // The All-1 FCN cannot number a tile of a window
+  memcpy(invalid_context, context, sizeof(context));
+  invalid_context[31] = 8;
+  status = context_validate(&validated_context, invalid_context,
+                            sizeof(invalid_context));
+  assert(!status);
+}
+
+/* ********************************************************************** */
+
+void test_reassembly_pool(void) {
+  /**
+   * @brief Test that a device cannot hold more than its share of reassembly
+   * buffers and that the memory pool is given back.
+   */
+
+  reassembly_pool_t reassembly_pool;
+  uint8_t          *first_buffer;
+  uint8_t          *second_buffer;
+  uint8_t          *third_buffer;
+  size_t            used;
+  int               status;
+
+  used   = pool->used;
+  status = init_reassembly_pool(&reassembly_pool, 3, PACKET_BYTE_LEN, 2);
+  assert(status);
+
+  first_buffer  = acquire_reassembly_buffer(&reassembly_pool, 1);
+  second_buffer = acquire_reassembly_buffer(&reassembly_pool, 1);
+  assert(first_buffer != NULL && second_buffer != NULL);
+  assert(first_buffer != second_buffer);
+  assert(acquire_reassembly_buffer(&reassembly_pool, 1) == NULL);
+
+  third_buffer = acquire_reassembly_buffer(&reassembly_pool, 2);
+  assert(third_buffer != NULL);
+  assert(acquire_reassembly_buffer(&reassembly_pool, 3) == NULL);
+
+  release_reassembly_buffer(&reassembly_pool, first_buffer);
+  assert(acquire_reassembly_buffer(&reassembly_pool, 3) == first_buffer);
+
+  destroy_reassembly_pool(&reassembly_pool);
+  assert(pool->used == used);
+}
+
+/* ********************************************************************** */
+
+void test_no_ack(void) {
+  /**
+   * @brief Test that a Packet larger than the LoRaWAN MTU goes through
+   * compression, No-ACK fragmentation, reassembly and decompression.
+   */
+
+  uint8_t                    packet[PACKET_BYTE_LEN];
+  uint8_t                    decompressed_packet[PACKET_BYTE_LEN + 1];
+  uint8_t                    fragments[MAX_FRAGMENTS][LORAWAN_MTU];
+  size_t                     fragment_byte_lens[MAX_FRAGMENTS];
+  size_t                     card_fragments;
+  size_t                     decompressed_packet_byte_len;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_receiver_t   receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  int                        status;
+
+  for (size_t index = 0; index < PACKET_BYTE_LEN; index++) {
+    packet[index] = (uint8_t) (index * 13 + 5);
+  }
+
+  card_fragments = fragment_packet(fragments, fragment_byte_lens, 3, packet);
+  assert(card_fragments == 5);
+
+  // The receiver finds the Fragmentation Rule from the Rule ID
+  status = get_fragment_descriptor(&descriptor, fragments[0],
+                                   fragment_byte_lens[0], context,
+                                   sizeof(context));
+  assert(status);
+  assert(descriptor.rule_id == 1);
+
+  status = init_reassembly_pool(&reassembly_pool, REASSEMBLY_BUFFERS,
+                                PACKET_BYTE_LEN + 1, 1);
+  assert(status);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID, NULL, 0);
+  assert(status);
+
+  for (size_t index = 0; index < card_fragments - 1; index++) {
+    reassembly_status = receive_fragment(&receiver, fragments[index],
+                                         fragment_byte_lens[index]);
+    assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  }
+  reassembly_status =
+      receive_fragment(&receiver, fragments[card_fragments - 1],
+                       fragment_byte_lens[card_fragments - 1]);
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+  assert(receiver.byte_len == PACKET_BYTE_LEN + 1);
+
+  decompressed_packet_byte_len =
+      decompress(decompressed_packet, sizeof(decompressed_packet), DI_UP,
+                 receiver.buffer, receiver.byte_len, context, sizeof(context));
+  assert(decompressed_packet_byte_len >= PACKET_BYTE_LEN);
+  assert(memcmp(decompressed_packet, packet, PACKET_BYTE_LEN) == 0);
+
+  reset_fragmentation_receiver(&receiver);
+  assert(receiver.buffer == NULL);
+
+  destroy_reassembly_pool(&reassembly_pool);
+}
+
+/* ********************************************************************** */
+
+void test_no_ack_loss(void) {
+  /**
+   * @brief Test that a lost fragment is detected by the RCS, and that a new
+   * DTag restarts the reassembly.
+   */
+
+  uint8_t                    packet[PACKET_BYTE_LEN];
+  uint8_t                    fragments[MAX_FRAGMENTS][LORAWAN_MTU];
+  size_t                     fragment_byte_lens[MAX_FRAGMENTS];
+  size_t                     card_fragments;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_receiver_t   receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  int                        status;
+
+  memset(packet, 0xa5, sizeof(packet));
+
+  card_fragments = fragment_packet(fragments, fragment_byte_lens, 1, packet);
+
+  status = get_fragment_descriptor(&descriptor, fragments[0],
+                                   fragment_byte_lens[0], context,
+                                   sizeof(context));
+  assert(status);
+  status = init_reassembly_pool(&reassembly_pool, REASSEMBLY_BUFFERS,
+                                PACKET_BYTE_LEN + 1, 1);
+  assert(status);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID, NULL, 0);
+  assert(status);
+
+  // The second fragment is lost
+  for (size_t index = 0; index < card_fragments - 1; index++) {
+    if (index != 1) {
+      reassembly_status = receive_fragment(&receiver, fragments[index],
+                                           fragment_byte_lens[index]);
+      assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+    }
+  }
+  reassembly_status =
+      receive_fragment(&receiver, fragments[card_fragments - 1],
+                       fragment_byte_lens[card_fragments - 1]);
+  assert(reassembly_status == REASSEMBLY_ERROR);
+  assert(receiver.buffer == NULL);
+
+  // The first fragments of DTag 1 are dropped once DTag 2 starts, the device
+  // holding a single reassembly buffer
+  reassembly_status =
+      receive_fragment(&receiver, fragments[0], fragment_byte_lens[0]);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+
+  card_fragments = fragment_packet(fragments, fragment_byte_lens, 2, packet);
+  for (size_t index = 0; index < card_fragments; index++) {
+    reassembly_status = receive_fragment(&receiver, fragments[index],
+                                         fragment_byte_lens[index]);
+  }
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+  assert(receiver.dtag == 2);
+
+  reset_fragmentation_receiver(&receiver);
+  destroy_reassembly_pool(&reassembly_pool);
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Gets the ACK-on-Error Fragmentation Rule and fills a SCHC Packet.
+ *
+ * @param descriptor Fragmentation Descriptor to fill.
+ * @param schc_packet SCHC Packet to fill.
+ * @param seed Seed of the SCHC Packet content.
+ */
+void init_ack_on_error(fragmentation_descriptor_t *descriptor,
+                       uint8_t schc_packet[PACKET_BYTE_LEN + 1],
+                       const uint8_t seed) {
+  rule_descriptor_t rule_descriptor;
+  int               status;
+
+  status = get_rule_descriptor(&rule_descriptor, 2, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(status);
+
+  for (size_t index = 0; index < PACKET_BYTE_LEN + 1; index++) {
+    schc_packet[index] = (uint8_t) (index * 7 + seed);
+  }
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Draws whether a SCHC message is lost, from a linear congruential
+ * generator so that runs are reproducible.
+ *
+ * @param state State of the generator.
+ * @return 1 if the message is lost, otherwise 0.
+ */
+int is_lost(uint32_t *state) {
+  *state = *state * 1103515245u + 12345u;
+
+  return (*state >> 16) % 100 < LOSS_PERCENT;
+}
+
+/* ********************************************************************** */
+
+void test_ack_on_error(void) {
+  /**
+   * @brief Test that a lost fragment is reported by a SCHC ACK and sent again,
+   * and that the compressed bitmap only covers the windows sent.
+   */
+
+  uint8_t                    schc_packet[PACKET_BYTE_LEN + 1];
+  uint8_t                    fragment[LORAWAN_MTU];
+  uint8_t                    ack[LORAWAN_MTU];
+  size_t                     fragment_byte_len;
+  size_t                     ack_byte_len;
+  size_t                     card_fragments;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_sender_t     sender;
+  fragmentation_receiver_t   receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  init_ack_on_error(&descriptor, schc_packet, 1);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_pool(&reassembly_pool, REASSEMBLY_BUFFERS,
+                                PACKET_BYTE_LEN + 1, 1);
+  assert(status);
+
+  // The Retransmission Timer needs a Timer Wheel
+  status = init_fragmentation_sender(&sender, &descriptor, 1, schc_packet,
+                                     sizeof(schc_packet), NULL, 0);
+  assert(!status);
+
+  status = init_fragmentation_sender(&sender, &descriptor, 1, schc_packet,
+                                     sizeof(schc_packet), &timer_wheel,
+                                     RETRANSMISSION_TICKS);
+  assert(status);
+  assert(sender.card_tiles == 21);
+  assert(sender.last_window == 2);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID,
+                                       &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+
+  // 4 then 3 tiles per window, the second fragment is lost
+  card_fragments = 0;
+  while ((fragment_byte_len =
+              get_next_fragment(&sender, fragment, sizeof(fragment))) > 0) {
+    if (card_fragments != 1) {
+      reassembly_status =
+          receive_fragment(&receiver, fragment, fragment_byte_len);
+      assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+    }
+    card_fragments++;
+  }
+  assert(card_fragments == 7);
+  assert(sender.step == SENDER_WAIT_ACK);
+  assert(receiver.is_all_1_received);
+
+  // Window 0, tiles 4 to 6 missing
+  ack_byte_len = get_next_ack(&receiver, ack, sizeof(ack));
+  assert(ack_byte_len == 2);
+  assert(ack[0] == 0x90);  // Rule 2, DTag 1, W 0, C 0
+  assert(ack[1] == 0xf0);  // Bitmap 1111000
+  assert(get_next_ack(&receiver, ack, sizeof(ack)) == 0);
+
+  status = receive_ack(&sender, ack, ack_byte_len);
+  assert(status);
+  assert(sender.step == SENDER_RESEND_TILES);
+
+  // The missing tiles, then an ACK REQ as window 0 is not the last one
+  fragment_byte_len = get_next_fragment(&sender, fragment, sizeof(fragment));
+  assert(fragment_byte_len == BYTE_LENGTH(10 + 3 * 8 * 10));
+  reassembly_status = receive_fragment(&receiver, fragment, fragment_byte_len);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+
+  fragment_byte_len = get_next_fragment(&sender, fragment, sizeof(fragment));
+  assert(fragment_byte_len == 2);
+  reassembly_status = receive_fragment(&receiver, fragment, fragment_byte_len);
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+  assert(receiver.byte_len == sizeof(schc_packet));
+  assert(memcmp(receiver.buffer, schc_packet, sizeof(schc_packet)) == 0);
+
+  // C=1 for the last window
+  ack_byte_len = get_next_ack(&receiver, ack, sizeof(ack));
+  assert(ack_byte_len == 1);
+  assert(ack[0] == 0x95);
+  status = receive_ack(&sender, ack, ack_byte_len);
+  assert(status);
+  assert(sender.is_complete);
+  assert(sender.step == SENDER_DONE);
+  assert(get_next_fragment(&sender, fragment, sizeof(fragment)) == 0);
+  assert(timer_wheel.card_timers == 0);
+
+  reset_fragmentation_receiver(&receiver);
+  destroy_reassembly_pool(&reassembly_pool);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_ack_on_error_lossy_link(void) {
+  /**
+   * @brief Test that SCHC Packets go through a link losing fragments and SCHC
+   * ACKs in both directions, timers being driven by a simulated clock.
+   */
+
+  uint8_t                    schc_packet[PACKET_BYTE_LEN + 1];
+  uint8_t                    fragment[LORAWAN_MTU];
+  uint8_t                    ack[LORAWAN_MTU];
+  size_t                     fragment_byte_len;
+  size_t                     ack_byte_len;
+  size_t                     card_complete;
+  uint64_t                   tick;
+  uint32_t                   state;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_sender_t     sender;
+  fragmentation_receiver_t   receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_pool(&reassembly_pool, REASSEMBLY_BUFFERS,
+                                PACKET_BYTE_LEN + 1, 1);
+  assert(status);
+
+  init_ack_on_error(&descriptor, schc_packet, 0);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID,
+                                       &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+
+  state = 42;
+  tick  = 0;
+
+  for (uint8_t packet = 0; packet < SIMULATED_PACKETS; packet++) {
+    init_ack_on_error(&descriptor, schc_packet, packet);
+    status = init_fragmentation_sender(&sender, &descriptor, packet % 4,
+                                       schc_packet, sizeof(schc_packet),
+                                       &timer_wheel, RETRANSMISSION_TICKS);
+    assert(status);
+
+    card_complete = 0;
+    while (sender.step != SENDER_DONE) {
+      assert(tick < MAX_SIMULATED_TICKS * SIMULATED_PACKETS);
+
+      while ((fragment_byte_len = get_next_fragment(&sender, fragment,
+                                                    sizeof(fragment))) > 0) {
+        if (is_lost(&state)) {
+          continue;
+        }
+        reassembly_status =
+            receive_fragment(&receiver, fragment, fragment_byte_len);
+        assert(reassembly_status != REASSEMBLY_ERROR);
+        if (reassembly_status == REASSEMBLY_COMPLETE) {
+          assert(receiver.byte_len == sizeof(schc_packet));
+          assert(memcmp(receiver.buffer, schc_packet, sizeof(schc_packet)) ==
+                 0);
+          reset_fragmentation_receiver(&receiver);
+          card_complete++;
+        }
+      }
+
+      ack_byte_len = get_next_ack(&receiver, ack, sizeof(ack));
+      if (ack_byte_len > 0 && !is_lost(&state)) {
+        receive_ack(&sender, ack, ack_byte_len);
+      }
+
+      advance_timer_wheel(&timer_wheel, ++tick);
+    }
+
+    // Delivered once, and acknowledged
+    assert(sender.is_complete);
+    assert(!sender.is_aborted);
+    assert(card_complete == 1);
+  }
+
+  reset_fragmentation_receiver(&receiver);
+  assert(timer_wheel.card_timers == 0);
+
+  destroy_reassembly_pool(&reassembly_pool);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_ack_on_error_abort(void) {
+  /**
+   * @brief Test that the sender aborts after MAX_ACK_REQUESTS unanswered ACK
+   * REQs, and that the receiver aborts when the Inactivity Timer expires.
+   */
+
+  uint8_t                    schc_packet[PACKET_BYTE_LEN + 1];
+  uint8_t                    fragment[LORAWAN_MTU];
+  uint8_t                    ack[LORAWAN_MTU];
+  size_t                     fragment_byte_len;
+  size_t                     ack_byte_len;
+  size_t                     card_ack_requests;
+  uint64_t                   tick;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_sender_t     sender;
+  fragmentation_receiver_t   receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  init_ack_on_error(&descriptor, schc_packet, 2);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_pool(&reassembly_pool, REASSEMBLY_BUFFERS,
+                                PACKET_BYTE_LEN + 1, 1);
+  assert(status);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID,
+                                       &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+
+  // Every SCHC ACK is lost
+  status = init_fragmentation_sender(&sender, &descriptor, 0, schc_packet,
+                                     sizeof(schc_packet), &timer_wheel,
+                                     RETRANSMISSION_TICKS);
+  assert(status);
+
+  tick              = 0;
+  card_ack_requests = 0;
+  while (sender.step != SENDER_DONE) {
+    while ((fragment_byte_len =
+                get_next_fragment(&sender, fragment, sizeof(fragment))) > 0) {
+      reassembly_status =
+          receive_fragment(&receiver, fragment, fragment_byte_len);
+      if (fragment_byte_len == 2 && sender.step == SENDER_WAIT_ACK) {
+        card_ack_requests++;
+      }
+    }
+    get_next_ack(&receiver, ack, sizeof(ack));
+    advance_timer_wheel(&timer_wheel, ++tick);
+  }
+  assert(sender.is_aborted);
+  assert(!sender.is_complete);
+  assert(card_ack_requests == descriptor.max_ack_requests);
+  assert(reassembly_status == REASSEMBLY_ERROR);
+  assert(receiver.buffer == NULL);
+
+  // Only the first fragment arrives
+  status = init_fragmentation_sender(&sender, &descriptor, 1, schc_packet,
+                                     sizeof(schc_packet), &timer_wheel,
+                                     RETRANSMISSION_TICKS);
+  assert(status);
+  fragment_byte_len = get_next_fragment(&sender, fragment, sizeof(fragment));
+  reassembly_status = receive_fragment(&receiver, fragment, fragment_byte_len);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  while (get_next_fragment(&sender, fragment, sizeof(fragment)) > 0) {
+  }
+  assert(get_next_ack(&receiver, ack, sizeof(ack)) == 0);
+
+  // The Retransmission Timer fires first, its ACK REQs are lost too
+  advance_timer_wheel(&timer_wheel, tick + INACTIVITY_TICKS);
+  assert(receiver.buffer == NULL);
+
+  ack_byte_len = get_next_ack(&receiver, ack, sizeof(ack));
+  assert(ack_byte_len == 2);
+  assert(ack[0] == 0x9f);  // Rule 2, DTag 1, W 7, C 1
+  assert(ack[1] == 0xff);
+  status = receive_ack(&sender, ack, ack_byte_len);
+  assert(status);
+  assert(sender.is_aborted);
+  assert(sender.step == SENDER_DONE);
+  assert(timer_wheel.card_timers == 0);
+
+  reset_fragmentation_receiver(&receiver);
+  destroy_reassembly_pool(&reassembly_pool);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_ack_on_error_out_of_range_window(void) {
+  /**
+   * @brief Test that an ACK REQ or an All-1 fragment whose W has no tile in
+   * the reassembly buffer is rejected, and that a SCHC ACK only reports the
+   * tiles of its own buffer, not those of the next buffer of the pool.
+   */
+
+  uint8_t                    schc_packet[PACKET_BYTE_LEN + 1];
+  uint8_t                    fragment[LORAWAN_MTU];
+  uint8_t                    ack[LORAWAN_MTU];
+  size_t                     fragment_byte_len;
+  size_t                     ack_byte_len;
+  fragmentation_descriptor_t descriptor;
+  fragmentation_sender_t     sender;
+  fragmentation_receiver_t   receiver;
+  fragmentation_receiver_t   other_receiver;
+  reassembly_pool_t          reassembly_pool;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  // Rule 2, DTag 0, W 5: tiles 35 to 41, beyond the 3 tiles of a buffer and
+  // the 32 bits of its bitmap
+  const uint8_t ack_request[]     = {0x8a, 0x00};
+  const uint8_t all_1_fragment[]  = {0x8b, 0xc0, 0x00, 0x00, 0x00, 0x00};
+  const uint8_t ack_request_w_0[] = {0x80, 0x00};
+
+  init_ack_on_error(&descriptor, schc_packet, 3);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_pool(&reassembly_pool, 2, 30, 1);
+  assert(status);
+  status = init_fragmentation_receiver(&receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID,
+                                       &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+  status = init_fragmentation_receiver(&other_receiver, &descriptor,
+                                       &reassembly_pool, DEVICE_ID + 1,
+                                       &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+
+  // The first buffer for this device, the second one filled by another device
+  reassembly_status =
+      receive_fragment(&receiver, ack_request_w_0, sizeof(ack_request_w_0));
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  status = init_fragmentation_sender(&sender, &descriptor, 0, schc_packet, 30,
+                                     &timer_wheel, RETRANSMISSION_TICKS);
+  assert(status);
+  while ((fragment_byte_len =
+              get_next_fragment(&sender, fragment, sizeof(fragment))) > 0) {
+    reassembly_status =
+        receive_fragment(&other_receiver, fragment, fragment_byte_len);
+  }
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+
+  // No tile received, including those beyond the buffer
+  ack_byte_len = get_next_ack(&receiver, ack, sizeof(ack));
+  assert(ack_byte_len == 2);
+  assert(ack[0] == 0x80);  // Rule 2, DTag 0, W 0, C 0
+  assert(ack[1] == 0x00);  // Bitmap 0000000
+
+  reassembly_status =
+      receive_fragment(&receiver, ack_request, sizeof(ack_request));
+  assert(reassembly_status == REASSEMBLY_ERROR);
+  assert(receiver.buffer == NULL);
+  assert(get_next_ack(&receiver, ack, sizeof(ack)) == 0);
+
+  reassembly_status =
+      receive_fragment(&receiver, all_1_fragment, sizeof(all_1_fragment));
+  assert(reassembly_status == REASSEMBLY_ERROR);
+  assert(receiver.buffer == NULL);
+  assert(!receiver.is_all_1_received);
+  assert(get_next_ack(&receiver, ack, sizeof(ack)) == 0);
+
+  reset_fragmentation_receiver(&other_receiver);
+  reset_fragmentation_receiver(&receiver);
+  stop_wheel_timer(&timer_wheel, &sender.retransmission_timer);
+  destroy_reassembly_pool(&reassembly_pool);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_fragmentation_descriptor();
+  test_reassembly_pool();
+  test_no_ack();
+  test_no_ack_loss();
+  test_ack_on_error();
+  test_ack_on_error_lossy_link();
+  test_ack_on_error_abort();
+  test_ack_on_error_out_of_range_window();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
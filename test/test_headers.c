@@ -94,10 +94,126 @@ void test_get_coap_option_bit_length(void) {
 
 /* ********************************************************************** */
 
+void test_parse_coap_options(void) {
+  coap_options_t coap_options;
+
+  /**
+   * @brief Parse the Options of a CoAP message without Token.
+   *
+   * @details Observe (6), Uri-Path (11) with an Option Length Extended on 8
+   * bits, Block2 (23), then an empty Option with an Option Delta Extended on
+   * 16 bits (23 + 300), and the Payload Marker.
+   */
+  const uint8_t packet[] = {
+      0x50, 0x45, 0x12, 0x34,  // CoAP Header
+      0x61, 0x05,              // Observe
+      0x5d, 0x01, 0x61, 0x62, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6a,
+      0x6b, 0x6c, 0x6d, 0x6e,  // Uri-Path "abcdefghijklmn"
+      0xc1, 0x02,              // Block2
+      0xe0, 0x00, 0x1f,        // Option 323
+      0xff, 0x32, 0x31         // Payload Marker and Payload
+  };
+
+  assert(parse_coap_options(&coap_options, packet, sizeof(packet), 4, 0));
+  assert(coap_options.card_options == 4);
+  assert(coap_options.end_offset == 27);
+
+  assert(coap_options.options[0].number == COAP_OPTION_NUMBER_OBSERVE);
+  assert(coap_options.options[0].position == 1);
+  assert(coap_options.options[0].length == 1);
+  assert(coap_options.options[0].header_offset == 4);
+  assert(coap_options.options[0].value_offset == 5);
+
+  assert(coap_options.options[1].number == COAP_OPTION_NUMBER_URI_PATH);
+  assert(coap_options.options[1].length == 14);
+  assert(coap_options.options[1].header_offset == 6);
+  assert(coap_options.options[1].value_offset == 8);
+
+  assert(coap_options.options[2].number == COAP_OPTION_NUMBER_BLOCK2);
+  assert(coap_options.options[2].value_offset == 23);
+
+  assert(coap_options.options[3].number == COAP_OPTION_NUMBER_BLOCK2 + 300);
+  assert(coap_options.options[3].length == 0);
+  assert(coap_options.options[3].value_offset == 27);
+
+  // Options after Option 11, without Payload Marker
+  assert(parse_coap_options(&coap_options, packet, 24, 22, 11));
+  assert(coap_options.card_options == 1);
+  assert(coap_options.options[0].number == COAP_OPTION_NUMBER_BLOCK2);
+  assert(coap_options.end_offset == 24);
+
+  /**
+   * @brief Parse repeated Options, numbered by their occurrence.
+   */
+  const uint8_t repeated_packet[] = {
+      0xb3, 0x61, 0x70, 0x69,  // Uri-Path "api"
+      0x02, 0x76, 0x31,        // Uri-Path "v1"
+      0x01, 0x78,              // Uri-Path "x"
+      0x41, 0x79,              // Uri-Query "y"
+      0x01, 0x7a               // Uri-Query "z"
+  };
+
+  assert(parse_coap_options(&coap_options, repeated_packet,
+                            sizeof(repeated_packet), 0, 0));
+  assert(coap_options.card_options == 5);
+  for (size_t index = 0; index < 3; index++) {
+    assert(coap_options.options[index].number == COAP_OPTION_NUMBER_URI_PATH);
+    assert(coap_options.options[index].position == index + 1);
+  }
+  assert(coap_options.options[3].number == COAP_OPTION_NUMBER_URI_QUERY);
+  assert(coap_options.options[3].position == 1);
+  assert(coap_options.options[4].position == 2);
+
+  /**
+   * @brief Parse Options with a reserved nibble, and a truncated Option Value.
+   */
+  const uint8_t reserved_packet[]  = {0x61, 0x05, 0xf1, 0x00};
+  const uint8_t truncated_packet[] = {0x61, 0x05, 0x13, 0x00};
+
+  assert(!parse_coap_options(&coap_options, reserved_packet,
+                             sizeof(reserved_packet), 0, 0));
+  assert(!parse_coap_options(&coap_options, truncated_packet,
+                             sizeof(truncated_packet), 0, 0));
+}
+
+/* ********************************************************************** */
+
+void test_add_coap_option_header(void) {
+  uint8_t buffer[6];
+  size_t  bit_position;
+
+  /**
+   * @brief Add the headers of Options with a Delta of 6 and a Length of 1,
+   * then with a Delta of 235 and a Length of 300.
+   *
+   * @details The second one needs an extension on 8 bits for the Option Delta
+   * and on 16 bits for the Option Length.
+   */
+  const uint8_t expected_buffer[] = {0x61, 0xde, 0xde, 0x00, 0x1f};
+
+  memset(buffer, 0x00, sizeof(buffer));
+  bit_position = 0;
+  assert(add_coap_option_header(buffer, sizeof(buffer), &bit_position, 6, 1));
+  assert(bit_position == 8);
+  assert(
+      add_coap_option_header(buffer, sizeof(buffer), &bit_position, 235, 300));
+  assert(bit_position == 40);
+  assert(memcmp(buffer, expected_buffer, sizeof(expected_buffer)) == 0);
+
+  // Not enough room left for a 4-byte header
+  assert(
+      !add_coap_option_header(buffer, sizeof(buffer), &bit_position, 300, 0));
+  assert(bit_position == 40);
+}
+
+/* ********************************************************************** */
+
 int main(void) {
   test_udp_checksum();
   test_set_coap_option_variable_length();
   test_get_coap_option_bit_length();
+  test_parse_coap_options();
+  test_add_coap_option_header();
 
   printf("All tests passed!\n");
 
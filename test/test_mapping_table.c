@@ -0,0 +1,224 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/mapping_table.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_TARGET_VALUES      200
+#define RULE_FIELD_DESCRIPTORS  28
+#define TARGET_VALUES           (RULE_FIELD_DESCRIPTORS + 14 + 2 * 408)
+#define CONTEXT_BYTE_LEN        (TARGET_VALUES + 2 * CARD_TARGET_VALUES)
+
+/* ********************************************************************** */
+
+uint8_t context[CONTEXT_BYTE_LEN];
+
+/* ********************************************************************** */
+
+/**
+ * @brief Builds a Context whose Rules map a 16-bit Field on the 3 first Target
+ * Values, then on all of them, then a 12-bit Field on all of them, followed by
+ * the no-compression Rule.
+ *
+ * @details The Target Values are spread over 16 bits, the one at index 150 is
+ * the one at index 20 again, and the one at index 5 fits on 12 bits.
+ */
+void build_context(void) {
+  const uint8_t card_target_values[] = {3, CARD_TARGET_VALUES,
+                                        CARD_TARGET_VALUES};
+  const uint8_t lens[]               = {16, 16, 12};
+  uint16_t      target_value;
+  size_t        offset;
+  size_t        rule_field_descriptor_offset;
+
+  memset(context, 0x00, sizeof(context));
+  context[0] = 0;
+  context[1] = 4;
+
+  offset                       = 10;
+  rule_field_descriptor_offset = RULE_FIELD_DESCRIPTORS;
+  for (int index = 0; index < 3; index++) {
+    context[2 + 2 * index]     = offset >> 8;
+    context[2 + 2 * index + 1] = offset & 0xff;
+
+    // Rule Descriptor
+    context[offset++] = index;
+    context[offset++] = NATURE_COMPRESSION;
+    context[offset++] = 1;
+    context[offset++] = rule_field_descriptor_offset >> 8;
+    context[offset++] = rule_field_descriptor_offset & 0xff;
+
+    // Rule Field Descriptor sid-udp-app-port bi/mm/ms
+    context[rule_field_descriptor_offset++] = 0x13;
+    context[rule_field_descriptor_offset++] = 0xce;
+    context[rule_field_descriptor_offset++] = 0;
+    context[rule_field_descriptor_offset++] = lens[index];
+    context[rule_field_descriptor_offset++] = 0;
+    context[rule_field_descriptor_offset++] = 1;
+    context[rule_field_descriptor_offset++] = 0x5a;
+    context[rule_field_descriptor_offset++] = card_target_values[index];
+    for (int index_target_value = 0;
+         index_target_value < card_target_values[index];
+         index_target_value++) {
+      context[rule_field_descriptor_offset++] =
+          (TARGET_VALUES + 2 * index_target_value) >> 8;
+      context[rule_field_descriptor_offset++] =
+          (TARGET_VALUES + 2 * index_target_value) & 0xff;
+    }
+  }
+  context[8] = offset >> 8;
+  context[9] = offset & 0xff;
+  context[offset++] = 3;
+  context[offset++] = NATURE_NO_COMPRESSION;
+  context[offset++] = 0;
+  assert(offset == RULE_FIELD_DESCRIPTORS);
+  assert(rule_field_descriptor_offset == TARGET_VALUES);
+
+  for (int index = 0; index < CARD_TARGET_VALUES; index++) {
+    target_value = (uint16_t) (index * 7919 + 1234);
+    if (index == 150) {
+      target_value = (uint16_t) (20 * 7919 + 1234);
+    } else if (index == 5) {
+      target_value = 0x0abc;
+    }
+    context[TARGET_VALUES + 2 * index]     = target_value >> 8;
+    context[TARGET_VALUES + 2 * index + 1] = target_value & 0xff;
+  }
+}
+
+/* ********************************************************************** */
+
+void test_mapping_table_lookup(void) {
+  /**
+   * @brief Test that the Mapping Tables are sorted and give the index of the
+   * Target Value, the lowest one among equal Target Values.
+   */
+
+  compiled_context_t      *compiled_context;
+  const mapping_table_t   *mapping_table;
+  rule_field_descriptor_t  rule_field_descriptor;
+  uint8_t                  field[2];
+  uint8_t                  mapping_index;
+  int                      card_short_target_values;
+
+  build_context();
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+  assert(compiled_context->mapping_tables.card_tables == 3);
+
+  get_compiled_rule_field_descriptor(
+      &rule_field_descriptor, 0, &compiled_context->compiled_rules.rules[1]);
+  mapping_table = get_mapping_table(&compiled_context->mapping_tables,
+                                    &rule_field_descriptor);
+  assert(mapping_table != NULL);
+  assert(mapping_table->card_entries == CARD_TARGET_VALUES);
+  for (int index = 1; index < mapping_table->card_entries; index++) {
+    assert(memcmp(context +
+                      mapping_table->entries[index - 1].target_value_offset,
+                  context + mapping_table->entries[index].target_value_offset,
+                  2) <= 0);
+  }
+
+  for (int index = 0; index < CARD_TARGET_VALUES; index++) {
+    memcpy(field, context + TARGET_VALUES + 2 * index, 2);
+    assert(lookup_mapping_table(&mapping_index, field, mapping_table,
+                                context) == 1);
+    assert(mapping_index == (index == 150 ? 20 : index));
+  }
+
+  // Not a Target Value
+  field[0] = 0x00;
+  field[1] = 0x00;
+  assert(lookup_mapping_table(&mapping_index, field, mapping_table, context) ==
+         0);
+
+  // The Target Values with more than 4 bits in their first byte cannot match a
+  // 12-bit Field
+  get_compiled_rule_field_descriptor(
+      &rule_field_descriptor, 0, &compiled_context->compiled_rules.rules[2]);
+  mapping_table = get_mapping_table(&compiled_context->mapping_tables,
+                                    &rule_field_descriptor);
+  assert(mapping_table != NULL);
+  card_short_target_values = 0;
+  for (int index = 0; index < CARD_TARGET_VALUES; index++) {
+    card_short_target_values += context[TARGET_VALUES + 2 * index] <= 0x0f;
+  }
+  assert(mapping_table->card_entries == card_short_target_values);
+
+  field[0] = 0xfa;
+  field[1] = 0xbc;
+  assert(lookup_mapping_table(&mapping_index, field, mapping_table, context) ==
+         1);
+  assert(mapping_index == 5);
+
+  // Only the offsets of the lists have a Mapping Table
+  rule_field_descriptor.first_target_value_offset = TARGET_VALUES;
+  assert(get_mapping_table(&compiled_context->mapping_tables,
+                           &rule_field_descriptor) == NULL);
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_mapping_table_compression(void) {
+  /**
+   * @brief Test that compressing with the Mapping Tables gives the same SCHC
+   * Packets as comparing the Field with every Target Value, for every 16-bit
+   * value.
+   */
+
+  compiled_context_t *compiled_context;
+  uint8_t             packet[3];
+  uint8_t             schc_packet[8];
+  uint8_t             compiled_schc_packet[8];
+  size_t              schc_packet_byte_len;
+  int                 card_compressed;
+
+  build_context();
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+
+  packet[2]       = 0xaa;
+  card_compressed = 0;
+  for (uint32_t value = 0; value <= 0xffff; value++) {
+    packet[0] = value >> 8;
+    packet[1] = value & 0xff;
+
+    schc_packet_byte_len = compress_validated(
+        schc_packet, sizeof(schc_packet), DI_UP, packet, sizeof(packet),
+        &compiled_context->validated_context);
+    assert(schc_packet_byte_len > 0);
+    assert(compress_compiled(compiled_schc_packet,
+                             sizeof(compiled_schc_packet), DI_UP, packet,
+                             sizeof(packet),
+                             compiled_context) == schc_packet_byte_len);
+    assert(memcmp(compiled_schc_packet, schc_packet, schc_packet_byte_len) ==
+           0);
+    card_compressed += (schc_packet[0] >> 6) != 3;
+  }
+
+  // Every Target Value but the duplicate one, and the 12-bit matches, are
+  // mapped
+  assert(card_compressed >= CARD_TARGET_VALUES - 1);
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_mapping_table_lookup();
+  test_mapping_table_compression();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
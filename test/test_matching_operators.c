@@ -1,4 +1,5 @@
 #include "core/matching_operators.h"
+#include "utils/binary.h"
 #include "utils/memory.h"
 
 #include <assert.h>
@@ -313,6 +314,68 @@ void test_MO_most_significant_bits(void) {
 
 /* ********************************************************************** */
 
+void test_MO_most_significant_bits_lengths(void) {
+  /**
+   * @brief Test MO_most_significant_bits on Fields of 1 to 136 bits, through
+   * its 64-bit, 128-bit and byte paths, against the MSB shifted out of the
+   * Field with right_shift.
+   *
+   * @details Fields hold random bits, also beyond their length, and are
+   * compared with their own MSB as well as with random Target Values.
+   */
+  rule_field_descriptor_t rule_field_descriptor;
+  uint8_t                 field[17];
+  uint8_t                 msb_field[17];
+  uint8_t                 target_value[17];
+  size_t                  field_byte_len;
+  size_t                  msb_field_byte_len;
+  uint32_t                seed;
+  int                     expected_status;
+
+  memset(&rule_field_descriptor, 0x00, sizeof(rule_field_descriptor_t));
+  rule_field_descriptor.first_target_value_offset = 0;
+
+  seed = 1;
+  for (uint16_t len = 1; len <= 136; len++) {
+    for (uint16_t msb_len = 1; msb_len <= len; msb_len++) {
+      rule_field_descriptor.len     = len;
+      rule_field_descriptor.msb_len = msb_len;
+      field_byte_len                = BYTE_LENGTH(len);
+
+      for (size_t index = 0; index < field_byte_len; index++) {
+        seed         = seed * 1103515245 + 12345;
+        field[index] = seed >> 16;
+      }
+
+      memcpy(msb_field, field, field_byte_len);
+      msb_field_byte_len =
+          right_shift(msb_field, field_byte_len, len - msb_len);
+      if (msb_field_byte_len == 0) {
+        assert(!MO_most_significant_bits(field, &rule_field_descriptor,
+                                         target_value, sizeof(target_value)));
+        continue;
+      }
+      if (msb_len % 8 != 0) {
+        msb_field[0] &= (1 << (msb_len % 8)) - 1;
+      }
+
+      memcpy(target_value, msb_field, msb_field_byte_len);
+      assert(MO_most_significant_bits(field, &rule_field_descriptor,
+                                      target_value, sizeof(target_value)));
+
+      seed = seed * 1103515245 + 12345;
+      target_value[(seed >> 16) % msb_field_byte_len] ^= 1 << (seed >> 8) % 8;
+      expected_status =
+          memcmp(target_value, msb_field, msb_field_byte_len) == 0;
+      assert(MO_most_significant_bits(field, &rule_field_descriptor,
+                                      target_value, sizeof(target_value)) ==
+             expected_status);
+    }
+  }
+}
+
+/* ********************************************************************** */
+
 void test_MO_match_mapping(void) {
   const uint8_t short_context[] = {
       // ...
@@ -415,6 +478,7 @@ int main(void) {
 
   init_memory_pool();
   test_MO_most_significant_bits();  // Needs the pool to be allocated
+  test_MO_most_significant_bits_lengths();
   destroy_memory_pool();
 
   test_MO_match_mapping();
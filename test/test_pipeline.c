@@ -0,0 +1,258 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/context_loader.h"
+#include "core/decompression.h"
+#include "core/pipeline.h"
+#include "helpers/random_packets.h"
+#include "utils/memory.h"
+#include "utils/ring_buffer.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_THREADS        4
+#define CARD_ITEMS          100000
+#define CARD_PACKETS        4096
+#define BATCH_LEN           16
+#define MAX_PACKET_BYTE_LEN 128
+
+/* ********************************************************************** */
+
+validated_context_t validated_context;
+compiled_context_t *compiled_context;
+
+ring_buffer_t    ring_buffer;
+_Atomic uint64_t popped_sum;
+_Atomic size_t   card_popped;
+
+uint8_t packets[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+size_t  packet_byte_lens[CARD_PACKETS];
+uint8_t outputs[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+
+/* ********************************************************************** */
+
+/**
+ * @brief Pushes the items 1 to CARD_ITEMS of the thread to the ring buffer.
+ */
+void *producer_thread(void *arg) {
+  size_t offset;
+
+  offset = (size_t) arg * CARD_ITEMS;
+  for (size_t item = 1; item <= CARD_ITEMS; item++) {
+    while (!ring_buffer_push(&ring_buffer, (void *) (offset + item))) {
+      sched_yield();
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Pops items from the ring buffer until all of them are popped.
+ */
+void *consumer_thread(void *arg) {
+  void *item;
+
+  (void) arg;
+  while (atomic_load(&card_popped) < CARD_THREADS * CARD_ITEMS) {
+    if (!ring_buffer_pop(&ring_buffer, &item)) {
+      sched_yield();
+      continue;
+    }
+    atomic_fetch_add(&popped_sum, (uint64_t) (size_t) item);
+    atomic_fetch_add(&card_popped, 1);
+  }
+
+  return NULL;
+}
+
+/* ********************************************************************** */
+
+void test_ring_buffer(void) {
+  /**
+   * @brief Test that a ring buffer keeps the order of a single producer, and
+   * that concurrent producers and consumers pop each item once.
+   */
+
+  pthread_t producers[CARD_THREADS];
+  pthread_t consumers[CARD_THREADS];
+  void     *item;
+  uint64_t  expected_sum;
+
+  assert(init_ring_buffer(&ring_buffer, 5));
+  assert(ring_buffer.capacity == 8);
+  assert(!ring_buffer_pop(&ring_buffer, &item));
+  for (size_t index = 1; index <= 8; index++) {
+    assert(ring_buffer_push(&ring_buffer, (void *) index));
+  }
+  assert(!ring_buffer_push(&ring_buffer, (void *) 9));
+  for (size_t index = 1; index <= 8; index++) {
+    assert(ring_buffer_pop(&ring_buffer, &item) && (size_t) item == index);
+  }
+  assert(!ring_buffer_pop(&ring_buffer, &item));
+  destroy_ring_buffer(&ring_buffer);
+
+  assert(init_ring_buffer(&ring_buffer, 64));
+  atomic_init(&popped_sum, 0);
+  atomic_init(&card_popped, 0);
+  for (size_t index = 0; index < CARD_THREADS; index++) {
+    assert(pthread_create(&producers[index], NULL, producer_thread,
+                          (void *) index) == 0);
+    assert(pthread_create(&consumers[index], NULL, consumer_thread, NULL) ==
+           0);
+  }
+  for (size_t index = 0; index < CARD_THREADS; index++) {
+    pthread_join(producers[index], NULL);
+    pthread_join(consumers[index], NULL);
+  }
+
+  expected_sum = 0;
+  for (uint64_t index = 0; index < CARD_THREADS; index++) {
+    expected_sum += index * CARD_ITEMS * CARD_ITEMS +
+                    (uint64_t) CARD_ITEMS * (CARD_ITEMS + 1) / 2;
+  }
+  assert(atomic_load(&card_popped) == CARD_THREADS * CARD_ITEMS);
+  assert(atomic_load(&popped_sum) == expected_sum);
+  assert(!ring_buffer_pop(&ring_buffer, &item));
+  destroy_ring_buffer(&ring_buffer);
+}
+
+/* ********************************************************************** */
+
+void test_pipeline(void) {
+  /**
+   * @brief Test that batches are received in submission order, with the
+   * results of the single-threaded compression and decompression, and that
+   * submitting fails while the window is full.
+   */
+
+  pipeline_t        *pipeline;
+  pipeline_batch_t   batches[CARD_PACKETS / BATCH_LEN];
+  pipeline_packet_t  batch_packets[CARD_PACKETS];
+  pipeline_batch_t  *batch;
+  uint8_t            schc_packet[MAX_PACKET_BYTE_LEN];
+  uint8_t            output[MAX_PACKET_BYTE_LEN];
+  size_t             schc_packet_byte_len;
+  size_t             output_byte_len;
+  size_t             card_submitted;
+  size_t             card_received;
+  size_t             card_compressed;
+  size_t             index;
+
+  const size_t card_batches = CARD_PACKETS / BATCH_LEN;
+
+  // Packets are the decompression of random SCHC Packets, and the SCHC
+  // Packets themselves for the decompression batches.
+  index = 0;
+  while (index < CARD_PACKETS) {
+    schc_packet_byte_len = random_schc_packet(schc_packet, 1, 63);
+
+    if (index % 2 == 0) {
+      packet_byte_lens[index] =
+          decompress_compiled(packets[index], MAX_PACKET_BYTE_LEN, DI_UP,
+                              schc_packet, schc_packet_byte_len,
+                              compiled_context);
+      if (packet_byte_lens[index] == 0) {
+        continue;
+      }
+    } else {
+      memcpy(packets[index], schc_packet, schc_packet_byte_len);
+      packet_byte_lens[index] = schc_packet_byte_len;
+    }
+    index++;
+  }
+
+  for (index = 0; index < CARD_PACKETS; index++) {
+    batch_packets[index].packet              = packets[index];
+    batch_packets[index].packet_byte_len     = packet_byte_lens[index];
+    batch_packets[index].output              = outputs[index];
+    batch_packets[index].output_max_byte_len = MAX_PACKET_BYTE_LEN;
+    batch_packets[index].output_byte_len     = 0;
+  }
+  for (index = 0; index < card_batches; index++) {
+    batches[index].compiled_context = compiled_context;
+    batches[index].direction        = DI_UP;
+    batches[index].decompression    = index % 2;
+    batches[index].packets          = &batch_packets[index * BATCH_LEN];
+    batches[index].card_packets     = BATCH_LEN;
+  }
+
+  // Nothing is received before a batch is submitted
+  pipeline = create_pipeline(CARD_THREADS, 8);
+  assert(pipeline != NULL);
+  assert(receive_pipeline_batch(pipeline) == NULL);
+
+  card_submitted = 0;
+  card_received  = 0;
+  while (card_received < card_batches) {
+    while (card_submitted < card_batches &&
+           submit_pipeline_batch(pipeline, &batches[card_submitted])) {
+      card_submitted++;
+    }
+    assert(card_submitted - card_received <= 8);
+    assert(card_submitted == card_batches ||
+           card_submitted - card_received == 8);
+
+    batch = receive_pipeline_batch(pipeline);
+    if (batch == NULL) {
+      sched_yield();
+      continue;
+    }
+    assert(batch == &batches[card_received]);
+    assert(batch->sequence == card_received);
+    card_received++;
+  }
+  assert(receive_pipeline_batch(pipeline) == NULL);
+  destroy_pipeline(pipeline);
+
+  card_compressed = 0;
+  for (index = 0; index < CARD_PACKETS; index++) {
+    if ((index / BATCH_LEN) % 2 == 1) {
+      output_byte_len =
+          decompress_compiled(output, sizeof(output), DI_UP, packets[index],
+                              packet_byte_lens[index], compiled_context);
+    } else {
+      output_byte_len =
+          compress_compiled(output, sizeof(output), DI_UP, packets[index],
+                            packet_byte_lens[index], compiled_context);
+      card_compressed += output_byte_len > 0;
+    }
+    assert(batch_packets[index].output_byte_len == output_byte_len);
+    assert(memcmp(outputs[index], output, output_byte_len) == 0);
+  }
+  assert(card_compressed > 0);
+
+  // A Pipeline may be destroyed with batches in flight
+  pipeline = create_pipeline(2, 4);
+  assert(pipeline != NULL);
+  assert(submit_pipeline_batch(pipeline, &batches[0]));
+  destroy_pipeline(pipeline);
+
+  assert(create_pipeline(0, 4) == NULL);
+  assert(create_pipeline(PIPELINE_MAX_WORKERS + 1, 4) == NULL);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  assert(load_context_file(&validated_context, CODEGEN_CONTEXT_FILE));
+  compiled_context = compile_context(validated_context.context,
+                                     validated_context.context_byte_len);
+  assert(compiled_context != NULL);
+
+  test_ring_buffer();
+  test_pipeline();
+
+  free_compiled_context(compiled_context);
+  unload_context_file(&validated_context);
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
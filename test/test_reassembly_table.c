@@ -0,0 +1,354 @@
+#include "core/fragmentation.h"
+#include "core/reassembly_table.h"
+#include "utils/memory.h"
+#include "utils/timer_wheel.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PACKET_BYTE_LEN    15
+#define MTU                12
+#define TIMER_WHEEL_SLOTS  64
+#define INACTIVITY_TICKS   100
+#define CARD_DEVICES       100000
+#define MAX_SESSIONS       1024
+#define CONCURRENT_DEVICES 100000
+
+/* ********************************************************************** */
+
+const uint8_t context[] = {
+    // Context
+    0, 2, 0, 6, 0, 9,
+
+    // Rule Descriptors
+    0, 1, 0,                             // No-compression Rule
+    1, 2, 0, 0, 0, 2, 0, 1, 1, 0, 0, 10  // No-ACK, DTag 2 bits, 10-byte tiles
+};
+
+const uint8_t packet[PACKET_BYTE_LEN] = {0x01, 0x23, 0x45, 0x67, 0x89,
+                                         0xab, 0xcd, 0xef, 0xfe, 0xdc,
+                                         0xba, 0x98, 0x76, 0x54, 0x32};
+
+/* ********************************************************************** */
+
+/**
+ * @brief Fragments the Packet in a Regular fragment and an All-1 fragment.
+ *
+ * @param descriptor Fragmentation Descriptor to fill.
+ * @param fragments Fragments to fill.
+ * @param fragment_byte_lens Byte lengths of the fragments.
+ * @param dtag Datagram Tag.
+ */
+void fragment_packet(fragmentation_descriptor_t *descriptor,
+                     uint8_t fragments[2][MTU], size_t fragment_byte_lens[2],
+                     const uint8_t dtag) {
+  fragmentation_sender_t sender;
+  rule_descriptor_t      rule_descriptor;
+  int                    status;
+
+  status = get_rule_descriptor(&rule_descriptor, 1, context, sizeof(context));
+  assert(status);
+  status = get_fragmentation_descriptor(descriptor, &rule_descriptor, context,
+                                        sizeof(context));
+  assert(status);
+  status = init_fragmentation_sender(&sender, descriptor, dtag, packet,
+                                     sizeof(packet), NULL, 0);
+  assert(status);
+
+  for (size_t index = 0; index < 2; index++) {
+    fragment_byte_lens[index] =
+        get_next_fragment(&sender, fragments[index], MTU);
+    assert(fragment_byte_lens[index] > 0);
+  }
+  assert(sender.is_complete);
+}
+
+/* ********************************************************************** */
+
+void test_reassembly_table_lru(void) {
+  /**
+   * @brief Test that sessions are keyed by device and DTag, and that the least
+   * recently used session is evicted when the table is full.
+   */
+
+  uint8_t                    fragments[2][MTU];
+  uint8_t                    other_fragments[2][MTU];
+  size_t                     fragment_byte_lens[2];
+  size_t                     other_fragment_byte_lens[2];
+  size_t                     used;
+  fragmentation_descriptor_t descriptor;
+  reassembly_table_t         table;
+  reassembly_session_t      *session;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  fragment_packet(&descriptor, fragments, fragment_byte_lens, 0);
+  fragment_packet(&descriptor, other_fragments, other_fragment_byte_lens, 1);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  used   = pool->used;
+  status = init_reassembly_table(
+      &table, 4 * get_reassembly_session_byte_len(PACKET_BYTE_LEN),
+      PACKET_BYTE_LEN, &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+  assert(table.max_sessions == 4);
+  assert(pool->used - used <=
+         4 * get_reassembly_session_byte_len(PACKET_BYTE_LEN));
+
+  // Devices 1 to 3, and DTag 1 of device 1
+  for (uint64_t device_id = 1; device_id <= 3; device_id++) {
+    reassembly_status =
+        receive_session_fragment(&table, &descriptor, device_id, fragments[0],
+                                 fragment_byte_lens[0], &session);
+    assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+    assert(session->device_id == device_id);
+  }
+  reassembly_status = receive_session_fragment(
+      &table, &descriptor, 1, other_fragments[0], other_fragment_byte_lens[0],
+      &session);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  assert(table.card_sessions == 4);
+  assert(find_reassembly_session(&table, 1, 1, 0) != session);
+  assert(find_reassembly_session(&table, 1, 1, 1) == session);
+
+  // Device 1 is used again, device 2 is evicted for device 4
+  session = get_reassembly_session(&table, &descriptor, 1, fragments[0],
+                                   fragment_byte_lens[0]);
+  assert(session != NULL);
+  reassembly_status =
+      receive_session_fragment(&table, &descriptor, 4, fragments[0],
+                               fragment_byte_lens[0], &session);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  assert(table.card_evictions == 1);
+  assert(find_reassembly_session(&table, 2, 1, 0) == NULL);
+  assert(find_reassembly_session(&table, 1, 1, 0) != NULL);
+  assert(find_reassembly_session(&table, 3, 1, 0) != NULL);
+
+  // Both SCHC Packets of device 1 complete
+  reassembly_status =
+      receive_session_fragment(&table, &descriptor, 1, fragments[1],
+                               fragment_byte_lens[1], &session);
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+  assert(session->receiver.byte_len == sizeof(packet));
+  assert(memcmp(session->receiver.buffer, packet, sizeof(packet)) == 0);
+  close_reassembly_session(&table, session);
+
+  reassembly_status = receive_session_fragment(
+      &table, &descriptor, 1, other_fragments[1], other_fragment_byte_lens[1],
+      &session);
+  assert(reassembly_status == REASSEMBLY_COMPLETE);
+  close_reassembly_session(&table, session);
+  assert(table.card_sessions == 2);
+
+  // The All-1 fragment of an evicted session fails the RCS check
+  reassembly_status =
+      receive_session_fragment(&table, &descriptor, 2, fragments[1],
+                               fragment_byte_lens[1], &session);
+  assert(reassembly_status == REASSEMBLY_ERROR);
+  assert(session == NULL);
+  assert(table.card_sessions == 2);
+
+  destroy_reassembly_table(&table);
+  assert(pool->used == used);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_reassembly_table_expiry(void) {
+  /**
+   * @brief Test that sessions without any fragment for the inactivity
+   * duration are closed, and their reassembly buffers given back.
+   */
+
+  uint8_t                    fragments[2][MTU];
+  size_t                     fragment_byte_lens[2];
+  fragmentation_descriptor_t descriptor;
+  reassembly_table_t         table;
+  reassembly_session_t      *session;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  fragment_packet(&descriptor, fragments, fragment_byte_lens, 2);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_table(
+      &table, 8 * get_reassembly_session_byte_len(PACKET_BYTE_LEN),
+      PACKET_BYTE_LEN, &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+
+  reassembly_status =
+      receive_session_fragment(&table, &descriptor, 1, fragments[0],
+                               fragment_byte_lens[0], &session);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+
+  advance_timer_wheel(&timer_wheel, INACTIVITY_TICKS / 2);
+  reassembly_status =
+      receive_session_fragment(&table, &descriptor, 2, fragments[0],
+                               fragment_byte_lens[0], &session);
+  assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+
+  // Device 1 expires first
+  advance_timer_wheel(&timer_wheel, INACTIVITY_TICKS);
+  assert(table.card_sessions == 1);
+  assert(find_reassembly_session(&table, 1, 1, 2) == NULL);
+  assert(find_reassembly_session(&table, 2, 1, 2) == session);
+
+  advance_timer_wheel(&timer_wheel, 2 * INACTIVITY_TICKS);
+  assert(table.card_sessions == 0);
+  assert(timer_wheel.card_timers == 0);
+  for (size_t index = 0; index < table.reassembly_pool.card_buffers; index++) {
+    assert(table.reassembly_pool.owners[index] == REASSEMBLY_BUFFER_FREE);
+  }
+
+  destroy_reassembly_table(&table);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_reassembly_table_many_devices(void) {
+  /**
+   * @brief Test that a burst of fragments from many more devices than
+   * sessions neither allocates memory nor loses the most recent sessions.
+   */
+
+  uint8_t                    fragments[2][MTU];
+  size_t                     fragment_byte_lens[2];
+  size_t                     used;
+  fragmentation_descriptor_t descriptor;
+  reassembly_table_t         table;
+  reassembly_session_t      *session;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  int                        status;
+
+  fragment_packet(&descriptor, fragments, fragment_byte_lens, 3);
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_table(
+      &table, MAX_SESSIONS * get_reassembly_session_byte_len(PACKET_BYTE_LEN),
+      PACKET_BYTE_LEN, &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+  assert(table.max_sessions == MAX_SESSIONS);
+  used = pool->used;
+
+  for (uint64_t device_id = 0; device_id < CARD_DEVICES; device_id++) {
+    reassembly_status =
+        receive_session_fragment(&table, &descriptor, device_id, fragments[0],
+                                 fragment_byte_lens[0], &session);
+    assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  }
+  assert(pool->used == used);
+  assert(table.card_sessions == MAX_SESSIONS);
+  assert(table.card_evictions == CARD_DEVICES - MAX_SESSIONS);
+
+  for (uint64_t device_id = CARD_DEVICES - MAX_SESSIONS;
+       device_id < CARD_DEVICES; device_id++) {
+    reassembly_status =
+        receive_session_fragment(&table, &descriptor, device_id, fragments[1],
+                                 fragment_byte_lens[1], &session);
+    assert(reassembly_status == REASSEMBLY_COMPLETE);
+    assert(memcmp(session->receiver.buffer, packet, sizeof(packet)) == 0);
+    close_reassembly_session(&table, session);
+  }
+  assert(table.card_sessions == 0);
+
+  destroy_reassembly_table(&table);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_reassembly_table_concurrent_devices(void) {
+  /**
+   * @brief Test that as many sessions as devices stay open at once, none
+   * evicted, and that each one reassembles the SCHC Packet of its device.
+   *
+   * @details The sessions do not fit the default memory pool, a larger one,
+   * with room for the Timer Wheel too, replaces it for the test.
+   */
+
+  uint8_t                    fragments[2][MTU];
+  size_t                     fragment_byte_lens[2];
+  size_t                     max_byte_len;
+  fragmentation_descriptor_t descriptor;
+  reassembly_table_t         table;
+  reassembly_session_t      *session;
+  reassembly_status_t        reassembly_status;
+  timer_wheel_t              timer_wheel;
+  memory_pool_t              large_pool;
+  memory_pool_t             *default_pool;
+  int                        status;
+
+  fragment_packet(&descriptor, fragments, fragment_byte_lens, 1);
+
+  max_byte_len =
+      CONCURRENT_DEVICES * get_reassembly_session_byte_len(PACKET_BYTE_LEN);
+  large_pool.memory = (uint8_t *) malloc(max_byte_len + POOL_SIZE);
+  assert(large_pool.memory != NULL);
+  large_pool.used = 0;
+  large_pool.size = max_byte_len + POOL_SIZE;
+  default_pool    = pool;
+  pool            = &large_pool;
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+  status = init_reassembly_table(&table, max_byte_len, PACKET_BYTE_LEN,
+                                 &timer_wheel, INACTIVITY_TICKS);
+  assert(status);
+  assert(table.max_sessions == CONCURRENT_DEVICES);
+
+  for (uint64_t device_id = 0; device_id < CONCURRENT_DEVICES; device_id++) {
+    reassembly_status =
+        receive_session_fragment(&table, &descriptor, device_id, fragments[0],
+                                 fragment_byte_lens[0], &session);
+    assert(reassembly_status == REASSEMBLY_IN_PROGRESS);
+  }
+  assert(table.card_sessions == CONCURRENT_DEVICES);
+  assert(table.card_evictions == 0);
+  assert(table.reassembly_pool.card_free_buffers == 0);
+
+  for (uint64_t device_id = 0; device_id < CONCURRENT_DEVICES; device_id++) {
+    reassembly_status =
+        receive_session_fragment(&table, &descriptor, device_id, fragments[1],
+                                 fragment_byte_lens[1], &session);
+    assert(reassembly_status == REASSEMBLY_COMPLETE);
+    assert(session->device_id == device_id);
+    assert(memcmp(session->receiver.buffer, packet, sizeof(packet)) == 0);
+    close_reassembly_session(&table, session);
+  }
+  assert(table.card_sessions == 0);
+  assert(table.reassembly_pool.card_free_buffers == CONCURRENT_DEVICES);
+
+  destroy_reassembly_table(&table);
+  destroy_timer_wheel(&timer_wheel);
+  assert(large_pool.used == 0);
+
+  pool = default_pool;
+  free(large_pool.memory);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_reassembly_table_lru();
+  test_reassembly_table_expiry();
+  test_reassembly_table_many_devices();
+  test_reassembly_table_concurrent_devices();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
@@ -196,6 +196,18 @@ void test_get_rule_field_descriptor(void) {
   assert(!get_rule_field_descriptor(&rule_field_descriptor, 15,
                                     rule_descriptor_offset, context,
                                     context_byte_len));
+
+  /**
+   * @brief Get Rule Field Descriptor 7 (sid-ipv6-destinationaddress) from a
+   * truncated Context
+   *
+   * @details The Rule Field Descriptor itself is in the Context but its Target
+   * Value, from offset 179 to 194, is not.
+   */
+  assert(get_rule_field_descriptor(&rule_field_descriptor, 7,
+                                   rule_descriptor_offset, context, 195));
+  assert(!get_rule_field_descriptor(&rule_field_descriptor, 7,
+                                    rule_descriptor_offset, context, 194));
 }
 
 /* ********************************************************************** */
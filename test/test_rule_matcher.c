@@ -0,0 +1,279 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/rule_matcher.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_MANY_RULES 100
+#define CARD_MUTATIONS  2000
+
+/* ********************************************************************** */
+
+/**
+ * @brief The Rules 0 to 2 share the Source Address and differ by the UDP
+ * Application Port. The Rule 2 also compares the UDP Device Port, uplink only.
+ */
+const uint8_t context[] = {
+    // Context
+    0, 4, 0, 10, 0, 19, 0, 28, 0, 39,
+
+    // Rule Descriptors
+    0, 0, 3, 0, 42, 0, 50, 0, 60,         // Rule Descriptor n° 0
+    1, 0, 3, 0, 42, 0, 50, 0, 70,         // Rule Descriptor n° 1
+    2, 0, 4, 0, 42, 0, 50, 0, 80, 0, 90,  // Rule Descriptor n° 2
+    3, 1, 0,                              // Rule Descriptor n° 3
+
+    // Rule Field Descriptors
+    0x13, 0xc6, 0, 8, 0, 1, 75, 0,              // sid-ipv6-hop-limit
+                                                // bi/ig/vs
+    0x13, 0xc1, 0, 128, 0, 1, 64, 1, 0, 100,    // sid-ipv6-src-address
+                                                // bi/eq/ns
+    0x13, 0xce, 0, 16, 0, 1, 64, 1, 0, 116,     // sid-udp-app-port
+                                                // bi/eq/ns
+    0x13, 0xce, 0, 16, 0, 1, 64, 1, 0, 118,     // sid-udp-app-port
+                                                // bi/eq/ns
+    0x13, 0xce, 0, 16, 0, 1, 64, 1, 0, 120,     // sid-udp-app-port
+                                                // bi/eq/ns
+    0x13, 0xd1, 0, 16, 0, 1, 0, 1, 0, 122,      // sid-udp-dev-port
+                                                // up/eq/ns
+
+    // Target Values
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x20,  // Source Address
+    0x16, 0x33,              // Application Port of the Rule 0
+    0x16, 0x34,              // Application Port of the Rule 1
+    0x16, 0x35,              // Application Port of the Rule 2
+    0x12, 0x34               // Device Port of the Rule 2
+};
+
+/* ********************************************************************** */
+
+/**
+ * @brief Builds a packet for the Rules of context.
+ *
+ * @param packet Pointer to the packet to fill, 24 bytes long.
+ * @param app_port The UDP Application Port.
+ * @param dev_port The UDP Device Port.
+ */
+void build_packet(uint8_t packet[24], const uint16_t app_port,
+                  const uint16_t dev_port) {
+  packet[0] = 0x40;
+  memcpy(packet + 1, context + 100, 16);
+  packet[17] = app_port >> 8;
+  packet[18] = app_port & 0xff;
+  packet[19] = dev_port >> 8;
+  packet[20] = dev_port & 0xff;
+  packet[21] = 0x70;
+  packet[22] = 0x61;
+  packet[23] = 0x79;
+}
+
+/* ********************************************************************** */
+
+void test_rule_matcher_columns(void) {
+  /**
+   * @brief Test that MO_EQUAL Fields at the same position share a column, and
+   * that a packet only keeps the Rules whose Target Values it holds, whatever
+   * the instruction set.
+   */
+
+  compiled_context_t *compiled_context;
+  rule_matcher_t     *rule_matcher;
+  uint64_t            candidate_rules[RULE_MATCHER_MASK_WORDS];
+  uint8_t             packet[24];
+
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+
+  // Source Address on 2 columns, Application Port, then Device Port uplink
+  assert(compiled_context->rule_matchers[DI_UP].card_columns == 4);
+  assert(compiled_context->rule_matchers[DI_DW].card_columns == 3);
+  assert(compiled_context->rule_matchers[DI_UP].columns[0].bit_position == 8);
+  assert(compiled_context->rule_matchers[DI_UP].columns[1].bit_position == 72);
+  assert(compiled_context->rule_matchers[DI_UP].columns[2].bit_len == 16);
+  assert(compiled_context->rule_matchers[DI_UP].columns[2].rules[0] == 0x07);
+  assert(compiled_context->rule_matchers[DI_UP].columns[3].rules[0] == 0x04);
+
+  for (int isa = RULE_MATCHER_SCALAR; isa <= (int) get_rule_matcher_isa();
+       isa++) {
+    compiled_context->rule_matchers[DI_UP].isa = (rule_matcher_isa_t) isa;
+    compiled_context->rule_matchers[DI_DW].isa = (rule_matcher_isa_t) isa;
+    rule_matcher = &compiled_context->rule_matchers[DI_UP];
+
+    build_packet(packet, 0x1634, 0x1234);
+    match_rules(candidate_rules, rule_matcher, packet, sizeof(packet));
+    assert(candidate_rules[0] == 0x0a);
+    assert(candidate_rules[1] == 0 && candidate_rules[3] == 0);
+
+    build_packet(packet, 0x1635, 0x1234);
+    match_rules(candidate_rules, rule_matcher, packet, sizeof(packet));
+    assert(candidate_rules[0] == 0x0c);
+
+    build_packet(packet, 0x1635, 0x4321);
+    match_rules(candidate_rules, rule_matcher, packet, sizeof(packet));
+    assert(candidate_rules[0] == 0x08);
+
+    // The Device Port is not compared downlink
+    match_rules(candidate_rules, &compiled_context->rule_matchers[DI_DW],
+                packet, sizeof(packet));
+    assert(candidate_rules[0] == 0x0c);
+
+    // Last byte of the Source Address
+    build_packet(packet, 0x1633, 0x1234);
+    packet[16] ^= 0x01;
+    match_rules(candidate_rules, rule_matcher, packet, sizeof(packet));
+    assert(candidate_rules[0] == 0x08);
+
+    // Too short for any column
+    build_packet(packet, 0x1633, 0x1234);
+    match_rules(candidate_rules, rule_matcher, packet, 10);
+    assert(candidate_rules[0] == 0x08);
+  }
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_rule_matcher_compression(void) {
+  /**
+   * @brief Test that compressing with the candidate Rules gives the same SCHC
+   * Packets as trying every Rule, on packets with random bit flips.
+   */
+
+  compiled_context_t *compiled_context;
+  uint8_t             packet[24];
+  uint8_t             schc_packet[32];
+  uint8_t             compiled_schc_packet[32];
+  size_t              schc_packet_byte_len;
+  uint32_t            seed;
+  int                 card_compressed;
+
+  compiled_context = compile_context(context, sizeof(context));
+  assert(compiled_context != NULL);
+
+  seed            = 1;
+  card_compressed = 0;
+  for (int index = 0; index < CARD_MUTATIONS; index++) {
+    build_packet(packet, 0x1633 + index % 3, 0x1234);
+
+    // Most packets keep a Rule, the others only fit the no-compression Rule
+    seed = seed * 1103515245 + 12345;
+    if (seed % 4 == 0) {
+      packet[1 + (seed >> 8) % 20] ^= 1 << ((seed >> 16) % 8);
+    }
+
+    for (int packet_direction = DI_UP; packet_direction <= DI_DW;
+         packet_direction++) {
+      schc_packet_byte_len = compress_validated(
+          schc_packet, sizeof(schc_packet),
+          (direction_indicator_t) packet_direction, packet, sizeof(packet),
+          &compiled_context->validated_context);
+      assert(schc_packet_byte_len > 0);
+      assert(compress_compiled(compiled_schc_packet,
+                               sizeof(compiled_schc_packet),
+                               (direction_indicator_t) packet_direction,
+                               packet, sizeof(packet),
+                               compiled_context) == schc_packet_byte_len);
+      assert(memcmp(compiled_schc_packet, schc_packet, schc_packet_byte_len) ==
+             0);
+      card_compressed += schc_packet_byte_len < sizeof(packet);
+    }
+  }
+  assert(card_compressed > CARD_MUTATIONS);
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+void test_rule_matcher_many_rules(void) {
+  /**
+   * @brief Test the bitmask of candidate Rules beyond its first word, with a
+   * Rule per Application Port followed by the no-compression Rule.
+   */
+
+  static uint8_t      many_context[2 + 2 * (CARD_MANY_RULES + 1) +
+                              5 * CARD_MANY_RULES + 3 +
+                              12 * CARD_MANY_RULES];
+  compiled_context_t *compiled_context;
+  uint64_t            candidate_rules[RULE_MATCHER_MASK_WORDS];
+  uint8_t             packet[4];
+  size_t              offset;
+  size_t              rule_field_descriptor_offset;
+
+  many_context[0] = 0;
+  many_context[1] = CARD_MANY_RULES + 1;
+  offset          = 2 + 2 * (CARD_MANY_RULES + 1);
+  rule_field_descriptor_offset = offset + 5 * CARD_MANY_RULES + 3;
+
+  for (int index = 0; index <= CARD_MANY_RULES; index++) {
+    many_context[2 + 2 * index]     = offset >> 8;
+    many_context[2 + 2 * index + 1] = offset & 0xff;
+
+    if (index == CARD_MANY_RULES) {
+      many_context[offset++] = index;
+      many_context[offset++] = NATURE_NO_COMPRESSION;
+      many_context[offset++] = 0;
+      break;
+    }
+
+    // Rule Descriptor
+    many_context[offset++] = index;
+    many_context[offset++] = NATURE_COMPRESSION;
+    many_context[offset++] = 1;
+    many_context[offset++] = rule_field_descriptor_offset >> 8;
+    many_context[offset++] = rule_field_descriptor_offset & 0xff;
+
+    // Rule Field Descriptor sid-udp-app-port bi/eq/ns and its Target Value
+    uint8_t rule_field_descriptor[] = {
+        0x13, 0xce, 0, 16, 0, 1, 64, 1,
+        (rule_field_descriptor_offset + 10) >> 8,
+        (rule_field_descriptor_offset + 10) & 0xff, 0x16, index};
+    memcpy(many_context + rule_field_descriptor_offset, rule_field_descriptor,
+           sizeof(rule_field_descriptor));
+    rule_field_descriptor_offset += sizeof(rule_field_descriptor);
+  }
+
+  compiled_context = compile_context(many_context, sizeof(many_context));
+  assert(compiled_context != NULL);
+  assert(compiled_context->rule_matchers[DI_UP].card_columns == 1);
+
+  packet[0] = 0x16;
+  packet[2] = 0xca;
+  packet[3] = 0xfe;
+  for (int index = 0; index < CARD_MANY_RULES; index++) {
+    packet[1] = index;
+    match_rules(candidate_rules, &compiled_context->rule_matchers[DI_UP],
+                packet, sizeof(packet));
+    for (int index_word = 0; index_word < RULE_MATCHER_MASK_WORDS;
+         index_word++) {
+      assert(candidate_rules[index_word] ==
+             (index / 64 == index_word ? (uint64_t) 1 << (index % 64) : 0) +
+                 (CARD_MANY_RULES / 64 == index_word
+                      ? (uint64_t) 1 << (CARD_MANY_RULES % 64)
+                      : 0));
+    }
+  }
+
+  free_compiled_context(compiled_context);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_rule_matcher_columns();
+  test_rule_matcher_compression();
+  test_rule_matcher_many_rules();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,252 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/context_loader.h"
+#include "core/decompression.h"
+#include "core/rule_program.h"
+#include "helpers/random_packets.h"
+#include "utils/binary.h"
+#include "utils/memory.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_PACKETS        2000
+#define MAX_PACKET_BYTE_LEN 128
+
+/* ********************************************************************** */
+
+validated_context_t validated_context;
+compiled_context_t *compiled_context;
+
+/* ********************************************************************** */
+
+/**
+ * @brief Writes the bit_len low bits of a value into a buffer.
+ */
+void write_bits(uint8_t *buffer, size_t *bit_position, const uint64_t value,
+                const size_t bit_len) {
+  for (size_t index = bit_len; index > 0; index--) {
+    assert(add_byte_to_buffer(buffer, MAX_PACKET_BYTE_LEN, bit_position,
+                              (value >> (index - 1)) & 0x01, 1));
+  }
+}
+
+/**
+ * @brief Compresses a packet with the Compiled Context and with the Validated
+ * Context, for several SCHC Packet capacities, into buffers that are not
+ * zeroed, and checks that both give the same SCHC Packet.
+ *
+ * @return The Rule ID of the SCHC Packet, 0xff if the packet is not
+ * compressed.
+ */
+uint8_t compare_compression(const direction_indicator_t direction,
+                            const uint8_t *packet,
+                            const size_t   packet_byte_len) {
+  uint8_t schc_packet[MAX_PACKET_BYTE_LEN + 8];
+  uint8_t compiled_schc_packet[MAX_PACKET_BYTE_LEN + 8];
+  size_t  schc_packet_max_byte_lens[3];
+  size_t  schc_packet_byte_len;
+  uint8_t rule_id;
+
+  schc_packet_max_byte_lens[0] = sizeof(schc_packet);
+  schc_packet_max_byte_lens[1] = packet_byte_len;
+  schc_packet_max_byte_lens[2] = random_byte() % (packet_byte_len + 1);
+
+  // Rules write over what the previous compression left, whatever it is
+  memset(schc_packet, 0xff, sizeof(schc_packet));
+  memset(compiled_schc_packet, 0xa5, sizeof(compiled_schc_packet));
+
+  rule_id = 0xff;
+  for (int index = 0; index < 3; index++) {
+    schc_packet_byte_len = compress_validated(
+        schc_packet, schc_packet_max_byte_lens[index], direction, packet,
+        packet_byte_len, &validated_context);
+    assert(compress_compiled(compiled_schc_packet,
+                             schc_packet_max_byte_lens[index], direction,
+                             packet, packet_byte_len,
+                             compiled_context) == schc_packet_byte_len);
+    assert(memcmp(compiled_schc_packet, schc_packet, schc_packet_byte_len) ==
+           0);
+    if (index == 0 && schc_packet_byte_len > 0) {
+      rule_id = schc_packet[0] >> 5;
+    }
+  }
+
+  return rule_id;
+}
+
+/* ********************************************************************** */
+
+void test_rule_program_selection(void) {
+  /**
+   * @brief Test that only the Rules with Fixed-Length Fields get Programs, that
+   * the compression ones leave out the Mapping Sent Fields over 64 bits and the
+   * decompression ones CDA_LSB and CDA_COMPUTE.
+   */
+
+  const rule_programs_t    *rule_programs;
+  const rule_program_t     *rule_program;
+  const rule_instruction_t *instruction;
+
+  // Programs of Rules 0 to 5, compression then decompression, DI_UP then DI_DW
+  const int has_programs[6][4] = {{0, 0, 1, 1}, {1, 1, 0, 0}, {1, 1, 0, 0},
+                                  {1, 1, 1, 1}, {0, 1, 0, 1}, {0, 0, 0, 0}};
+
+  rule_programs = &compiled_context->rule_programs;
+  for (unsigned int index = 0; index < 6; index++) {
+    for (int program = 0; program < 4; program++) {
+      assert((get_rule_program(rule_programs, index,
+                               program % 2 == 0 ? DI_UP : DI_DW,
+                               program / 2) != NULL) ==
+             has_programs[index][program]);
+    }
+    assert(get_rule_program(rule_programs, index, DI_BI, 0) == NULL);
+  }
+  assert(get_rule_program(rule_programs, 6, DI_UP, 0) == NULL);
+
+  // In DI_DW, no 5-bit Field matches the 8-bit MSB Target Value of Rule 1
+  instruction = get_rule_program(rule_programs, 1, DI_DW, 0)->instructions;
+  while (instruction->opcode > OPCODE_FAIL) {
+    instruction++;
+  }
+  assert(instruction->opcode == OPCODE_FAIL);
+
+  // In DI_DW, Rule 3 decompresses to its header template, Version 6 then 0
+  rule_program = get_rule_program(rule_programs, 3, DI_DW, 1);
+  assert(rule_program->packet_bit_len == 12);
+  assert(rule_program->instructions[0].opcode == OPCODE_SKIP &&
+         rule_program->instructions[0].len == 12);
+  assert(rule_program->instructions[1].opcode == OPCODE_END);
+  assert(rule_program->header_template[0] == 0x60 &&
+         rule_program->header_template[1] == 0x00);
+  assert(get_rule_program(rule_programs, 1, DI_UP, 0)->residue_len == 26);
+}
+
+/* ********************************************************************** */
+
+void test_rule_program_decompression(void) {
+  /**
+   * @brief Test that the Programs decompress random SCHC Packets as the
+   * Rule-by-Rule decompression, and compress the packets they give, and their
+   * mutations, as the Rule-by-Rule compression.
+   */
+
+  uint8_t schc_packet[MAX_PACKET_BYTE_LEN];
+  uint8_t packet[MAX_PACKET_BYTE_LEN];
+  uint8_t compiled_packet[MAX_PACKET_BYTE_LEN];
+  size_t  schc_packet_byte_len;
+  size_t  packet_max_byte_len;
+  size_t  packet_byte_len;
+  int     card_decompressed;
+  int     card_compressed;
+
+  const direction_indicator_t directions[] = {DI_UP, DI_DW};
+
+  card_decompressed = 0;
+  card_compressed   = 0;
+  for (int index = 0; index < CARD_PACKETS; index++) {
+    schc_packet_byte_len = random_schc_packet(schc_packet, 1, 63);
+
+    for (int index_direction = 0; index_direction < 2; index_direction++) {
+      packet_max_byte_len = (index % 4 == 0) ? random_byte() % 64
+                                             : sizeof(packet);
+      packet_byte_len     = decompress_validated(
+          packet, packet_max_byte_len, directions[index_direction], schc_packet,
+          schc_packet_byte_len, &validated_context);
+      assert(decompress_compiled(compiled_packet, packet_max_byte_len,
+                                 directions[index_direction], schc_packet,
+                                 schc_packet_byte_len,
+                                 compiled_context) == packet_byte_len);
+      assert(memcmp(compiled_packet, packet, packet_byte_len) == 0);
+      if (packet_byte_len == 0) {
+        continue;
+      }
+      card_decompressed++;
+
+      card_compressed += compare_compression(directions[index_direction],
+                                             packet, packet_byte_len) != 5;
+
+      // A flipped bit, then a truncated packet
+      packet[random_byte() % packet_byte_len] ^= 1 << (random_byte() % 8);
+      compare_compression(directions[index_direction], packet,
+                          packet_byte_len);
+      compare_compression(directions[index_direction], packet,
+                          random_byte() % packet_byte_len);
+    }
+  }
+
+  assert(card_decompressed > CARD_PACKETS / 2);
+  assert(card_compressed > CARD_PACKETS / 4);
+}
+
+/* ********************************************************************** */
+
+void test_rule_program_compression_lsb(void) {
+  /**
+   * @brief Test that the Programs compress the packets matching the Rule 1,
+   * with CDA_LSB, and their mutations as the Rule-by-Rule compression.
+   */
+
+  uint8_t packet[MAX_PACKET_BYTE_LEN];
+  size_t  packet_byte_len;
+  size_t  bit_position;
+  int     card_compressed;
+
+  const uint8_t target_value[] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66,
+                                  0x77, 0x88, 0x99, 0x00, 0xaa};
+
+  card_compressed = 0;
+  for (int index = 0; index < CARD_PACKETS; index++) {
+    memset(packet, 0x00, sizeof(packet));
+    bit_position = 0;
+    write_bits(packet, &bit_position, 0x6, 4);
+    write_bits(packet, &bit_position, 0xabc00 | random_byte(), 20);
+    write_bits(packet, &bit_position, 0x1630 | (random_byte() & 0x0f), 16);
+    write_bits(packet, &bit_position, 0x2, 2);
+    assert(add_bits_to_buffer(packet, sizeof(packet), &bit_position,
+                              target_value, 8 * sizeof(target_value)));
+    write_bits(packet, &bit_position,
+               ((random_byte() & 0x03) << 8) | random_byte(), 10);
+    write_bits(packet, &bit_position, 0x10 | (random_byte() & 0x0f), 5);
+
+    packet_byte_len = BYTE_LENGTH(bit_position) + random_byte() % 32;
+    for (size_t index_byte = BYTE_LENGTH(bit_position);
+         index_byte < packet_byte_len; index_byte++) {
+      packet[index_byte] = random_byte();
+    }
+
+    card_compressed += compare_compression(DI_UP, packet, packet_byte_len) == 1;
+    compare_compression(DI_DW, packet, packet_byte_len);
+
+    packet[random_byte() % packet_byte_len] ^= 1 << (random_byte() % 8);
+    compare_compression(DI_UP, packet, packet_byte_len);
+    compare_compression(DI_UP, packet, random_byte() % packet_byte_len);
+  }
+
+  assert(card_compressed == CARD_PACKETS);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  assert(load_context_file(&validated_context, CODEGEN_CONTEXT_FILE));
+  compiled_context = compile_context(validated_context.context,
+                                     validated_context.context_byte_len);
+  assert(compiled_context != NULL);
+
+  test_rule_program_selection();
+  test_rule_program_decompression();
+  test_rule_program_compression_lsb();
+
+  free_compiled_context(compiled_context);
+  unload_context_file(&validated_context);
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
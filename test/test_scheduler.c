@@ -0,0 +1,280 @@
+#include "core/compiled_context.h"
+#include "core/compression.h"
+#include "core/context_loader.h"
+#include "core/decompression.h"
+#include "core/scheduler.h"
+#include "helpers/random_packets.h"
+#include "utils/memory.h"
+#include "utils/work_deque.h"
+
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CARD_THIEVES        3
+#define CARD_ITEMS          200000
+#define CARD_WORKERS        4
+#define CARD_PACKETS        4096
+#define CARD_BATCHES        CARD_PACKETS
+#define MAX_PACKET_BYTE_LEN 128
+
+/* ********************************************************************** */
+
+validated_context_t validated_context;
+compiled_context_t *compiled_contexts[2];
+
+work_deque_t     work_deque;
+_Atomic int      owner_done;
+_Atomic uint64_t taken_sum;
+_Atomic size_t   card_taken;
+_Atomic size_t   card_callbacks;
+
+uint8_t packets[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+size_t  packet_byte_lens[CARD_PACKETS];
+uint8_t outputs[CARD_PACKETS][MAX_PACKET_BYTE_LEN];
+
+/* ********************************************************************** */
+
+/**
+ * @brief Steals items from the Work Deque until the owner is done and the
+ * Work Deque is empty.
+ */
+void *thief_thread(void *arg) {
+  void *item;
+
+  (void) arg;
+  while (!atomic_load(&owner_done) ||
+         get_work_deque_size(&work_deque) > 0) {
+    if (!work_deque_steal(&work_deque, &item)) {
+      sched_yield();
+      continue;
+    }
+    atomic_fetch_add(&taken_sum, (uint64_t) (size_t) item);
+    atomic_fetch_add(&card_taken, 1);
+  }
+
+  return NULL;
+}
+
+/**
+ * @brief Counts the batches processed.
+ */
+void count_batch(pipeline_batch_t *batch, void *user_data) {
+  (void) batch;
+  assert(user_data == &card_callbacks);
+  atomic_fetch_add(&card_callbacks, 1);
+}
+
+/* ********************************************************************** */
+
+void test_work_deque(void) {
+  /**
+   * @brief Test that the owner of a Work Deque pops the last item pushed and
+   * thieves the first one, and that items pushed and popped by the owner while
+   * thieves steal are taken once.
+   */
+
+  pthread_t thieves[CARD_THIEVES];
+  void     *item;
+
+  assert(init_work_deque(&work_deque, 3));
+  assert(work_deque.capacity == 4);
+  assert(!work_deque_pop(&work_deque, &item));
+  assert(!work_deque_steal(&work_deque, &item));
+  for (size_t index = 1; index <= 4; index++) {
+    assert(work_deque_push(&work_deque, (void *) index));
+  }
+  assert(!work_deque_push(&work_deque, (void *) 5));
+  assert(get_work_deque_size(&work_deque) == 4);
+  assert(work_deque_steal(&work_deque, &item) && (size_t) item == 1);
+  assert(work_deque_pop(&work_deque, &item) && (size_t) item == 4);
+  assert(work_deque_push(&work_deque, (void *) 5));
+  assert(work_deque_push(&work_deque, (void *) 6));
+  assert(work_deque_steal(&work_deque, &item) && (size_t) item == 2);
+  assert(work_deque_pop(&work_deque, &item) && (size_t) item == 6);
+  assert(work_deque_pop(&work_deque, &item) && (size_t) item == 5);
+  assert(work_deque_pop(&work_deque, &item) && (size_t) item == 3);
+  assert(!work_deque_pop(&work_deque, &item));
+  assert(!work_deque_steal(&work_deque, &item));
+  destroy_work_deque(&work_deque);
+
+  assert(init_work_deque(&work_deque, 64));
+  atomic_init(&owner_done, 0);
+  atomic_init(&taken_sum, 0);
+  atomic_init(&card_taken, 0);
+  for (size_t index = 0; index < CARD_THIEVES; index++) {
+    assert(pthread_create(&thieves[index], NULL, thief_thread, NULL) == 0);
+  }
+
+  // The owner pops one item out of three it pushes
+  for (size_t index = 1; index <= CARD_ITEMS; index++) {
+    while (!work_deque_push(&work_deque, (void *) index)) {
+      if (work_deque_pop(&work_deque, &item)) {
+        atomic_fetch_add(&taken_sum, (uint64_t) (size_t) item);
+        atomic_fetch_add(&card_taken, 1);
+      }
+    }
+    if (index % 3 == 0 && work_deque_pop(&work_deque, &item)) {
+      atomic_fetch_add(&taken_sum, (uint64_t) (size_t) item);
+      atomic_fetch_add(&card_taken, 1);
+    }
+  }
+  atomic_store(&owner_done, 1);
+  for (size_t index = 0; index < CARD_THIEVES; index++) {
+    pthread_join(thieves[index], NULL);
+  }
+
+  assert(atomic_load(&card_taken) == CARD_ITEMS);
+  assert(atomic_load(&taken_sum) ==
+         (uint64_t) CARD_ITEMS * (CARD_ITEMS + 1) / 2);
+  destroy_work_deque(&work_deque);
+}
+
+/* ********************************************************************** */
+
+void test_scheduler(void) {
+  /**
+   * @brief Test that interleaved uplink decompression and downlink compression
+   * batches of two Contexts and uneven sizes are all processed, with the
+   * results of the single-threaded compression and decompression.
+   */
+
+  scheduler_t       *scheduler;
+  pipeline_batch_t   batches[CARD_BATCHES];
+  pipeline_packet_t  batch_packets[CARD_PACKETS];
+  uint8_t            schc_packet[MAX_PACKET_BYTE_LEN];
+  uint8_t            output[MAX_PACKET_BYTE_LEN];
+  size_t             schc_packet_byte_len;
+  size_t             output_byte_len;
+  size_t             card_batches;
+  size_t             card_compressed;
+  size_t             index;
+  size_t             firsts[2];
+  size_t             first;
+  size_t             decompression;
+  uint64_t           card_processed;
+
+  // The first half are the decompression of random SCHC Packets, in DI_DW, the
+  // second half SCHC Packets.
+  index = 0;
+  while (index < CARD_PACKETS) {
+    schc_packet_byte_len = random_schc_packet(schc_packet, 1, 63);
+
+    if (index < CARD_PACKETS / 2) {
+      packet_byte_lens[index] = decompress_compiled(
+          packets[index], MAX_PACKET_BYTE_LEN, DI_DW, schc_packet,
+          schc_packet_byte_len, compiled_contexts[0]);
+      if (packet_byte_lens[index] == 0) {
+        continue;
+      }
+    } else {
+      memcpy(packets[index], schc_packet, schc_packet_byte_len);
+      packet_byte_lens[index] = schc_packet_byte_len;
+    }
+    index++;
+  }
+
+  for (index = 0; index < CARD_PACKETS; index++) {
+    batch_packets[index].packet              = packets[index];
+    batch_packets[index].packet_byte_len     = packet_byte_lens[index];
+    batch_packets[index].output              = outputs[index];
+    batch_packets[index].output_max_byte_len = MAX_PACKET_BYTE_LEN;
+    batch_packets[index].output_byte_len     = 0;
+  }
+
+  // Batches of 1 to 32 packets, downlink compression and uplink decompression
+  // alternating while both halves last
+  card_batches = 0;
+  firsts[0]    = 0;
+  firsts[1]    = CARD_PACKETS / 2;
+  while (firsts[0] < CARD_PACKETS / 2 || firsts[1] < CARD_PACKETS) {
+    assert(card_batches < CARD_BATCHES);
+    decompression = (firsts[0] < CARD_PACKETS / 2) ? card_batches % 2 : 1;
+    if (firsts[1] == CARD_PACKETS) {
+      decompression = 0;
+    }
+    batches[card_batches].compiled_context =
+        compiled_contexts[random_byte() % 2];
+    batches[card_batches].decompression = decompression;
+    batches[card_batches].direction     = decompression ? DI_UP : DI_DW;
+    batches[card_batches].packets       = &batch_packets[firsts[decompression]];
+    batches[card_batches].card_packets  = 1 + random_byte() % 32;
+    if (firsts[decompression] + batches[card_batches].card_packets >
+        (decompression + 1) * CARD_PACKETS / 2) {
+      batches[card_batches].card_packets =
+          (decompression + 1) * CARD_PACKETS / 2 - firsts[decompression];
+    }
+    firsts[decompression] += batches[card_batches].card_packets;
+    card_batches++;
+  }
+
+  atomic_init(&card_callbacks, 0);
+  scheduler = create_scheduler(CARD_WORKERS, 16, count_batch, &card_callbacks);
+  assert(scheduler != NULL);
+  for (index = 0; index < card_batches; index++) {
+    while (!submit_scheduler_batch(scheduler, &batches[index])) {
+      sched_yield();
+    }
+  }
+  wait_scheduler(scheduler);
+
+  assert(atomic_load(&card_callbacks) == card_batches);
+  card_processed = 0;
+  for (index = 0; index < CARD_WORKERS; index++) {
+    card_processed += atomic_load(&scheduler->workers[index].card_processed);
+  }
+  assert(card_processed == card_batches);
+  destroy_scheduler(scheduler);
+
+  card_compressed = 0;
+  for (index = 0; index < card_batches; index++) {
+    for (first = 0; first < batches[index].card_packets; first++) {
+      if (batches[index].decompression) {
+        output_byte_len = decompress_compiled(
+            output, sizeof(output), DI_UP, batches[index].packets[first].packet,
+            batches[index].packets[first].packet_byte_len,
+            batches[index].compiled_context);
+      } else {
+        output_byte_len = compress_compiled(
+            output, sizeof(output), DI_DW, batches[index].packets[first].packet,
+            batches[index].packets[first].packet_byte_len,
+            batches[index].compiled_context);
+        card_compressed += output_byte_len > 0;
+      }
+      assert(batches[index].packets[first].output_byte_len == output_byte_len);
+      assert(memcmp(batches[index].packets[first].output, output,
+                    output_byte_len) == 0);
+    }
+  }
+  assert(card_compressed > 0);
+
+  assert(create_scheduler(0, 16, NULL, NULL) == NULL);
+  assert(create_scheduler(PIPELINE_MAX_WORKERS + 1, 16, NULL, NULL) == NULL);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  assert(load_context_file(&validated_context, CODEGEN_CONTEXT_FILE));
+  for (int index = 0; index < 2; index++) {
+    compiled_contexts[index] = compile_context(
+        validated_context.context, validated_context.context_byte_len);
+    assert(compiled_contexts[index] != NULL);
+  }
+
+  test_work_deque();
+  test_scheduler();
+
+  free_compiled_context(compiled_contexts[0]);
+  free_compiled_context(compiled_contexts[1]);
+  unload_context_file(&validated_context);
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+#include "utils/memory.h"
+#include "utils/timer_wheel.h"
+
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+#define TIMER_WHEEL_SLOTS 8
+#define CARD_TIMERS       1000
+#define MAX_DELAY_TICKS   5000  // Beyond the 8^4 ticks of the levels
+
+/* ********************************************************************** */
+
+/**
+ * @brief Struct that defines an object owning a timer.
+ */
+typedef struct {
+  wheel_timer_t  timer;          // Timer
+  timer_wheel_t *timer_wheel;    // Timer Wheel of the timer
+  uint64_t       expired_tick;   // Tick of the last expiry
+  size_t         card_expiries;  // Number of expiries
+  uint64_t       period_ticks;   // Restart delay, 0 for a one-shot timer
+} expiry_t;
+
+/* ********************************************************************** */
+
+/**
+ * @brief Records the expiry of a timer, and restarts periodic timers.
+ *
+ * @param timer Pointer to the expired timer.
+ */
+void on_expiry(wheel_timer_t *timer) {
+  expiry_t *expiry;
+
+  expiry = (expiry_t *) timer->owner;
+  expiry->expired_tick = expiry->timer_wheel->current_tick;
+  expiry->card_expiries++;
+
+  if (expiry->period_ticks > 0) {
+    start_wheel_timer(expiry->timer_wheel, timer, expiry->period_ticks);
+  }
+}
+
+/* ********************************************************************** */
+
+/**
+ * @brief Initializes an object owning a timer.
+ *
+ * @param expiry Pointer to the object.
+ * @param timer_wheel Pointer to the Timer Wheel.
+ * @param period_ticks Restart delay, 0 for a one-shot timer.
+ */
+void init_expiry(expiry_t *expiry, timer_wheel_t *timer_wheel,
+                 const uint64_t period_ticks) {
+  memset(expiry, 0x00, sizeof(expiry_t));
+  expiry->timer_wheel  = timer_wheel;
+  expiry->period_ticks = period_ticks;
+  init_wheel_timer(&expiry->timer, on_expiry, expiry);
+}
+
+/* ********************************************************************** */
+
+void test_timer_wheel_expiry(void) {
+  /**
+   * @brief Test that timers expire at their tick, including timers further
+   * than the levels of the wheel, and that stopped timers never expire.
+   */
+
+  timer_wheel_t timer_wheel;
+  expiry_t      short_expiry;
+  expiry_t      long_expiry;
+  expiry_t      far_expiry;
+  expiry_t      stopped_expiry;
+  size_t        used;
+  int           status;
+
+  used   = pool->used;
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 100);
+  assert(status);
+
+  init_expiry(&short_expiry, &timer_wheel, 0);
+  init_expiry(&long_expiry, &timer_wheel, 0);
+  init_expiry(&far_expiry, &timer_wheel, 0);
+  init_expiry(&stopped_expiry, &timer_wheel, 0);
+
+  start_wheel_timer(&timer_wheel, &short_expiry.timer, 3);
+  start_wheel_timer(&timer_wheel, &long_expiry.timer,
+                    3 + 2 * TIMER_WHEEL_SLOTS);
+  start_wheel_timer(&timer_wheel, &far_expiry.timer, 3 * MAX_DELAY_TICKS);
+  start_wheel_timer(&timer_wheel, &stopped_expiry.timer, 5);
+  assert(timer_wheel.card_timers == 4);
+
+  stop_wheel_timer(&timer_wheel, &stopped_expiry.timer);
+  assert(!is_wheel_timer_running(&stopped_expiry.timer));
+  assert(timer_wheel.card_timers == 3);
+
+  assert(advance_timer_wheel(&timer_wheel, 102) == 0);
+  assert(advance_timer_wheel(&timer_wheel, 103) == 1);
+  assert(short_expiry.card_expiries == 1);
+  assert(short_expiry.expired_tick == 103);
+  assert(long_expiry.card_expiries == 0);
+  assert(is_wheel_timer_running(&long_expiry.timer));
+
+  // Several ticks at once
+  assert(advance_timer_wheel(&timer_wheel, 200) == 1);
+  assert(long_expiry.expired_tick == 103 + 2 * TIMER_WHEEL_SLOTS);
+  assert(timer_wheel.card_timers == 1);
+  assert(timer_wheel.current_tick == 200);
+
+  // Restarting a running timer moves its expiry
+  start_wheel_timer(&timer_wheel, &short_expiry.timer, 2);
+  start_wheel_timer(&timer_wheel, &short_expiry.timer, 4);
+  assert(timer_wheel.card_timers == 2);
+  assert(advance_timer_wheel(&timer_wheel, 203) == 0);
+  assert(advance_timer_wheel(&timer_wheel, 204) == 1);
+
+  assert(advance_timer_wheel(&timer_wheel, 4 * MAX_DELAY_TICKS) == 1);
+  assert(far_expiry.expired_tick == 100 + 3 * MAX_DELAY_TICKS);
+  assert(stopped_expiry.card_expiries == 0);
+  assert(timer_wheel.card_timers == 0);
+
+  destroy_timer_wheel(&timer_wheel);
+  assert(pool->used == used);
+}
+
+/* ********************************************************************** */
+
+void test_timer_wheel_periodic(void) {
+  /**
+   * @brief Test that a timer restarted from its expiry function expires
+   * periodically.
+   */
+
+  timer_wheel_t timer_wheel;
+  expiry_t      periodic_expiry;
+  int           status;
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+
+  init_expiry(&periodic_expiry, &timer_wheel, TIMER_WHEEL_SLOTS);
+  start_wheel_timer(&timer_wheel, &periodic_expiry.timer, TIMER_WHEEL_SLOTS);
+
+  assert(advance_timer_wheel(&timer_wheel, 10 * TIMER_WHEEL_SLOTS) == 10);
+  assert(periodic_expiry.card_expiries == 10);
+  assert(periodic_expiry.expired_tick == 10 * TIMER_WHEEL_SLOTS);
+  assert(is_wheel_timer_running(&periodic_expiry.timer));
+
+  stop_wheel_timer(&timer_wheel, &periodic_expiry.timer);
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+void test_timer_wheel_many_timers(void) {
+  /**
+   * @brief Test that many timers sharing slots all expire once, in any order
+   * of delays.
+   */
+
+  static expiry_t expiries[CARD_TIMERS];
+  timer_wheel_t   timer_wheel;
+  size_t          card_expired;
+  int             status;
+
+  status = init_timer_wheel(&timer_wheel, TIMER_WHEEL_SLOTS, 0);
+  assert(status);
+
+  for (size_t index = 0; index < CARD_TIMERS; index++) {
+    init_expiry(&expiries[index], &timer_wheel, 0);
+    start_wheel_timer(&timer_wheel, &expiries[index].timer,
+                      1 + (index * 7919) % MAX_DELAY_TICKS);
+  }
+  assert(timer_wheel.card_timers == CARD_TIMERS);
+
+  card_expired = 0;
+  for (uint64_t tick = 1; tick <= MAX_DELAY_TICKS; tick++) {
+    card_expired += advance_timer_wheel(&timer_wheel, tick);
+  }
+  assert(card_expired == CARD_TIMERS);
+
+  for (size_t index = 0; index < CARD_TIMERS; index++) {
+    assert(expiries[index].card_expiries == 1);
+    assert(expiries[index].expired_tick ==
+           1 + (index * 7919) % MAX_DELAY_TICKS);
+  }
+
+  destroy_timer_wheel(&timer_wheel);
+}
+
+/* ********************************************************************** */
+
+int main(void) {
+  init_memory_pool();
+
+  test_timer_wheel_expiry();
+  test_timer_wheel_periodic();
+  test_timer_wheel_many_timers();
+
+  destroy_memory_pool();
+
+  printf("All tests passed!\n");
+
+  return 0;
+}
\ No newline at end of file